@@ -418,6 +418,15 @@ int run_benchmark(viennacl::context ctx)
   std::cout << "------- CG solver (no preconditioner) via ViennaCL, compressed_matrix ----------" << std::endl;
   run_solver(vcl_compressed_matrix, vcl_vec2, vcl_result, cg_solver, viennacl::linalg::no_precond(), cg_ops);
 
+  if (viennacl::traits::active_handle_id(vcl_compressed_matrix) == viennacl::MAIN_MEMORY)
+  {
+    // the default run above fuses each CG iteration into a single parallel region. Compare with separate kernels for the vector update and the matrix-vector product:
+    std::cout << "------- CG solver (no preconditioner) via ViennaCL, compressed_matrix, separate kernels per iteration ----------" << std::endl;
+    viennacl::linalg::host_based::set_fused_cg_iteration(false);
+    run_solver(vcl_compressed_matrix, vcl_vec2, vcl_result, cg_solver, viennacl::linalg::no_precond(), cg_ops);
+    viennacl::linalg::host_based::set_fused_cg_iteration(true);
+  }
+
   bool is_double = (sizeof(ScalarType) == sizeof(double));
   if (is_double)
   {
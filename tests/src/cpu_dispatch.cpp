@@ -0,0 +1,207 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+
+
+/** \file tests/src/cpu_dispatch.cpp  Tests the runtime selection of vectorized kernels in the host backend.
+*   \test Tests the runtime selection of vectorized kernels in the host backend.
+**/
+
+#ifndef VIENNACL_WITH_CPU_DISPATCH
+  #define VIENNACL_WITH_CPU_DISPATCH
+#endif
+
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdlib>
+
+
+template<typename NumericT>
+NumericT diff(std::vector<NumericT> const & v1, std::vector<NumericT> const & v2)
+{
+  NumericT max_diff = 0;
+  NumericT max_val  = 0;
+  for (std::size_t i=0; i<v1.size(); ++i)
+  {
+    max_diff = std::max<NumericT>(max_diff, std::fabs(v1[i] - v2[i]));
+    max_val  = std::max<NumericT>(max_val,  std::fabs(v1[i]));
+  }
+  return (max_val > 0) ? max_diff / max_val : max_diff;
+}
+
+/** @brief Runs GEMM, GEMV, CSR-SpMV, inner_prod, and norm_2 with the currently active kernel variant and stores the results in a flat array */
+template<typename NumericT, typename LayoutT>
+std::vector<NumericT> run_kernels(std::size_t N)
+{
+  std::vector<NumericT> results;
+
+  // dense operands:
+  std::vector<std::vector<NumericT> > std_A(N, std::vector<NumericT>(N+3)), std_B(N+3, std::vector<NumericT>(N));
+  for (std::size_t i=0; i<N; ++i)
+    for (std::size_t j=0; j<N+3; ++j)
+    {
+      std_A[i][j] = NumericT((i * 7 + j * 3) % 13) / NumericT(13) - NumericT(0.5);
+      std_B[j][i] = NumericT((i * 5 + j * 2) % 11) / NumericT(11) - NumericT(0.5);
+    }
+  std::vector<NumericT> std_x(N+3);
+  for (std::size_t i=0; i<std_x.size(); ++i)
+    std_x[i] = NumericT((i * 5) % 11) / NumericT(11);
+
+  viennacl::matrix<NumericT, LayoutT> A(N, N+3), B(N+3, N), C(N, N);
+  viennacl::copy(std_A, A);
+  viennacl::copy(std_B, B);
+
+  viennacl::vector<NumericT> x(N+3), y(N), z(N+3);
+  viennacl::copy(std_x, x);
+
+  // GEMM:
+  std::vector<std::vector<NumericT> > std_C(N, std::vector<NumericT>(N));
+  C = viennacl::linalg::prod(A, B);
+  viennacl::copy(C, std_C);
+  for (std::size_t i=0; i<N; ++i)
+    results.insert(results.end(), std_C[i].begin(), std_C[i].end());
+
+  C = viennacl::linalg::prod(trans(B), trans(A));
+  viennacl::copy(C, std_C);
+  for (std::size_t i=0; i<N; ++i)
+    results.insert(results.end(), std_C[i].begin(), std_C[i].end());
+
+  // GEMV:
+  y = viennacl::linalg::prod(A, x);
+  std::vector<NumericT> std_y(N);
+  viennacl::copy(y, std_y);
+  results.insert(results.end(), std_y.begin(), std_y.end());
+
+  z = viennacl::linalg::prod(trans(A), y);
+  std::vector<NumericT> std_z(N+3);
+  viennacl::copy(z, std_z);
+  results.insert(results.end(), std_z.begin(), std_z.end());
+
+  // CSR SpMV (tridiagonal plus a dense first row):
+  std::vector<std::map<unsigned int, NumericT> > std_sparse(N+3);
+  for (std::size_t i=0; i<N+3; ++i)
+  {
+    std_sparse[0][static_cast<unsigned int>(i)] = NumericT(1) / NumericT(i+1);
+    std_sparse[i][static_cast<unsigned int>(i)] = NumericT(2);
+    if (i > 0)
+      std_sparse[i][static_cast<unsigned int>(i-1)] = NumericT(-1);
+    if (i < N+2)
+      std_sparse[i][static_cast<unsigned int>(i+1)] = NumericT(-1);
+  }
+  viennacl::compressed_matrix<NumericT> S;
+  viennacl::copy(std_sparse, S);
+
+  z = viennacl::linalg::prod(S, x);
+  viennacl::copy(z, std_z);
+  results.insert(results.end(), std_z.begin(), std_z.end());
+
+  // reductions:
+  results.push_back(viennacl::linalg::inner_prod(x, z));
+  results.push_back(viennacl::linalg::norm_2(z));
+
+  return results;
+}
+
+template<typename NumericT, typename LayoutT>
+int test(NumericT epsilon, std::size_t N)
+{
+  using namespace viennacl::linalg::host_based;
+
+  set_cpu_isa_limit(CPU_ISA_GENERIC);
+  if (selected_kernel_variant<NumericT>(HOST_KERNEL_GEMM) != "generic")
+  {
+    std::cout << "# Error: Variant not restricted to generic kernels!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<NumericT> reference = run_kernels<NumericT, LayoutT>(N);
+
+  cpu_isa_type isa_levels[] = { CPU_ISA_AVX2, CPU_ISA_AVX512 };
+  for (std::size_t i=0; i<2; ++i)
+  {
+    set_cpu_isa_limit(isa_levels[i]);
+    if (active_cpu_isa() != isa_levels[i])
+      continue;
+
+    std::cout << "  * variant '" << selected_kernel_variant<NumericT>(HOST_KERNEL_GEMM) << "', N = " << N << ": ";
+    std::vector<NumericT> result = run_kernels<NumericT, LayoutT>(N);
+    NumericT rel_diff = diff(reference, result);
+    if (rel_diff > epsilon)
+    {
+      std::cout << "FAILED (relative difference " << rel_diff << ")" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "passed" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int main()
+{
+  using namespace viennacl::linalg::host_based;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Runtime CPU dispatch" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "Detected instruction set: " << cpu_isa_name(detected_cpu_isa()) << std::endl;
+  std::cout << "Compiled instruction set: " << cpu_isa_name(compiled_cpu_isa()) << std::endl;
+  std::cout << "Active instruction set:   " << cpu_isa_name(active_cpu_isa()) << std::endl;
+
+  if (selected_kernel_variant<int>(HOST_KERNEL_INNER_PROD) != "generic")
+  {
+    std::cout << "# Error: Integer kernels must use generic variant!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::size_t sizes[] = { 1, 7, 37, 130 };
+  for (std::size_t i=0; i<4; ++i)
+  {
+    std::cout << "# Testing float, row-major" << std::endl;
+    if (test<float, viennacl::row_major>(1e-4f, sizes[i]) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    std::cout << "# Testing float, column-major" << std::endl;
+    if (test<float, viennacl::column_major>(1e-4f, sizes[i]) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    std::cout << "# Testing double, row-major" << std::endl;
+    if (test<double, viennacl::row_major>(1e-12, sizes[i]) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    std::cout << "# Testing double, column-major" << std::endl;
+    if (test<double, viennacl::column_major>(1e-12, sizes[i]) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,819 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+
+
+/** \file tests/src/iterative_solvers.cpp  Tests the iterative solvers on 2D convection-diffusion problems.
+*   \test  Tests the iterative solvers on 2D convection-diffusion problems.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+//
+// *** ViennaCL
+//
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/symmetric_compressed_matrix.hpp"
+#include "viennacl/sliced_ell_matrix.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/ilu.hpp"
+#include "viennacl/linalg/ichol.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/s_step_cg.hpp"
+#include "viennacl/linalg/s_step_gmres.hpp"
+#include "viennacl/linalg/block_cg.hpp"
+#include "viennacl/linalg/block_gmres.hpp"
+#include "viennacl/linalg/fgmres.hpp"
+#include "viennacl/linalg/gcrodr.hpp"
+#include "viennacl/linalg/idrs.hpp"
+#include "viennacl/linalg/minres.hpp"
+#include "viennacl/linalg/chebyshev.hpp"
+#include "viennacl/linalg/amg.hpp"
+
+
+//
+// -------------------------------------------------------------
+//
+
+/** @brief Five-point stencil of -Laplace(u) + c * (u_x + u_y) + shift * u on a grid_size x grid_size grid, scaled by the square of the mesh size. Symmetric for zero convection c. */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > convection_diffusion_2d(std::size_t grid_size, NumericT c, NumericT shift = 0)
+{
+  std::vector<std::map<unsigned int, NumericT> > std_matrix(grid_size * grid_size);
+  for (std::size_t i=0; i<grid_size; ++i)
+    for (std::size_t j=0; j<grid_size; ++j)
+    {
+      unsigned int row = static_cast<unsigned int>(i * grid_size + j);
+      std_matrix[row][row] = NumericT(4) + shift;
+      if (i > 0)             std_matrix[row][row - static_cast<unsigned int>(grid_size)] = NumericT(-1) - c;
+      if (i < grid_size - 1) std_matrix[row][row + static_cast<unsigned int>(grid_size)] = NumericT(-1) + c;
+      if (j > 0)             std_matrix[row][row - 1] = NumericT(-1) - c;
+      if (j < grid_size - 1) std_matrix[row][row + 1] = NumericT(-1) + c;
+    }
+  return std_matrix;
+}
+
+/** @brief Returns ||b - A x|| / ||b||, or ||b - A x|| if b is zero */
+template<typename MatrixT, typename VectorT>
+double relative_residual(MatrixT const & A, VectorT const & x, VectorT const & b)
+{
+  VectorT residual = viennacl::linalg::prod(A, x);
+  residual = b - residual;
+  double norm_b = viennacl::linalg::norm_2(b);
+  double norm_residual = viennacl::linalg::norm_2(residual);
+  return (norm_b > 0) ? norm_residual / norm_b : norm_residual;
+}
+
+
+/** @brief Tests the pipelined CG solver with a compressed_matrix in main memory, with and without fusing each iteration into a single parallel region. */
+template<typename NumericT>
+int fused_cg_test(double tolerance)
+{
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  std::size_t N = 30 * 30;
+  viennacl::compressed_matrix<NumericT> vcl_laplace(N, N, host_ctx);
+  viennacl::copy(convection_diffusion_2d<NumericT>(30, 0), vcl_laplace);
+
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1), host_ctx);
+
+  for (int fused = 1; fused >= 0; --fused)
+  {
+    viennacl::linalg::host_based::set_fused_cg_iteration(fused != 0);
+
+    viennacl::linalg::cg_tag tag(tolerance, 1000);
+    viennacl::vector<NumericT> vcl_result = viennacl::linalg::solve(vcl_laplace, vcl_rhs, tag);
+    double residual = relative_residual(vcl_laplace, vcl_result, vcl_rhs);
+
+    std::cout << "  " << (fused ? "fused iteration:   " : "separate kernels:  ") << tag.iters() << " iterations, relative residual " << residual << std::endl;
+    if (residual > 10 * tolerance)
+    {
+      std::cout << "# Error at operation: pipelined CG with compressed_matrix" << (fused ? ", fused iteration" : ", separate kernels") << std::endl;
+      viennacl::linalg::host_based::set_fused_cg_iteration(true);
+      return EXIT_FAILURE;
+    }
+  }
+  viennacl::linalg::host_based::set_fused_cg_iteration(true);
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the pipelined CG solver with a symmetric_compressed_matrix, which only holds the upper triangle of the 2D Laplacian, against the solver run with the full compressed_matrix. */
+template<typename NumericT>
+int symmetric_cg_test(double tolerance)
+{
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  std::size_t N = 30 * 30;
+  std::vector<std::map<unsigned int, NumericT> > std_laplace = convection_diffusion_2d<NumericT>(30, 0);
+  viennacl::compressed_matrix<NumericT> vcl_laplace(N, N, host_ctx);
+  viennacl::copy(std_laplace, vcl_laplace);
+  viennacl::symmetric_compressed_matrix<NumericT> vcl_sym_laplace(N);
+  viennacl::copy(std_laplace, vcl_sym_laplace);
+
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1), host_ctx);
+
+  viennacl::linalg::cg_tag full_tag(tolerance, 1000);
+  viennacl::vector<NumericT> vcl_full_result = viennacl::linalg::solve(vcl_laplace, vcl_rhs, full_tag);
+
+  viennacl::linalg::cg_tag tag(tolerance, 1000);
+  viennacl::vector<NumericT> vcl_result = viennacl::linalg::solve(vcl_sym_laplace, vcl_rhs, tag);
+  double residual = relative_residual(vcl_laplace, vcl_result, vcl_rhs);
+
+  std::cout << "  symmetric_compressed_matrix: " << tag.iters() << " iterations (compressed_matrix: " << full_tag.iters() << "), relative residual " << residual << std::endl;
+  if (!(residual <= 10 * tolerance) || tag.iters() > full_tag.iters() + 1)
+  {
+    std::cout << "# Error at operation: pipelined CG with symmetric_compressed_matrix" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Solves with CG (solver 0), BiCGStab (solver 1), or GMRES (solver 2) and returns the number of iterations */
+template<typename MatrixT, typename NumericT>
+std::size_t solve_pipelined(MatrixT const & A, viennacl::vector<NumericT> const & rhs, viennacl::vector<NumericT> & result, int solver, double tolerance)
+{
+  if (solver == 0)
+  {
+    viennacl::linalg::cg_tag tag(tolerance, 1000);
+    viennacl::vector<NumericT> solution = viennacl::linalg::solve(A, rhs, tag);
+    result.fast_swap(solution);
+    return tag.iters();
+  }
+  if (solver == 1)
+  {
+    viennacl::linalg::bicgstab_tag tag(tolerance, 1000);
+    viennacl::vector<NumericT> solution = viennacl::linalg::solve(A, rhs, tag);
+    result.fast_swap(solution);
+    return tag.iters();
+  }
+  viennacl::linalg::gmres_tag tag(tolerance, 1000, 50);
+  viennacl::vector<NumericT> solution = viennacl::linalg::solve(A, rhs, tag);
+  result.fast_swap(solution);
+  return tag.iters();
+}
+
+/** @brief Tests the pipelined CG, BiCGStab, and GMRES solvers with a sliced_ell_matrix with sorted rows (sigma > 1), for which the fused kernels have to map the rows through the row permutation.
+  *
+  * The true residual is compared with the tolerance and with the residual of the same solver with the compressed_matrix, as the recursively updated residual of BiCGStab drifts from the true one.
+  */
+template<typename NumericT>
+int sliced_ell_solver_test(double tolerance)
+{
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  std::size_t N = 30 * 30;
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1), host_ctx);
+
+  for (int convection = 0; convection <= 1; ++convection)
+  {
+    std::vector<std::map<unsigned int, NumericT> > std_matrix = convection_diffusion_2d<NumericT>(30, convection ? NumericT(0.5) : NumericT(0));
+    viennacl::compressed_matrix<NumericT> vcl_compressed_matrix(N, N, host_ctx);
+    viennacl::copy(std_matrix, vcl_compressed_matrix);
+    viennacl::sliced_ell_matrix<NumericT> vcl_matrix(viennacl::sliced_ell_parameters(8, 64), host_ctx);
+    viennacl::copy(std_matrix, vcl_matrix);
+
+    for (int solver = convection; solver < 3; ++solver)   // CG for the symmetric matrix only
+    {
+      viennacl::vector<NumericT> vcl_reference(N, host_ctx);
+      solve_pipelined(vcl_compressed_matrix, vcl_rhs, vcl_reference, solver, tolerance);
+      double reference_residual = relative_residual(vcl_compressed_matrix, vcl_reference, vcl_rhs);
+
+      viennacl::vector<NumericT> vcl_result(N, host_ctx);
+      std::size_t iters = solve_pipelined(vcl_matrix, vcl_rhs, vcl_result, solver, tolerance);
+      double residual = relative_residual(vcl_compressed_matrix, vcl_result, vcl_rhs);
+
+      char const * solver_name = (solver == 0) ? "CG" : (solver == 1 ? "BiCGStab" : "GMRES");
+      std::cout << "  " << solver_name << (convection ? ", convection-diffusion: " : ", Laplace: ") << iters << " iterations, relative residual " << residual
+                << " (compressed_matrix: " << reference_residual << ")" << std::endl;
+      if (!(residual <= 10 * std::max(tolerance, reference_residual)))
+      {
+        std::cout << "# Error at operation: pipelined " << solver_name << " with sorted sliced_ell_matrix" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the s-step CG and GMRES solvers with both polynomial bases, including the fallback for ill-conditioned bases. */
+template<typename NumericT>
+int s_step_solver_test(double tolerance)
+{
+  std::size_t N = 30 * 30;
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1));
+
+  for (int convection = 0; convection <= 1; ++convection)
+  {
+    viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+    viennacl::copy(convection_diffusion_2d<NumericT>(30, convection ? NumericT(0.5) : NumericT(0)), vcl_matrix);
+
+    for (int basis = 0; basis <= 1; ++basis)
+    {
+      viennacl::linalg::s_step_basis_type basis_type = basis ? viennacl::linalg::S_STEP_BASIS_NEWTON : viennacl::linalg::S_STEP_BASIS_MONOMIAL;
+
+      if (!convection)
+      {
+        viennacl::linalg::s_step_cg_tag cg_tag(tolerance, 1000, 4, basis_type);
+        viennacl::vector<NumericT> vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, cg_tag);
+        double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+        std::cout << "  s-step CG, " << (basis ? "Newton basis:   " : "monomial basis: ") << cg_tag.iters() << " iterations, relative residual " << residual << std::endl;
+        if (residual > 10 * tolerance)
+        {
+          std::cout << "# Error at operation: s-step CG" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      viennacl::linalg::s_step_gmres_tag gmres_tag(tolerance, 1000, 32, 4, basis_type);
+      viennacl::vector<NumericT> vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, gmres_tag);
+      double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+      std::cout << "  s-step GMRES, " << (basis ? "Newton basis:   " : "monomial basis: ") << gmres_tag.iters() << " iterations, relative residual " << residual << std::endl;
+      if (residual > 10 * tolerance)
+      {
+        std::cout << "# Error at operation: s-step GMRES" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // a strict basis tolerance enforces the fallback to fewer Krylov vectors per block:
+    viennacl::linalg::s_step_gmres_tag gmres_tag(tolerance, 1000, 32, 8, viennacl::linalg::S_STEP_BASIS_MONOMIAL);
+    gmres_tag.basis_tolerance(0.1);
+    viennacl::vector<NumericT> vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, gmres_tag);
+    double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+    std::cout << "  s-step GMRES with basis fallback: " << gmres_tag.iters() << " iterations, " << gmres_tag.basis_fallbacks() << " fallbacks, relative residual " << residual << std::endl;
+    if (gmres_tag.basis_fallbacks() == 0 || residual > 10 * tolerance)
+    {
+      std::cout << "# Error at operation: s-step GMRES with basis fallback" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the block CG and block GMRES solvers for multiple right-hand sides, including a linearly dependent and a zero right-hand side. */
+template<typename NumericT>
+int block_solver_test(double tolerance)
+{
+  std::size_t N = 30 * 30;
+  std::size_t num_rhs = 5;
+
+  std::vector<std::vector<NumericT> > std_rhs(N, std::vector<NumericT>(num_rhs));
+  for (std::size_t i=0; i<N; ++i)
+  {
+    std_rhs[i][0] = NumericT(1);
+    std_rhs[i][1] = NumericT(i % 7);
+    std_rhs[i][2] = std_rhs[i][0] + std_rhs[i][1];
+    std_rhs[i][3] = NumericT(0);
+    std_rhs[i][4] = (i == N / 2) ? NumericT(1) : NumericT(0);
+  }
+  viennacl::matrix<NumericT> vcl_rhs(N, num_rhs);
+  viennacl::copy(std_rhs, vcl_rhs);
+
+  for (int convection = 0; convection <= 1; ++convection)
+  {
+    viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+    viennacl::copy(convection_diffusion_2d<NumericT>(30, convection ? NumericT(0.5) : NumericT(0)), vcl_matrix);
+
+    viennacl::matrix<NumericT, viennacl::column_major> vcl_result;
+    unsigned int iters = 0;
+    if (convection)
+    {
+      viennacl::linalg::block_gmres_tag gmres_tag(tolerance, 1000, 10);
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, gmres_tag);
+      iters = gmres_tag.iters();
+    }
+    else
+    {
+      viennacl::linalg::block_cg_tag cg_tag(tolerance, 1000);
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, cg_tag);
+      iters = cg_tag.iters();
+    }
+
+    std::cout << "  " << (convection ? "block GMRES: " : "block CG:    ") << iters << " iterations, relative residuals";
+    for (std::size_t k=0; k<num_rhs; ++k)
+    {
+      viennacl::vector<NumericT> vcl_result_k = viennacl::column(vcl_result, static_cast<unsigned int>(k));
+      viennacl::vector<NumericT> vcl_rhs_k    = viennacl::column(vcl_rhs, static_cast<unsigned int>(k));
+      double residual = relative_residual(vcl_matrix, vcl_result_k, vcl_rhs_k);
+      std::cout << " " << residual;
+
+      if (residual > 10 * tolerance)
+      {
+        std::cout << std::endl << "# Error at operation: " << (convection ? "block GMRES" : "block CG") << ", right-hand side " << k << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Regression test for the pipelined GMRES with a large Krylov dimension on several threads.
+  *
+  * The number of rows is not divisible by the number of threads, so the orthogonalization has to cover the remainder rows of each thread and the last vector entry.
+  * Otherwise the basis loses orthogonality and the solver stagnates.
+  */
+template<typename NumericT>
+int pipelined_gmres_test(double tolerance)
+{
+#ifdef VIENNACL_WITH_OPENMP
+  int old_num_threads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  std::size_t N = 31 * 31;
+  viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+  viennacl::copy(convection_diffusion_2d<NumericT>(31, NumericT(0.5)), vcl_matrix);
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1));
+
+  viennacl::linalg::gmres_tag tag(tolerance, 400, 200);
+  viennacl::vector<NumericT> vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag);
+  double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+#ifdef VIENNACL_WITH_OPENMP
+  omp_set_num_threads(old_num_threads);
+#endif
+
+  std::cout << "  GMRES(200): " << tag.iters() << " iterations, relative residual " << residual << std::endl;
+  if (!(residual <= 10 * tolerance) || tag.iters() >= tag.max_iterations())   // stagnation shows up as exhausting the iterations
+  {
+    std::cout << "# Error at operation: pipelined GMRES with large Krylov dimension" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the flexible GMRES solver without preconditioner and with an inner GMRES solve as variable preconditioner. */
+template<typename NumericT>
+int fgmres_test(double tolerance)
+{
+  std::size_t N = 30 * 30;
+  viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+  viennacl::copy(convection_diffusion_2d<NumericT>(30, NumericT(0.5)), vcl_matrix);
+
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1));
+
+  for (int preconditioned = 0; preconditioned <= 1; ++preconditioned)
+  {
+    viennacl::linalg::fgmres_tag tag(tolerance, 1000, 30);
+    viennacl::vector<NumericT> vcl_result(N);
+    if (preconditioned)
+    {
+      // inner GMRES with a loose tolerance, so that the number of inner iterations and hence the preconditioner varies from one application to the next:
+      viennacl::linalg::iterative_solver_precond<viennacl::compressed_matrix<NumericT>, viennacl::linalg::gmres_tag> inner_gmres(vcl_matrix, viennacl::linalg::gmres_tag(1e-2, 10, 10));
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag, inner_gmres);
+    }
+    else
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag);
+
+    double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+    std::cout << "  FGMRES, " << (preconditioned ? "inner GMRES preconditioner: " : "no preconditioner:          ") << tag.iters() << " iterations, relative residual " << residual << std::endl;
+    if (residual > 10 * tolerance)
+    {
+      std::cout << "# Error at operation: flexible GMRES" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests GCRO-DR on a sequence of slowly changing systems, where recycling the subspace of the first solve has to reduce the number of iterations of the later ones. */
+template<typename NumericT>
+int gcrodr_test(double tolerance)
+{
+  std::size_t N = 30 * 30;
+
+  viennacl::linalg::gcrodr_solver<viennacl::vector<NumericT> > solver(viennacl::linalg::gcrodr_tag(tolerance, 1000, 30, 10));
+  unsigned int first_iters = 0;
+  for (std::size_t system = 0; system < 3; ++system)
+  {
+    viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+    viennacl::copy(convection_diffusion_2d<NumericT>(30, NumericT(0.1), NumericT(0.001) * NumericT(system)), vcl_matrix);
+
+    std::vector<NumericT> std_rhs(N);
+    for (std::size_t row=0; row<N; ++row)
+      std_rhs[row] = NumericT(1) + NumericT(0.1) * NumericT(std::sin(double(row + system)));
+    viennacl::vector<NumericT> vcl_rhs(N);
+    viennacl::copy(std_rhs, vcl_rhs);
+
+    viennacl::vector<NumericT> vcl_result = solver(vcl_matrix, vcl_rhs);
+    double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+    std::cout << "  GCRO-DR, system " << system << ": " << solver.tag().iters() << " iterations, relative residual " << residual
+              << ", recycled vectors: " << solver.recycle_dim() << std::endl;
+    if (residual > 10 * tolerance)
+    {
+      std::cout << "# Error at operation: GCRO-DR" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (system == 0)
+      first_iters = solver.tag().iters();
+    else if (solver.tag().iters() >= first_iters)
+    {
+      std::cout << "# Error at operation: GCRO-DR, no reduction of iterations by recycling" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests IDR(s) on a convection-dominated system for several dimensions of the shadow space, without preconditioner and with ILU0. */
+template<typename NumericT>
+int idrs_test(double tolerance)
+{
+  std::size_t N = 30 * 30;
+  viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+  viennacl::copy(convection_diffusion_2d<NumericT>(30, NumericT(0.9)), vcl_matrix);
+
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1));
+  viennacl::linalg::ilu0_precond<viennacl::compressed_matrix<NumericT> > ilu0(vcl_matrix, viennacl::linalg::ilu0_tag());
+
+  for (std::size_t run = 0; run < 4; ++run)
+  {
+    std::size_t s = (run < 3) ? (std::size_t(1) << (2 * run)) : 4;   // s = 1, 4, 16 without and s = 4 with preconditioner
+    viennacl::linalg::idrs_tag tag(s, tolerance, 2000);
+    viennacl::vector<NumericT> vcl_result(N);
+    if (run < 3)
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag);
+    else
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag, ilu0);
+
+    double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+    std::cout << "  IDR(" << s << ")" << (run < 3 ? ": " : " ILU0: ") << tag.iters() << " matrix-vector products, relative residual " << residual << std::endl;
+    if (residual > 10 * tolerance)
+    {
+      std::cout << "# Error at operation: IDR(s)" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests MINRES on a symmetric indefinite system obtained by shifting the 2D Laplacian and scaling it symmetrically with a diagonal matrix with entries between 1 and 10.
+  *
+  * Without preconditioner, the scaling has to be resolved by the Krylov method. The Jacobi preconditioner is SPD because the diagonal stays positive and undoes the scaling, hence it has to reduce the number of iterations.
+  */
+template<typename NumericT>
+int minres_test(double tolerance)
+{
+  std::size_t N = 30 * 30;
+  std::vector<std::map<unsigned int, NumericT> > std_matrix = convection_diffusion_2d<NumericT>(30, 0, NumericT(-1));   // 73 of the 900 eigenvalues become negative
+  std::vector<NumericT> scaling(N);
+  for (std::size_t i=0; i<N; ++i)
+    scaling[i] = std::sqrt(NumericT(1) + NumericT(9) * NumericT((7 * i) % 13) / NumericT(12));
+  for (std::size_t i=0; i<N; ++i)
+    for (typename std::map<unsigned int, NumericT>::iterator it = std_matrix[i].begin(); it != std_matrix[i].end(); ++it)
+      it->second *= scaling[i] * scaling[it->first];
+
+  viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+  viennacl::copy(std_matrix, vcl_matrix);
+
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1));
+  viennacl::linalg::jacobi_precond<viennacl::compressed_matrix<NumericT> > jacobi(vcl_matrix, viennacl::linalg::jacobi_tag());
+
+  std::size_t unpreconditioned_iters = 0;
+  for (std::size_t run = 0; run < 2; ++run)
+  {
+    viennacl::linalg::minres_tag tag(tolerance, 5000);
+    viennacl::vector<NumericT> vcl_result(N);
+    if (run == 0)
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag);
+    else
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag, jacobi);
+
+    // the convergence criterion refers to the norm induced by the inverse of the preconditioner:
+    viennacl::vector<NumericT> vcl_residual = viennacl::linalg::prod(vcl_matrix, vcl_result);
+    vcl_residual = vcl_rhs - vcl_residual;
+    viennacl::vector<NumericT> vcl_precond_residual(vcl_residual);
+    viennacl::vector<NumericT> vcl_precond_rhs(vcl_rhs);
+    if (run == 1)
+    {
+      jacobi.apply(vcl_precond_residual);
+      jacobi.apply(vcl_precond_rhs);
+    }
+    double residual = std::sqrt(double(viennacl::linalg::inner_prod(vcl_residual, vcl_precond_residual)) / double(viennacl::linalg::inner_prod(vcl_rhs, vcl_precond_rhs)));
+
+    std::cout << "  MINRES" << (run == 0 ? ": " : ", Jacobi: ") << tag.iters() << " iterations, relative residual " << residual << std::endl;
+    if (!(residual <= tolerance))
+    {
+      std::cout << "# Error at operation: MINRES" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (run == 0)
+      unpreconditioned_iters = tag.iters();
+    else if (tag.iters() >= unpreconditioned_iters)
+    {
+      std::cout << "# Error at operation: MINRES, Jacobi preconditioner does not reduce the number of iterations" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the Chebyshev iteration on the 2D Laplacian with the exact eigenvalue bounds, with estimated bounds, and with estimated bounds for the ichol0-preconditioned operator. */
+template<typename NumericT>
+int chebyshev_test(double tolerance)
+{
+  std::size_t grid_size = 30;
+  std::size_t N = grid_size * grid_size;
+
+  viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+  viennacl::copy(convection_diffusion_2d<NumericT>(grid_size, 0), vcl_matrix);
+
+  viennacl::vector<NumericT> vcl_rhs = viennacl::scalar_vector<NumericT>(N, NumericT(1));
+  viennacl::linalg::ichol0_precond<viennacl::compressed_matrix<NumericT> > ichol0(vcl_matrix, viennacl::linalg::ichol0_tag());
+
+  double pi = 3.14159265358979323846;
+  double h = 1.0 / double(grid_size + 1);
+  for (std::size_t run = 0; run < 3; ++run)
+  {
+    viennacl::linalg::chebyshev_tag tag(tolerance, 2000);
+    viennacl::vector<NumericT> vcl_result(N);
+    if (run == 0)
+    {
+      tag.eigenvalue_bounds(8.0 * std::sin(pi * h / 2.0) * std::sin(pi * h / 2.0), 8.0 * std::cos(pi * h / 2.0) * std::cos(pi * h / 2.0));
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag);
+    }
+    else if (run == 1)
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag);
+    else
+      vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, tag, ichol0);
+
+    double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+    std::cout << "  Chebyshev, " << (run == 0 ? "exact bounds:    " : (run == 1 ? "estimated bounds: " : "ichol0, estimated bounds: "))
+              << tag.iters() << " iterations, bounds [" << tag.lambda_min() << ", " << tag.lambda_max() << "], relative residual " << residual << std::endl;
+    if (residual > 10 * tolerance)
+    {
+      std::cout << "# Error at operation: Chebyshev iteration" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests amg_precond::resetup() for new values with the same sparsity pattern and for a new sparsity pattern with the same number of nonzeros.
+  *
+  * In both cases the preconditioner has to match a fresh setup for the new matrix. The aggregation is randomized, hence the same seed is used for all setups.
+  */
+template<typename NumericT>
+int amg_resetup_test(double tolerance)
+{
+  std::size_t N = 30 * 30;
+  std::vector<std::map<unsigned int, NumericT> > std_laplace = convection_diffusion_2d<NumericT>(30, 0);
+
+  // symmetric permutation of the Laplacian, so that the sparsity pattern changes while the number of nonzeros stays the same:
+  std::vector<std::map<unsigned int, NumericT> > std_permuted(N);
+  for (std::size_t i=0; i<N; ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_laplace[i].begin(); it != std_laplace[i].end(); ++it)
+      std_permuted[(7 * i) % N][static_cast<unsigned int>((7 * it->first) % N)] = it->second;
+
+  viennacl::compressed_matrix<NumericT> vcl_laplace(N, N);
+  viennacl::copy(std_laplace, vcl_laplace);
+
+  std::vector<NumericT> std_rhs(N);
+  for (std::size_t i=0; i<N; ++i)
+    std_rhs[i] = NumericT(1) + NumericT(0.1) * NumericT(std::sin(double(i)));
+  viennacl::vector<NumericT> vcl_rhs(N);
+  viennacl::copy(std_rhs, vcl_rhs);
+
+  viennacl::linalg::amg_tag tag;
+  tag.set_interpolation_method(viennacl::linalg::AMG_INTERPOLATION_METHOD_SMOOTHED_AGGREGATION);
+
+  std::srand(42);
+  viennacl::linalg::amg_precond<viennacl::compressed_matrix<NumericT> > amg(vcl_laplace, tag);
+  amg.setup();
+
+  for (std::size_t run = 0; run < 2; ++run)
+  {
+    viennacl::compressed_matrix<NumericT> vcl_matrix(N, N);
+    if (run == 0)
+      viennacl::copy(convection_diffusion_2d<NumericT>(30, 0, NumericT(0.5)), vcl_matrix);
+    else
+      viennacl::copy(std_permuted, vcl_matrix);
+
+    std::srand(42);
+    amg.resetup(vcl_matrix);
+
+    std::srand(42);
+    viennacl::linalg::amg_precond<viennacl::compressed_matrix<NumericT> > fresh_amg(vcl_matrix, tag);
+    fresh_amg.setup();
+
+    viennacl::vector<NumericT> vcl_resetup_result = vcl_rhs;
+    amg.apply(vcl_resetup_result);
+    viennacl::vector<NumericT> vcl_fresh_result = vcl_rhs;
+    fresh_amg.apply(vcl_fresh_result);
+    double difference = viennacl::linalg::norm_2(vcl_resetup_result - vcl_fresh_result) / viennacl::linalg::norm_2(vcl_fresh_result);
+
+    // CG with both preconditioners. In single precision, the true residual may stagnate above the tolerance, hence it is compared with the one for the fresh setup:
+    viennacl::linalg::cg_tag cg_tag(tolerance, 1000);
+    viennacl::vector<NumericT> vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, cg_tag, amg);
+    double residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+    viennacl::linalg::cg_tag fresh_cg_tag(tolerance, 1000);
+    vcl_result = viennacl::linalg::solve(vcl_matrix, vcl_rhs, fresh_cg_tag, fresh_amg);
+    double fresh_residual = relative_residual(vcl_matrix, vcl_result, vcl_rhs);
+
+    std::cout << "  AMG resetup, " << (run == 0 ? "new values:  " : "new pattern: ") << "difference to fresh setup " << difference
+              << ", CG: " << cg_tag.iters() << " iterations, relative residual " << residual << " (fresh setup: " << fresh_residual << ")" << std::endl;
+    if (   !(difference <= 10 * tolerance)   // also catches NaN
+        || cg_tag.iters() != fresh_cg_tag.iters()
+        || !(residual <= std::max(10 * tolerance, 2 * fresh_residual)))
+    {
+      std::cout << "# Error at operation: AMG resetup, " << (run == 0 ? "new values" : "new sparsity pattern") << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+template<typename NumericT>
+int test(double tolerance)
+{
+  int retval = EXIT_SUCCESS;
+
+  std::cout << "Testing pipelined CG with compressed_matrix in main memory" << std::endl;
+  retval = fused_cg_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing pipelined CG with symmetric_compressed_matrix" << std::endl;
+  retval = symmetric_cg_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing pipelined solvers with sorted sliced_ell_matrix" << std::endl;
+  retval = sliced_ell_solver_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing s-step CG and GMRES" << std::endl;
+  retval = s_step_solver_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing block CG and block GMRES" << std::endl;
+  retval = block_solver_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing pipelined GMRES with large Krylov dimension" << std::endl;
+  retval = pipelined_gmres_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing flexible GMRES" << std::endl;
+  retval = fgmres_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing GCRO-DR with Krylov subspace recycling" << std::endl;
+  retval = gcrodr_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing IDR(s)" << std::endl;
+  retval = idrs_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing MINRES" << std::endl;
+  // the recursively updated residual of MINRES drifts from the true residual by about 1e-5 in single precision:
+  retval = minres_test<NumericT>((sizeof(NumericT) > sizeof(float)) ? tolerance : 1e-3);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing Chebyshev iteration" << std::endl;
+  // the attainable accuracy in single precision is about eps * cond(A):
+  retval = chebyshev_test<NumericT>((sizeof(NumericT) > sizeof(float)) ? tolerance : 1e-4);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing re-setup of the AMG preconditioner" << std::endl;
+  retval = amg_resetup_test<NumericT>(tolerance);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  return retval;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Iterative Solvers" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  int retval = EXIT_SUCCESS;
+
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+  {
+    typedef float NumericT;
+    double tolerance = 1e-5;
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  tolerance: " << tolerance << std::endl;
+    std::cout << "  numeric:   float" << std::endl;
+    retval = test<NumericT>(tolerance);
+    if ( retval == EXIT_SUCCESS )
+        std::cout << "# Test passed" << std::endl;
+    else
+        return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  {
+    typedef double NumericT;
+    double tolerance = 1e-10;
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  tolerance: " << tolerance << std::endl;
+    std::cout << "  numeric:   double" << std::endl;
+    retval = test<NumericT>(tolerance);
+    if ( retval == EXIT_SUCCESS )
+      std::cout << "# Test passed" << std::endl;
+    else
+      return retval;
+  }
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return retval;
+}
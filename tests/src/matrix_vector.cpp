@@ -37,6 +37,7 @@
 #include "viennacl/linalg/norm_2.hpp"
 #include "viennacl/linalg/direct_solve.hpp"
 #include "viennacl/linalg/lu.hpp"
+#include "viennacl/linalg/cholesky.hpp"
 #include "viennacl/linalg/sum.hpp"
 #include "viennacl/tools/random.hpp"
 
@@ -1244,6 +1245,111 @@ int test(Epsilon const& epsilon)
    }
 
 
+   ////////////// LU decomposition with partial pivoting (several panels, small diagonal entries enforce row interchanges):
+
+   std::cout << "Full solver with partial pivoting" << std::endl;
+   unsigned int pivot_dim = 300;
+   std::vector<std::vector<NumericT> > pivot_matrix(pivot_dim, std::vector<NumericT>(pivot_dim));
+   std::vector<NumericT> pivot_rhs(pivot_dim);
+   std::vector<NumericT> pivot_result(pivot_dim);
+   viennacl::matrix<NumericT, F> vcl_pivot_matrix(pivot_dim, pivot_dim);
+   viennacl::vector<NumericT> vcl_pivot_rhs(pivot_dim);
+   viennacl::matrix<NumericT, F> vcl_pivot_rhs_matrix(pivot_dim, 2);
+
+   for (std::size_t i=0; i<pivot_dim; ++i)
+     for (std::size_t j=0; j<pivot_dim; ++j)
+       pivot_matrix[i][j] = randomNumber() - static_cast<NumericT>(0.5);
+
+   for (std::size_t j=0; j<pivot_dim; ++j)
+   {
+     pivot_matrix[j][j] *= static_cast<NumericT>(0.001);
+     pivot_matrix[j][(j + pivot_dim / 2) % pivot_dim] = static_cast<NumericT>(5.0) + randomNumber();
+     pivot_result[j] = NumericT(0.1) + randomNumber();
+   }
+
+   for (std::size_t i=0; i<pivot_dim; ++i)
+     for (std::size_t j=0; j<pivot_dim; ++j)
+       pivot_rhs[i] += pivot_matrix[i][j] * pivot_result[j];
+
+   std::vector<std::vector<NumericT> > pivot_rhs_matrix(pivot_dim, std::vector<NumericT>(2));
+   for (std::size_t i=0; i<pivot_dim; ++i)
+     pivot_rhs_matrix[i][0] = pivot_rhs_matrix[i][1] = pivot_rhs[i];
+
+   viennacl::copy(pivot_matrix, vcl_pivot_matrix);
+   viennacl::copy(pivot_rhs, vcl_pivot_rhs);
+   viennacl::copy(pivot_rhs_matrix, vcl_pivot_rhs_matrix);
+
+   // ViennaCL:
+   std::vector<viennacl::vcl_size_t> pivots;
+   viennacl::linalg::lu_factorize(vcl_pivot_matrix, pivots);
+   viennacl::linalg::lu_substitute(vcl_pivot_matrix, pivots, vcl_pivot_rhs);
+   viennacl::linalg::lu_substitute(vcl_pivot_matrix, pivots, vcl_pivot_rhs_matrix);
+
+   if ( std::fabs(diff(pivot_result, vcl_pivot_rhs)) > epsilon )
+   {
+      std::cout << "# Error at operation: dense solver with partial pivoting" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(pivot_result, vcl_pivot_rhs)) << std::endl;
+      retval = EXIT_FAILURE;
+   }
+
+   vcl_pivot_rhs = viennacl::column(vcl_pivot_rhs_matrix, 1);
+   if ( std::fabs(diff(pivot_result, vcl_pivot_rhs)) > epsilon )
+   {
+      std::cout << "# Error at operation: dense solver with partial pivoting (matrix of load vectors)" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(pivot_result, vcl_pivot_rhs)) << std::endl;
+      retval = EXIT_FAILURE;
+   }
+
+
+   ////////////// Cholesky decomposition (several block columns):
+
+   std::cout << "Cholesky solver" << std::endl;
+   std::vector<std::vector<NumericT> > spd_matrix(pivot_dim, std::vector<NumericT>(pivot_dim));
+   std::vector<NumericT> spd_rhs(pivot_dim);
+   viennacl::matrix<NumericT, F> vcl_spd_matrix(pivot_dim, pivot_dim);
+
+   for (std::size_t i=0; i<pivot_dim; ++i)
+   {
+     for (std::size_t j=0; j<i; ++j)
+       spd_matrix[i][j] = spd_matrix[j][i] = randomNumber() - static_cast<NumericT>(0.5);
+     spd_matrix[i][i] = static_cast<NumericT>(pivot_dim) + randomNumber();  // diagonally dominant, hence positive definite
+   }
+
+   for (std::size_t i=0; i<pivot_dim; ++i)
+     for (std::size_t j=0; j<pivot_dim; ++j)
+       spd_rhs[i] += spd_matrix[i][j] * pivot_result[j];
+
+   viennacl::copy(spd_matrix, vcl_spd_matrix);
+   viennacl::copy(spd_rhs, vcl_pivot_rhs);
+
+   viennacl::linalg::cholesky_factorize(vcl_spd_matrix);
+   viennacl::linalg::cholesky_substitute(vcl_spd_matrix, vcl_pivot_rhs);
+
+   if ( std::fabs(diff(pivot_result, vcl_pivot_rhs)) > epsilon )
+   {
+      std::cout << "# Error at operation: Cholesky solver" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(pivot_result, vcl_pivot_rhs)) << std::endl;
+      retval = EXIT_FAILURE;
+   }
+
+   // matrix with negative eigenvalue must be rejected:
+   spd_matrix[pivot_dim / 2][pivot_dim / 2] = -static_cast<NumericT>(1.0);
+   viennacl::copy(spd_matrix, vcl_spd_matrix);
+   try
+   {
+     viennacl::linalg::cholesky_factorize(vcl_spd_matrix);
+     std::cout << "# Error at operation: Cholesky factorization of indefinite matrix did not fail" << std::endl;
+     retval = EXIT_FAILURE;
+   }
+   catch (viennacl::linalg::not_positive_definite_exception const & e)
+   {
+     if (e.index() != pivot_dim / 2)
+     {
+       std::cout << "# Error at operation: Cholesky factorization of indefinite matrix failed at wrong index " << e.index() << std::endl;
+       retval = EXIT_FAILURE;
+     }
+   }
+
 
    return retval;
 }
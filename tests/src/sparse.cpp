@@ -28,6 +28,7 @@
 #include <vector>
 #include <map>
 #include <cmath>
+#include <limits>
 
 //
 // *** ViennaCL
@@ -39,12 +40,22 @@
 #include "viennacl/ell_matrix.hpp"
 #include "viennacl/sliced_ell_matrix.hpp"
 #include "viennacl/hyb_matrix.hpp"
+#include "viennacl/bsr_matrix.hpp"
+#include "viennacl/symmetric_compressed_matrix.hpp"
+#include "viennacl/delta_compressed_matrix.hpp"
+#include "viennacl/auto_sparse_matrix.hpp"
+#include "viennacl/misc/sliced_ell_tuning.hpp"
 #include "viennacl/vector.hpp"
 #include "viennacl/vector_proxy.hpp"
 #include "viennacl/linalg/prod.hpp"
 #include "viennacl/linalg/norm_2.hpp"
 #include "viennacl/linalg/ilu.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
 #include "viennacl/linalg/detail/ilu/common.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_factor.hpp"
 #include "viennacl/io/matrix_market.hpp"
 #include "viennacl/tools/random.hpp"
 
@@ -209,6 +220,720 @@ int strided_matrix_vector_product_test(Epsilon epsilon,
 }
 
 
+/** @brief Compares the row-wise and the merge-path kernels of the host backend for a compressed_matrix with a few dense rows and some empty rows.
+  *
+  * The merge path is also split into a fixed number of pieces, so that the fix-up of rows shared by several pieces is tested irrespective of the number of threads.
+  */
+template<typename NumericT, typename Epsilon>
+int merge_path_spmv_test(Epsilon epsilon)
+{
+  std::size_t N = 1000;
+  std::vector<std::map<unsigned int, NumericT> > std_A(N);
+  for (std::size_t i=0; i<N; ++i)
+  {
+    if (i % 101 == 0)
+      for (std::size_t j=0; j<N; j += 2)
+        std_A[i][static_cast<unsigned int>(j)] = NumericT(1) / NumericT(j + 1);
+    else if (i % 7 != 0)
+    {
+      std_A[i][static_cast<unsigned int>(i)] = NumericT(2);
+      std_A[i][static_cast<unsigned int>((i * 13) % N)] += NumericT(-1);
+    }
+  }
+
+  std::vector<NumericT> x(N), y(N), result(N);
+  for (std::size_t i=0; i<N; ++i)
+  {
+    x[i] = NumericT(1) + NumericT(i % 5) / NumericT(5);
+    y[i] = NumericT(i % 3);
+  }
+
+  viennacl::compressed_matrix<NumericT> vcl_A;
+  viennacl::copy(std_A, vcl_A);
+  viennacl::vector<NumericT> vcl_x(N), vcl_y(N);
+  viennacl::copy(x, vcl_x);
+
+  viennacl::linalg::host_based::csr_spmv_kernel_type kernels[] = { viennacl::linalg::host_based::CSR_SPMV_KERNEL_ROW,
+                                                                   viennacl::linalg::host_based::CSR_SPMV_KERNEL_MERGE_PATH,
+                                                                   viennacl::linalg::host_based::CSR_SPMV_KERNEL_MERGE_PATH,
+                                                                   viennacl::linalg::host_based::CSR_SPMV_KERNEL_MERGE_PATH };
+  std::size_t merge_path_parts[] = { 0, 0, 7, 64 };   // with 64 pieces, each dense row is shared by several pieces
+  int retval = EXIT_SUCCESS;
+  for (std::size_t k=0; k<4 && retval == EXIT_SUCCESS; ++k)
+  {
+    viennacl::linalg::host_based::set_csr_spmv_kernel(kernels[k]);
+    viennacl::linalg::host_based::set_csr_spmv_merge_path_parts(merge_path_parts[k]);
+
+    // y = A * x
+    result = viennacl::linalg::prod(std_A, x);
+    vcl_y = viennacl::linalg::prod(vcl_A, vcl_x);
+    if ( std::fabs(diff(result, vcl_y)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with irregular compressed_matrix, kernel " << k << " (=)" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_y)) << std::endl;
+      retval = EXIT_FAILURE;
+    }
+
+    // y += A * x
+    for (std::size_t i=0; i<N; ++i) result[i] += y[i];
+    viennacl::copy(y, vcl_y);
+    vcl_y += viennacl::linalg::prod(vcl_A, vcl_x);
+    if ( std::fabs(diff(result, vcl_y)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with irregular compressed_matrix, kernel " << k << " (+=)" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_y)) << std::endl;
+      retval = EXIT_FAILURE;
+    }
+  }
+
+  viennacl::linalg::host_based::set_csr_spmv_kernel(viennacl::linalg::host_based::CSR_SPMV_KERNEL_AUTO);
+  viennacl::linalg::host_based::set_csr_spmv_merge_path_parts(0);
+  return retval;
+}
+
+
+/** @brief Tests the products of a bsr_matrix obtained from a compressed_matrix. The bsr_matrix resides in main memory, so the vectors are created in main memory as well. */
+template<typename NumericT, unsigned int BlockSize, typename Epsilon>
+int bsr_matrix_test(Epsilon epsilon, std::vector<std::map<unsigned int, NumericT> > const & std_matrix, std::vector<NumericT> const & rhs)
+{
+  std::size_t N = std_matrix.size();
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  viennacl::compressed_matrix<NumericT> vcl_compressed_matrix(N, N, host_ctx);
+  viennacl::copy(std_matrix, vcl_compressed_matrix);
+
+  viennacl::bsr_matrix<NumericT, BlockSize> vcl_bsr_matrix;
+  viennacl::copy(vcl_compressed_matrix, vcl_bsr_matrix);
+
+  std::vector<NumericT> result(N);
+  viennacl::vector<NumericT> vcl_rhs(N, host_ctx), vcl_result(N, host_ctx);
+  viennacl::copy(rhs, vcl_rhs);
+
+  // y = A * x
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  vcl_result = viennacl::linalg::prod(vcl_bsr_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with bsr_matrix, block size " << BlockSize << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y += A * x
+  for (std::size_t i=0; i<N; ++i) result[i] += rhs[i];
+  vcl_result = vcl_rhs;
+  vcl_result += viennacl::linalg::prod(vcl_bsr_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with bsr_matrix, block size " << BlockSize << " (+=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y -= A * x
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  for (std::size_t i=0; i<N; ++i) result[i] = rhs[i] - result[i];
+  vcl_result = vcl_rhs;
+  vcl_result -= viennacl::linalg::prod(vcl_bsr_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with bsr_matrix, block size " << BlockSize << " (-=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y += trans(A) * x (the threads of the host backend sum up partial results in a different order, hence avoid entries close to zero)
+  std::vector<std::map<unsigned int, NumericT> > std_matrix_trans(N);
+  for (std::size_t i=0; i<N; ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_matrix[i].begin(); it != std_matrix[i].end(); ++it)
+      std_matrix_trans[it->first][static_cast<unsigned int>(i)] = it->second;
+  result = viennacl::linalg::prod(std_matrix_trans, rhs);
+  for (std::size_t i=0; i<N; ++i) result[i] += rhs[i];
+  vcl_result = vcl_rhs;
+  vcl_result += viennacl::linalg::prod(trans(vcl_bsr_matrix), vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: transposed matrix-vector product with bsr_matrix, block size " << BlockSize << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // iterative solvers with Jacobi and ILU0 preconditioners set up from a bsr_matrix. The matrix above is indefinite, hence use a 2D Laplacian with a variable diagonal:
+  {
+    std::size_t grid_size = 40;
+    std::size_t laplace_N = grid_size * grid_size;
+    std::vector<std::map<unsigned int, NumericT> > std_laplace(laplace_N);
+    for (std::size_t i=0; i<grid_size; ++i)
+      for (std::size_t j=0; j<grid_size; ++j)
+      {
+        unsigned int row = static_cast<unsigned int>(i * grid_size + j);
+        std_laplace[row][row] = NumericT(4) + NumericT(row % 5);
+        if (i > 0)             std_laplace[row][row - static_cast<unsigned int>(grid_size)] = NumericT(-1);
+        if (i < grid_size - 1) std_laplace[row][row + static_cast<unsigned int>(grid_size)] = NumericT(-1);
+        if (j > 0)             std_laplace[row][row - 1] = NumericT(-1);
+        if (j < grid_size - 1) std_laplace[row][row + 1] = NumericT(-1);
+      }
+    viennacl::compressed_matrix<NumericT> vcl_laplace(laplace_N, laplace_N, host_ctx);
+    viennacl::copy(std_laplace, vcl_laplace);
+    viennacl::bsr_matrix<NumericT, BlockSize> vcl_bsr_laplace;
+    viennacl::copy(vcl_laplace, vcl_bsr_laplace);
+
+    viennacl::vector<NumericT> vcl_laplace_rhs = viennacl::scalar_vector<NumericT>(laplace_N, NumericT(1), host_ctx);
+    viennacl::vector<NumericT> vcl_laplace_result(laplace_N, host_ctx);
+    double solver_tolerance = (sizeof(NumericT) > sizeof(float)) ? 1e-10 : 1e-5;
+    viennacl::linalg::jacobi_precond<viennacl::bsr_matrix<NumericT, BlockSize> > bsr_jacobi(vcl_bsr_laplace, viennacl::linalg::jacobi_tag());
+    viennacl::linalg::ilu0_precond<viennacl::bsr_matrix<NumericT, BlockSize> >   bsr_ilu0(vcl_bsr_laplace, viennacl::linalg::ilu0_tag());
+    for (std::size_t run = 0; run < 4; ++run)
+    {
+      if (run == 0)
+        vcl_laplace_result = viennacl::linalg::solve(vcl_bsr_laplace, vcl_laplace_rhs, viennacl::linalg::cg_tag(solver_tolerance, 1000), bsr_jacobi);
+      else if (run == 1)
+        vcl_laplace_result = viennacl::linalg::solve(vcl_bsr_laplace, vcl_laplace_rhs, viennacl::linalg::cg_tag(solver_tolerance, 1000), bsr_ilu0);
+      else if (run == 2)
+        vcl_laplace_result = viennacl::linalg::solve(vcl_bsr_laplace, vcl_laplace_rhs, viennacl::linalg::bicgstab_tag(solver_tolerance, 1000), bsr_ilu0);
+      else
+        vcl_laplace_result = viennacl::linalg::solve(vcl_bsr_laplace, vcl_laplace_rhs, viennacl::linalg::gmres_tag(solver_tolerance, 1000, 30), bsr_jacobi);
+
+      viennacl::vector<NumericT> vcl_residual = viennacl::linalg::prod(vcl_laplace, vcl_laplace_result);
+      vcl_residual = vcl_laplace_rhs - vcl_residual;
+      double relative_residual = viennacl::linalg::norm_2(vcl_residual) / viennacl::linalg::norm_2(vcl_laplace_rhs);
+      if (relative_residual > 10 * solver_tolerance)
+      {
+        std::cout << "# Error at operation: " << (run == 0 ? "CG with Jacobi" : (run == 1 ? "CG with ILU0" : (run == 2 ? "BiCGStab with ILU0" : "GMRES with Jacobi")))
+                  << " preconditioner on bsr_matrix, block size " << BlockSize << std::endl;
+        std::cout << "  relative residual: " << relative_residual << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // conversion back to compressed_matrix:
+  viennacl::compressed_matrix<NumericT> vcl_compressed_matrix2(N, N, host_ctx);
+  viennacl::copy(vcl_bsr_matrix, vcl_compressed_matrix2);
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  vcl_result = viennacl::linalg::prod(vcl_compressed_matrix2, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with compressed_matrix obtained from bsr_matrix, block size " << BlockSize << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the products of a symmetric_compressed_matrix obtained from the symmetric part A + A^T of the supplied matrix. The matrix resides in main memory, so the vectors are created in main memory as well. */
+template<typename NumericT, typename Epsilon>
+int symmetric_compressed_matrix_test(Epsilon epsilon, std::vector<std::map<unsigned int, NumericT> > const & std_matrix, std::vector<NumericT> const & rhs)
+{
+  std::size_t N = std_matrix.size();
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  std::vector<std::map<unsigned int, NumericT> > std_sym_matrix(N);
+  for (std::size_t i=0; i<N; ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_matrix[i].begin(); it != std_matrix[i].end(); ++it)
+    {
+      std_sym_matrix[i][it->first] += it->second;
+      std_sym_matrix[it->first][static_cast<unsigned int>(i)] += it->second;
+    }
+
+  viennacl::compressed_matrix<NumericT> vcl_compressed_matrix(N, N, host_ctx);
+  viennacl::copy(std_sym_matrix, vcl_compressed_matrix);
+
+  viennacl::symmetric_compressed_matrix<NumericT> vcl_sym_matrix;
+  viennacl::copy(vcl_compressed_matrix, vcl_sym_matrix);
+
+  std::vector<NumericT> result(N);
+  viennacl::vector<NumericT> vcl_rhs(N, host_ctx), vcl_result(N, host_ctx);
+  viennacl::copy(rhs, vcl_rhs);
+
+  // The threads of the host backend sum up partial results in a different order, hence avoid entries close to zero by adding x:
+
+  // y = A * x
+  result = viennacl::linalg::prod(std_sym_matrix, rhs);
+  for (std::size_t i=0; i<N; ++i) result[i] += rhs[i];
+  vcl_result = viennacl::linalg::prod(vcl_sym_matrix, vcl_rhs);
+  vcl_result += vcl_rhs;
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with symmetric_compressed_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y += A * x
+  vcl_result = vcl_rhs;
+  vcl_result += viennacl::linalg::prod(vcl_sym_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with symmetric_compressed_matrix (+=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // x += A * x
+  vcl_result = vcl_rhs;
+  vcl_result += viennacl::linalg::prod(vcl_sym_matrix, vcl_result);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with symmetric_compressed_matrix (x += A * x)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y -= A * x
+  result = viennacl::linalg::prod(std_sym_matrix, rhs);
+  for (std::size_t i=0; i<N; ++i) result[i] = rhs[i] - result[i];
+  vcl_result = vcl_rhs;
+  vcl_result -= viennacl::linalg::prod(vcl_sym_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with symmetric_compressed_matrix (-=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y -= trans(A) * x
+  vcl_result = vcl_rhs;
+  vcl_result -= viennacl::linalg::prod(trans(vcl_sym_matrix), vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: transposed matrix-vector product with symmetric_compressed_matrix (-=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y = A * x for a matrix without entries must not read the old contents of y:
+  viennacl::symmetric_compressed_matrix<NumericT> vcl_empty_matrix(N);
+  vcl_result = viennacl::scalar_vector<NumericT>(N, std::numeric_limits<NumericT>::quiet_NaN(), host_ctx);
+  vcl_result = viennacl::linalg::prod(vcl_empty_matrix, vcl_rhs);
+  if ( !(viennacl::linalg::norm_2(vcl_result) <= 0) )
+  {
+    std::cout << "# Error at operation: matrix-vector product with empty symmetric_compressed_matrix" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // conversion back to compressed_matrix:
+  viennacl::compressed_matrix<NumericT> vcl_compressed_matrix2(N, N, host_ctx);
+  viennacl::copy(vcl_sym_matrix, vcl_compressed_matrix2);
+  result = viennacl::linalg::prod(std_sym_matrix, rhs);
+  vcl_result = viennacl::linalg::prod(vcl_compressed_matrix2, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with compressed_matrix obtained from symmetric_compressed_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the products of a delta_compressed_matrix with 16-bit and 8-bit column offsets. For 8-bit offsets, the rows with a column range of more than 255 fall back to full column indices. */
+template<typename NumericT, typename Epsilon>
+int delta_compressed_matrix_test(Epsilon epsilon, std::vector<std::map<unsigned int, NumericT> > const & std_matrix, std::vector<NumericT> const & rhs)
+{
+  std::size_t N = std_matrix.size();
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  viennacl::compressed_matrix<NumericT> vcl_compressed_matrix(N, N, host_ctx);
+  viennacl::copy(std_matrix, vcl_compressed_matrix);
+
+  viennacl::delta_compressed_matrix<NumericT> vcl_delta_matrix;
+  viennacl::copy(vcl_compressed_matrix, vcl_delta_matrix);
+
+  viennacl::delta_compressed_matrix<NumericT, unsigned char> vcl_delta8_matrix(N, N);
+  viennacl::copy(std_matrix, vcl_delta8_matrix);
+
+  std::cout << "  16-bit offsets: " << vcl_delta_matrix.wide_rows() << " rows with full column indices, " << vcl_delta_matrix.index_bytes() << " bytes of index data" << std::endl;
+  std::cout << "  8-bit offsets:  " << vcl_delta8_matrix.wide_rows() << " rows with full column indices, " << vcl_delta8_matrix.index_bytes() << " bytes of index data" << std::endl;
+
+  std::size_t csr_index_bytes = sizeof(unsigned int) * (N + 1 + vcl_compressed_matrix.nnz());
+  if (vcl_delta_matrix.nnz() != vcl_compressed_matrix.nnz() || vcl_delta_matrix.wide_rows() > 0 || vcl_delta_matrix.index_bytes() >= csr_index_bytes
+      || vcl_delta8_matrix.index_bytes() > csr_index_bytes)
+  {
+    std::cout << "# Error at operation: index compression of delta_compressed_matrix" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // 8-bit offsets for a 2D stencil on a grid wider than 256 (all rows wide), and for the same stencil with the coupling in the second direction in every third row only (mixed rows).
+  // The index memory must not exceed the one of compressed_matrix:
+  for (std::size_t variant = 0; variant < 2; ++variant)
+  {
+    bool mixed = (variant == 1);
+    std::size_t grid_size = 300;
+    std::size_t stencil_N = grid_size * 20;
+    std::vector<std::map<unsigned int, NumericT> > std_stencil(stencil_N);
+    std::vector<NumericT> stencil_rhs(stencil_N);
+    for (std::size_t row = 0; row < stencil_N; ++row)
+    {
+      unsigned int r = static_cast<unsigned int>(row);
+      std_stencil[row][r] = NumericT(4);
+      if (row >= grid_size && (row % 3 == 0 || !mixed))            std_stencil[row][r - static_cast<unsigned int>(grid_size)] = NumericT(-1);
+      if (row + grid_size < stencil_N && (row % 3 == 0 || !mixed)) std_stencil[row][r + static_cast<unsigned int>(grid_size)] = NumericT(-1);
+      if (row > 0)                     std_stencil[row][r - 1] = NumericT(-1);
+      if (row + 1 < stencil_N)         std_stencil[row][r + 1] = NumericT(-1);
+      stencil_rhs[row] = NumericT(1) + NumericT(row % 7);
+    }
+    viennacl::delta_compressed_matrix<NumericT, unsigned char> vcl_stencil8(stencil_N, stencil_N);
+    viennacl::copy(std_stencil, vcl_stencil8);
+    std::size_t stencil_nnz = 0;
+    for (std::size_t row = 0; row < stencil_N; ++row)
+      stencil_nnz += std_stencil[row].size();
+
+    std::cout << "  8-bit offsets, " << (mixed ? "mixed rows: " : "wide rows: ") << vcl_stencil8.wide_rows() << " of " << stencil_N << " rows with full column indices, "
+              << vcl_stencil8.index_bytes() << " bytes of index data" << std::endl;
+    if (vcl_stencil8.index_bytes() > sizeof(unsigned int) * (stencil_N + 1 + stencil_nnz) || vcl_stencil8.plain_csr() == mixed)
+    {
+      std::cout << "# Error at operation: index compression of delta_compressed_matrix, wide rows" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::vector<NumericT> stencil_result = viennacl::linalg::prod(std_stencil, stencil_rhs);
+    viennacl::vector<NumericT> vcl_stencil_rhs(stencil_N, host_ctx), vcl_stencil_result(stencil_N, host_ctx);
+    viennacl::copy(stencil_rhs, vcl_stencil_rhs);
+    vcl_stencil_result = viennacl::linalg::prod(vcl_stencil8, vcl_stencil_rhs);
+    if ( std::fabs(diff(stencil_result, vcl_stencil_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with delta_compressed_matrix, wide rows" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(stencil_result, vcl_stencil_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<NumericT> result(N);
+  viennacl::vector<NumericT> vcl_rhs(N, host_ctx), vcl_result(N, host_ctx);
+  viennacl::copy(rhs, vcl_rhs);
+
+  // y = A * x
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  vcl_result = viennacl::linalg::prod(vcl_delta_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with delta_compressed_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vcl_result = viennacl::linalg::prod(vcl_delta8_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with delta_compressed_matrix, 8-bit offsets" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y += A * x
+  for (std::size_t i=0; i<N; ++i) result[i] += rhs[i];
+  vcl_result = vcl_rhs;
+  vcl_result += viennacl::linalg::prod(vcl_delta_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with delta_compressed_matrix (+=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // x += A * x
+  vcl_result = vcl_rhs;
+  vcl_result += viennacl::linalg::prod(vcl_delta8_matrix, vcl_result);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with delta_compressed_matrix (x += A * x)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y -= A * x
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  for (std::size_t i=0; i<N; ++i) result[i] = rhs[i] - result[i];
+  vcl_result = vcl_rhs;
+  vcl_result -= viennacl::linalg::prod(vcl_delta_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with delta_compressed_matrix (-=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y = A * x for a matrix without entries must not read the old contents of y:
+  viennacl::delta_compressed_matrix<NumericT> vcl_empty_matrix(N, N);
+  vcl_result = viennacl::scalar_vector<NumericT>(N, std::numeric_limits<NumericT>::quiet_NaN(), host_ctx);
+  vcl_result = viennacl::linalg::prod(vcl_empty_matrix, vcl_rhs);
+  if ( !(viennacl::linalg::norm_2(vcl_result) <= 0) )
+  {
+    std::cout << "# Error at operation: matrix-vector product with empty delta_compressed_matrix" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the products of compressed_matrix, ell_matrix, and sliced_ell_matrix holding single precision entries with double precision vectors, and the solution with CG and GMRES. The matrices reside in main memory. */
+template<typename NumericT, typename Epsilon>
+int mixed_precision_test(Epsilon epsilon, std::vector<std::map<unsigned int, NumericT> > const & std_matrix, std::vector<NumericT> const & rhs)
+{
+  std::size_t N = std_matrix.size();
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  // reference: entries rounded to single precision, product in double precision
+  std::vector<std::map<unsigned int, float> >  std_float_matrix(N);
+  std::vector<std::map<unsigned int, double> > std_rounded_matrix(N);
+  for (std::size_t i=0; i<N; ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_matrix[i].begin(); it != std_matrix[i].end(); ++it)
+    {
+      std_float_matrix[i][it->first]   = static_cast<float>(it->second);
+      std_rounded_matrix[i][it->first] = static_cast<double>(static_cast<float>(it->second));
+    }
+
+  std::vector<double> std_rhs(rhs.begin(), rhs.end());
+  std::vector<double> result = viennacl::linalg::prod(std_rounded_matrix, std_rhs);
+
+  viennacl::compressed_matrix<float> vcl_compressed_matrix(N, N, host_ctx);
+  viennacl::ell_matrix<float>        vcl_ell_matrix(host_ctx);
+  viennacl::sliced_ell_matrix<float> vcl_sliced_ell_matrix(viennacl::sliced_ell_parameters(32, 256), host_ctx);
+  viennacl::copy(std_float_matrix, vcl_compressed_matrix);
+  viennacl::copy(std_float_matrix, vcl_ell_matrix);
+  viennacl::copy(std_float_matrix, vcl_sliced_ell_matrix);
+
+  viennacl::vector<double> vcl_rhs(N, host_ctx), vcl_result(N, host_ctx);
+  viennacl::copy(std_rhs, vcl_rhs);
+
+  vcl_result = viennacl::linalg::prod(vcl_compressed_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: mixed precision matrix-vector product with compressed_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vcl_result = viennacl::linalg::prod(vcl_ell_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: mixed precision matrix-vector product with ell_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vcl_result = viennacl::linalg::prod(vcl_sliced_ell_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: mixed precision matrix-vector product with sliced_ell_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y -= A * x
+  for (std::size_t i=0; i<N; ++i) result[i] = std_rhs[i] - result[i];
+  vcl_result = vcl_rhs;
+  vcl_result -= viennacl::linalg::prod(vcl_compressed_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: mixed precision matrix-vector product with compressed_matrix (-=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // iterative solvers on the 1D Laplace operator, which is represented exactly in single precision:
+  std::size_t N_solver = 200;
+  std::vector<std::map<unsigned int, float> > std_laplace(N_solver);
+  for (std::size_t i=0; i<N_solver; ++i)
+  {
+    std_laplace[i][static_cast<unsigned int>(i)] = 2.0f;
+    if (i > 0)
+      std_laplace[i][static_cast<unsigned int>(i-1)] = -1.0f;
+    if (i < N_solver - 1)
+      std_laplace[i][static_cast<unsigned int>(i+1)] = -1.0f;
+  }
+  viennacl::compressed_matrix<float> vcl_laplace(N_solver, N_solver, host_ctx);
+  viennacl::copy(std_laplace, vcl_laplace);
+
+  viennacl::vector<double> vcl_laplace_rhs = viennacl::scalar_vector<double>(N_solver, 1.0, host_ctx);
+
+  viennacl::vector<double> vcl_cg_result = viennacl::linalg::solve(vcl_laplace, vcl_laplace_rhs, viennacl::linalg::cg_tag(1e-12, 1000));
+  viennacl::vector<double> vcl_residual = vcl_laplace_rhs;
+  vcl_residual -= viennacl::linalg::prod(vcl_laplace, vcl_cg_result);
+  if ( viennacl::linalg::norm_2(vcl_residual) > 1e-8 * viennacl::linalg::norm_2(vcl_laplace_rhs) )
+  {
+    std::cout << "# Error at operation: CG with mixed precision compressed_matrix" << std::endl;
+    std::cout << "  relative residual: " << viennacl::linalg::norm_2(vcl_residual) / viennacl::linalg::norm_2(vcl_laplace_rhs) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  viennacl::vector<double> vcl_gmres_result = viennacl::linalg::solve(vcl_laplace, vcl_laplace_rhs, viennacl::linalg::gmres_tag(1e-12, 400, 200));
+  vcl_residual = vcl_laplace_rhs;
+  vcl_residual -= viennacl::linalg::prod(vcl_laplace, vcl_gmres_result);
+  if ( viennacl::linalg::norm_2(vcl_residual) > 1e-8 * viennacl::linalg::norm_2(vcl_laplace_rhs) )
+  {
+    std::cout << "# Error at operation: GMRES with mixed precision compressed_matrix" << std::endl;
+    std::cout << "  relative residual: " << viennacl::linalg::norm_2(vcl_residual) / viennacl::linalg::norm_2(vcl_laplace_rhs) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the products of a sliced_ell_matrix with rows sorted within windows of sigma rows, and the selection of C and sigma by tune_sliced_ell(). Row sorting requires main memory. */
+template<typename NumericT, typename Epsilon>
+int sliced_ell_sorting_test(Epsilon epsilon, std::vector<std::map<unsigned int, NumericT> > const & std_matrix, std::vector<NumericT> const & rhs)
+{
+  std::size_t N = std_matrix.size();
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  viennacl::sliced_ell_matrix<NumericT> vcl_unsorted_matrix(viennacl::sliced_ell_parameters(8, 1), host_ctx);
+  viennacl::copy(std_matrix, vcl_unsorted_matrix);
+
+  viennacl::sliced_ell_matrix<NumericT> vcl_sorted_matrix(viennacl::sliced_ell_parameters(8, 256), host_ctx);
+  viennacl::copy(std_matrix, vcl_sorted_matrix);
+
+  if (vcl_sorted_matrix.sorting_scope() != 256 || vcl_sorted_matrix.nnz() != vcl_unsorted_matrix.nnz() || vcl_sorted_matrix.internal_nnz() > vcl_unsorted_matrix.internal_nnz())
+  {
+    std::cout << "# Error at operation: padding of sliced_ell_matrix with sorted rows" << std::endl;
+    std::cout << "  stored entries: " << vcl_sorted_matrix.internal_nnz() << " (sorted) vs. " << vcl_unsorted_matrix.internal_nnz() << " (unsorted)" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<NumericT> result(N);
+  viennacl::vector<NumericT> vcl_rhs(N, host_ctx), vcl_result(N, host_ctx);
+  viennacl::copy(rhs, vcl_rhs);
+
+  // y = A * x
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  vcl_result = viennacl::linalg::prod(vcl_sorted_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with sliced_ell_matrix, sorted rows" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y -= A * x
+  for (std::size_t i=0; i<N; ++i) result[i] = rhs[i] - result[i];
+  vcl_result = vcl_rhs;
+  vcl_result -= viennacl::linalg::prod(vcl_sorted_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with sliced_ell_matrix, sorted rows (-=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // tuned parameters:
+  viennacl::sliced_ell_matrix<NumericT> vcl_tuned_matrix(host_ctx);
+  viennacl::sliced_ell_tuning_result tuning_result = viennacl::tune_sliced_ell(std_matrix, vcl_tuned_matrix, viennacl::sliced_ell_tuning_tag(2));
+  std::cout << "  " << tuning_result << std::endl;
+  if (tuning_result.rows_per_block != vcl_tuned_matrix.rows_per_block() || tuning_result.sorting_scope != vcl_tuned_matrix.sorting_scope() || tuning_result.internal_nnz != vcl_tuned_matrix.internal_nnz())
+  {
+    std::cout << "# Error at operation: parameters reported by tune_sliced_ell()" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  vcl_result = viennacl::linalg::prod(vcl_tuned_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with tuned sliced_ell_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+/** @brief Tests the format selection of auto_sparse_matrix and the products with the selected format, both with benchmarks and with the heuristic only. */
+template<typename NumericT, typename Epsilon>
+int auto_sparse_matrix_test(Epsilon epsilon, std::vector<std::map<unsigned int, NumericT> > const & std_matrix, std::vector<NumericT> const & rhs)
+{
+  std::size_t N = std_matrix.size();
+
+  viennacl::compressed_matrix<NumericT> vcl_compressed_matrix(N, N);
+  viennacl::copy(std_matrix, vcl_compressed_matrix);
+
+  // row statistics:
+  std::size_t nnz = 0, max_row_length = 0, empty_rows = 0;
+  for (std::size_t i=0; i<N; ++i)
+  {
+    nnz += std_matrix[i].size();
+    max_row_length = std::max<std::size_t>(max_row_length, std_matrix[i].size());
+    if (std_matrix[i].size() == 0)
+      ++empty_rows;
+  }
+
+  viennacl::sparse_row_statistics stats = viennacl::row_statistics(vcl_compressed_matrix);
+  if (stats.nnz != nnz || stats.max_row_length != max_row_length || stats.empty_rows != empty_rows)
+  {
+    std::cout << "# Error at operation: row statistics of compressed_matrix" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  viennacl::sparse_format_cache cache;
+  viennacl::auto_sparse_matrix<NumericT> vcl_auto_matrix(vcl_compressed_matrix, cache);
+  std::cout << "  selected format: " << viennacl::sparse_format_name(vcl_auto_matrix.format()) << std::endl;
+
+  // the decision for the same sparsity pattern is taken from the cache:
+  viennacl::auto_sparse_matrix<NumericT> vcl_auto_matrix2(vcl_compressed_matrix, cache);
+  if (cache.size() != 1 || vcl_auto_matrix2.format() != vcl_auto_matrix.format())
+  {
+    std::cout << "# Error at operation: cached format selection for auto_sparse_matrix" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // selection based on the row statistics only:
+  viennacl::auto_sparse_matrix<NumericT> vcl_auto_matrix3(vcl_compressed_matrix, viennacl::auto_sparse_tag(0));
+
+  std::vector<NumericT> result(N);
+  viennacl::vector<NumericT> vcl_rhs(N), vcl_result(N);
+  viennacl::copy(rhs, vcl_rhs);
+
+  // y = A * x
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  vcl_result = viennacl::linalg::prod(vcl_auto_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with auto_sparse_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vcl_result = viennacl::linalg::prod(vcl_auto_matrix3, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with auto_sparse_matrix (heuristic selection)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y += A * x
+  for (std::size_t i=0; i<N; ++i) result[i] += rhs[i];
+  vcl_result = vcl_rhs;
+  vcl_result += viennacl::linalg::prod(vcl_auto_matrix2, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with auto_sparse_matrix (+=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // y -= A * x
+  result = viennacl::linalg::prod(std_matrix, rhs);
+  for (std::size_t i=0; i<N; ++i) result[i] = rhs[i] - result[i];
+  vcl_result = vcl_rhs;
+  vcl_result -= viennacl::linalg::prod(vcl_auto_matrix, vcl_rhs);
+  if ( std::fabs(diff(result, vcl_result)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-vector product with auto_sparse_matrix (-=)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
 template< typename NumericT, typename VCL_MATRIX, typename Epsilon >
 int resize_test(Epsilon const& epsilon)
 {
@@ -314,6 +1039,47 @@ int resize_test(Epsilon const& epsilon)
 //
 // -------------------------------------------------------------
 //
+/** @brief Compares the level-scheduled and synchronization-free triangular solves on the host with inplace_solve() for A and trans(A) */
+template<typename NumericT, typename TagT, typename Epsilon>
+int level_scheduling_test(viennacl::compressed_matrix<NumericT> const & A, viennacl::vector<NumericT> const & rhs, TagT tag, Epsilon const & epsilon)
+{
+  using namespace viennacl::linalg::host_based;
+
+  sparse_triangular_solve_mode modes[] = { SPARSE_TRIANGULAR_SOLVE_LEVEL_SCHEDULED, SPARSE_TRIANGULAR_SOLVE_SYNC_FREE };
+  for (std::size_t m = 0; m < 2; ++m)
+  {
+    for (std::size_t transposed = 0; transposed < 2; ++transposed)
+    {
+      viennacl::vector<NumericT> reference = rhs;
+      viennacl::vector<NumericT> result = rhs;
+
+      sparse_triangular_factor<NumericT> factor(modes[m]);
+      if (transposed)
+      {
+        factor.init(A, tag, true);
+        factor.apply(result);
+        viennacl::linalg::inplace_solve(trans(A), reference, tag);
+      }
+      else
+      {
+        viennacl::linalg::inplace_solve(A, result, tag, factor);
+        viennacl::linalg::inplace_solve(A, reference, tag);
+      }
+
+      NumericT rel_diff = viennacl::linalg::norm_2(reference - result) / viennacl::linalg::norm_2(reference);
+      if ( std::fabs(rel_diff) > epsilon )
+      {
+        std::cout << "# Error at operation: " << (m == 0 ? "level-scheduled " : "synchronization-free ") << (transposed ? "transposed " : "") << TagT::name() << " triangular solve with compressed_matrix" << std::endl;
+        std::cout << "  diff: " << rel_diff << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
 template< typename NumericT, typename Epsilon >
 int test(Epsilon const& epsilon)
 {
@@ -399,6 +1165,11 @@ int test(Epsilon const& epsilon)
   if (retval != EXIT_SUCCESS)
     return retval;
 
+  std::cout << "Testing products: compressed_matrix, irregular row lengths" << std::endl;
+  retval = merge_path_spmv_test<NumericT>(epsilon);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
   result = rhs;
   result = viennacl::linalg::prod(std_matrix, rhs);
   for (std::size_t i=0; i<result.size(); ++i) result[i] += rhs[i];
@@ -656,6 +1427,16 @@ int test(Epsilon const& epsilon)
     return EXIT_FAILURE;
   }
 
+  if (viennacl::traits::context(vcl_compressed_matrix).memory_type() == viennacl::MAIN_MEMORY)
+  {
+    std::cout << "Testing level-scheduled and synchronization-free triangular solves: compressed_matrix" << std::endl;
+    if (   level_scheduling_test(vcl_compressed_matrix, vcl_rhs, viennacl::linalg::unit_upper_tag(), epsilon) != EXIT_SUCCESS
+        || level_scheduling_test(vcl_compressed_matrix, vcl_rhs, viennacl::linalg::upper_tag(),      epsilon) != EXIT_SUCCESS
+        || level_scheduling_test(vcl_compressed_matrix, vcl_rhs, viennacl::linalg::unit_lower_tag(), epsilon) != EXIT_SUCCESS
+        || level_scheduling_test(vcl_compressed_matrix, vcl_rhs, viennacl::linalg::lower_tag(),      epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
 
   //
   /////////////////////////
@@ -931,6 +1712,39 @@ int test(Epsilon const& epsilon)
     return EXIT_FAILURE;
   }
 
+  std::cout << "Testing products: bsr_matrix" << std::endl;
+  retval = bsr_matrix_test<NumericT, 2>(epsilon, std_matrix, rhs);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+  retval = bsr_matrix_test<NumericT, 3>(epsilon, std_matrix, rhs);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing products: symmetric_compressed_matrix" << std::endl;
+  retval = symmetric_compressed_matrix_test<NumericT>(epsilon, std_matrix, rhs);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing products: single precision matrices with double precision vectors" << std::endl;
+  retval = mixed_precision_test<NumericT>(epsilon, std_matrix, rhs);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing products: delta_compressed_matrix" << std::endl;
+  retval = delta_compressed_matrix_test<NumericT>(epsilon, std_matrix, rhs);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing products: sliced_ell_matrix with sorted rows" << std::endl;
+  retval = sliced_ell_sorting_test<NumericT>(epsilon, std_matrix, rhs);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
+  std::cout << "Testing products: auto_sparse_matrix" << std::endl;
+  retval = auto_sparse_matrix_test<NumericT>(epsilon, std_matrix, rhs);
+  if (retval != EXIT_SUCCESS)
+    return retval;
+
 
   // --------------------------------------------------------------------------
   // --------------------------------------------------------------------------
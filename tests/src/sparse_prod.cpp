@@ -35,6 +35,7 @@
 #include "viennacl/scalar.hpp"
 #include "viennacl/compressed_matrix.hpp"
 #include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/amg_operations.hpp"
 
 #include "viennacl/tools/random.hpp"
 
@@ -192,6 +193,159 @@ int test(Epsilon const& epsilon)
     retval = EXIT_FAILURE;
   }
 
+  // --------------------------------------------------------------------------
+  std::cout << "Testing products: compressed_matrix with power-law row lengths and all SpGEMM kernels" << std::endl;
+
+  // row i of A has about K/(i+1) nonzeros, some rows are empty or hold one or two nonzeros only:
+  std::vector<std::map<unsigned int, NumericT> > stl_A2(N);
+  std::vector<std::map<unsigned int, NumericT> > stl_C2(N);
+  for (std::size_t i=0; i<stl_A2.size(); ++i)
+  {
+    std::size_t nnz_row_A2 = (i % 7 == 3) ? 0 : K / (i + 1) + i % 3;
+    for (std::size_t j=0; j<nnz_row_A2; ++j)
+      stl_A2[i][static_cast<unsigned int>(randomNumber() * NumericT(K))] = NumericT(1.0) + randomNumber();
+  }
+  // make a few rows of B dense:
+  for (std::size_t i=0; i<stl_B.size(); i += 50)
+    for (std::size_t j=0; j<M; ++j)
+      stl_B[i][static_cast<unsigned int>(j)] = NumericT(1.0) + randomNumber();
+
+  viennacl::compressed_matrix<NumericT>  vcl_A2(N, K);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_A2(stl_A2, N, K);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_B2(stl_B, K, M);
+  viennacl::copy(adapted_stl_A2, vcl_A2);
+  viennacl::copy(adapted_stl_B2, vcl_B);
+
+  prod(stl_A2, stl_B, stl_C2);
+
+  viennacl::linalg::host_based::spgemm_kernel_type kernels[] = { viennacl::linalg::host_based::SPGEMM_KERNEL_MERGE,
+                                                                viennacl::linalg::host_based::SPGEMM_KERNEL_HASH,
+                                                                viennacl::linalg::host_based::SPGEMM_KERNEL_HEAP,
+                                                                viennacl::linalg::host_based::SPGEMM_KERNEL_AUTO };
+  for (std::size_t i=0; i<4; ++i)
+  {
+    viennacl::linalg::host_based::set_spgemm_kernel(kernels[i]);
+    vcl_C = viennacl::linalg::prod(vcl_A2, vcl_B);
+    if ( std::fabs(diff(stl_C2, vcl_C)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-matrix product with compressed_matrix (kernel " << kernels[i] << ")" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(stl_C2, vcl_C)) << std::endl;
+      retval = EXIT_FAILURE;
+    }
+  }
+
+  // --------------------------------------------------------------------------
+  std::cout << "Testing products: compressed_matrix with reused sparsity pattern" << std::endl;
+
+  viennacl::linalg::spgemm_plan plan;
+  viennacl::linalg::prod_symbolic(vcl_A2, vcl_B, vcl_C, plan);
+  if ( std::fabs(diff(stl_C2, vcl_C)) > epsilon )
+  {
+    std::cout << "# Error at operation: symbolic matrix-matrix product with compressed_matrix" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(stl_C2, vcl_C)) << std::endl;
+    retval = EXIT_FAILURE;
+  }
+
+  // new values, same sparsity patterns:
+  for (std::size_t i=0; i<stl_A2.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::iterator it = stl_A2[i].begin(); it != stl_A2[i].end(); ++it)
+      it->second = NumericT(1.0) + randomNumber();
+  for (std::size_t i=0; i<stl_B.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::iterator it = stl_B[i].begin(); it != stl_B[i].end(); ++it)
+      it->second = NumericT(1.0) + randomNumber();
+  viennacl::copy(adapted_stl_A2, vcl_A2);
+  viennacl::copy(adapted_stl_B2, vcl_B);
+
+  stl_C2 = std::vector<std::map<unsigned int, NumericT> >(N);
+  prod(stl_A2, stl_B, stl_C2);
+
+  for (std::size_t i=0; i<2; ++i) // second run reuses work buffers
+  {
+    viennacl::linalg::prod_numeric(vcl_A2, vcl_B, vcl_C, plan);
+    if ( std::fabs(diff(stl_C2, vcl_C)) > epsilon )
+    {
+      std::cout << "# Error at operation: numeric matrix-matrix product with compressed_matrix" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(stl_C2, vcl_C)) << std::endl;
+      retval = EXIT_FAILURE;
+    }
+  }
+
+  // --------------------------------------------------------------------------
+  std::cout << "Testing products: Galerkin product trans(P) * A * P for AMG" << std::endl;
+
+  // prolongation with one or two nonzeros per row and an empty column:
+  std::size_t N_coarse = N / 3;
+  std::vector<std::map<unsigned int, NumericT> > stl_A3(N), stl_P(N), stl_PT(N_coarse);
+  for (std::size_t i=0; i<N; ++i)
+  {
+    for (std::size_t j=0; j<nnz_row; ++j)
+      stl_A3[i][static_cast<unsigned int>(randomNumber() * NumericT(N))] = NumericT(1.0) + randomNumber();
+    stl_A3[i][static_cast<unsigned int>(i)] = NumericT(4.0);
+
+    if (i / 3 != 5)
+      stl_P[i][static_cast<unsigned int>(i / 3)] = NumericT(1.0);
+    if (i % 2 && (i * 7) % N_coarse != 5)
+      stl_P[i][static_cast<unsigned int>((i * 7) % N_coarse)] = randomNumber();
+  }
+  for (std::size_t i=0; i<N; ++i)
+    for (typename std::map<unsigned int, NumericT>::iterator it = stl_P[i].begin(); it != stl_P[i].end(); ++it)
+      stl_PT[it->first][static_cast<unsigned int>(i)] = it->second;
+
+  viennacl::compressed_matrix<NumericT> vcl_A3(N, N), vcl_P(N, N_coarse), vcl_C3;
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_A3(stl_A3, N, N);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_P(stl_P, N, N_coarse);
+  viennacl::copy(adapted_stl_A3, vcl_A3);
+  viennacl::copy(adapted_stl_P, vcl_P);
+
+  if (viennacl::traits::active_handle_id(vcl_A3) == viennacl::MAIN_MEMORY)
+  {
+    viennacl::linalg::detail::amg::amg_galerkin_plan galerkin_plan;
+    for (std::size_t run=0; run<2; ++run)
+    {
+      std::vector<std::map<unsigned int, NumericT> > stl_A3_P(N), stl_C3(N_coarse);
+      prod(stl_A3, stl_P, stl_A3_P);
+      prod(stl_PT, stl_A3_P, stl_C3);
+
+      if (run == 0)
+        viennacl::linalg::host_based::amg::amg_galerkin_prod_symbolic(vcl_A3, vcl_P, vcl_C3, galerkin_plan);
+      else
+        viennacl::linalg::host_based::amg::amg_galerkin_prod_numeric(vcl_A3, vcl_P, vcl_C3, galerkin_plan);
+
+      if ( std::fabs(diff(stl_C3, vcl_C3)) > epsilon )
+      {
+        std::cout << "# Error at operation: Galerkin product (" << (run == 0 ? "symbolic" : "numeric") << " phase)" << std::endl;
+        std::cout << "  diff: " << std::fabs(diff(stl_C3, vcl_C3)) << std::endl;
+        retval = EXIT_FAILURE;
+      }
+
+      // new values, same sparsity pattern:
+      for (std::size_t i=0; i<N; ++i)
+        for (typename std::map<unsigned int, NumericT>::iterator it = stl_A3[i].begin(); it != stl_A3[i].end(); ++it)
+          it->second = NumericT(1.0) + randomNumber();
+      viennacl::copy(adapted_stl_A3, vcl_A3);
+    }
+
+    if (!viennacl::linalg::host_based::amg::amg_galerkin_plan_matches(vcl_A3, vcl_P, galerkin_plan))
+    {
+      std::cout << "# Error at operation: Galerkin product, plan rejected for unchanged sparsity patterns" << std::endl;
+      retval = EXIT_FAILURE;
+    }
+
+    // shift the columns of A_fine, so that the sparsity pattern changes while the number of nonzeros stays the same:
+    std::vector<std::map<unsigned int, NumericT> > stl_A4(N);
+    for (std::size_t i=0; i<N; ++i)
+      for (typename std::map<unsigned int, NumericT>::iterator it = stl_A3[i].begin(); it != stl_A3[i].end(); ++it)
+        stl_A4[i][static_cast<unsigned int>((it->first + 1) % N)] = it->second;
+    viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_A4(stl_A4, N, N);
+    viennacl::copy(adapted_stl_A4, vcl_A3);
+
+    if (viennacl::linalg::host_based::amg::amg_galerkin_plan_matches(vcl_A3, vcl_P, galerkin_plan))
+    {
+      std::cout << "# Error at operation: Galerkin product, plan accepted for a different sparsity pattern of A_fine" << std::endl;
+      retval = EXIT_FAILURE;
+    }
+  }
+
   // --------------------------------------------------------------------------
   return retval;
 }
@@ -39,6 +39,8 @@
 #include "viennacl/coordinate_matrix.hpp"
 #include "viennacl/ell_matrix.hpp"
 #include "viennacl/hyb_matrix.hpp"
+#include "viennacl/sliced_ell_matrix.hpp"
+#include "viennacl/bsr_matrix.hpp"
 #include "viennacl/linalg/prod.hpp"       //generic matrix-vector product
 #include "viennacl/linalg/norm_2.hpp"     //generic l2-norm for vectors
 #include "viennacl/io/matrix_market.hpp"
@@ -276,6 +278,110 @@ int test(NumericT epsilon)
     return retVal;
   }
 
+  /******************************************************************/
+
+  // bsr_matrix is only available in main memory:
+  if (viennacl::traits::active_handle_id(B1) == viennacl::MAIN_MEMORY)
+  {
+    viennacl::bsr_matrix<NumericT, 3> bsr_A;
+    viennacl::copy(compressed_A, bsr_A);
+
+    std::cout << "Testing compressed(BSR) lhs * dense rhs" << std::endl;
+    C.clear();
+    C = viennacl::linalg::prod(bsr_A, B1);
+
+    for (std::size_t i=0; i<temp.size(); ++i)
+      for (std::size_t j=0; j<temp[i].size(); ++j)
+        temp[i][j] = 0;
+    viennacl::copy(C, temp);
+    retVal = check_matrices(std_C, temp, epsilon);
+    if (retVal != EXIT_SUCCESS)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return retVal;
+    }
+
+    std::cout << "Testing compressed(BSR) lhs * transposed dense rhs" << std::endl;
+    C.clear();
+    C = viennacl::linalg::prod(bsr_A, viennacl::trans(B2));
+
+    for (std::size_t i=0; i<temp.size(); ++i)
+      for (std::size_t j=0; j<temp[i].size(); ++j)
+        temp[i][j] = 0;
+    viennacl::copy(C, temp);
+    retVal = check_matrices(std_C, temp, epsilon);
+    if (retVal != EXIT_SUCCESS)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return retVal;
+    }
+
+    // sliced_ell_matrix times dense matrix is only available in main memory:
+    viennacl::sliced_ell_matrix<NumericT> sell_A;
+    viennacl::copy(std_A, sell_A);
+
+    std::cout << "Testing compressed(SELL) lhs * dense rhs" << std::endl;
+    C.clear();
+    C = viennacl::linalg::prod(sell_A, B1);
+
+    for (std::size_t i=0; i<temp.size(); ++i)
+      for (std::size_t j=0; j<temp[i].size(); ++j)
+        temp[i][j] = 0;
+    viennacl::copy(C, temp);
+    retVal = check_matrices(std_C, temp, epsilon);
+    if (retVal != EXIT_SUCCESS)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return retVal;
+    }
+
+    std::cout << "Testing compressed(SELL) lhs * transposed dense rhs" << std::endl;
+    C.clear();
+    C = viennacl::linalg::prod(sell_A, viennacl::trans(B2));
+
+    for (std::size_t i=0; i<temp.size(); ++i)
+      for (std::size_t j=0; j<temp[i].size(); ++j)
+        temp[i][j] = 0;
+    viennacl::copy(C, temp);
+    retVal = check_matrices(std_C, temp, epsilon);
+    if (retVal != EXIT_SUCCESS)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return retVal;
+    }
+  }
+
+  /******************************************************************/
+
+  // tall and skinny right hand sides with different numbers of columns (processed in blocks of 16, 8, 4, 2, and 1 columns by the host backend):
+  std::size_t tall_skinny_cols[] = {1, 2, 8, 16, 27};
+  for (std::size_t k=0; k<sizeof(tall_skinny_cols) / sizeof(tall_skinny_cols[0]); ++k)
+  {
+    std::size_t cols = tall_skinny_cols[k];
+    std::cout << "Testing compressed(CSR) lhs * dense rhs with " << cols << " columns" << std::endl;
+
+    std::vector<std::vector<NumericT> > std_B3(std_A.size(), std::vector<NumericT>(cols));
+    std::vector<std::vector<NumericT> > std_C3(std_A.size(), std::vector<NumericT>(cols));
+    std::vector<std::vector<NumericT> > temp3(std_A.size(), std::vector<NumericT>(cols));
+    for (std::size_t i = 0; i < std_B3.size(); i++)
+      for (std::size_t j = 0; j < std_B3[i].size(); j++)
+        std_B3[i][j] = NumericT(0.5) + NumericT(0.1) * randomNumber();
+    compute_reference_result(std_A, std_B3, std_C3);
+
+    viennacl::matrix<NumericT, FactorLayoutT> B3(std_A.size(), cols);
+    viennacl::matrix<NumericT, ResultLayoutT> C3(std_A.size(), cols);
+    viennacl::copy(std_B3, B3);
+
+    C3 = viennacl::linalg::prod(compressed_A, B3);
+    viennacl::copy(C3, temp3);
+    retVal = check_matrices(std_C3, temp3, epsilon);
+    if (retVal != EXIT_SUCCESS)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return retVal;
+    }
+  }
+
   /******************************************************************/
   if (retVal == EXIT_SUCCESS) {
     std::cout << "Tests passed successfully" << std::endl;
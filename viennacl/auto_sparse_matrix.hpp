@@ -0,0 +1,345 @@
+#ifndef VIENNACL_AUTO_SPARSE_MATRIX_HPP_
+#define VIENNACL_AUTO_SPARSE_MATRIX_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/auto_sparse_matrix.hpp
+    @brief Implementation of the auto_sparse_matrix class, which stores a sparse matrix in the format found to be fastest for matrix-vector products.
+*/
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/compressed_compressed_matrix.hpp"
+#include "viennacl/coordinate_matrix.hpp"
+#include "viennacl/ell_matrix.hpp"
+#include "viennacl/sliced_ell_matrix.hpp"
+#include "viennacl/hyb_matrix.hpp"
+#include "viennacl/misc/sparse_format_selection.hpp"
+
+#include "viennacl/tools/adapter.hpp"
+#include "viennacl/tools/shared_ptr.hpp"
+#include "viennacl/tools/timer.hpp"
+
+#include "viennacl/linalg/sparse_matrix_operations.hpp"
+
+namespace viennacl
+{
+namespace detail
+{
+  /** @brief Interface of the matrices held by auto_sparse_matrix, one implementation per sparse format */
+  template<typename NumericT>
+  class auto_sparse_matrix_base
+  {
+  public:
+    virtual ~auto_sparse_matrix_base() {}
+
+    /** @brief Computes result = alpha * A * vec + beta * result */
+    virtual void apply_prod(viennacl::vector_base<NumericT> const & vec, NumericT alpha, viennacl::vector_base<NumericT> & result, NumericT beta) const = 0;
+
+    /** @brief Returns the memory handle to the matrix entries */
+    virtual viennacl::backend::mem_handle const & handle() const = 0;
+  };
+
+  /** @brief Holds the sparse matrix in the format given by SparseMatrixT */
+  template<typename NumericT, typename SparseMatrixT>
+  class auto_sparse_matrix_holder : public auto_sparse_matrix_base<NumericT>
+  {
+  public:
+    auto_sparse_matrix_holder(std::vector< std::map<unsigned int, NumericT> > const & std_A, vcl_size_t num_cols, viennacl::context ctx) : mat_(ctx)
+    {
+      viennacl::copy(viennacl::tools::const_sparse_matrix_adapter<NumericT, unsigned int>(std_A, std_A.size(), num_cols), mat_);
+    }
+
+    void apply_prod(viennacl::vector_base<NumericT> const & vec, NumericT alpha, viennacl::vector_base<NumericT> & result, NumericT beta) const
+    {
+      viennacl::linalg::prod_impl(mat_, vec, alpha, result, beta);
+    }
+
+    viennacl::backend::mem_handle const & handle() const { return mat_.handle(); }
+
+  private:
+    SparseMatrixT mat_;
+  };
+
+  /** @brief Creates the holder for the sparse format 'format' from the entries of a matrix with num_cols columns in the context ctx */
+  template<typename NumericT>
+  viennacl::tools::shared_ptr<auto_sparse_matrix_base<NumericT> >
+  make_auto_sparse_matrix_holder(sparse_format_type format, std::vector< std::map<unsigned int, NumericT> > const & std_A, vcl_size_t num_cols, viennacl::context ctx)
+  {
+    typedef viennacl::tools::shared_ptr<auto_sparse_matrix_base<NumericT> >   PointerType;
+
+    switch (format)
+    {
+      case SPARSE_FORMAT_COMPRESSED_CSR:
+        return PointerType(new auto_sparse_matrix_holder<NumericT, viennacl::compressed_compressed_matrix<NumericT> >(std_A, num_cols, ctx));
+      case SPARSE_FORMAT_COO:
+        return PointerType(new auto_sparse_matrix_holder<NumericT, viennacl::coordinate_matrix<NumericT> >(std_A, num_cols, ctx));
+      case SPARSE_FORMAT_ELL:
+        return PointerType(new auto_sparse_matrix_holder<NumericT, viennacl::ell_matrix<NumericT> >(std_A, num_cols, ctx));
+      case SPARSE_FORMAT_SLICED_ELL:
+        return PointerType(new auto_sparse_matrix_holder<NumericT, viennacl::sliced_ell_matrix<NumericT> >(std_A, num_cols, ctx));
+      case SPARSE_FORMAT_HYB:
+        return PointerType(new auto_sparse_matrix_holder<NumericT, viennacl::hyb_matrix<NumericT> >(std_A, num_cols, ctx));
+      default:
+        break;
+    }
+    return PointerType(new auto_sparse_matrix_holder<NumericT, viennacl::compressed_matrix<NumericT> >(std_A, num_cols, ctx));
+  }
+}
+
+
+/** @brief A sparse matrix stored in the format (CSR, compressed CSR, COO, ELL, sliced ELL, or HYB) found to be the fastest for sparse matrix-vector products.
+  *
+  * The format is selected from the row statistics of the supplied compressed_matrix and by timing a few sparse matrix-vector products with each candidate format
+  * in the memory domain of the supplied matrix. The selection can be reused for matrices with the same sparsity pattern via a sparse_format_cache.
+  * prod() with a vector is dispatched to the product of the selected format at run time.
+  *
+  * Typical use:
+  *   viennacl::sparse_format_cache cache;
+  *   viennacl::auto_sparse_matrix<double> A_auto(A, cache);
+  *   y = viennacl::linalg::prod(A_auto, x);
+  */
+template<typename NumericT>
+class auto_sparse_matrix
+{
+  typedef viennacl::tools::shared_ptr<detail::auto_sparse_matrix_base<NumericT> >   PointerType;
+
+public:
+  typedef viennacl::backend::mem_handle                                                              handle_type;
+  typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<NumericT>::ResultType>     value_type;
+  typedef vcl_size_t                                                                                 size_type;
+
+  auto_sparse_matrix() : format_(SPARSE_FORMAT_CSR) {}
+
+  /** @brief Selects the format for the compressed_matrix A and stores A in this format. */
+  template<unsigned int AlignmentV>
+  explicit auto_sparse_matrix(viennacl::compressed_matrix<NumericT, AlignmentV> const & A, auto_sparse_tag const & tag = auto_sparse_tag()) : format_(SPARSE_FORMAT_CSR)
+  {
+    set(A, NULL, tag);
+  }
+
+  /** @brief Selects the format for the compressed_matrix A, reusing the decision stored in 'cache' for the sparsity pattern of A if available, and stores A in this format. */
+  template<unsigned int AlignmentV>
+  auto_sparse_matrix(viennacl::compressed_matrix<NumericT, AlignmentV> const & A, sparse_format_cache & cache, auto_sparse_tag const & tag = auto_sparse_tag()) : format_(SPARSE_FORMAT_CSR)
+  {
+    set(A, &cache, tag);
+  }
+
+  /** @brief Selects the format for the compressed_matrix A and stores A in this format. If 'cache' is not NULL, the decision is looked up in and stored to the cache. */
+  template<unsigned int AlignmentV>
+  void set(viennacl::compressed_matrix<NumericT, AlignmentV> const & A, sparse_format_cache * cache, auto_sparse_tag const & tag = auto_sparse_tag())
+  {
+    stats_ = viennacl::row_statistics(A);
+    viennacl::context ctx = viennacl::traits::context(A);
+
+    std::vector< std::map<unsigned int, NumericT> > std_A(A.size1());
+    viennacl::copy(A, std_A);
+
+    std::string key;
+    if (cache)
+    {
+      key = viennacl::sparse_structure_key(A);
+      if (cache->find(key, format_))
+      {
+        matrix_ = detail::make_auto_sparse_matrix_holder(format_, std_A, A.size2(), ctx);
+        return;
+      }
+    }
+
+    if (tag.benchmark_runs() == 0 || A.nnz() == 0)
+    {
+      format_ = viennacl::sparse_format_heuristic(stats_, tag, ctx.memory_type());
+      matrix_ = detail::make_auto_sparse_matrix_holder(format_, std_A, A.size2(), ctx);
+    }
+    else
+    {
+      std::vector<sparse_format_type> candidates = viennacl::sparse_format_candidates(stats_, tag);
+
+      viennacl::vector<NumericT> x = viennacl::scalar_vector<NumericT>(A.size2(), NumericT(1), ctx);
+      viennacl::vector<NumericT> y(A.size1(), ctx);
+      viennacl::tools::timer timer;
+
+      double best_time = -1;
+      for (std::size_t i=0; i<candidates.size(); ++i)
+      {
+        PointerType candidate = detail::make_auto_sparse_matrix_holder(candidates[i], std_A, A.size2(), ctx);
+
+        candidate->apply_prod(x, NumericT(1), y, NumericT(0)); // warm-up, includes kernel compilation for OpenCL
+        viennacl::backend::finish();
+
+        timer.start();
+        for (unsigned int run=0; run<tag.benchmark_runs(); ++run)
+          candidate->apply_prod(x, NumericT(1), y, NumericT(0));
+        viennacl::backend::finish();
+        double elapsed = timer.get();
+
+        if (best_time < 0 || elapsed < best_time)
+        {
+          best_time = elapsed;
+          format_ = candidates[i];
+          matrix_ = candidate;
+        }
+      }
+    }
+
+    if (cache)
+      cache->insert(key, format_);
+  }
+
+  /** @brief Returns the selected format */
+  sparse_format_type format() const { return format_; }
+
+  /** @brief Returns the row statistics of the matrix the format was selected for */
+  sparse_row_statistics const & statistics() const { return stats_; }
+
+  /** @brief Returns the number of rows */
+  size_type size1() const { return stats_.size1; }
+  /** @brief Returns the number of columns */
+  size_type size2() const { return stats_.size2; }
+  /** @brief Returns the number of nonzero entries */
+  size_type nnz() const { return stats_.nnz; }
+
+  /** @brief Returns the memory handle to the entries of the matrix in the selected format */
+  const handle_type & handle() const
+  {
+    assert( matrix_.get() && bool("auto_sparse_matrix not initialized!") );
+    return matrix_->handle();
+  }
+
+  /** @brief Computes result = alpha * A * vec + beta * result with the selected format. Use viennacl::linalg::prod() instead of calling this function directly. */
+  void apply_prod(viennacl::vector_base<NumericT> const & vec, NumericT alpha, viennacl::vector_base<NumericT> & result, NumericT beta) const
+  {
+    assert( matrix_.get() && bool("auto_sparse_matrix not initialized!") );
+    matrix_->apply_prod(vec, alpha, result, beta);
+  }
+
+private:
+  sparse_format_type    format_;
+  sparse_row_statistics stats_;
+  PointerType           matrix_;
+};
+
+
+//
+// Specify available operations:
+//
+
+/** \cond */
+
+namespace linalg
+{
+namespace detail
+{
+  // x = A * y
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const auto_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const auto_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x = A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const auto_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const auto_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x += A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const auto_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const auto_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x -= A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+
+  // x = A * vec_op
+  template<typename NumericT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const auto_sparse_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const auto_sparse_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  // x += A * vec_op
+  template<typename NumericT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const auto_sparse_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const auto_sparse_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  // x -= A * vec_op
+  template<typename NumericT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const auto_sparse_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const auto_sparse_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+} // namespace detail
+} // namespace linalg
+
+/** \endcond */
+}
+
+#endif
@@ -0,0 +1,441 @@
+#ifndef VIENNACL_BSR_MATRIX_HPP_
+#define VIENNACL_BSR_MATRIX_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/bsr_matrix.hpp
+    @brief Implementation of the bsr_matrix class (block compressed sparse row format)
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+
+#include "viennacl/tools/tools.hpp"
+
+#include "viennacl/linalg/sparse_matrix_operations.hpp"
+
+namespace viennacl
+{
+/** @brief Sparse matrix class using the block compressed sparse row (BSR) format with dense blocks of size BlockSize x BlockSize.
+  *
+  * The block rows are stored in CSR format, where each nonzero refers to a dense block stored row-major.
+  * Compared to compressed_matrix, only one column index per block is stored, which reduces the index traffic for matrices with a block structure,
+  * e.g. from finite element discretizations of systems of PDEs with BlockSize unknowns per node.
+  * If the number of rows or columns is not a multiple of BlockSize, the blocks in the last block row and block column are padded with zeros.
+  *
+  * The matrix resides in main memory. Operations are provided by the host backend only.
+  */
+template<typename NumericT, unsigned int BlockSize>
+class bsr_matrix
+{
+public:
+  typedef viennacl::backend::mem_handle                                                              handle_type;
+  typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<NumericT>::ResultType>     value_type;
+  typedef vcl_size_t                                                                                 size_type;
+
+  bsr_matrix() : rows_(0), cols_(0), nonzero_blocks_(0) {}
+
+  /** @brief Construction of an empty matrix with the supplied number of rows and columns. Entries are supplied by copy() from a compressed_matrix or by set(). */
+  bsr_matrix(size_type num_rows, size_type num_cols) : rows_(num_rows), cols_(num_cols), nonzero_blocks_(0) {}
+
+  /** @brief Sets the block row pointers, the block column indices, and the blocks of the matrix.
+    *
+    * @param block_row_jumper   Start and stop indices in the block column and block array for each block row (length block_rows()+1)
+    * @param block_col_buffer   Block column indices, sorted within each block row
+    * @param elements           The blocks, each stored row-major with BlockSize * BlockSize entries
+    * @param rows               Number of rows of the matrix
+    * @param cols               Number of columns of the matrix
+    * @param nonzero_blocks     Number of nonzero blocks
+    */
+  void set(unsigned int const * block_row_jumper,
+           unsigned int const * block_col_buffer,
+           NumericT     const * elements,
+           size_type rows,
+           size_type cols,
+           size_type nonzero_blocks)
+  {
+    assert( (rows > 0)           && bool("Error in bsr_matrix::set(): Number of rows must be larger than zero!"));
+    assert( (cols > 0)           && bool("Error in bsr_matrix::set(): Number of columns must be larger than zero!"));
+    assert( (nonzero_blocks > 0) && bool("Error in bsr_matrix::set(): Number of nonzero blocks must be larger than zero!"));
+
+    rows_ = rows;
+    cols_ = cols;
+    nonzero_blocks_ = nonzero_blocks;
+
+    viennacl::context host_context(viennacl::MAIN_MEMORY);
+    viennacl::backend::memory_create(block_row_buffer_, sizeof(unsigned int) * (block_rows() + 1),                           host_context, block_row_jumper);
+    viennacl::backend::memory_create(block_col_buffer_, sizeof(unsigned int) * nonzero_blocks,                               host_context, block_col_buffer);
+    viennacl::backend::memory_create(elements_,         sizeof(NumericT) * nonzero_blocks * BlockSize * BlockSize,           host_context, elements);
+  }
+
+  /** @brief Resets the matrix to the empty state, releasing all memory. */
+  void clear()
+  {
+    rows_ = 0;
+    cols_ = 0;
+    nonzero_blocks_ = 0;
+    block_row_buffer_ = handle_type();
+    block_col_buffer_ = handle_type();
+    elements_ = handle_type();
+  }
+
+  /** @brief Returns the number of rows */
+  size_type size1() const { return rows_; }
+  /** @brief Returns the number of columns */
+  size_type size2() const { return cols_; }
+
+  /** @brief Returns the number of rows and columns of each block */
+  static unsigned int block_size() { return BlockSize; }
+
+  /** @brief Returns the number of block rows */
+  size_type block_rows() const { return (rows_ + BlockSize - 1) / BlockSize; }
+  /** @brief Returns the number of block columns */
+  size_type block_cols() const { return (cols_ + BlockSize - 1) / BlockSize; }
+
+  /** @brief Returns the number of nonzero blocks */
+  size_type nnz_blocks() const { return nonzero_blocks_; }
+  /** @brief Returns the number of stored entries, i.e. the number of nonzero blocks times the number of entries per block */
+  size_type nnz() const { return nonzero_blocks_ * BlockSize * BlockSize; }
+
+  /** @brief Returns the memory handle to the block row index array */
+  const handle_type & handle1() const { return block_row_buffer_; }
+  /** @brief Returns the memory handle to the block column index array */
+  const handle_type & handle2() const { return block_col_buffer_; }
+  /** @brief Returns the memory handle to the matrix entry array */
+  const handle_type & handle() const { return elements_; }
+
+  /** @brief Returns the memory handle to the block row index array */
+  handle_type & handle1() { return block_row_buffer_; }
+  /** @brief Returns the memory handle to the block column index array */
+  handle_type & handle2() { return block_col_buffer_; }
+  /** @brief Returns the memory handle to the matrix entry array */
+  handle_type & handle() { return elements_; }
+
+private:
+  size_type rows_;
+  size_type cols_;
+  size_type nonzero_blocks_;
+  handle_type block_row_buffer_;
+  handle_type block_col_buffer_;
+  handle_type elements_;
+};
+
+
+/** @brief Converts a compressed_matrix to a bsr_matrix. Blocks containing at least one nonzero of the compressed_matrix are stored, missing entries within a block are set to zero.
+  *
+  * @param csr_mat      The compressed_matrix, may reside in any memory domain
+  * @param bsr_mat      The bsr_matrix in main memory
+  */
+template<typename NumericT, unsigned int AlignmentV, unsigned int BlockSize>
+void copy(compressed_matrix<NumericT, AlignmentV> const & csr_mat,
+          bsr_matrix<NumericT, BlockSize> & bsr_mat)
+{
+  assert( (bsr_mat.size1() == 0 || csr_mat.size1() == bsr_mat.size1()) && bool("Size mismatch") );
+  assert( (bsr_mat.size2() == 0 || csr_mat.size2() == bsr_mat.size2()) && bool("Size mismatch") );
+
+  if (csr_mat.size1() == 0 || csr_mat.size2() == 0 || csr_mat.nnz() == 0)
+  {
+    bsr_mat.clear();
+    return;
+  }
+
+  //get raw data from memory:
+  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(csr_mat.handle1(), csr_mat.size1() + 1);
+  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(csr_mat.handle2(), csr_mat.nnz());
+  std::vector<NumericT> csr_elements(csr_mat.nnz());
+
+  viennacl::backend::memory_read(csr_mat.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+  viennacl::backend::memory_read(csr_mat.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+  viennacl::backend::memory_read(csr_mat.handle(),  0, sizeof(NumericT) * csr_mat.nnz(), &(csr_elements[0]));
+
+  vcl_size_t block_rows = (csr_mat.size1() + BlockSize - 1) / BlockSize;
+  vcl_size_t block_cols = (csr_mat.size2() + BlockSize - 1) / BlockSize;
+
+  // block pattern: the marker holds the last block row in which a block column has been encountered, the position holds the index of the block within its block row
+  std::vector<unsigned int> block_row_buffer(block_rows + 1, 0);
+  std::vector<unsigned int> block_col_buffer;
+  std::vector<vcl_size_t>   block_marker(block_cols, block_rows);
+  std::vector<unsigned int> block_position(block_cols);
+
+  for (vcl_size_t block_row = 0; block_row < block_rows; ++block_row)
+  {
+    vcl_size_t row_stop = std::min<vcl_size_t>((block_row + 1) * BlockSize, csr_mat.size1());
+    for (vcl_size_t row = block_row * BlockSize; row < row_stop; ++row)
+      for (vcl_size_t j = row_buffer[row]; j < row_buffer[row+1]; ++j)
+      {
+        vcl_size_t block_col = col_buffer[j] / BlockSize;
+        if (block_marker[block_col] != block_row)
+        {
+          block_marker[block_col] = block_row;
+          block_col_buffer.push_back(static_cast<unsigned int>(block_col));
+        }
+      }
+
+    std::sort(block_col_buffer.begin() + block_row_buffer[block_row], block_col_buffer.end());
+    block_row_buffer[block_row + 1] = static_cast<unsigned int>(block_col_buffer.size());
+  }
+
+  // blocks:
+  std::vector<NumericT> elements(block_col_buffer.size() * BlockSize * BlockSize, NumericT(0));
+  for (vcl_size_t block_row = 0; block_row < block_rows; ++block_row)
+  {
+    for (unsigned int k = block_row_buffer[block_row]; k < block_row_buffer[block_row + 1]; ++k)
+      block_position[block_col_buffer[k]] = k;
+
+    vcl_size_t row_stop = std::min<vcl_size_t>((block_row + 1) * BlockSize, csr_mat.size1());
+    for (vcl_size_t row = block_row * BlockSize; row < row_stop; ++row)
+      for (vcl_size_t j = row_buffer[row]; j < row_buffer[row+1]; ++j)
+      {
+        vcl_size_t col = col_buffer[j];
+        vcl_size_t block_index = block_position[col / BlockSize];
+        elements[(block_index * BlockSize + row % BlockSize) * BlockSize + col % BlockSize] = csr_elements[j];
+      }
+  }
+
+  bsr_mat.set(&(block_row_buffer[0]), &(block_col_buffer[0]), &(elements[0]),
+                 csr_mat.size1(), csr_mat.size2(), block_col_buffer.size());
+}
+
+
+/** @brief Converts a bsr_matrix to a compressed_matrix.
+  *
+  * All entries of the stored blocks are transferred, including zeros within a block, so that the sparsity pattern of the compressed_matrix is given by the blocks.
+  *
+  * @param bsr_mat      The bsr_matrix
+  * @param csr_mat      The compressed_matrix, may reside in any memory domain
+  */
+template<typename NumericT, unsigned int BlockSize, unsigned int AlignmentV>
+void copy(bsr_matrix<NumericT, BlockSize> const & bsr_mat,
+          compressed_matrix<NumericT, AlignmentV> & csr_mat)
+{
+  assert( (csr_mat.size1() == 0 || csr_mat.size1() == bsr_mat.size1()) && bool("Size mismatch") );
+  assert( (csr_mat.size2() == 0 || csr_mat.size2() == bsr_mat.size2()) && bool("Size mismatch") );
+
+  if (bsr_mat.nnz_blocks() == 0)
+    return;
+
+  unsigned int const * block_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(bsr_mat.handle1());
+  unsigned int const * block_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(bsr_mat.handle2());
+  NumericT     const * block_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(bsr_mat.handle());
+
+  vcl_size_t rows = bsr_mat.size1();
+  vcl_size_t cols = bsr_mat.size2();
+
+  // number of entries per row: each block contributes its columns inside the matrix
+  std::vector<vcl_size_t> row_lengths(bsr_mat.block_rows(), 0);
+  for (vcl_size_t block_row = 0; block_row < bsr_mat.block_rows(); ++block_row)
+    for (unsigned int k = block_row_buffer[block_row]; k < block_row_buffer[block_row + 1]; ++k)
+      row_lengths[block_row] += std::min<vcl_size_t>(BlockSize, cols - block_col_buffer[k] * BlockSize);
+
+  vcl_size_t nonzeros = 0;
+  for (vcl_size_t row = 0; row < rows; ++row)
+    nonzeros += row_lengths[row / BlockSize];
+
+  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(csr_mat.handle1(), rows + 1);
+  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(csr_mat.handle2(), nonzeros);
+  std::vector<NumericT> elements(nonzeros);
+
+  vcl_size_t data_index = 0;
+  for (vcl_size_t row = 0; row < rows; ++row)
+  {
+    row_buffer.set(row, data_index);
+    vcl_size_t block_row = row / BlockSize;
+    for (unsigned int k = block_row_buffer[block_row]; k < block_row_buffer[block_row + 1]; ++k)
+    {
+      vcl_size_t col_start = block_col_buffer[k] * BlockSize;
+      vcl_size_t col_stop  = std::min<vcl_size_t>(col_start + BlockSize, cols);
+      NumericT const * block_row_entries = block_elements + (vcl_size_t(k) * BlockSize + row % BlockSize) * BlockSize;
+      for (vcl_size_t col = col_start; col < col_stop; ++col, ++data_index)
+      {
+        col_buffer.set(data_index, col);
+        elements[data_index] = block_row_entries[col - col_start];
+      }
+    }
+  }
+  row_buffer.set(rows, data_index);
+
+  csr_mat.set(row_buffer.get(), col_buffer.get(), &(elements[0]), rows, cols, nonzeros);
+}
+
+
+//
+// Specify available operations:
+//
+
+/** \cond */
+
+namespace linalg
+{
+namespace detail
+{
+  // x = A * y
+  template<typename NumericT, unsigned int BlockSize>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x = A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  template<typename NumericT, unsigned int BlockSize>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x += A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  template<typename NumericT, unsigned int BlockSize>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x -= A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+
+  // x = A * vec_op
+  template<typename NumericT, unsigned int BlockSize, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  // x += A * vec_op
+  template<typename NumericT, unsigned int BlockSize, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  // x -= A * vec_op
+  template<typename NumericT, unsigned int BlockSize, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const bsr_matrix<NumericT, BlockSize>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+
+  // x = trans(A) * y
+  template<typename NumericT, unsigned int BlockSize>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const matrix_expression<const bsr_matrix<NumericT, BlockSize>, const bsr_matrix<NumericT, BlockSize>, op_trans>,
+                                                                         const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const matrix_expression<const bsr_matrix<NumericT, BlockSize>, const bsr_matrix<NumericT, BlockSize>, op_trans>,
+                                                                      const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x = trans(A) * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  template<typename NumericT, unsigned int BlockSize>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const matrix_expression<const bsr_matrix<NumericT, BlockSize>, const bsr_matrix<NumericT, BlockSize>, op_trans>,
+                                                                              const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const matrix_expression<const bsr_matrix<NumericT, BlockSize>, const bsr_matrix<NumericT, BlockSize>, op_trans>,
+                                                                      const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x += trans(A) * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  template<typename NumericT, unsigned int BlockSize>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const matrix_expression<const bsr_matrix<NumericT, BlockSize>, const bsr_matrix<NumericT, BlockSize>, op_trans>,
+                                                                              const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const matrix_expression<const bsr_matrix<NumericT, BlockSize>, const bsr_matrix<NumericT, BlockSize>, op_trans>,
+                                                                      const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x -= trans(A) * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+} // namespace detail
+} // namespace linalg
+
+/** \endcond */
+}
+
+#endif
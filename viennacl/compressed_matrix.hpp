@@ -1280,6 +1280,56 @@ namespace detail
   };
 
 
+  // x = A * y with single precision entries and double precision vectors
+  template<unsigned int A>
+  struct op_executor<vector_base<double>, op_assign, vector_expression<const compressed_matrix<float, A>, const vector_base<double>, op_prod> >
+  {
+    static void apply(vector_base<double> & lhs, vector_expression<const compressed_matrix<float, A>, const vector_base<double>, op_prod> const & rhs)
+    {
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<double> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, temp, 0.0);
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, lhs, 0.0);
+    }
+  };
+
+  template<unsigned int A>
+  struct op_executor<vector_base<double>, op_inplace_add, vector_expression<const compressed_matrix<float, A>, const vector_base<double>, op_prod> >
+  {
+    static void apply(vector_base<double> & lhs, vector_expression<const compressed_matrix<float, A>, const vector_base<double>, op_prod> const & rhs)
+    {
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<double> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, temp, 0.0);
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, lhs, 1.0);
+    }
+  };
+
+  template<unsigned int A>
+  struct op_executor<vector_base<double>, op_inplace_sub, vector_expression<const compressed_matrix<float, A>, const vector_base<double>, op_prod> >
+  {
+    static void apply(vector_base<double> & lhs, vector_expression<const compressed_matrix<float, A>, const vector_base<double>, op_prod> const & rhs)
+    {
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<double> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, temp, 0.0);
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), -1.0, lhs, 1.0);
+    }
+  };
+
+
   // x = A * vec_op
   template<typename T, unsigned int A, typename LHS, typename RHS, typename OP>
   struct op_executor<vector_base<T>, op_assign, vector_expression<const compressed_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
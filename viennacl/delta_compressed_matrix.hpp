@@ -0,0 +1,440 @@
+#ifndef VIENNACL_DELTA_COMPRESSED_MATRIX_HPP_
+#define VIENNACL_DELTA_COMPRESSED_MATRIX_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/delta_compressed_matrix.hpp
+    @brief Implementation of the delta_compressed_matrix class (CSR format with column indices stored as short offsets to a base column per row)
+*/
+
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+
+#include "viennacl/tools/tools.hpp"
+
+#include "viennacl/linalg/sparse_matrix_operations.hpp"
+
+namespace viennacl
+{
+/** @brief Sparse matrix class in compressed sparse row (CSR) format, where the column indices are stored as offsets of type DeltaT to a base column per row.
+  *
+  * The base column of a row is its smallest column index. With DeltaT being unsigned short (unsigned char), the memory traffic for the column indices is halved (quartered)
+  * compared to compressed_matrix for all rows with a column range below 65536 (256), which is the case for most rows of a banded matrix, e.g. after a reordering with viennacl::reorder().
+  * Rows with a larger column range ('wide' rows) fall back to full 32-bit column indices, stored in a separate array (handle4()). Only the other rows store offsets (handle2()).
+  *
+  * The per-row information (handle3()) holds the base column of each row with offsets, or wide_row_flag for a wide row. Thus, the number of columns must be smaller than 2^31.
+  * The offsets of a row start at its row pointer minus the number of entries in the wide rows above. This number is stored for every block of block_rows rows (handle5()),
+  * from which it is accumulated over the rows of the block.
+  *
+  * If the offsets do not save enough memory to pay for the per-row information, e.g. because most rows are wide, all rows keep full column indices
+  * and no per-row information is stored. The index data then equals the one of compressed_matrix, so it never exceeds the index data of compressed_matrix.
+  *
+  * The matrix resides in main memory. Operations are provided by the host backend only.
+  *
+  * @tparam NumericT    The floating point type
+  * @tparam DeltaT      The type of the column offsets, unsigned short or unsigned char
+  */
+template<typename NumericT, typename DeltaT>
+class delta_compressed_matrix
+{
+public:
+  typedef viennacl::backend::mem_handle                                                              handle_type;
+  typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<NumericT>::ResultType>     value_type;
+  typedef vcl_size_t                                                                                 size_type;
+
+  /** @brief Marks the entries of the per-row information referring to rows with full column indices */
+  static const unsigned int wide_row_flag = 0x80000000u;
+
+  /** @brief Number of rows per block for which the number of entries in the wide rows above is stored */
+  static const unsigned int block_rows = 64;
+
+  delta_compressed_matrix() : rows_(0), cols_(0), nonzeros_(0), wide_rows_(0), wide_nonzeros_(0) {}
+
+  /** @brief Construction of an empty matrix with the supplied number of rows and columns. Entries are supplied by copy() or by set(). */
+  delta_compressed_matrix(size_type num_rows, size_type num_cols) : rows_(num_rows), cols_(num_cols), nonzeros_(0), wide_rows_(0), wide_nonzeros_(0) {}
+
+  /** @brief Sets the entries from the row pointers and column indices of a matrix in CSR format. The column offsets are computed for each row.
+    *
+    * @param row_jumper     Start and stop indices in the column and entry array for each row (length rows+1)
+    * @param col_buffer     Column indices, sorted within each row
+    * @param elements       The nonzero entries
+    * @param rows           Number of rows
+    * @param cols           Number of columns
+    * @param nonzeros       Number of nonzero entries
+    */
+  void set(unsigned int const * row_jumper,
+           unsigned int const * col_buffer,
+           NumericT     const * elements,
+           size_type rows,
+           size_type cols,
+           size_type nonzeros)
+  {
+    assert( (rows > 0)     && bool("Error in delta_compressed_matrix::set(): Number of rows must be larger than zero!"));
+    assert( (nonzeros > 0) && bool("Error in delta_compressed_matrix::set(): Number of nonzeros must be larger than zero!"));
+    assert( (cols < wide_row_flag) && bool("Error in delta_compressed_matrix::set(): Number of columns must be smaller than 2^31!"));
+
+    size_type max_offset = static_cast<size_type>(std::numeric_limits<DeltaT>::max());
+
+    // determine the wide rows first, as they decide upon the layout:
+    std::vector<unsigned int> row_info(rows);
+    size_type wide_rows = 0;
+    size_type wide_nonzeros = 0;
+    for (size_type row = 0; row < rows; ++row)
+    {
+      unsigned int row_start = row_jumper[row];
+      unsigned int row_stop  = row_jumper[row+1];
+
+      if (row_start == row_stop)
+        row_info[row] = 0;
+      else if (static_cast<size_type>(col_buffer[row_stop - 1] - col_buffer[row_start]) <= max_offset)
+        row_info[row] = col_buffer[row_start];
+      else // column range too large for DeltaT, keep full column indices
+      {
+        row_info[row] = wide_row_flag;
+        wide_nonzeros += row_stop - row_start;
+        ++wide_rows;
+      }
+    }
+
+    size_type num_blocks = (rows - 1) / block_rows + 1;
+    size_type csr_bytes  = sizeof(unsigned int) * (rows + 1 + nonzeros);
+    size_type delta_bytes = sizeof(unsigned int) * (2 * rows + 1 + wide_nonzeros + (wide_rows > 0 ? num_blocks : 0)) + sizeof(DeltaT) * (nonzeros - wide_nonzeros);
+    bool plain_csr = (delta_bytes >= csr_bytes);
+
+    std::vector<DeltaT>       offsets;
+    std::vector<unsigned int> wide_cols;
+    std::vector<unsigned int> wide_block_start;
+    if (plain_csr) // offsets do not pay off, store all column indices in full
+    {
+      wide_rows = rows;
+      wide_nonzeros = nonzeros;
+      wide_cols.assign(col_buffer, col_buffer + nonzeros);
+    }
+    else
+    {
+      offsets.reserve(nonzeros - wide_nonzeros);
+      wide_cols.reserve(wide_nonzeros);
+      for (size_type row = 0; row < rows; ++row)
+      {
+        if (wide_rows > 0 && row % block_rows == 0)
+          wide_block_start.push_back(static_cast<unsigned int>(wide_cols.size()));
+
+        unsigned int row_start = row_jumper[row];
+        unsigned int row_stop  = row_jumper[row+1];
+        if (row_info[row] & wide_row_flag)
+          wide_cols.insert(wide_cols.end(), col_buffer + row_start, col_buffer + row_stop);
+        else
+          for (unsigned int i = row_start; i < row_stop; ++i)
+            offsets.push_back(static_cast<DeltaT>(col_buffer[i] - row_info[row]));
+      }
+    }
+
+    rows_ = rows;
+    cols_ = cols;
+    nonzeros_ = nonzeros;
+    wide_rows_ = wide_rows;
+    wide_nonzeros_ = wide_nonzeros;
+
+    viennacl::context host_context(viennacl::MAIN_MEMORY);
+    viennacl::backend::memory_create(row_buffer_, sizeof(unsigned int) * (rows + 1), host_context, row_jumper);
+    viennacl::backend::memory_create(elements_,   sizeof(NumericT) * nonzeros,       host_context, elements);
+    offsets_ = handle_type();
+    row_info_ = handle_type();
+    wide_cols_ = handle_type();
+    wide_block_start_ = handle_type();
+    if (offsets.size() > 0)
+      viennacl::backend::memory_create(offsets_, sizeof(DeltaT) * offsets.size(), host_context, &(offsets[0]));
+    if (!plain_csr)
+      viennacl::backend::memory_create(row_info_, sizeof(unsigned int) * rows, host_context, &(row_info[0]));
+    if (wide_cols.size() > 0)
+      viennacl::backend::memory_create(wide_cols_, sizeof(unsigned int) * wide_cols.size(), host_context, &(wide_cols[0]));
+    if (wide_block_start.size() > 0)
+      viennacl::backend::memory_create(wide_block_start_, sizeof(unsigned int) * wide_block_start.size(), host_context, &(wide_block_start[0]));
+  }
+
+  /** @brief Resets the matrix to the empty state, releasing all memory. */
+  void clear()
+  {
+    rows_ = 0;
+    cols_ = 0;
+    nonzeros_ = 0;
+    wide_rows_ = 0;
+    wide_nonzeros_ = 0;
+    row_buffer_ = handle_type();
+    offsets_ = handle_type();
+    row_info_ = handle_type();
+    wide_cols_ = handle_type();
+    wide_block_start_ = handle_type();
+    elements_ = handle_type();
+  }
+
+  /** @brief Returns the number of rows */
+  size_type size1() const { return rows_; }
+  /** @brief Returns the number of columns */
+  size_type size2() const { return cols_; }
+
+  /** @brief Returns the number of nonzero entries */
+  size_type nnz() const { return nonzeros_; }
+
+  /** @brief Returns the number of rows for which full column indices are stored, because their column range exceeds the range of DeltaT */
+  size_type wide_rows() const { return wide_rows_; }
+  /** @brief Returns the number of entries in rows with full column indices */
+  size_type wide_nnz() const { return wide_nonzeros_; }
+
+  /** @brief Returns true if all rows keep full column indices and no per-row information is stored, as the offsets would not save memory */
+  bool plain_csr() const { return nonzeros_ > 0 && wide_rows_ == rows_; }
+
+  /** @brief Returns the number of bytes used for the row pointers and the column information. Never exceeds (size1() + 1 + nnz()) * sizeof(unsigned int) for compressed_matrix. */
+  size_type index_bytes() const
+  {
+    if (rows_ == 0 || nonzeros_ == 0)
+      return 0;
+    if (plain_csr())
+      return sizeof(unsigned int) * (rows_ + 1 + nonzeros_);
+    size_type num_blocks = (wide_rows_ > 0) ? (rows_ - 1) / block_rows + 1 : 0;
+    return sizeof(unsigned int) * (2 * rows_ + 1 + wide_nonzeros_ + num_blocks) + sizeof(DeltaT) * (nonzeros_ - wide_nonzeros_);
+  }
+
+  /** @brief Returns the memory handle to the row index array */
+  const handle_type & handle1() const { return row_buffer_; }
+  /** @brief Returns the memory handle to the column offset array */
+  const handle_type & handle2() const { return offsets_; }
+  /** @brief Returns the memory handle to the per-row information (base column or wide_row_flag), empty if plain_csr() */
+  const handle_type & handle3() const { return row_info_; }
+  /** @brief Returns the memory handle to the full column indices of the rows exceeding the range of DeltaT */
+  const handle_type & handle4() const { return wide_cols_; }
+  /** @brief Returns the memory handle to the number of entries in the wide rows above each block of block_rows rows */
+  const handle_type & handle5() const { return wide_block_start_; }
+  /** @brief Returns the memory handle to the matrix entry array */
+  const handle_type & handle() const { return elements_; }
+
+  /** @brief Returns the memory handle to the row index array */
+  handle_type & handle1() { return row_buffer_; }
+  /** @brief Returns the memory handle to the column offset array */
+  handle_type & handle2() { return offsets_; }
+  /** @brief Returns the memory handle to the per-row information (base column or wide_row_flag), empty if plain_csr() */
+  handle_type & handle3() { return row_info_; }
+  /** @brief Returns the memory handle to the full column indices of the rows exceeding the range of DeltaT */
+  handle_type & handle4() { return wide_cols_; }
+  /** @brief Returns the memory handle to the number of entries in the wide rows above each block of block_rows rows */
+  handle_type & handle5() { return wide_block_start_; }
+  /** @brief Returns the memory handle to the matrix entry array */
+  handle_type & handle() { return elements_; }
+
+private:
+  size_type rows_;
+  size_type cols_;
+  size_type nonzeros_;
+  size_type wide_rows_;
+  size_type wide_nonzeros_;
+  handle_type row_buffer_;
+  handle_type offsets_;
+  handle_type row_info_;
+  handle_type wide_cols_;
+  handle_type wide_block_start_;
+  handle_type elements_;
+};
+
+template<typename NumericT, typename DeltaT>
+const unsigned int delta_compressed_matrix<NumericT, DeltaT>::wide_row_flag;
+
+template<typename NumericT, typename DeltaT>
+const unsigned int delta_compressed_matrix<NumericT, DeltaT>::block_rows;
+
+
+/** @brief Copies a sparse matrix given as a STL vector of maps to a delta_compressed_matrix.
+  *
+  * @param cpu_matrix   A sparse matrix on the host
+  * @param dc_mat       The delta_compressed_matrix
+  */
+template<typename SizeT, typename NumericT, typename DeltaT>
+void copy(std::vector< std::map<SizeT, NumericT> > const & cpu_matrix,
+          delta_compressed_matrix<NumericT, DeltaT> & dc_mat)
+{
+  vcl_size_t rows = cpu_matrix.size();
+  vcl_size_t cols = 0;
+
+  std::vector<unsigned int> row_buffer(rows + 1);
+  std::vector<unsigned int> col_buffer;
+  std::vector<NumericT>     elements;
+
+  for (vcl_size_t row = 0; row < rows; ++row)
+  {
+    row_buffer[row] = static_cast<unsigned int>(col_buffer.size());
+    for (typename std::map<SizeT, NumericT>::const_iterator it = cpu_matrix[row].begin(); it != cpu_matrix[row].end(); ++it)
+    {
+      col_buffer.push_back(static_cast<unsigned int>(it->first));
+      elements.push_back(it->second);
+      cols = std::max<vcl_size_t>(cols, static_cast<vcl_size_t>(it->first) + 1);
+    }
+  }
+  row_buffer[rows] = static_cast<unsigned int>(col_buffer.size());
+
+  if (col_buffer.empty())
+  {
+    dc_mat.clear();
+    return;
+  }
+
+  dc_mat.set(&(row_buffer[0]), &(col_buffer[0]), &(elements[0]), rows, std::max(cols, dc_mat.size2()), col_buffer.size());
+}
+
+
+/** @brief Copies a compressed_matrix to a delta_compressed_matrix.
+  *
+  * @param csr_mat      The compressed_matrix, may reside in any memory domain
+  * @param dc_mat       The delta_compressed_matrix in main memory
+  */
+template<typename NumericT, unsigned int AlignmentV, typename DeltaT>
+void copy(compressed_matrix<NumericT, AlignmentV> const & csr_mat,
+          delta_compressed_matrix<NumericT, DeltaT> & dc_mat)
+{
+  if (csr_mat.size1() == 0 || csr_mat.nnz() == 0)
+  {
+    dc_mat.clear();
+    return;
+  }
+
+  //get raw data from memory:
+  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(csr_mat.handle1(), csr_mat.size1() + 1);
+  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(csr_mat.handle2(), csr_mat.nnz());
+  std::vector<NumericT> elements(csr_mat.nnz());
+
+  viennacl::backend::memory_read(csr_mat.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+  viennacl::backend::memory_read(csr_mat.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+  viennacl::backend::memory_read(csr_mat.handle(),  0, sizeof(NumericT) * csr_mat.nnz(), &(elements[0]));
+
+  std::vector<unsigned int> rows(csr_mat.size1() + 1);
+  std::vector<unsigned int> cols(csr_mat.nnz());
+  for (vcl_size_t i = 0; i < rows.size(); ++i)
+    rows[i] = static_cast<unsigned int>(row_buffer[i]);
+  for (vcl_size_t i = 0; i < cols.size(); ++i)
+    cols[i] = static_cast<unsigned int>(col_buffer[i]);
+
+  dc_mat.set(&(rows[0]), &(cols[0]), &(elements[0]), csr_mat.size1(), csr_mat.size2(), csr_mat.nnz());
+}
+
+
+//
+// Specify available operations:
+//
+
+/** \cond */
+
+namespace linalg
+{
+namespace detail
+{
+  // x = A * y
+  template<typename NumericT, typename DeltaT>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x = A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  template<typename NumericT, typename DeltaT>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x += A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  template<typename NumericT, typename DeltaT>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x -= A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+
+  // x = A * vec_op
+  template<typename NumericT, typename DeltaT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  // x += A * vec_op
+  template<typename NumericT, typename DeltaT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  // x -= A * vec_op
+  template<typename NumericT, typename DeltaT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const delta_compressed_matrix<NumericT, DeltaT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+} // namespace detail
+} // namespace linalg
+
+/** \endcond */
+}
+
+#endif
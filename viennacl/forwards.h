@@ -426,6 +426,18 @@ namespace viennacl
   template<typename ScalarT, typename IndexT = unsigned int>
   class sliced_ell_matrix;
 
+  template<typename NumericT, unsigned int BlockSize>
+  class bsr_matrix;
+
+  template<typename NumericT>
+  class symmetric_compressed_matrix;
+
+  template<typename NumericT, typename DeltaT = unsigned short>
+  class delta_compressed_matrix;
+
+  template<typename NumericT>
+  class auto_sparse_matrix;
+
   template<class SCALARTYPE, unsigned int ALIGNMENT = 1>
   class hyb_matrix;
 
@@ -539,6 +551,27 @@ namespace viennacl
   };
 
 
+  /** @brief Helper class for checking whether a matrix is a bsr_matrix (block CSR format) */
+  template<typename T>
+  struct is_bsr_matrix
+  {
+    enum { value = false };
+  };
+
+  /** @brief Helper class for checking whether a matrix is a symmetric_compressed_matrix (CSR format holding the upper triangle) */
+  template<typename T>
+  struct is_symmetric_compressed_matrix
+  {
+    enum { value = false };
+  };
+
+  /** @brief Helper class for checking whether a matrix is a delta_compressed_matrix (CSR format with column indices stored as offsets to a base column per row) */
+  template<typename T>
+  struct is_delta_compressed_matrix
+  {
+    enum { value = false };
+  };
+
   /** @brief Helper class for checking whether a matrix is a hyb_matrix (hybrid format: ELL plus CSR) */
   template<typename T>
   struct is_hyb_matrix
@@ -68,23 +68,35 @@ private:
 namespace detail
 {
   /** @brief Sparse Galerkin product: Calculates A_coarse = trans(P)*A_fine*P = R*A_fine*P
+    *
+    * In main memory, the product is computed by a fused kernel which forms neither R nor the intermediate A_fine*P.
+    * Its symbolic phase is recorded in 'plan' for recomputing the product with new values. Other backends compute R*(A_fine*P) instead.
     *
     * @param A_fine    Operator matrix on fine grid (quadratic)
     * @param P         Prolongation/Interpolation matrix
     * @param R         Restriction matrix
     * @param A_coarse  Result matrix on coarse grid (Galerkin operator)
+    * @param plan      Symbolic phase of the Galerkin product
     */
   template<typename NumericT>
   void amg_galerkin_prod(compressed_matrix<NumericT> & A_fine,
                          compressed_matrix<NumericT> & P,
                          compressed_matrix<NumericT> & R, //P^T
-                         compressed_matrix<NumericT> & A_coarse)
+                         compressed_matrix<NumericT> & A_coarse,
+                         detail::amg::amg_galerkin_plan & plan)
   {
+    // transpose P in memory (required for the restriction when applying the preconditioner):
+    viennacl::linalg::detail::amg::amg_transpose(P, R);
 
-    compressed_matrix<NumericT> A_fine_times_P(viennacl::traits::context(A_fine));
+    if (viennacl::traits::active_handle_id(A_fine) == viennacl::MAIN_MEMORY)
+    {
+      viennacl::linalg::host_based::amg::amg_galerkin_prod_symbolic(A_fine, P, A_coarse, plan);
+      return;
+    }
 
-    // transpose P in memory (no known way of efficiently multiplying P^T * B for CSR-matrices P and B):
-    viennacl::linalg::detail::amg::amg_transpose(P, R);
+    plan.clear();
+
+    compressed_matrix<NumericT> A_fine_times_P(viennacl::traits::context(A_fine));
 
     // compute Galerkin product using a temporary for the result of A_fine * P
     A_fine_times_P = viennacl::linalg::prod(A_fine, P);
@@ -93,6 +105,32 @@ namespace detail
   }
 
 
+  /** @brief Recomputes the Galerkin product A_coarse = trans(P)*A_fine*P for new values of A_fine and P.
+    *
+    * If A_fine resides in main memory and the sparsity patterns of A_fine and P are unchanged, only the numeric phase recorded in 'plan' is carried out.
+    * Otherwise, the product is recomputed by amg_galerkin_prod().
+    */
+  template<typename NumericT>
+  void amg_galerkin_prod_update(compressed_matrix<NumericT> & A_fine,
+                                compressed_matrix<NumericT> & P,
+                                compressed_matrix<NumericT> & R, //P^T
+                                compressed_matrix<NumericT> & A_coarse,
+                                detail::amg::amg_galerkin_plan & plan)
+  {
+    if (viennacl::traits::active_handle_id(A_fine) == viennacl::MAIN_MEMORY
+        && viennacl::linalg::host_based::amg::amg_galerkin_plan_matches(A_fine, P, plan))
+    {
+      viennacl::linalg::detail::amg::amg_transpose(P, R);
+
+      A_coarse.switch_memory_context(viennacl::traits::context(A_fine));
+      viennacl::linalg::host_based::amg::amg_galerkin_prod_numeric(A_fine, P, A_coarse, plan);
+      return;
+    }
+
+    amg_galerkin_prod(A_fine, P, R, A_coarse, plan);
+  }
+
+
   /** @brief Setup AMG preconditioner
   *
   * @param list_of_A                  Operator matrices on all levels
@@ -140,7 +178,7 @@ namespace detail
       detail::amg::amg_interpol(list_of_A[i], list_of_P[i], list_of_amg_level_context[i], tag);
 
       // Compute coarse grid operator (A[i+1] = R * A[i] * P) with R = trans(P).
-      amg_galerkin_prod(list_of_A[i], list_of_P[i], list_of_R[i], list_of_A[i+1]);
+      amg_galerkin_prod(list_of_A[i], list_of_P[i], list_of_R[i], list_of_A[i+1], list_of_amg_level_context[i].galerkin_plan_);
 
       // send matrices to target context:
       list_of_A[i].switch_memory_context(tag.get_target_context());
@@ -156,6 +194,47 @@ namespace detail
   }
 
 
+  /** @brief Re-setup of the AMG preconditioner after the values of the operator on the finest level have changed.
+  *
+  * The coarse points, aggregates, and strong influences from a previous run of amg_setup() are kept.
+  * Only the interpolation operators (see amg_interpol_update()) and the coarse grid operators are recomputed.
+  *
+  * @param list_of_A                  Operator matrices on all levels. The operator on the finest level holds the new values.
+  * @param list_of_P                  Prolongation/Interpolation operators on all levels
+  * @param list_of_R                  Restriction operators on all levels
+  * @param list_of_amg_level_context  Auxiliary datastructures for managing the grid hierarchy (coarse nodes, etc.)
+  * @param coarse_levels              Number of coarse levels as returned by amg_setup()
+  * @param tag                        AMG preconditioner tag
+  */
+  template<typename NumericT, typename AMGContextListT>
+  void amg_resetup(std::vector<compressed_matrix<NumericT> > & list_of_A,
+                   std::vector<compressed_matrix<NumericT> > & list_of_P,
+                   std::vector<compressed_matrix<NumericT> > & list_of_R,
+                   AMGContextListT & list_of_amg_level_context,
+                   vcl_size_t coarse_levels,
+                   amg_tag & tag)
+  {
+    for (vcl_size_t i=0; i<coarse_levels; ++i)
+    {
+      list_of_A[i].switch_memory_context(tag.get_setup_context());
+      list_of_P[i].switch_memory_context(tag.get_setup_context());
+      list_of_R[i].switch_memory_context(tag.get_setup_context());
+      list_of_A[i+1].switch_memory_context(tag.get_setup_context());
+
+      // Update interpolation matrix for level i.
+      detail::amg::amg_interpol_update(list_of_A[i], list_of_P[i], list_of_amg_level_context[i], tag);
+
+      // Update coarse grid operator (A[i+1] = R * A[i] * P) with R = trans(P).
+      amg_galerkin_prod_update(list_of_A[i], list_of_P[i], list_of_R[i], list_of_A[i+1], list_of_amg_level_context[i].galerkin_plan_);
+
+      // send matrices to target context:
+      list_of_A[i].switch_memory_context(tag.get_target_context());
+      list_of_P[i].switch_memory_context(tag.get_target_context());
+      list_of_R[i].switch_memory_context(tag.get_target_context());
+    }
+  }
+
+
   /** @brief Initialize AMG preconditioner
   *
   * @param mat                        System matrix
@@ -185,6 +264,38 @@ namespace detail
     list_of_A[0].switch_memory_context(tag.get_setup_context());
   }
 
+  /** @brief Returns true if the two matrices have the same sparsity pattern. The matrices may reside in different memory domains.
+  */
+  template<typename NumericT, unsigned int AlignmentV1, unsigned int AlignmentV2>
+  bool amg_same_sparsity_pattern(compressed_matrix<NumericT, AlignmentV1> const & A, compressed_matrix<NumericT, AlignmentV2> const & B)
+  {
+    if (A.size1() != B.size1() || A.size2() != B.size2() || A.nnz() != B.nnz())
+      return false;
+    if (A.size1() == 0)
+      return true;
+
+    viennacl::backend::typesafe_host_array<unsigned int> A_row_buffer(A.handle1(), A.size1() + 1);
+    viennacl::backend::typesafe_host_array<unsigned int> B_row_buffer(B.handle1(), B.size1() + 1);
+    viennacl::backend::memory_read(A.handle1(), 0, A_row_buffer.raw_size(), A_row_buffer.get());
+    viennacl::backend::memory_read(B.handle1(), 0, B_row_buffer.raw_size(), B_row_buffer.get());
+    for (vcl_size_t i = 0; i <= A.size1(); ++i)
+      if (A_row_buffer[i] != B_row_buffer[i])
+        return false;
+
+    if (A.nnz() == 0)
+      return true;
+
+    viennacl::backend::typesafe_host_array<unsigned int> A_col_buffer(A.handle2(), A.nnz());
+    viennacl::backend::typesafe_host_array<unsigned int> B_col_buffer(B.handle2(), B.nnz());
+    viennacl::backend::memory_read(A.handle2(), 0, A_col_buffer.raw_size(), A_col_buffer.get());
+    viennacl::backend::memory_read(B.handle2(), 0, B_col_buffer.raw_size(), B_col_buffer.get());
+    for (vcl_size_t i = 0; i < A.nnz(); ++i)
+      if (A_col_buffer[i] != B_col_buffer[i])
+        return false;
+
+    return true;
+  }
+
   /** @brief Setup data structures for precondition phase for later use on the GPU
   *
   * @param result          Result vector on all levels
@@ -297,6 +408,43 @@ public:
   }
 
 
+  /** @brief Re-setup for a new system matrix, e.g. in the next time step.
+  *
+  * If the sparsity pattern of the system matrix is unchanged, the coarsening (C/F splitting, aggregates) and the sparsity patterns of the interpolation operators from setup() are kept.
+  * Only the values of the interpolation operators, the coarse grid operators, and the factorization on the coarsest level are recomputed.
+  * Falls back to a full setup() if the sparsity pattern has changed or if no coarse levels have been set up before.
+  *
+  * @param mat  New system matrix
+  */
+  void resetup(compressed_matrix<NumericT, AlignmentV> const & mat)
+  {
+    vcl_size_t num_coarse_levels = residual_list_.size();
+    if (num_coarse_levels == 0 || A_list_.empty() || !detail::amg_same_sparsity_pattern(A_list_[0], mat))
+    {
+      // discard the hierarchy, setup() assumes freshly initialized levels:
+      A_list_.clear();
+      P_list_.clear();
+      R_list_.clear();
+      amg_context_list_.clear();
+      result_list_.clear();
+      result_backup_list_.clear();
+      rhs_list_.clear();
+      residual_list_.clear();
+      detail::amg_init(mat, A_list_, P_list_, R_list_, amg_context_list_, tag_);
+      setup();
+      return;
+    }
+
+    A_list_[0].switch_memory_context(viennacl::traits::context(mat));
+    A_list_[0] = mat;
+    A_list_[0].switch_memory_context(tag_.get_setup_context());
+
+    detail::amg_resetup(A_list_, P_list_, R_list_, amg_context_list_, num_coarse_levels, tag_);
+
+    detail::amg_lu(coarsest_op_, A_list_[num_coarse_levels], tag_);
+  }
+
+
   /** @brief Precondition Operation
   *
   * @param vec       The vector to which preconditioning is applied to
@@ -128,6 +128,39 @@ void amg_interpol(compressed_matrix<NumericT> const & A,
 }
 
 
+/** @brief Recomputes the interpolation operator P for a new operator A with the same sparsity pattern, keeping the coarsening stored in 'amg_context'.
+  *
+  * Only the host backend updates the values of P in place, other backends recompute the interpolation operator.
+  */
+template<typename NumericT, typename AMGContextT>
+void amg_interpol_update(compressed_matrix<NumericT> const & A,
+                         compressed_matrix<NumericT>       & P,
+                         AMGContextT & amg_context,
+                         amg_tag & tag)
+{
+  switch (viennacl::traits::handle(A).get_active_handle_id())
+  {
+    case viennacl::MAIN_MEMORY:
+      viennacl::linalg::host_based::amg::amg_interpol_update(A, P, amg_context, tag);
+      break;
+#ifdef VIENNACL_WITH_OPENCL
+    case viennacl::OPENCL_MEMORY:
+      viennacl::linalg::opencl::amg::amg_interpol(A, P, amg_context, tag);
+      break;
+#endif
+#ifdef VIENNACL_WITH_CUDA
+    case viennacl::CUDA_MEMORY:
+      viennacl::linalg::cuda::amg::amg_interpol(A, P, amg_context, tag);
+      break;
+#endif
+    case viennacl::MEMORY_NOT_INITIALIZED:
+      throw memory_exception("not initialised!");
+    default:
+      throw memory_exception("not implemented");
+  }
+}
+
+
 template<typename NumericT>
 void amg_transpose(compressed_matrix<NumericT> & A,
                    compressed_matrix<NumericT> & B)
@@ -117,8 +117,8 @@ bisect(VectorT const & alphas, VectorT const & betas)
 
   for (vcl_size_t i = 0; i < size; i++)
   {
-    x_temp[i] = xmax;
-    wu.push_back(xmin);
+    x_temp[i] = static_cast<CPU_NumericType>(xmax);
+    wu.push_back(static_cast<CPU_NumericType>(xmin));
   }
 
   for (long k = static_cast<long>(size) - 1; k >= 0; --k)
@@ -156,12 +156,12 @@ bisect(VectorT const & alphas, VectorT const & betas)
       {
         xu = x1;
         if (a < 1)
-          wu[0] = x1;
+          wu[0] = static_cast<CPU_NumericType>(x1);
         else
         {
-          wu[a] = x1;
+          wu[a] = static_cast<CPU_NumericType>(x1);
           if (x_temp[a - 1] > x1)
-              x_temp[a - 1] = x1;
+              x_temp[a - 1] = static_cast<CPU_NumericType>(x1);
         }
       }
       else
@@ -169,7 +169,7 @@ bisect(VectorT const & alphas, VectorT const & betas)
 
       x1 = (xu + x0) / 2.0;
     }
-    x_temp[vcl_size_t(k)] = x1;
+    x_temp[vcl_size_t(k)] = static_cast<CPU_NumericType>(x1);
   }
   return x_temp;
 }
@@ -0,0 +1,356 @@
+#ifndef VIENNACL_LINALG_BLOCK_CG_HPP_
+#define VIENNACL_LINALG_BLOCK_CG_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/block_cg.hpp
+    @brief The block conjugate gradient method for multiple right-hand sides is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/tsqr.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/krylov/small_dense.hpp"
+#include "viennacl/linalg/detail/krylov/block_columns.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the block conjugate gradient solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class block_cg_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol              Relative tolerance for the residual of each right-hand side (solver quits if ||r_i|| < tol * ||b_i|| for all i)
+  * @param max_iterations   The maximum number of iterations
+  */
+  block_cg_tag(double tol = 1e-8, unsigned int max_iterations = 300)
+    : tol_(tol), abs_tol_(0), iterations_(max_iterations), basis_tol_(1e-10), iters_taken_(0), last_error_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  unsigned int max_iterations() const { return iterations_; }
+
+  /** @brief Returns the tolerance below which a new search direction is considered numerically dependent on the others of the block and dropped */
+  double basis_tolerance() const { return basis_tol_; }
+  /** @brief Sets the tolerance below which a new search direction is considered numerically dependent on the others of the block and dropped */
+  void basis_tolerance(double new_tol) { if (new_tol >= 0) basis_tol_ = new_tol; }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the largest estimated relative error of all right-hand sides at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  double basis_tol_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Implementation of the block conjugate gradient method (no preconditioner).
+  *
+  * Uses the breakdown-free variant of H. Ji and Y. Li, BIT 57 (2017), which orthonormalizes the block of search directions in each iteration
+  * and drops directions which are numerically linearly dependent on the others.
+  * All right-hand sides share one sparse matrix-dense matrix product per iteration, the recurrence coefficients are obtained from small Gram matrices.
+  * Right-hand sides which have converged are removed from the block (deflation), so that the remaining ones continue with a narrower block.
+  */
+  template<typename MatrixT, typename NumericT>
+  viennacl::matrix<NumericT, viennacl::column_major> block_cg_solve(MatrixT const & A,
+                                                                   viennacl::matrix_base<NumericT> const & rhs,
+                                                                   block_cg_tag const & tag)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef viennacl::matrix_range<BlockType>                    BlockRangeType;
+
+    vcl_size_t n = rhs.size1();
+    vcl_size_t num_rhs = rhs.size2();
+    viennacl::context ctx = viennacl::traits::context(rhs);
+
+    BlockType result(n, num_rhs, ctx);
+    if (n == 0 || num_rhs == 0)
+    {
+      tag.iters(0);
+      tag.error(0);
+      return result;
+    }
+
+    // X and B hold the solutions and the right-hand sides which have not converged yet.
+    // Columns of Z: the images Q = AP of the search directions (right-aligned in the first num_rhs columns, such that [Q, R] is contiguous)
+    // and the residuals R of the right-hand sides which have not converged yet.
+    BlockType Z(n, 2 * num_rhs, ctx);
+    BlockType X(n, num_rhs, ctx);
+    BlockType B(n, num_rhs, ctx);
+    BlockType P_buffer_1(n, num_rhs, ctx);
+    BlockType P_buffer_2(n, num_rhs, ctx);
+    BlockType * P     = &P_buffer_1;
+    BlockType * P_new = &P_buffer_2;
+
+    viennacl::matrix<NumericT> gram(2 * num_rhs, 2 * num_rhs, ctx);
+    viennacl::matrix<NumericT> small_coeffs(num_rhs, num_rhs, ctx);
+
+    viennacl::range all_rows(0, n);
+    BlockRangeType R_initial(Z, all_rows, viennacl::range(num_rhs, 2 * num_rhs));
+    copy_to_block_columns(rhs, Z, num_rhs);
+    copy_to_block_columns(rhs, B, 0);
+
+    double pivot_tolerance = std::max(tag.basis_tolerance(), 100.0 * static_cast<double>(std::numeric_limits<NumericT>::epsilon()));
+
+    // active[i] is the right-hand side held in column i of X and R:
+    std::vector<vcl_size_t> active(num_rhs);
+    for (vcl_size_t i = 0; i < num_rhs; ++i)
+      active[i] = i;
+    viennacl::matrix<NumericT> rhs_gram(num_rhs, num_rhs, ctx);
+    std::vector<double> norm_rhs = block_column_norms(R_initial, rhs_gram);
+    std::vector<double> norm_r = norm_rhs;
+    std::vector<double> final_error(num_rhs, 0.0);
+
+    vcl_size_t k = 0;                        // number of search directions
+    std::vector<double> PQ;                  // Cholesky factor of P^T A P
+    std::vector<double> beta;                // P^T A R, becomes the coefficients of P in the new search directions
+    unsigned int iters = 0;
+
+    for (;;)
+    {
+      vcl_size_t p = active.size();
+
+      // remove the converged right-hand sides from the block:
+      std::vector<vcl_size_t> keep;
+      for (vcl_size_t i = 0; i < p; ++i)
+      {
+        vcl_size_t j = active[i];
+        bool converged = norm_r[i] <= tag.tolerance() * norm_rhs[j] || norm_r[i] <= tag.abs_tolerance();
+        if (converged || iters >= tag.max_iterations())
+        {
+          copy_block_column(X, i, result, j);
+          final_error[j] = (norm_rhs[j] > 0) ? norm_r[i] / norm_rhs[j] : 0;
+        }
+        else
+          keep.push_back(i);
+      }
+      if (keep.size() < p)
+      {
+        compact_block_columns(X, 0, keep);
+        compact_block_columns(B, 0, keep);
+        compact_block_columns(Z, num_rhs, keep);
+        for (vcl_size_t i = 0; i < keep.size(); ++i)
+        {
+          active[i] = active[keep[i]];
+          norm_r[i] = norm_r[keep[i]];
+          for (vcl_size_t l = 0; l < k; ++l)
+            beta[l * num_rhs + i] = beta[l * num_rhs + keep[i]];
+        }
+        p = keep.size();
+        active.resize(p);
+      }
+      if (p == 0)
+        break;
+
+      BlockRangeType R(Z, all_rows, viennacl::range(num_rhs, num_rhs + p));
+      BlockRangeType W(*P_new, all_rows, viennacl::range(0, p));
+
+      // new search directions: orthonormal basis of R - P (P^T A P)^{-1} P^T A R
+      static_cast<viennacl::matrix_base<NumericT> &>(W) = R;
+      if (k > 0)
+      {
+        std::vector<double> coeffs(k * p);
+        std::vector<double> b(k);
+        for (vcl_size_t i = 0; i < p; ++i)
+        {
+          for (vcl_size_t l = 0; l < k; ++l)
+            b[l] = beta[l * num_rhs + i];
+          small_cholesky_solve(PQ, k, k, b);
+          for (vcl_size_t l = 0; l < k; ++l)
+            coeffs[l * p + i] = -b[l];
+        }
+        write_small_matrix(coeffs, k, p, small_coeffs);
+
+        BlockRangeType P_old(*P, all_rows, viennacl::range(0, k));
+        W += viennacl::linalg::prod(P_old, small_coeffs);
+      }
+
+      std::vector<double> W_R;
+      viennacl::linalg::tsqr(W, W_R);
+
+      std::vector<vcl_size_t> independent;
+      for (vcl_size_t i = 0; i < p; ++i)
+      {
+        double norm_squared = 0;
+        for (vcl_size_t l = 0; l <= i; ++l)
+          norm_squared += W_R[l * p + i] * W_R[l * p + i];
+        if (W_R[i * p + i] * W_R[i * p + i] > pivot_tolerance * norm_squared)
+          independent.push_back(i);
+      }
+      if (independent.empty()) // residuals numerically zero
+      {
+        for (vcl_size_t i = 0; i < p; ++i)
+          norm_r[i] = 0;
+        continue;
+      }
+      k = independent.size();
+      if (k < p)
+      {
+        // W = Q R with Q from the TSQR, where the columns of Q belonging to the dependent columns of W are arbitrary.
+        // The span of the independent columns of W is spanned by Q times an orthonormal basis of the respective columns of R:
+        std::vector<double> R_independent(p * k);
+        for (vcl_size_t i = 0; i < p; ++i)
+          for (vcl_size_t l = 0; l < k; ++l)
+            R_independent[i * k + l] = W_R[i * p + independent[l]];
+        write_small_matrix(small_orthonormal_columns(R_independent, p, k), p, k, small_coeffs);
+
+        BlockRangeType P_target(*P, all_rows, viennacl::range(0, k));
+        P_target = viennacl::linalg::prod(W, small_coeffs);
+      }
+      else
+        std::swap(P, P_new);
+
+      // Q = A P, then the Gram matrix P^T [Q, R] yields P^T A P and P^T R:
+      BlockRangeType P_current(*P, all_rows, viennacl::range(0, k));
+      BlockRangeType Q(Z, all_rows, viennacl::range(num_rhs - k, num_rhs));
+      BlockRangeType QR(Z, all_rows, viennacl::range(num_rhs - k, num_rhs + p));
+      viennacl::linalg::prod_impl(A, P_current, Q);
+
+      viennacl::matrix_range<viennacl::matrix<NumericT> > gram_PQR(gram, viennacl::range(0, k), viennacl::range(0, k + p));
+      gram_PQR = viennacl::linalg::prod(viennacl::trans(P_current), QR);
+      std::vector<double> G;
+      read_small_matrix(gram, G);
+
+      PQ.resize(k * k);
+      for (vcl_size_t i = 0; i < k; ++i)
+        for (vcl_size_t l = 0; l < k; ++l)
+          PQ[i * k + l] = 0.5 * (G[i * 2 * num_rhs + l] + G[l * 2 * num_rhs + i]);
+      vcl_size_t rank = small_cholesky(PQ, k, 0.0);
+
+      // alpha = (P^T A P)^{-1} P^T R, restricted to the directions with positive curvature:
+      std::vector<double> alpha(k * p, 0.0);
+      std::vector<double> b(k);
+      for (vcl_size_t i = 0; i < p; ++i)
+      {
+        for (vcl_size_t l = 0; l < rank; ++l)
+          b[l] = G[l * 2 * num_rhs + k + i];
+        small_cholesky_solve(PQ, k, rank, b);
+        for (vcl_size_t l = 0; l < rank; ++l)
+          alpha[l * p + i] = b[l];
+      }
+      write_small_matrix(alpha, k, p, small_coeffs);
+
+      BlockRangeType X_active(X, all_rows, viennacl::range(0, p));
+      X_active += viennacl::linalg::prod(P_current, small_coeffs);
+      R        -= viennacl::linalg::prod(Q, small_coeffs);
+      ++iters;
+
+      // the Gram matrix [Q, R]^T R yields Q^T R for the next search directions and the residual norms.
+      // Before right-hand sides are removed from the block, the residuals are replaced by the true residuals, as the recurrence may have drifted away:
+      viennacl::matrix_range<viennacl::matrix<NumericT> > gram_QRR(gram, viennacl::range(0, k + p), viennacl::range(0, p));
+      for (unsigned int pass = 0; pass < 2; ++pass)
+      {
+        gram_QRR = viennacl::linalg::prod(viennacl::trans(QR), R);
+        read_small_matrix(gram, G);
+
+        bool any_converged = false;
+        for (vcl_size_t i = 0; i < p; ++i)
+        {
+          norm_r[i] = std::sqrt(std::max(G[(k + i) * 2 * num_rhs + i], 0.0));
+          any_converged = any_converged || norm_r[i] <= tag.tolerance() * norm_rhs[active[i]] || norm_r[i] <= tag.abs_tolerance();
+        }
+        if (!any_converged || pass > 0)
+          break;
+
+        BlockRangeType B_active(B, all_rows, viennacl::range(0, p));
+        viennacl::linalg::prod_impl(A, X_active, R);
+        R = B_active - R;
+      }
+
+      beta.assign(k * num_rhs, 0.0);
+      for (vcl_size_t l = 0; l < rank; ++l)
+        for (vcl_size_t i = 0; i < p; ++i)
+          beta[l * num_rhs + i] = G[l * 2 * num_rhs + i];
+
+      if (rank < k) // keep the leading directions with positive curvature only
+      {
+        for (vcl_size_t i = 0; i < rank; ++i)
+          for (vcl_size_t l = 0; l < rank; ++l)
+            PQ[i * rank + l] = PQ[i * k + l];
+        k = rank;
+      }
+    }
+
+    tag.iters(iters);
+    tag.error(*std::max_element(final_error.begin(), final_error.end()));
+
+    return result;
+  }
+
+}
+
+
+/** @brief Solves A X = B for multiple right-hand sides (the columns of B) with the block conjugate gradient method. A must be one of the ViennaCL sparse matrix types.
+*
+* @param A          The system matrix
+* @param rhs        The right-hand sides, one per column
+* @param tag        Solver configuration tag
+* @return The solutions, one per column
+*/
+template<typename MatrixT, typename NumericT>
+viennacl::matrix<NumericT, viennacl::column_major> solve(MatrixT const & A, viennacl::matrix_base<NumericT> const & rhs, block_cg_tag const & tag, viennacl::linalg::no_precond)
+{
+  return detail::block_cg_solve(A, rhs, tag);
+}
+
+/** @brief Convenience overload for calling the block CG solver without preconditioner */
+template<typename MatrixT, typename NumericT>
+viennacl::matrix<NumericT, viennacl::column_major> solve(MatrixT const & A, viennacl::matrix_base<NumericT> const & rhs, block_cg_tag const & tag)
+{
+  return detail::block_cg_solve(A, rhs, tag);
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef VIENNACL_LINALG_BLOCK_GMRES_HPP_
+#define VIENNACL_LINALG_BLOCK_GMRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/block_gmres.hpp
+    @brief Implementation of the block GMRES solver for multiple right-hand sides.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/tsqr.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/krylov/small_dense.hpp"
+#include "viennacl/linalg/detail/krylov/block_columns.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the block GMRES solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class block_gmres_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol            Relative tolerance for the residual of each right-hand side (solver quits if ||r_i|| < tol * ||b_i|| for all i)
+  * @param max_iterations The maximum number of block iterations (including restarts)
+  * @param krylov_dim     The maximum number of blocks of Krylov vectors before restart
+  */
+  block_gmres_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20)
+   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim > 0 ? krylov_dim : 1), basis_tol_(1e-10), iters_taken_(0), last_error_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of block iterations */
+  unsigned int max_iterations() const { return iterations_; }
+  /** @brief Returns the maximum number of blocks of Krylov vectors before restart */
+  unsigned int krylov_dim() const { return krylov_dim_; }
+
+  /** @brief Returns the tolerance below which a new Krylov vector is considered numerically dependent on the previous ones, which ends the restart cycle */
+  double basis_tolerance() const { return basis_tol_; }
+  /** @brief Sets the tolerance below which a new Krylov vector is considered numerically dependent on the previous ones, which ends the restart cycle */
+  void basis_tolerance(double new_tol) { if (new_tol >= 0) basis_tol_ = new_tol; }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  /** @brief Set the number of solver iterations (should only be modified by the solver) */
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the largest relative error of all right-hand sides at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  unsigned int krylov_dim_;
+  double basis_tol_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Implementation of the restarted block GMRES method (no preconditioner).
+  *
+  * Each iteration applies A to the last block of basis vectors with a single sparse matrix-dense matrix product,
+  * orthogonalizes the result against the previous blocks by block classical Gram-Schmidt (two passes) and among itself by TSQR.
+  * The least squares problems for all right-hand sides are solved on the host with the small block Hessenberg matrix.
+  * At each restart, the true residuals are computed and the right-hand sides which have converged are removed from the block (deflation).
+  */
+  template<typename MatrixT, typename NumericT>
+  viennacl::matrix<NumericT, viennacl::column_major> block_gmres_solve(MatrixT const & A,
+                                                                      viennacl::matrix_base<NumericT> const & rhs,
+                                                                      block_gmres_tag const & tag)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef viennacl::matrix_range<BlockType>                    BlockRangeType;
+
+    vcl_size_t n = rhs.size1();
+    vcl_size_t num_rhs = rhs.size2();
+    vcl_size_t m = tag.krylov_dim();
+    viennacl::context ctx = viennacl::traits::context(rhs);
+
+    BlockType result(n, num_rhs, ctx);
+    if (n == 0 || num_rhs == 0)
+    {
+      tag.iters(0);
+      tag.error(0);
+      return result;
+    }
+
+    // X and B hold the solutions and the right-hand sides which have not converged yet, the blocks of V the orthonormal basis vectors:
+    BlockType X(n, num_rhs, ctx);
+    BlockType B(n, num_rhs, ctx);
+    BlockType V(n, (m + 1) * num_rhs, ctx);
+    copy_to_block_columns(rhs, B, 0);
+
+    viennacl::matrix<NumericT> gram(num_rhs, num_rhs, ctx);
+    viennacl::matrix<NumericT> small_C((m + 1) * num_rhs, num_rhs, ctx);
+    viennacl::matrix<NumericT> small_Y(m * num_rhs, num_rhs, ctx);
+
+    viennacl::range all_rows(0, n);
+    double pivot_tolerance = std::max(tag.basis_tolerance(), 100.0 * static_cast<double>(std::numeric_limits<NumericT>::epsilon()));
+
+    // active[i] is the right-hand side held in column i of X and B:
+    std::vector<vcl_size_t> active(num_rhs);
+    for (vcl_size_t i = 0; i < num_rhs; ++i)
+      active[i] = i;
+    BlockRangeType B_all(B, all_rows, viennacl::range(0, num_rhs));
+    std::vector<double> norm_rhs = block_column_norms(B_all, gram);
+    std::vector<double> final_error(num_rhs, 0.0);
+    unsigned int iters = 0;
+
+    for (;;)
+    {
+      vcl_size_t p = active.size();
+
+      // true residuals:
+      BlockRangeType X_current(X, all_rows, viennacl::range(0, p));
+      BlockRangeType B_current(B, all_rows, viennacl::range(0, p));
+      BlockRangeType R(V, all_rows, viennacl::range(0, p));
+      viennacl::linalg::prod_impl(A, X_current, R);
+      R = B_current - R;
+      std::vector<double> norm_r = block_column_norms(R, gram);
+
+      // remove the converged right-hand sides from the block:
+      std::vector<vcl_size_t> keep;
+      for (vcl_size_t i = 0; i < p; ++i)
+      {
+        vcl_size_t j = active[i];
+        bool converged = norm_r[i] <= tag.tolerance() * norm_rhs[j] || norm_r[i] <= tag.abs_tolerance();
+        if (converged || iters >= tag.max_iterations())
+        {
+          copy_block_column(X, i, result, j);
+          final_error[j] = (norm_rhs[j] > 0) ? norm_r[i] / norm_rhs[j] : 0;
+        }
+        else
+          keep.push_back(i);
+      }
+      if (keep.size() < p)
+      {
+        compact_block_columns(X, 0, keep);
+        compact_block_columns(B, 0, keep);
+        compact_block_columns(V, 0, keep);
+        for (vcl_size_t i = 0; i < keep.size(); ++i)
+          active[i] = active[keep[i]];
+        p = keep.size();
+        active.resize(p);
+      }
+      if (p == 0)
+        break;
+
+      // first block of basis vectors and the right-hand side S of the least squares problems:
+      BlockRangeType V_0(V, all_rows, viennacl::range(0, p));
+      std::vector<double> S;
+      viennacl::linalg::tsqr(V_0, S);
+
+      vcl_size_t H_cols = m * p;
+      std::vector<double> H((m + 1) * p * H_cols, 0.0);  // block Hessenberg matrix
+      std::vector<double> Y;
+      vcl_size_t num_blocks = 0;
+
+      for (vcl_size_t j = 0; j < m; ++j)
+      {
+        BlockRangeType V_j  (V, all_rows, viennacl::range(      j * p, (j + 1) * p));
+        BlockRangeType W    (V, all_rows, viennacl::range((j + 1) * p, (j + 2) * p));
+        BlockRangeType V_prev(V, all_rows, viennacl::range(0, (j + 1) * p));
+        viennacl::linalg::prod_impl(A, V_j, W);
+
+        // block Gram-Schmidt against the previous blocks, two passes:
+        viennacl::matrix_range<viennacl::matrix<NumericT> > C_block(small_C, viennacl::range(0, (j + 1) * p), viennacl::range(0, p));
+        for (unsigned int pass = 0; pass < 2; ++pass)
+        {
+          std::vector<double> C_pass;
+          C_block = viennacl::linalg::prod(viennacl::trans(V_prev), W);
+          W -= viennacl::linalg::prod(V_prev, C_block);
+          read_small_matrix(small_C, C_pass);
+          for (vcl_size_t i = 0; i < (j + 1) * p; ++i)
+            for (vcl_size_t l = 0; l < p; ++l)
+              H[i * H_cols + j * p + l] += C_pass[i * num_rhs + l];
+        }
+
+        std::vector<double> W_R;
+        viennacl::linalg::tsqr(W, W_R);
+        for (vcl_size_t i = 0; i < p; ++i)
+          for (vcl_size_t l = i; l < p; ++l)
+            H[((j + 1) * p + i) * H_cols + j * p + l] = W_R[i * p + l];
+        ++iters;
+        num_blocks = j + 1;
+
+        // A V_j numerically contained in the previous blocks: the Krylov space of at least one right-hand side is exhausted
+        bool breakdown = false;
+        for (vcl_size_t l = 0; l < p; ++l)
+        {
+          double norm_squared = 0;
+          for (vcl_size_t i = 0; i < (j + 2) * p; ++i)
+            norm_squared += H[i * H_cols + j * p + l] * H[i * H_cols + j * p + l];
+          breakdown = breakdown || !(W_R[l * p + l] * W_R[l * p + l] > pivot_tolerance * norm_squared);
+        }
+
+        // least squares problems min ||E_1 S - H y||:
+        vcl_size_t rows = (j + 2) * p;
+        vcl_size_t cols = (j + 1) * p;
+        std::vector<double> H_used(rows * cols);
+        std::vector<double> rhs_used(rows * p, 0.0);
+        for (vcl_size_t i = 0; i < rows; ++i)
+          for (vcl_size_t l = 0; l < cols; ++l)
+            H_used[i * cols + l] = H[i * H_cols + l];
+        for (vcl_size_t i = 0; i < p; ++i)
+          for (vcl_size_t l = 0; l < p; ++l)
+            rhs_used[i * p + l] = S[i * p + l];
+
+        std::vector<double> residual_norms;
+        Y = small_least_squares(H_used, rows, cols, rhs_used, p, residual_norms);
+
+        bool converged = true;
+        for (vcl_size_t i = 0; i < p; ++i)
+          converged = converged && (residual_norms[i] <= tag.tolerance() * norm_rhs[active[i]] || residual_norms[i] <= tag.abs_tolerance());
+        if (converged || breakdown || iters >= tag.max_iterations())
+          break;
+      }
+
+      // update of the solutions:
+      BlockRangeType X_active(X, all_rows, viennacl::range(0, p));
+      BlockRangeType V_used(V, all_rows, viennacl::range(0, num_blocks * p));
+      write_small_matrix(Y, num_blocks * p, p, small_Y);
+      X_active += viennacl::linalg::prod(V_used, small_Y);
+    }
+
+    tag.iters(iters);
+    tag.error(*std::max_element(final_error.begin(), final_error.end()));
+
+    return result;
+  }
+
+}
+
+
+/** @brief Solves A X = B for multiple right-hand sides (the columns of B) with the block GMRES method. A must be one of the ViennaCL sparse matrix types.
+*
+* @param A          The system matrix
+* @param rhs        The right-hand sides, one per column
+* @param tag        Solver configuration tag
+* @return The solutions, one per column
+*/
+template<typename MatrixT, typename NumericT>
+viennacl::matrix<NumericT, viennacl::column_major> solve(MatrixT const & A, viennacl::matrix_base<NumericT> const & rhs, block_gmres_tag const & tag, viennacl::linalg::no_precond)
+{
+  return detail::block_gmres_solve(A, rhs, tag);
+}
+
+/** @brief Convenience overload for calling the block GMRES solver without preconditioner */
+template<typename MatrixT, typename NumericT>
+viennacl::matrix<NumericT, viennacl::column_major> solve(MatrixT const & A, viennacl::matrix_base<NumericT> const & rhs, block_gmres_tag const & tag)
+{
+  return detail::block_gmres_solve(A, rhs, tag);
+}
+
+}
+}
+
+#endif
@@ -53,7 +53,7 @@ public:
   * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
   * @param max_iterations   The maximum number of iterations
   */
-  cg_tag(double tol = 1e-8, unsigned int max_iterations = 300) : tol_(tol), abs_tol_(0), iterations_(max_iterations) {}
+  cg_tag(double tol = 1e-8, unsigned int max_iterations = 300) : tol_(tol), abs_tol_(0), iterations_(max_iterations), iters_taken_(0), last_error_(0) {}
 
   /** @brief Returns the relative tolerance */
   double tolerance() const { return tol_; }
@@ -113,6 +113,56 @@ namespace detail
 namespace detail
 {
 
+  /** @brief Runs one iteration of the pipelined CG algorithm with the separate kernels for the vector update and the fused matrix-vector product.
+  *
+  * The inner products (r,r), (Ap,Ap), and (p,Ap) are written to inner_prods[0], inner_prods[1], and inner_prods[2].
+  */
+  template<typename MatrixT, typename NumericT>
+  void pipelined_step_impl(MatrixT const & A,
+                           viennacl::vector<NumericT> & result, NumericT alpha,
+                           viennacl::vector<NumericT> & p, viennacl::vector<NumericT> & residual, viennacl::vector<NumericT> & Ap, NumericT beta,
+                           viennacl::vector<NumericT> & inner_prod_buffer, std::vector<NumericT> & host_inner_prod_buffer,
+                           NumericT * inner_prods)
+  {
+    typedef typename viennacl::vector<NumericT>::difference_type   difference_type;
+
+    difference_type buffer_offset_per_vector = static_cast<difference_type>(inner_prod_buffer.size() / 3);
+
+    viennacl::linalg::pipelined_cg_vector_update(result, alpha, p, residual, Ap, beta, inner_prod_buffer);
+    viennacl::linalg::pipelined_cg_prod(A, p, Ap, inner_prod_buffer);
+
+    // bring back the partial results to the host:
+    viennacl::fast_copy(inner_prod_buffer.begin(), inner_prod_buffer.end(), host_inner_prod_buffer.begin());
+
+    inner_prods[0] = std::accumulate(host_inner_prod_buffer.begin(),                                host_inner_prod_buffer.begin() +     buffer_offset_per_vector, NumericT(0));
+    inner_prods[1] = std::accumulate(host_inner_prod_buffer.begin() +     buffer_offset_per_vector, host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, NumericT(0));
+    inner_prods[2] = std::accumulate(host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, host_inner_prod_buffer.begin() + 3 * buffer_offset_per_vector, NumericT(0));
+  }
+
+  template<typename MatrixT, typename NumericT>
+  void pipelined_step(MatrixT const & A,
+                      viennacl::vector<NumericT> & result, NumericT alpha,
+                      viennacl::vector<NumericT> & p, viennacl::vector<NumericT> & residual, viennacl::vector<NumericT> & Ap, NumericT beta,
+                      viennacl::vector<NumericT> & inner_prod_buffer, std::vector<NumericT> & host_inner_prod_buffer,
+                      NumericT * inner_prods)
+  {
+    pipelined_step_impl(A, result, alpha, p, residual, Ap, beta, inner_prod_buffer, host_inner_prod_buffer, inner_prods);
+  }
+
+  /** @brief Overload for compressed_matrix: In main memory, the whole iteration is carried out in a single parallel region, cf. viennacl::linalg::host_based::set_fused_cg_iteration() */
+  template<typename NumericT>
+  void pipelined_step(viennacl::compressed_matrix<NumericT> const & A,
+                      viennacl::vector<NumericT> & result, NumericT alpha,
+                      viennacl::vector<NumericT> & p, viennacl::vector<NumericT> & residual, viennacl::vector<NumericT> & Ap, NumericT beta,
+                      viennacl::vector<NumericT> & inner_prod_buffer, std::vector<NumericT> & host_inner_prod_buffer,
+                      NumericT * inner_prods)
+  {
+    if (viennacl::traits::active_handle_id(A) == viennacl::MAIN_MEMORY && viennacl::linalg::host_based::fused_cg_iteration())
+      viennacl::linalg::pipelined_cg_iteration(A, result, alpha, p, residual, Ap, beta, inner_prods);
+    else
+      pipelined_step_impl(A, result, alpha, p, residual, Ap, beta, inner_prod_buffer, host_inner_prod_buffer, inner_prods);
+  }
+
   /** @brief Implementation of a pipelined conjugate gradient algorithm (no preconditioner), specialized for ViennaCL types.
   *
   * Pipelined version from A. T. Chronopoulos and C. W. Gear, J. Comput. Appl. Math. 25(2), 153–168 (1989)
@@ -133,8 +183,6 @@ namespace detail
                                              bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                              void *monitor_data = NULL)
   {
-    typedef typename viennacl::vector<NumericT>::difference_type   difference_type;
-
     viennacl::vector<NumericT> result(rhs);
     viennacl::traits::clear(result);
 
@@ -143,8 +191,7 @@ namespace detail
     viennacl::vector<NumericT> Ap = viennacl::linalg::prod(A, p);
     viennacl::vector<NumericT> inner_prod_buffer = viennacl::zero_vector<NumericT>(3*256, viennacl::traits::context(rhs)); // temporary buffer
     std::vector<NumericT>      host_inner_prod_buffer(inner_prod_buffer.size());
-    vcl_size_t                 buffer_size_per_vector = inner_prod_buffer.size() / 3;
-    difference_type            buffer_offset_per_vector = static_cast<difference_type>(buffer_size_per_vector);
+    NumericT                   inner_prods[3];
 
     NumericT norm_rhs_squared = viennacl::linalg::norm_2(residual); norm_rhs_squared *= norm_rhs_squared;
 
@@ -161,15 +208,11 @@ namespace detail
     {
       tag.iters(i+1);
 
-      viennacl::linalg::pipelined_cg_vector_update(result, alpha, p, residual, Ap, beta, inner_prod_buffer);
-      viennacl::linalg::pipelined_cg_prod(A, p, Ap, inner_prod_buffer);
+      pipelined_step(A, result, alpha, p, residual, Ap, beta, inner_prod_buffer, host_inner_prod_buffer, inner_prods);
 
-      // bring back the partial results to the host:
-      viennacl::fast_copy(inner_prod_buffer.begin(), inner_prod_buffer.end(), host_inner_prod_buffer.begin());
-
-      inner_prod_rr   = std::accumulate(host_inner_prod_buffer.begin(),                                host_inner_prod_buffer.begin() +     buffer_offset_per_vector, NumericT(0));
-      inner_prod_ApAp = std::accumulate(host_inner_prod_buffer.begin() +     buffer_offset_per_vector, host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, NumericT(0));
-      inner_prod_pAp  = std::accumulate(host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, host_inner_prod_buffer.begin() + 3 * buffer_offset_per_vector, NumericT(0));
+      inner_prod_rr   = inner_prods[0];
+      inner_prod_ApAp = inner_prods[1];
+      inner_prod_pAp  = inner_prods[2];
 
       if (monitor && monitor(result, std::sqrt(std::fabs(inner_prod_rr / norm_rhs_squared)), monitor_data))
         break;
@@ -254,6 +297,23 @@ namespace detail
   }
 
 
+  /** @brief Overload for the pipelined CG implementation for a symmetric_compressed_matrix.
+    *
+    * Only the upper triangle of A is stored, so each matrix-vector product reads every off-diagonal entry once and applies it to both the row and the column.
+    * The inner products of the iteration are accumulated as the entries of the product are finalized. The vectors must reside in main memory.
+    */
+  template<typename NumericT>
+  viennacl::vector<NumericT> solve_impl(viennacl::symmetric_compressed_matrix<NumericT> const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        cg_tag const & tag,
+                                        viennacl::linalg::no_precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
+  }
+
+
   template<typename MatrixT, typename VectorT, typename PreconditionerT>
   VectorT solve_impl(MatrixT const & matrix,
                      VectorT const & rhs,
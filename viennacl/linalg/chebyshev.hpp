@@ -0,0 +1,399 @@
+#ifndef VIENNACL_LINALG_CHEBYSHEV_HPP_
+#define VIENNACL_LINALG_CHEBYSHEV_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/chebyshev.hpp
+    @brief Implementation of the Chebyshev iteration for symmetric positive definite systems.
+
+    Following Y. Saad, 'Iterative Methods for Sparse Linear Systems', 2nd edition, Algorithm 12.1. The iteration itself does not require any inner products.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/bisect.hpp"
+#include "viennacl/linalg/lanczos.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/traits/handle.hpp"
+#include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/iterative_operations.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the Chebyshev iteration. Used for supplying solver parameters and for dispatching the solve() function
+*
+* Unless bounds for the spectrum of the (preconditioned) system matrix are supplied via eigenvalue_bounds(), they are estimated from a few Lanczos steps at the beginning of each solver run.
+*/
+class chebyshev_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+  * @param max_iterations   The maximum number of iterations
+  */
+  chebyshev_tag(double tol = 1e-8, vcl_size_t max_iterations = 1000)
+    : tol_(tol), abs_tol_(0), iterations_(max_iterations), check_interval_(10), estimation_steps_(20),
+      lambda_min_(0), lambda_max_(0), used_lambda_min_(0), used_lambda_max_(0), iters_taken_(0), last_error_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  vcl_size_t max_iterations() const { return iterations_; }
+
+  /** @brief Returns the number of iterations after which the residual norm is checked (default: 10). This is the only reduction of the iteration. */
+  vcl_size_t check_interval() const { return check_interval_; }
+  /** @brief Sets the number of iterations after which the residual norm is checked */
+  void check_interval(vcl_size_t num) { if (num > 0) check_interval_ = num; }
+
+  /** @brief Returns the number of Lanczos steps used for estimating the eigenvalue bounds (default: 20) */
+  vcl_size_t estimation_steps() const { return estimation_steps_; }
+  /** @brief Sets the number of Lanczos steps used for estimating the eigenvalue bounds */
+  void estimation_steps(vcl_size_t num) { if (num > 1) estimation_steps_ = num; }
+
+  /** @brief Sets bounds 0 < lambda_min < lambda_max for the spectrum of the (preconditioned) system matrix. Invalid bounds request an estimate in each solver run. */
+  void eigenvalue_bounds(double lambda_min, double lambda_max)
+  {
+    bool valid = (lambda_min > 0 && lambda_max > lambda_min);
+    lambda_min_ = valid ? lambda_min : 0;
+    lambda_max_ = valid ? lambda_max : 0;
+    used_lambda_min_ = lambda_min_;
+    used_lambda_max_ = lambda_max_;
+  }
+  /** @brief Returns true if eigenvalue bounds have been supplied via eigenvalue_bounds() */
+  bool has_eigenvalue_bounds() const { return lambda_max_ > 0; }
+
+  /** @brief Returns the lower eigenvalue bound used in the last solver run */
+  double lambda_min() const { return used_lambda_min_; }
+  /** @brief Returns the upper eigenvalue bound used in the last solver run */
+  double lambda_max() const { return used_lambda_max_; }
+  /** @brief Sets the eigenvalue bounds used in the solver run */
+  void used_eigenvalue_bounds(double lambda_min, double lambda_max) const { used_lambda_min_ = lambda_min; used_lambda_max_ = lambda_max; }
+
+  /** @brief Return the number of solver iterations: */
+  vcl_size_t iters() const { return iters_taken_; }
+  void iters(vcl_size_t i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  vcl_size_t iterations_;
+  vcl_size_t check_interval_;
+  vcl_size_t estimation_steps_;
+  double lambda_min_;
+  double lambda_max_;
+
+  //return values from solver
+  mutable double used_lambda_min_;
+  mutable double used_lambda_max_;
+  mutable vcl_size_t iters_taken_;
+  mutable double last_error_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Estimates the extremal eigenvalues of A with a few steps of Lanczos' method without reorthogonalization. The estimates are ordered ascendingly. */
+  template<typename MatrixT, typename NumericT>
+  std::vector<NumericT> chebyshev_eigenvalue_estimates(MatrixT const & A, viennacl::vector<NumericT> const & rhs, vcl_size_t steps, viennacl::linalg::no_precond)
+  {
+    vcl_size_t krylov_size = std::min(steps, rhs.size());
+    viennacl::linalg::lanczos_tag tag(0.75, krylov_size, viennacl::linalg::lanczos_tag::no_reorthogonalization, krylov_size);
+    std::vector<NumericT> eigenvalues = viennacl::linalg::eig(A, tag); // the largest first
+
+    std::vector<NumericT> result(2);
+    result[0] = eigenvalues.back();
+    result[1] = eigenvalues.front();
+    return result;
+  }
+
+  /** @brief Estimates the extremal eigenvalues of the preconditioned system matrix.
+  *
+  * The Lanczos tridiagonal matrix of the preconditioned operator is obtained from the coefficients of a few preconditioned CG steps,
+  * as the Lanczos implementation in lanczos.hpp is restricted to symmetric operators. The estimates are ordered ascendingly.
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  std::vector<NumericT> chebyshev_eigenvalue_estimates(MatrixT const & A, viennacl::vector<NumericT> const & rhs, vcl_size_t steps, PreconditionerT const & precond)
+  {
+    viennacl::vector<NumericT> residual = rhs;
+    viennacl::vector<NumericT> z = rhs;
+    precond.apply(z);
+    viennacl::vector<NumericT> p = z;
+    viennacl::vector<NumericT> t(rhs.size(), viennacl::traits::context(rhs));
+
+    std::vector<NumericT> alphas, betas;   // diagonal and off-diagonal of the tridiagonal matrix, betas[0] is ignored
+    NumericT rz = viennacl::linalg::inner_prod(residual, z);
+    NumericT cg_alpha_old = 1;
+    NumericT cg_beta_old  = 0;
+    for (vcl_size_t i = 0; i < std::min(steps, rhs.size()) && rz > 0; ++i)
+    {
+      t = viennacl::linalg::prod(A, p);
+      NumericT cg_alpha = rz / viennacl::linalg::inner_prod(p, t);
+      residual -= cg_alpha * t;
+      viennacl::copy(residual, z);
+      precond.apply(z);
+      NumericT rz_new = viennacl::linalg::inner_prod(residual, z);
+      NumericT cg_beta = rz_new / rz;
+
+      alphas.push_back(NumericT(1) / cg_alpha + cg_beta_old / cg_alpha_old);
+      betas.push_back(std::sqrt(cg_beta_old) / cg_alpha_old);
+
+      p = z + cg_beta * p;
+      rz = rz_new;
+      cg_alpha_old = cg_alpha;
+      cg_beta_old  = cg_beta;
+    }
+
+    std::vector<NumericT> eigenvalues = viennacl::linalg::bisect(alphas, betas); // ascending
+
+    std::vector<NumericT> result(2);
+    result[0] = eigenvalues.front();
+    result[1] = eigenvalues.back();
+    return result;
+  }
+
+
+  /** @brief Performs the vector updates of one Chebyshev iteration: x += d, r -= t with t = A d, d = alpha * d + beta * M^{-1} r. */
+  template<typename NumericT, typename PreconditionerT>
+  void chebyshev_update(viennacl::vector<NumericT> & x, viennacl::vector<NumericT> & residual, viennacl::vector<NumericT> & d, viennacl::vector<NumericT> const & t,
+                        viennacl::vector<NumericT> & z, NumericT alpha, NumericT beta, PreconditionerT const & precond)
+  {
+    x += d;
+    residual -= t;
+    viennacl::copy(residual, z);
+    precond.apply(z);
+    d = alpha * d + beta * z;
+  }
+
+  /** @brief Performs the vector updates of one unpreconditioned Chebyshev iteration. In main memory, this is a single pass of a fused kernel. */
+  template<typename NumericT>
+  void chebyshev_update(viennacl::vector<NumericT> & x, viennacl::vector<NumericT> & residual, viennacl::vector<NumericT> & d, viennacl::vector<NumericT> const & t,
+                        viennacl::vector<NumericT> &, NumericT alpha, NumericT beta, viennacl::linalg::no_precond)
+  {
+    if (viennacl::traits::active_handle_id(x) == viennacl::MAIN_MEMORY)
+      viennacl::linalg::chebyshev_update(x, residual, d, t, alpha, beta);
+    else
+    {
+      x += d;
+      residual -= t;
+      d = alpha * d + beta * residual;
+    }
+  }
+
+
+  /** @brief Implementation of the preconditioned Chebyshev iteration.
+  *
+  * Apart from the residual norm computed every tag.check_interval() iterations, no reductions are required.
+  * The system matrix and the preconditioner must be symmetric positive definite.
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  viennacl::vector<NumericT> solve_impl(MatrixT const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        chebyshev_tag const & tag,
+                                        PreconditionerT const & precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    vcl_size_t n = rhs.size();
+    viennacl::context ctx = viennacl::traits::context(rhs);
+
+    viennacl::vector<NumericT> result = viennacl::zero_vector<NumericT>(n, ctx);
+    viennacl::vector<NumericT> residual = rhs;
+    viennacl::vector<NumericT> z = rhs;
+    viennacl::vector<NumericT> d(n, ctx);
+    viennacl::vector<NumericT> t(n, ctx);
+
+    NumericT norm_rhs = viennacl::linalg::norm_2(rhs);
+    NumericT norm_r = norm_rhs;
+    tag.iters(0);
+    tag.error(0);
+
+    if (norm_rhs <= tag.abs_tolerance()) //solution is zero if RHS norm is zero
+      return result;
+
+    NumericT lambda_min = NumericT(tag.lambda_min());
+    NumericT lambda_max = NumericT(tag.lambda_max());
+    if (!tag.has_eigenvalue_bounds())
+    {
+      std::vector<NumericT> estimates = chebyshev_eigenvalue_estimates(A, rhs, tag.estimation_steps(), precond);
+      // Ritz values lie inside the spectrum. The iteration diverges for eigenvalues beyond the upper bound, hence enlarge it,
+      // whereas an overestimated lower bound only slows down convergence:
+      lambda_min = estimates[0];
+      lambda_max = NumericT(1.1) * estimates[1];
+      tag.used_eigenvalue_bounds(lambda_min, lambda_max);
+    }
+
+    NumericT theta = (lambda_max + lambda_min) / NumericT(2);
+    NumericT delta = (lambda_max - lambda_min) / NumericT(2);
+    NumericT sigma = theta / delta;
+    NumericT rho   = NumericT(1) / sigma;
+
+    precond.apply(z);
+    d = z / theta;
+
+    vcl_size_t i = 0;
+    while (i < tag.max_iterations())
+    {
+      t = viennacl::linalg::prod(A, d);
+      NumericT rho_new = NumericT(1) / (NumericT(2) * sigma - rho);
+      chebyshev_update(result, residual, d, t, z, rho_new * rho, NumericT(2) * rho_new / delta, precond);
+      rho = rho_new;
+      ++i;
+
+      if (i % tag.check_interval() == 0 || i == tag.max_iterations())
+      {
+        norm_r = viennacl::linalg::norm_2(residual);
+        if (monitor && monitor(result, std::fabs(norm_r / norm_rhs), monitor_data))
+          break;
+        if (norm_r <= tag.tolerance() * norm_rhs || norm_r <= tag.abs_tolerance())
+        {
+          // the recursively updated residual may deviate from the true residual in finite precision, hence check the latter and continue with it if necessary:
+          residual = viennacl::linalg::prod(A, result);
+          residual = rhs - residual;
+          norm_r = viennacl::linalg::norm_2(residual);
+          if (norm_r <= tag.tolerance() * norm_rhs || norm_r <= tag.abs_tolerance())
+            break;
+        }
+      }
+    }
+
+    //store last error estimate:
+    tag.iters(i);
+    tag.error(norm_r / norm_rhs);
+
+    return result;
+  }
+
+}
+
+
+/** @brief Solves A x = rhs with the Chebyshev iteration and a symmetric positive definite preconditioner.
+*
+* @param A          The symmetric positive definite system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @param precond    The preconditioner
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT, typename PreconditionerT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, chebyshev_tag const & tag, PreconditionerT const & precond)
+{
+  return detail::solve_impl(A, rhs, tag, precond);
+}
+
+/** @brief Entry point for the unpreconditioned Chebyshev iteration.
+ *
+ *  @param A         The symmetric positive definite system matrix
+ *  @param rhs       Right hand side vector (load vector)
+ *  @param tag       A Chebyshev tag providing eigenvalue bounds, relative tolerances, etc.
+ */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, chebyshev_tag const & tag)
+{
+  return viennacl::linalg::solve(A, rhs, tag, viennacl::linalg::no_precond());
+}
+
+
+/** @brief Chebyshev iteration solver class, which allows to specify an initial guess and a monitor function.
+*
+* @tparam VectorT   The vector type, must be viennacl::vector<>
+*/
+template<typename VectorT>
+class chebyshev_solver
+{
+public:
+  typedef typename viennacl::result_of::cpu_value_type<VectorT>::type   numeric_type;
+
+  chebyshev_solver(chebyshev_tag const & tag) : tag_(tag), monitor_callback_(NULL), user_data_(NULL) {}
+
+  template<typename MatrixT, typename PreconditionerT>
+  VectorT operator()(MatrixT const & A, VectorT const & b, PreconditionerT const & precond) const
+  {
+    if (viennacl::traits::size(init_guess_) > 0) // take initial guess into account
+    {
+      VectorT mod_rhs = viennacl::linalg::prod(A, init_guess_);
+      mod_rhs = b - mod_rhs;
+      VectorT y = detail::solve_impl(A, mod_rhs, tag_, precond, monitor_callback_, user_data_);
+      return init_guess_ + y;
+    }
+    return detail::solve_impl(A, b, tag_, precond, monitor_callback_, user_data_);
+  }
+
+
+  template<typename MatrixT>
+  VectorT operator()(MatrixT const & A, VectorT const & b) const
+  {
+    return operator()(A, b, viennacl::linalg::no_precond());
+  }
+
+  /** @brief Specifies an initial guess for the iterative solver.
+    *
+    * An iterative solver for Ax = b with initial guess x_0 is equivalent to an iterative solver for Ay = b' := b - Ax_0, where x = x_0 + y.
+    */
+  void set_initial_guess(VectorT const & x) { init_guess_ = x; }
+
+  /** @brief Sets a monitor function pointer to be called every tag().check_interval() iterations. Set to NULL to run without monitor.
+   *
+   *  The monitor function is called with the current guess for the result as first argument and the current relative residual as second argument.
+   *  The third argument is a pointer to user-defined data, through which additional information can be passed.
+   *  If the montior function returns true, the solver terminates (either convergence or divergence).
+   */
+  void set_monitor(bool (*monitor_fun)(VectorT const &, numeric_type, void *), void *user_data)
+  {
+    monitor_callback_ = monitor_fun;
+    user_data_ = user_data;
+  }
+
+  /** @brief Returns the solver tag containing basic configuration such as tolerances, etc. */
+  chebyshev_tag const & tag() const { return tag_; }
+
+private:
+  chebyshev_tag tag_;
+  VectorT       init_guess_;
+  bool          (*monitor_callback_)(VectorT const &, numeric_type, void *);
+  void          *user_data_;
+};
+
+
+}
+}
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef VIENNACL_LINALG_CHOLESKY_HPP
+#define VIENNACL_LINALG_CHOLESKY_HPP
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/cholesky.hpp
+    @brief Implementations of the Cholesky factorization A = L L^T for symmetric positive definite row-major and column-major dense matrices.
+*/
+
+#include <algorithm>    //for std::min
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/direct_solve.hpp"
+#include "viennacl/linalg/host_based/common.hpp"
+
+/** @brief Width of the block columns in the blocked Cholesky factorization. */
+#ifndef VIENNACL_CHOLESKY_BLOCKSIZE
+  #define VIENNACL_CHOLESKY_BLOCKSIZE 128
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief Exception thrown by cholesky_factorize() if the matrix is not symmetric positive definite. */
+class not_positive_definite_exception : public std::runtime_error
+{
+public:
+  not_positive_definite_exception(std::string const & msg, vcl_size_t index) : std::runtime_error(msg), index_(index) {}
+
+  /** @brief Returns the row/column index at which the matrix has been found to be not positive definite */
+  vcl_size_t index() const { return index_; }
+
+private:
+  vcl_size_t index_;
+};
+
+namespace detail
+{
+  inline void cholesky_throw(std::string const & reason, vcl_size_t index)
+  {
+    std::stringstream ss;
+    ss << "ViennaCL: Matrix is not positive definite: " << reason << " (row/column " << index << ")";
+    throw not_positive_definite_exception(ss.str(), index);
+  }
+
+  /** @brief Checks necessary conditions for positive definiteness at O(n^2) cost before entering the O(n^3) factorization:
+  *
+  *   - All diagonal entries are positive.
+  *   - All 2x2 principal minors are positive, i.e. a_ij^2 < a_ii * a_jj. Only the lower triangular part is inspected.
+  */
+  template<typename NumericT, typename WrapperT>
+  void cholesky_check_necessary_conditions(WrapperT & A, vcl_size_t n)
+  {
+    for (vcl_size_t i = 0; i < n; ++i)
+      if (!(A(i, i) > 0))  // also catches NaN
+        cholesky_throw("non-positive diagonal entry", i);
+
+    long first_failed_row = static_cast<long>(n);
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (n * n > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+    for (long i = 0; i < static_cast<long>(n); ++i)
+    {
+      NumericT a_ii = A(i, i);
+      for (vcl_size_t j = 0; j < static_cast<vcl_size_t>(i); ++j)
+      {
+        NumericT a_ij = A(i, j);
+        if (!(a_ij * a_ij < a_ii * A(j, j)))
+        {
+#ifdef VIENNACL_WITH_OPENMP
+          #pragma omp critical
+#endif
+          first_failed_row = std::min<long>(first_failed_row, i);
+          break;
+        }
+      }
+    }
+
+    if (first_failed_row < static_cast<long>(n))
+      cholesky_throw("off-diagonal entry too large", static_cast<vcl_size_t>(first_failed_row));
+  }
+
+  /** @brief Unblocked left-looking Cholesky factorization of the diagonal block A(j0:j1, j0:j1). Contributions from columns left of j0 have already been subtracted. */
+  template<typename NumericT, typename WrapperT>
+  void cholesky_factorize_diagonal_block(WrapperT & A, vcl_size_t j0, vcl_size_t j1)
+  {
+    for (vcl_size_t j = j0; j < j1; ++j)
+    {
+      NumericT a_jj = A(j, j);
+      for (vcl_size_t k = j0; k < j; ++k)
+        a_jj -= A(j, k) * A(j, k);
+
+      if (!(a_jj > 0))
+        cholesky_throw("non-positive pivot", j);
+
+      NumericT l_jj = std::sqrt(a_jj);
+      A(j, j) = l_jj;
+
+      for (vcl_size_t i = j + 1; i < j1; ++i)
+      {
+        NumericT a_ij = A(i, j);
+        for (vcl_size_t k = j0; k < j; ++k)
+          a_ij -= A(i, k) * A(j, k);
+        A(i, j) = a_ij / l_jj;
+      }
+    }
+  }
+}
+
+/** @brief Blocked Cholesky factorization A = L L^T of a symmetric positive definite dense matrix.
+*
+* Right-looking algorithm: The diagonal block of each block column is factored, the subdiagonal block is obtained from a triangular solve,
+* and the lower triangle of the trailing matrix is updated block column by block column using matrix-matrix products.
+* The diagonal blocks of the trailing update are computed in a small buffer, so that the upper triangular part of A is not referenced.
+* With the host backend, the triangular solve and the products run multithreaded. Matrices in other memory domains are transferred to main memory for the factorization.
+*
+* Before the factorization starts, the diagonal entries and the 2x2 principal minors are checked at O(n^2) cost, so that most matrices which are not positive definite are rejected early.
+* Otherwise, the factorization stops at the first non-positive pivot.
+*
+* @param A    The system matrix. Only the lower triangular part is referenced and overwritten by L. The strictly upper triangular part is left unchanged.
+* @throws not_positive_definite_exception if A is not positive definite. The contents of A are undefined in this case.
+*/
+template<typename NumericT, typename F, unsigned int AlignmentV>
+void cholesky_factorize(matrix<NumericT, F, AlignmentV> & A)
+{
+  typedef matrix<NumericT, F, AlignmentV>  MatrixType;
+
+  assert(A.size1() == A.size2() && bool("Matrix must be square"));
+
+  vcl_size_t n = A.size1();
+
+  viennacl::context ctx = viennacl::traits::context(A);
+  if (ctx.memory_type() != viennacl::MAIN_MEMORY)
+    A.switch_memory_context(viennacl::context(viennacl::MAIN_MEMORY));
+
+  viennacl::linalg::host_based::detail::matrix_array_wrapper<NumericT, F, false>
+      A_wrapper(viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A), 0, 0, 1, 1, A.internal_size1(), A.internal_size2());
+
+  vcl_size_t block_size = VIENNACL_CHOLESKY_BLOCKSIZE;
+  MatrixType diagonal_update(block_size, block_size, viennacl::context(viennacl::MAIN_MEMORY));
+  viennacl::linalg::host_based::detail::matrix_array_wrapper<NumericT, F, false>
+      D_wrapper(viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(diagonal_update), 0, 0, 1, 1, diagonal_update.internal_size1(), diagonal_update.internal_size2());
+
+  try
+  {
+    detail::cholesky_check_necessary_conditions<NumericT>(A_wrapper, n);
+
+    for (vcl_size_t k = 0; k < n; k += block_size)
+    {
+      vcl_size_t k_end = std::min<vcl_size_t>(n, k + block_size);
+
+      detail::cholesky_factorize_diagonal_block<NumericT>(A_wrapper, k, k_end);
+
+      if (k_end < n)
+      {
+        viennacl::range     block_range(k, k_end);
+        viennacl::range remainder_range(k_end, n);
+
+        //
+        // Compute L_21 = A_21 L_11^{-T}, i.e. solve L_11 L_21^T = A_21^T:
+        //
+        viennacl::matrix_range<MatrixType> L_11(A, block_range,     block_range);
+        viennacl::matrix_range<MatrixType> L_21(A, remainder_range, block_range);
+        viennacl::linalg::inplace_solve(L_11, trans(L_21), viennacl::linalg::lower_tag());
+
+        //
+        // Update lower triangle of A_22 -= L_21 L_21^T block column by block column.
+        // Blocks above the diagonal are skipped, diagonal blocks are computed in a buffer so that the upper triangle of A is not touched.
+        //
+        for (vcl_size_t j = k_end; j < n; j += block_size)
+        {
+          vcl_size_t j_end = std::min<vcl_size_t>(n, j + block_size);
+
+          viennacl::range column_range(j, j_end);
+          viennacl::matrix_range<MatrixType> L_21_d(A, column_range, block_range);
+
+          if (j_end < n)
+          {
+            viennacl::range lower_range(j_end, n);
+            viennacl::matrix_range<MatrixType> A_22_j(A, lower_range, column_range);
+            viennacl::matrix_range<MatrixType> L_21_j(A, lower_range, block_range);
+
+            A_22_j -= viennacl::linalg::prod(L_21_j, trans(L_21_d));
+          }
+
+          viennacl::matrix_range<MatrixType> D(diagonal_update, viennacl::range(0, j_end - j), viennacl::range(0, j_end - j));
+          D = viennacl::linalg::prod(L_21_d, trans(L_21_d));
+          for (vcl_size_t i = 0; i < j_end - j; ++i)
+            for (vcl_size_t l = 0; l <= i; ++l)
+              A_wrapper(j + i, j + l) -= D_wrapper(i, l);
+        }
+      }
+    }
+  }
+  catch (...)
+  {
+    if (ctx.memory_type() != viennacl::MAIN_MEMORY)
+      A.switch_memory_context(ctx);
+    throw;
+  }
+
+  if (ctx.memory_type() != viennacl::MAIN_MEMORY)
+    A.switch_memory_context(ctx);
+}
+
+
+//
+// Convenience layer:
+//
+
+/** @brief Cholesky substitution for the system L L^T X = B.
+*
+* @param A    The Cholesky factor L in the lower triangular part as computed by cholesky_factorize()
+* @param B    The matrix of load vectors, where the solution is directly written to
+*/
+template<typename NumericT, typename F1, typename F2, unsigned int AlignmentV1, unsigned int AlignmentV2>
+void cholesky_substitute(matrix<NumericT, F1, AlignmentV1> const & A,
+                         matrix<NumericT, F2, AlignmentV2> & B)
+{
+  assert(A.size1() == A.size2() && bool("Matrix must be square"));
+  assert(A.size1() == B.size1() && bool("Matrix must be square"));
+  inplace_solve(A, B, lower_tag());
+  inplace_solve(trans(A), B, upper_tag());
+}
+
+/** @brief Cholesky substitution for the system L L^T x = b.
+*
+* @param A      The Cholesky factor L in the lower triangular part as computed by cholesky_factorize()
+* @param vec    The load vector, where the solution is directly written to
+*/
+template<typename NumericT, typename F, unsigned int MatAlignmentV, unsigned int VecAlignmentV>
+void cholesky_substitute(matrix<NumericT, F, MatAlignmentV> const & A,
+                         vector<NumericT, VecAlignmentV> & vec)
+{
+  assert(A.size1() == A.size2() && bool("Matrix must be square"));
+  inplace_solve(A, vec, lower_tag());
+  inplace_solve(trans(A), vec, upper_tag());
+}
+
+}
+}
+
+#endif
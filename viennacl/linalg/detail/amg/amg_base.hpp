@@ -29,6 +29,7 @@
 #include <list>
 #include <stdexcept>
 #include <algorithm>
+#include <vector>
 
 #include <map>
 #ifdef VIENNACL_WITH_OPENMP
@@ -164,6 +165,84 @@ namespace amg
 {
 
 
+  /** @brief Symbolic phase of the Galerkin product A_coarse = trans(P) * A_fine * P, reused if the product is recomputed for new values with the same sparsity patterns.
+  *
+  * Holds the sparsity pattern of A_coarse, an index of the nonzeros of P by column (i.e. the pattern of trans(P) without values),
+  * the distribution of the rows of A_coarse among threads, and the per-thread work buffers.
+  * A copy of the sparsity pattern of A_fine is kept for detecting whether the plan can be reused for a new A_fine.
+  */
+  class amg_galerkin_plan
+  {
+  public:
+    amg_galerkin_plan() : fine_size_(0), coarse_size_(0), A_nnz_(0), P_nnz_(0) {}
+
+    /** @brief Returns true if the symbolic phase has not been carried out yet */
+    bool empty() const { return coarse_row_indices_.empty(); }
+
+    /** @brief Returns true if the plan has been set up for operands with the given sizes and numbers of nonzeros */
+    bool matches(vcl_size_t fine_size, vcl_size_t coarse_size, vcl_size_t A_nnz, vcl_size_t P_nnz) const
+    {
+      return !empty() && fine_size_ == fine_size && coarse_size_ == coarse_size && A_nnz_ == A_nnz && P_nnz_ == P_nnz;
+    }
+
+    void init(vcl_size_t fine_size, vcl_size_t coarse_size, vcl_size_t A_nnz, vcl_size_t P_nnz)
+    {
+      fine_size_   = fine_size;
+      coarse_size_ = coarse_size;
+      A_nnz_       = A_nnz;
+      P_nnz_       = P_nnz;
+      std::vector<std::vector<unsigned int> >().swap(work_buffers_);
+    }
+
+    void clear()
+    {
+      init(0, 0, 0, 0);
+      std::vector<unsigned int>().swap(A_row_indices_);
+      std::vector<unsigned int>().swap(A_col_indices_);
+      std::vector<unsigned int>().swap(coarse_row_indices_);
+      std::vector<unsigned int>().swap(coarse_col_indices_);
+      std::vector<unsigned int>().swap(P_trans_row_indices_);
+      std::vector<unsigned int>().swap(P_trans_col_indices_);
+      std::vector<unsigned int>().swap(P_trans_entries_);
+      std::vector<vcl_size_t>().swap(chunk_starts_);
+    }
+
+    vcl_size_t fine_size()   const { return fine_size_; }
+    vcl_size_t coarse_size() const { return coarse_size_; }
+    vcl_size_t coarse_nnz()  const { return coarse_col_indices_.size(); }
+
+    /** @brief Ensures that work buffers for at least 'num_threads' threads are available */
+    void reserve_work_buffers(vcl_size_t num_threads)
+    {
+      if (work_buffers_.size() < num_threads)
+        work_buffers_.resize(num_threads);
+    }
+
+    /** @brief Work buffer of thread 'id' with at least coarse_size() entries */
+    std::vector<unsigned int> & work_buffer(vcl_size_t id)
+    {
+      if (work_buffers_[id].size() < coarse_size_)
+        work_buffers_[id].resize(coarse_size_);
+      return work_buffers_[id];
+    }
+
+    std::vector<unsigned int> A_row_indices_;       // row pointers of A_fine
+    std::vector<unsigned int> A_col_indices_;       // column indices of A_fine
+    std::vector<unsigned int> coarse_row_indices_;  // row pointers of A_coarse
+    std::vector<unsigned int> coarse_col_indices_;  // column indices of A_coarse
+    std::vector<unsigned int> P_trans_row_indices_; // row pointers of trans(P)
+    std::vector<unsigned int> P_trans_col_indices_; // column indices of trans(P), i.e. row indices of P
+    std::vector<unsigned int> P_trans_entries_;     // position of the respective entry in the arrays of P
+    std::vector<vcl_size_t>   chunk_starts_;        // rows of A_coarse processed by each chunk of work
+
+  private:
+    vcl_size_t fine_size_;
+    vcl_size_t coarse_size_;
+    vcl_size_t A_nnz_;
+    vcl_size_t P_nnz_;
+    std::vector<std::vector<unsigned int> > work_buffers_;
+  };
+
   struct amg_level_context
   {
     void resize(vcl_size_t num_points, vcl_size_t max_nnz)
@@ -197,6 +276,8 @@ namespace amg
     viennacl::vector<unsigned int> point_types_;      // 0: undecided, 1: coarse point, 2: fine point. Using char here because type for enum might be a larger type
     viennacl::vector<unsigned int> coarse_id_;        // coarse ID used on the next level. Only valid for coarse points. Fine points may (ab)use their entry for something else.
     unsigned int num_coarse_;
+
+    amg_galerkin_plan galerkin_plan_; // symbolic phase of the Galerkin product for the coarse operator on the next level
   };
 
 
@@ -42,9 +42,11 @@
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/linalg/detail/ilu/common.hpp"
 #include "viennacl/compressed_matrix.hpp"
+#include "viennacl/bsr_matrix.hpp"
 #include "viennacl/backend/memory.hpp"
 
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_factor.hpp"
 
 #include <map>
 
@@ -237,7 +239,12 @@ public:
     }
     else //apply ILU0 directly on CPU
     {
-      if (tag_.use_level_scheduling())
+      if (tag_.use_level_scheduling() && !host_L_.empty())
+      {
+        host_L_.apply(vec);
+        host_U_.apply(vec);
+      }
+      else if (tag_.use_level_scheduling())
       {
         //std::cout << "Using multifrontal..." << std::endl;
         detail::level_scheduling_substitute(vec,
@@ -264,7 +271,7 @@ public:
     }
   }
 
-  vcl_size_t levels() const { return multifrontal_L_row_index_arrays_.size(); }
+  vcl_size_t levels() const { return host_L_.empty() ? multifrontal_L_row_index_arrays_.size() : host_L_.levels(); }
 
 private:
   void init(MatrixType const & mat)
@@ -277,6 +284,14 @@ private:
     if (!tag_.use_level_scheduling())
       return;
 
+    // level-ordered factors for multi-threaded substitution if the system matrix is in main memory:
+    if (viennacl::traits::context(mat).memory_type() == viennacl::MAIN_MEMORY)
+    {
+      host_L_.init(LU_, unit_lower_tag());
+      host_U_.init(LU_, upper_tag());
+      return;
+    }
+
     // multifrontal part:
     viennacl::switch_memory_context(multifrontal_U_diagonal_, host_context);
     multifrontal_U_diagonal_.resize(LU_.size1(), false);
@@ -354,6 +369,9 @@ private:
   ilu0_tag tag_;
   viennacl::compressed_matrix<NumericT> LU_;
 
+  viennacl::linalg::host_based::sparse_triangular_factor<NumericT> host_L_;
+  viennacl::linalg::host_based::sparse_triangular_factor<NumericT> host_U_;
+
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_index_arrays_;
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_buffers_;
   std::list<viennacl::backend::mem_handle> multifrontal_L_col_buffers_;
@@ -369,6 +387,35 @@ private:
 
 };
 
+
+/** @brief ILU0 preconditioner class, can be supplied to solve()-routines.
+*
+*  Specialization for bsr_matrix: The factorization is computed on the block sparsity pattern, i.e. fill-in within the nonzero blocks is kept.
+*  The factors are stored as compressed_matrix in main memory, so that the options of ilu0_tag (e.g. level scheduling) apply as for compressed_matrix.
+*/
+template<typename NumericT, unsigned int BlockSize>
+class ilu0_precond< viennacl::bsr_matrix<NumericT, BlockSize> >
+{
+  typedef viennacl::bsr_matrix<NumericT, BlockSize>   MatrixType;
+
+public:
+  ilu0_precond(MatrixType const & mat, ilu0_tag const & tag) : precond_(to_compressed(mat), tag) {}
+
+  void apply(viennacl::vector<NumericT> & vec) const { precond_.apply(vec); }
+
+  vcl_size_t levels() const { return precond_.levels(); }
+
+private:
+  static viennacl::compressed_matrix<NumericT> to_compressed(MatrixType const & mat)
+  {
+    viennacl::compressed_matrix<NumericT> A(mat.size1(), mat.size2(), viennacl::context(viennacl::MAIN_MEMORY));
+    viennacl::copy(mat, A);
+    return A;
+  }
+
+  ilu0_precond< viennacl::compressed_matrix<NumericT> > precond_;
+};
+
 } // namespace linalg
 } // namespace viennacl
 
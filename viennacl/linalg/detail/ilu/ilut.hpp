@@ -32,6 +32,7 @@
 #include "viennacl/compressed_matrix.hpp"
 
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_factor.hpp"
 
 #include <map>
 
@@ -49,7 +50,7 @@ class ilut_tag
     *
     * @param entries_per_row        Number of nonzero entries per row in L and U. Note that L and U are stored in a single matrix, thus there are 2*entries_per_row in total.
     * @param drop_tolerance         The drop tolerance for ILUT
-    * @param with_level_scheduling  Flag for enabling level scheduling on GPUs.
+    * @param with_level_scheduling  Flag for enabling level scheduling on GPUs and multi-threaded triangular solves on the host.
     */
     ilut_tag(unsigned int entries_per_row = 20,
              double       drop_tolerance = 1e-4,
@@ -533,6 +534,11 @@ public:
         // return result:
         vec = x_k_;
       }
+      else if (!host_L_.empty())
+      {
+        host_L_.apply(vec);
+        host_U_.apply(vec);
+      }
       else
       {
         viennacl::linalg::inplace_solve(L_, vec, unit_lower_tag());
@@ -580,6 +586,14 @@ private:
     if (!tag_.use_level_scheduling())
       return;
 
+    // level-ordered factors for multi-threaded substitution if the system matrix is in main memory:
+    if (viennacl::traits::context(mat).memory_type() == viennacl::MAIN_MEMORY)
+    {
+      host_L_.init(L_, unit_lower_tag());
+      host_U_.init(U_, upper_tag());
+      return;
+    }
+
     //
     // multifrontal part:
     //
@@ -663,6 +677,9 @@ private:
   viennacl::compressed_matrix<NumericT> L_;
   viennacl::compressed_matrix<NumericT> U_;
 
+  viennacl::linalg::host_based::sparse_triangular_factor<NumericT> host_L_;
+  viennacl::linalg::host_based::sparse_triangular_factor<NumericT> host_U_;
+
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_index_arrays_;
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_buffers_;
   std::list<viennacl::backend::mem_handle> multifrontal_L_col_buffers_;
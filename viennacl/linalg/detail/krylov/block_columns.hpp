@@ -0,0 +1,108 @@
+#ifndef VIENNACL_LINALG_DETAIL_KRYLOV_BLOCK_COLUMNS_HPP_
+#define VIENNACL_LINALG_DETAIL_KRYLOV_BLOCK_COLUMNS_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/krylov/block_columns.hpp
+    @brief Column operations on the blocks of vectors used by block Krylov methods for multiple right-hand sides.
+
+    The blocks are stored as columns of column-major matrices, so that each column is a contiguous vector.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/detail/krylov/small_dense.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace detail
+{
+
+/** @brief Copies column 'from' of the column-major matrix src to column 'to' of the column-major matrix dst */
+template<typename NumericT>
+void copy_block_column(viennacl::matrix<NumericT, viennacl::column_major> const & src, vcl_size_t from,
+                       viennacl::matrix<NumericT, viennacl::column_major>       & dst, vcl_size_t to)
+{
+  viennacl::vector_base<NumericT> dst_column(dst.handle(), dst.size1(), to * dst.internal_size1(), 1);
+  dst_column = viennacl::vector_base<NumericT>(const_cast<viennacl::backend::mem_handle &>(src.handle()), src.size1(), from * src.internal_size1(), 1);
+}
+
+/** @brief Moves the columns first + keep[i] of the column-major matrix M to the columns first + i, where keep is increasing */
+template<typename NumericT>
+void compact_block_columns(viennacl::matrix<NumericT, viennacl::column_major> & M, vcl_size_t first, std::vector<vcl_size_t> const & keep)
+{
+  for (vcl_size_t i = 0; i < keep.size(); ++i)
+    if (keep[i] != i)
+      copy_block_column(M, first + keep[i], M, first + i);
+}
+
+/** @brief Copies the columns of the matrix src, which may have either layout, to the columns first, first+1, ... of the column-major matrix dst */
+template<typename NumericT>
+void copy_to_block_columns(viennacl::matrix_base<NumericT> const & src,
+                           viennacl::matrix<NumericT, viennacl::column_major> & dst, vcl_size_t first)
+{
+  if (src.row_major())
+  {
+    for (vcl_size_t j = 0; j < src.size2(); ++j)
+    {
+      viennacl::vector_base<NumericT> dst_column(dst.handle(), dst.size1(), (first + j) * dst.internal_size1(), 1);
+      dst_column = viennacl::column(src, static_cast<unsigned int>(j));
+    }
+  }
+  else
+  {
+    viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > dst_block(dst, viennacl::range(0, src.size1()), viennacl::range(first, first + src.size2()));
+    static_cast<viennacl::matrix_base<NumericT> &>(dst_block) = src;
+  }
+}
+
+/** @brief Returns the Euclidean norms of the columns of the block V, computed from the Gram matrix V^T V in a single reduction.
+  *
+  * @param V       The block of vectors
+  * @param gram    Work matrix for the Gram matrix on the device, resized if necessary
+  */
+template<typename NumericT, typename MatrixT>
+std::vector<double> block_column_norms(MatrixT const & V, viennacl::matrix<NumericT> & gram)
+{
+  if (gram.size1() != V.size2() || gram.size2() != V.size2())
+    gram.resize(V.size2(), V.size2(), false);
+  gram = viennacl::linalg::prod(viennacl::trans(V), V);
+
+  std::vector<double> host_gram;
+  read_small_matrix(gram, host_gram);
+
+  std::vector<double> norms(V.size2());
+  for (vcl_size_t i = 0; i < V.size2(); ++i)
+    norms[i] = std::sqrt(std::max(host_gram[i * V.size2() + i], 0.0));
+  return norms;
+}
+
+} //namespace detail
+} //namespace linalg
+} //namespace viennacl
+
+#endif
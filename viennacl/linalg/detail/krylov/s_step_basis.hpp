@@ -0,0 +1,187 @@
+#ifndef VIENNACL_LINALG_DETAIL_KRYLOV_S_STEP_BASIS_HPP_
+#define VIENNACL_LINALG_DETAIL_KRYLOV_S_STEP_BASIS_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/krylov/s_step_basis.hpp
+    @brief Generation of the Krylov bases used by the s-step (communication-avoiding) CG and GMRES solvers.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/sparse_matrix_operations.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief Enumeration of the polynomial bases used for generating s Krylov vectors at once in s-step solvers. */
+enum s_step_basis_type
+{
+  S_STEP_BASIS_MONOMIAL = 1,   // v_{j+1} = A v_j / sigma
+  S_STEP_BASIS_NEWTON          // v_{j+1} = (A - theta_j I) v_j / sigma, with Leja-ordered Ritz values theta_j
+};
+
+namespace detail
+{
+
+/** @brief The recurrence v_{j+1} = (A v_j - theta_j v_j) / sigma_j used for generating the Krylov vectors of an s-step solver.
+  *
+  * Until Ritz values are supplied via set_ritz_values(), the unscaled monomial basis (theta_j = 0, sigma_j = 1) is used.
+  */
+class s_step_recurrence
+{
+public:
+  s_step_recurrence(vcl_size_t s, s_step_basis_type basis) : basis_(basis), theta_(s, 0.0), sigma_(s, 1.0) {}
+
+  double theta(vcl_size_t j) const { return theta_[j]; }
+  double sigma(vcl_size_t j) const { return sigma_[j]; }
+
+  /** @brief Returns the (k+1) x k change-of-basis matrix T (row-major) satisfying A V(:, 0:k) = V(:, 0:k+1) T for the basis vectors V generated by the recurrence */
+  std::vector<double> change_of_basis(vcl_size_t k) const
+  {
+    std::vector<double> T((k+1) * k, 0.0);
+    for (vcl_size_t j = 0; j < k; ++j)
+    {
+      T[j*k + j]     = theta_[j];
+      T[(j+1)*k + j] = sigma_[j];
+    }
+    return T;
+  }
+
+  /** @brief Sets the shifts and the scaling from estimates of the eigenvalues of A.
+    *
+    * The monomial basis is scaled by the largest modulus of the Ritz values. The Newton basis uses the Ritz values as shifts in Leja ordering,
+    * which keeps the basis vectors well separated, and scales by the half-width of the spectral interval.
+    */
+  void set_ritz_values(std::vector<double> const & ritz_values)
+  {
+    if (ritz_values.empty())
+      return;
+
+    double max_abs = 0;
+    double lower = ritz_values[0];
+    double upper = ritz_values[0];
+    for (vcl_size_t i = 0; i < ritz_values.size(); ++i)
+    {
+      max_abs = std::max(max_abs, std::fabs(ritz_values[i]));
+      lower = std::min(lower, ritz_values[i]);
+      upper = std::max(upper, ritz_values[i]);
+    }
+    if (max_abs <= 0)
+      return;
+
+    if (basis_ == S_STEP_BASIS_NEWTON)
+    {
+      std::vector<double> shifts = leja_order(ritz_values);
+      double scaling = (upper > lower) ? 0.5 * (upper - lower) : max_abs;
+      for (vcl_size_t j = 0; j < theta_.size(); ++j)
+      {
+        theta_[j] = shifts[j % shifts.size()];
+        sigma_[j] = scaling;
+      }
+    }
+    else
+    {
+      for (vcl_size_t j = 0; j < theta_.size(); ++j)
+      {
+        theta_[j] = 0;
+        sigma_[j] = max_abs;
+      }
+    }
+  }
+
+private:
+  /** @brief Orders the points such that each point maximizes the product of the distances to the previous ones, starting with the point of largest modulus */
+  static std::vector<double> leja_order(std::vector<double> points)
+  {
+    std::vector<double> result;
+    std::vector<bool> used(points.size(), false);
+
+    while (result.size() < points.size())
+    {
+      vcl_size_t best = points.size();
+      double best_value = 0;
+      for (vcl_size_t i = 0; i < points.size(); ++i)
+      {
+        if (used[i])
+          continue;
+
+        double value = 0; // log of the product of distances, avoids overflow
+        if (result.empty())
+          value = std::fabs(points[i]);
+        else
+          for (vcl_size_t j = 0; j < result.size(); ++j)
+            value += std::log(std::fabs(points[i] - result[j]) + 1e-300);
+
+        if (best == points.size() || value > best_value)
+        {
+          best = i;
+          best_value = value;
+        }
+      }
+      used[best] = true;
+      result.push_back(points[best]);
+    }
+    return result;
+  }
+
+  s_step_basis_type basis_;
+  std::vector<double> theta_;
+  std::vector<double> sigma_;
+};
+
+
+/** @brief Generates the basis vectors V(:, first+1), ..., V(:, first+k) from V(:, first) with k sparse matrix-vector products.
+  *
+  * @param A       The system matrix
+  * @param V       The column-major matrix holding the basis vectors as columns
+  * @param first   Column of V holding the start vector
+  * @param k       Number of basis vectors to generate
+  * @param recurrence   The shifts and scalings of the basis
+  */
+template<typename MatrixT, typename NumericT>
+void s_step_generate_basis(MatrixT const & A, viennacl::matrix<NumericT, viennacl::column_major> & V, vcl_size_t first, vcl_size_t k, s_step_recurrence const & recurrence)
+{
+  for (vcl_size_t j = 0; j < k; ++j)
+  {
+    viennacl::vector_base<NumericT> v_j   (V.handle(), V.size1(), (first + j)     * V.internal_size1(), 1);
+    viennacl::vector_base<NumericT> v_next(V.handle(), V.size1(), (first + j + 1) * V.internal_size1(), 1);
+
+    NumericT inv_sigma = NumericT(1.0 / recurrence.sigma(j));
+    if (recurrence.theta(j) != 0)
+    {
+      v_next = v_j * NumericT(-recurrence.theta(j) / recurrence.sigma(j));
+      viennacl::linalg::prod_impl(A, v_j, inv_sigma, v_next, NumericT(1));
+    }
+    else
+      viennacl::linalg::prod_impl(A, v_j, inv_sigma, v_next, NumericT(0));
+  }
+}
+
+} //namespace detail
+} //namespace linalg
+} //namespace viennacl
+
+#endif
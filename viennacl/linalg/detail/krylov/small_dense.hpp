@@ -0,0 +1,384 @@
+#ifndef VIENNACL_LINALG_DETAIL_KRYLOV_SMALL_DENSE_HPP_
+#define VIENNACL_LINALG_DETAIL_KRYLOV_SMALL_DENSE_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/krylov/small_dense.hpp
+    @brief Routines for the small dense matrices (Gram matrices, projected operators) arising in block and s-step Krylov methods.
+
+    The small matrices are kept on the host in double precision as row-major arrays in std::vector<double>.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/vector.hpp"
+#include "viennacl/backend/memory.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace detail
+{
+
+/** @brief Computes the Cholesky factor L of the leading part of the symmetric n x n matrix A (row-major) in place.
+  *
+  * The factorization stops at the first pivot which is not larger than pivot_tolerance times the respective diagonal entry of A,
+  * i.e. at the first column which is numerically linearly dependent on the previous ones.
+  *
+  * @return The number of columns factored successfully. Only the leading block of this size holds L.
+  */
+inline vcl_size_t small_cholesky(std::vector<double> & A, vcl_size_t n, double pivot_tolerance)
+{
+  for (vcl_size_t j = 0; j < n; ++j)
+  {
+    double diag = A[j*n+j];
+    double pivot = diag;
+    for (vcl_size_t k = 0; k < j; ++k)
+      pivot -= A[j*n+k] * A[j*n+k];
+
+    if (!(pivot > pivot_tolerance * std::fabs(diag)) || !(pivot > 0))
+      return j;
+
+    double L_jj = std::sqrt(pivot);
+    A[j*n+j] = L_jj;
+    for (vcl_size_t i = j+1; i < n; ++i)
+    {
+      double value = A[i*n+j];
+      for (vcl_size_t k = 0; k < j; ++k)
+        value -= A[i*n+k] * A[j*n+k];
+      A[i*n+j] = value / L_jj;
+    }
+    for (vcl_size_t i = j+1; i < n; ++i) // clear upper triangle
+      A[j*n+i] = 0;
+  }
+  return n;
+}
+
+/** @brief Solves L L^T x = b in place for the leading k x k block of the Cholesky factor L (row-major, leading dimension n) */
+inline void small_cholesky_solve(std::vector<double> const & L, vcl_size_t n, vcl_size_t k, std::vector<double> & b)
+{
+  for (vcl_size_t i = 0; i < k; ++i)
+  {
+    for (vcl_size_t j = 0; j < i; ++j)
+      b[i] -= L[i*n+j] * b[j];
+    b[i] /= L[i*n+i];
+  }
+  for (vcl_size_t i = k; i-- > 0; )
+  {
+    for (vcl_size_t j = i+1; j < k; ++j)
+      b[i] -= L[j*n+i] * b[j];
+    b[i] /= L[i*n+i];
+  }
+}
+
+/** @brief Computes the eigenvalues of the symmetric n x n matrix A (row-major) with the cyclic Jacobi method. The eigenvalues are returned in ascending order. */
+inline std::vector<double> small_symmetric_eigenvalues(std::vector<double> A, vcl_size_t n)
+{
+  double norm = 0;
+  for (vcl_size_t i = 0; i < n*n; ++i)
+    norm += A[i] * A[i];
+
+  for (unsigned int sweep = 0; sweep < 50; ++sweep)
+  {
+    double off_diag = 0;
+    for (vcl_size_t i = 0; i < n; ++i)
+      for (vcl_size_t j = i+1; j < n; ++j)
+        off_diag += A[i*n+j] * A[i*n+j];
+    if (off_diag <= 1e-30 * norm)
+      break;
+
+    for (vcl_size_t p = 0; p < n; ++p)
+      for (vcl_size_t q = p+1; q < n; ++q)
+      {
+        if (A[p*n+q] == 0)
+          continue;
+
+        double theta = (A[q*n+q] - A[p*n+p]) / (2.0 * A[p*n+q]);
+        double t = ((theta >= 0) ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+        double c = 1.0 / std::sqrt(t * t + 1.0);
+        double s = t * c;
+
+        for (vcl_size_t k = 0; k < n; ++k) // A = A J
+        {
+          double a_kp = A[k*n+p];
+          double a_kq = A[k*n+q];
+          A[k*n+p] = c * a_kp - s * a_kq;
+          A[k*n+q] = s * a_kp + c * a_kq;
+        }
+        for (vcl_size_t k = 0; k < n; ++k) // A = J^T A
+        {
+          double a_pk = A[p*n+k];
+          double a_qk = A[q*n+k];
+          A[p*n+k] = c * a_pk - s * a_qk;
+          A[q*n+k] = s * a_pk + c * a_qk;
+        }
+      }
+  }
+
+  std::vector<double> eigenvalues(n);
+  for (vcl_size_t i = 0; i < n; ++i)
+    eigenvalues[i] = A[i*n+i];
+  std::sort(eigenvalues.begin(), eigenvalues.end());
+  return eigenvalues;
+}
+
+
+/** @brief Computes the eigenvalues of the generalized symmetric eigenvalue problem M y = lambda B y for symmetric positive definite B (both n x n, row-major).
+  *
+  * If B is numerically singular, only the leading block on which the Cholesky factorization of B succeeds (see small_cholesky()) is considered.
+  */
+inline std::vector<double> small_generalized_eigenvalues(std::vector<double> const & M, std::vector<double> B, vcl_size_t n, double pivot_tolerance)
+{
+  vcl_size_t r = small_cholesky(B, n, pivot_tolerance);
+
+  // X = L^{-1} M L^{-T} on the leading r x r block:
+  std::vector<double> X(r * r);
+  for (vcl_size_t i = 0; i < r; ++i)
+    for (vcl_size_t j = 0; j < r; ++j)
+      X[i*r+j] = M[i*n+j];
+
+  for (vcl_size_t j = 0; j < r; ++j)
+    for (vcl_size_t i = 0; i < r; ++i)
+    {
+      for (vcl_size_t l = 0; l < i; ++l)
+        X[i*r+j] -= B[i*n+l] * X[l*r+j];
+      X[i*r+j] /= B[i*n+i];
+    }
+  for (vcl_size_t i = 0; i < r; ++i)
+    for (vcl_size_t j = 0; j < r; ++j)
+    {
+      for (vcl_size_t l = 0; l < j; ++l)
+        X[i*r+j] -= B[j*n+l] * X[i*r+l];
+      X[i*r+j] /= B[j*n+j];
+    }
+
+  for (vcl_size_t i = 0; i < r; ++i)
+    for (vcl_size_t j = i+1; j < r; ++j)
+    {
+      double value = 0.5 * (X[i*r+j] + X[j*r+i]);
+      X[i*r+j] = value;
+      X[j*r+i] = value;
+    }
+
+  return small_symmetric_eigenvalues(X, r);
+}
+
+
+/** @brief Returns an orthonormal basis of the span of the rows x cols matrix A (row-major, linearly independent columns), computed by modified Gram-Schmidt applied twice */
+inline std::vector<double> small_orthonormal_columns(std::vector<double> A, vcl_size_t rows, vcl_size_t cols)
+{
+  for (vcl_size_t j = 0; j < cols; ++j)
+  {
+    for (unsigned int pass = 0; pass < 2; ++pass)
+      for (vcl_size_t l = 0; l < j; ++l)
+      {
+        double value = 0;
+        for (vcl_size_t i = 0; i < rows; ++i)
+          value += A[i*cols+l] * A[i*cols+j];
+        for (vcl_size_t i = 0; i < rows; ++i)
+          A[i*cols+j] -= value * A[i*cols+l];
+      }
+
+    double norm = 0;
+    for (vcl_size_t i = 0; i < rows; ++i)
+      norm += A[i*cols+j] * A[i*cols+j];
+    norm = std::sqrt(norm);
+    for (vcl_size_t i = 0; i < rows; ++i)
+      A[i*cols+j] = (norm > 0) ? A[i*cols+j] / norm : 0;
+  }
+  return A;
+}
+
+/** @brief Returns an orthonormal basis (n x k, row-major) of the invariant subspace of the n x n matrix K (row-major) belonging to its k eigenvalues of largest modulus.
+  *
+  * Computed by orthogonal subspace iteration, which needs no complex arithmetic for complex conjugate eigenvalue pairs.
+  * If the iteration does not converge within max_iterations, the last iterate is returned, which still approximates the dominant subspace.
+  */
+inline std::vector<double> small_dominant_subspace(std::vector<double> const & K, vcl_size_t n, vcl_size_t k,
+                                                   unsigned int max_iterations = 500, double tolerance = 1e-10)
+{
+  // deterministic start which is not aligned with the coordinate axes:
+  std::vector<double> Q(n * k);
+  for (vcl_size_t i = 0; i < n * k; ++i)
+    Q[i] = std::sin(1.0 + static_cast<double>(i) * static_cast<double>(i));
+  Q = small_orthonormal_columns(Q, n, k);
+
+  std::vector<double> X(n * k);
+  for (unsigned int iter = 0; iter < max_iterations; ++iter)
+  {
+    for (vcl_size_t i = 0; i < n; ++i)
+      for (vcl_size_t j = 0; j < k; ++j)
+      {
+        double value = 0;
+        for (vcl_size_t l = 0; l < n; ++l)
+          value += K[i*n+l] * Q[l*k+j];
+        X[i*k+j] = value;
+      }
+
+    // converged if K Q is contained in the span of Q:
+    double norm_X = 0;
+    double norm_E = 0;
+    for (vcl_size_t j = 0; j < k; ++j)
+    {
+      std::vector<double> E(n);
+      for (vcl_size_t i = 0; i < n; ++i)
+        E[i] = X[i*k+j];
+      for (vcl_size_t l = 0; l < k; ++l)
+      {
+        double value = 0;
+        for (vcl_size_t i = 0; i < n; ++i)
+          value += Q[i*k+l] * X[i*k+j];
+        for (vcl_size_t i = 0; i < n; ++i)
+          E[i] -= value * Q[i*k+l];
+      }
+      for (vcl_size_t i = 0; i < n; ++i)
+      {
+        norm_X += X[i*k+j] * X[i*k+j];
+        norm_E += E[i] * E[i];
+      }
+    }
+
+    Q = small_orthonormal_columns(X, n, k);
+    if (norm_E <= tolerance * tolerance * norm_X)
+      break;
+  }
+  return Q;
+}
+
+/** @brief Solves the least squares problems min ||B(:, c) - A Y(:, c)|| for the rows x cols matrix A and the rows x nrhs matrix B (both row-major) via Householder QR.
+  *
+  * @param residual_norms   Returns the norm of the residual of each of the nrhs least squares problems
+  * @return The cols x nrhs solution Y (row-major). Components belonging to zero diagonal entries of the R factor of A are set to zero.
+  */
+inline std::vector<double> small_least_squares(std::vector<double> A, vcl_size_t rows, vcl_size_t cols,
+                                               std::vector<double> B, vcl_size_t nrhs,
+                                               std::vector<double> & residual_norms)
+{
+  std::vector<double> v(rows);
+  for (vcl_size_t j = 0; j < cols && j < rows; ++j)
+  {
+    double norm_squared = 0;
+    for (vcl_size_t i = j; i < rows; ++i)
+      norm_squared += A[i*cols+j] * A[i*cols+j];
+    if (norm_squared <= 0)
+      continue;
+
+    // reflector I - 2 v v^T / (v^T v) mapping A(j:rows, j) to beta e_j:
+    double beta = (A[j*cols+j] > 0) ? -std::sqrt(norm_squared) : std::sqrt(norm_squared);
+    for (vcl_size_t i = j; i < rows; ++i)
+      v[i] = A[i*cols+j];
+    v[j] -= beta;
+    double v_norm_squared = norm_squared - A[j*cols+j] * A[j*cols+j] + v[j] * v[j];
+
+    for (vcl_size_t l = j; l < cols; ++l)
+    {
+      double w = 0;
+      for (vcl_size_t i = j; i < rows; ++i)
+        w += v[i] * A[i*cols+l];
+      w *= 2.0 / v_norm_squared;
+      for (vcl_size_t i = j; i < rows; ++i)
+        A[i*cols+l] -= w * v[i];
+    }
+    for (vcl_size_t l = 0; l < nrhs; ++l)
+    {
+      double w = 0;
+      for (vcl_size_t i = j; i < rows; ++i)
+        w += v[i] * B[i*nrhs+l];
+      w *= 2.0 / v_norm_squared;
+      for (vcl_size_t i = j; i < rows; ++i)
+        B[i*nrhs+l] -= w * v[i];
+    }
+  }
+
+  vcl_size_t rank_rows = std::min(rows, cols);
+  std::vector<double> Y(cols * nrhs, 0.0);
+  for (vcl_size_t l = 0; l < nrhs; ++l)
+    for (vcl_size_t i = rank_rows; i-- > 0; )
+    {
+      double value = B[i*nrhs+l];
+      for (vcl_size_t k = i+1; k < rank_rows; ++k)
+        value -= A[i*cols+k] * Y[k*nrhs+l];
+      Y[i*nrhs+l] = (A[i*cols+i] != 0) ? value / A[i*cols+i] : 0;
+    }
+
+  residual_norms.resize(nrhs);
+  for (vcl_size_t l = 0; l < nrhs; ++l)
+  {
+    double norm_squared = 0;
+    for (vcl_size_t i = rank_rows; i < rows; ++i)
+      norm_squared += B[i*nrhs+l] * B[i*nrhs+l];
+    residual_norms[l] = std::sqrt(norm_squared);
+  }
+
+  return Y;
+}
+
+
+/** @brief Reads a small row-major viennacl::matrix into a row-major host array in double precision */
+template<typename NumericT>
+void read_small_matrix(viennacl::matrix<NumericT> const & M, std::vector<double> & host)
+{
+  std::vector<NumericT> buffer(M.internal_size());
+  if (buffer.size() > 0)
+    viennacl::backend::memory_read(M.handle(), 0, sizeof(NumericT) * buffer.size(), &(buffer[0]));
+
+  host.resize(M.size1() * M.size2());
+  for (vcl_size_t i = 0; i < M.size1(); ++i)
+    for (vcl_size_t j = 0; j < M.size2(); ++j)
+      host[i*M.size2()+j] = static_cast<double>(buffer[i*M.internal_size2()+j]);
+}
+
+/** @brief Writes the rows x cols row-major host array to the small row-major viennacl::matrix M, which is resized if necessary */
+template<typename NumericT>
+void write_small_matrix(std::vector<double> const & host, vcl_size_t rows, vcl_size_t cols, viennacl::matrix<NumericT> & M)
+{
+  if (M.size1() != rows || M.size2() != cols)
+    M.resize(rows, cols, false);
+
+  std::vector<NumericT> buffer(M.internal_size());
+  for (vcl_size_t i = 0; i < rows; ++i)
+    for (vcl_size_t j = 0; j < cols; ++j)
+      buffer[i*M.internal_size2()+j] = static_cast<NumericT>(host[i*cols+j]);
+
+  if (buffer.size() > 0)
+    viennacl::backend::memory_write(M.handle(), 0, sizeof(NumericT) * buffer.size(), &(buffer[0]));
+}
+
+/** @brief Writes the first 'size' entries of the host array to the small vector v, which is resized if necessary */
+template<typename NumericT>
+void write_small_vector(std::vector<double> const & host, vcl_size_t size, viennacl::vector<NumericT> & v)
+{
+  if (v.size() != size)
+    v.resize(size, false);
+
+  std::vector<NumericT> buffer(size);
+  for (vcl_size_t i = 0; i < size; ++i)
+    buffer[i] = static_cast<NumericT>(host[i]);
+  viennacl::copy(buffer, v);
+}
+
+} //namespace detail
+} //namespace linalg
+} //namespace viennacl
+
+#endif
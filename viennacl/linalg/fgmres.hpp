@@ -0,0 +1,342 @@
+#ifndef VIENNACL_LINALG_FGMRES_HPP_
+#define VIENNACL_LINALG_FGMRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/fgmres.hpp
+    @brief Implementation of the flexible GMRES method, which admits a different preconditioner in each iteration.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/vector_proxy.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/iterative_operations.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the flexible GMRES solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class fgmres_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+  * @param max_iterations The maximum number of iterations (including restarts)
+  * @param krylov_dim     The maximum dimension of the Krylov space before restart (number of restarts is found by max_iterations / krylov_dim)
+  */
+  fgmres_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20)
+   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim > 0 ? krylov_dim : 1), iters_taken_(0), last_error_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  unsigned int max_iterations() const { return iterations_; }
+  /** @brief Returns the maximum dimension of the Krylov space before restart */
+  unsigned int krylov_dim() const { return krylov_dim_; }
+  /** @brief Returns the maximum number of GMRES restarts */
+  unsigned int max_restarts() const
+  {
+    unsigned int ret = iterations_ / krylov_dim_;
+    if (ret > 0 && (ret * krylov_dim_ == iterations_) )
+      return ret - 1;
+    return ret;
+  }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  /** @brief Set the number of solver iterations (should only be modified by the solver) */
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  unsigned int krylov_dim_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+};
+
+
+/** @brief A preconditioner which applies an inner iterative solver, e.g. a few CG or mixed-precision CG iterations, for use with flexible GMRES.
+  *
+  * apply() replaces the vector v by the approximate solution of A y = v computed by the solver configured by the tag.
+  * Since the result depends on v in a nonlinear way, this preconditioner must only be used with a flexible outer solver.
+  */
+template<typename MatrixT, typename SolverTagT>
+class iterative_solver_precond
+{
+public:
+  iterative_solver_precond(MatrixT const & A, SolverTagT const & tag) : A_(A), tag_(tag) {}
+
+  template<typename VectorT>
+  void apply(VectorT & vec) const
+  {
+    VectorT result = viennacl::linalg::solve(A_, vec, tag_);
+    vec.fast_swap(result);
+  }
+
+  /** @brief Returns the tag of the inner solver, which holds the number of iterations of the last application */
+  SolverTagT const & tag() const { return tag_; }
+
+private:
+  MatrixT const & A_;
+  SolverTagT tag_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Implementation of the flexible GMRES method with right preconditioning.
+  *
+  * The flexible variant of 'A Simpler GMRES' by Walker and Zhou: The preconditioned directions z_k = M_k^{-1} v_{k-1} are stored, and the orthonormal basis v_k is obtained
+  * from A z_k with the pipelined Gram-Schmidt kernels of the pipelined GMRES solver. Since A Z = V R with upper triangular R, the solution update is Z R^{-1} V^T r.
+  * The preconditioner may change from one application to the next, e.g. an inner iterative solver with a varying number of iterations.
+  *
+  * A must be one of the sparse matrix types supported by the pipelined GMRES kernels (compressed_matrix, coordinate_matrix, ell_matrix, sliced_ell_matrix, hyb_matrix).
+  *
+  * @param A            The system matrix
+  * @param rhs          The load vector
+  * @param tag          Solver configuration tag
+  * @param precond      The (possibly variable) preconditioner. Precondition operation is done via member function apply()
+  * @return The result vector
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  viennacl::vector<NumericT> pipelined_fgmres_solve(MatrixT const & A,
+                                                    viennacl::vector<NumericT> const & rhs,
+                                                    fgmres_tag const & tag,
+                                                    PreconditionerT const & precond)
+  {
+    viennacl::vector<NumericT> residual(rhs);
+    viennacl::vector<NumericT> result = viennacl::zero_vector<NumericT>(rhs.size(), viennacl::traits::context(rhs));
+
+    vcl_size_t krylov_dim = std::min<vcl_size_t>(tag.krylov_dim(), rhs.size());
+
+    // Krylov basis V and preconditioned directions Z. z_0 is stored separately, z_k for k > 0 at position k-1 of Z, as expected by pipelined_gmres_update_result():
+    viennacl::vector<NumericT> device_krylov_basis(rhs.internal_size() * krylov_dim, viennacl::traits::context(rhs));
+    viennacl::vector<NumericT> device_precond_basis(rhs.internal_size() * krylov_dim, viennacl::traits::context(rhs));
+    viennacl::vector<NumericT> z_0(rhs);
+    viennacl::vector<NumericT> z_k(rhs);
+    viennacl::vector<NumericT> device_buffer_R(krylov_dim * krylov_dim, viennacl::traits::context(rhs));
+    std::vector<NumericT>      host_buffer_R(device_buffer_R.size());
+
+    vcl_size_t buffer_size_per_vector = 128;
+    vcl_size_t num_buffer_chunks      = 3;
+    viennacl::vector<NumericT> device_inner_prod_buffer = viennacl::zero_vector<NumericT>(num_buffer_chunks*buffer_size_per_vector, viennacl::traits::context(rhs)); // temporary buffer
+    viennacl::vector<NumericT> device_r_dot_vk_buffer   = viennacl::zero_vector<NumericT>(buffer_size_per_vector * krylov_dim, viennacl::traits::context(rhs)); // holds result of first reduction stage for <r, v_k> on device
+    viennacl::vector<NumericT> device_vi_in_vk_buffer   = viennacl::zero_vector<NumericT>(buffer_size_per_vector * krylov_dim, viennacl::traits::context(rhs)); // holds <v_i, v_k> for i=0..k-1 on device
+    viennacl::vector<NumericT> device_update_coefficients = viennacl::zero_vector<NumericT>(krylov_dim, viennacl::traits::context(rhs));
+    std::vector<NumericT>      host_r_dot_vk_buffer(device_r_dot_vk_buffer.size());
+    std::vector<NumericT>      host_values_xi_k(krylov_dim);
+    std::vector<NumericT>      host_values_eta_k_buffer(krylov_dim);
+    std::vector<NumericT>      host_update_coefficients(krylov_dim);
+
+    NumericT norm_rhs = viennacl::linalg::norm_2(residual);
+    NumericT rho_0 = norm_rhs;
+    NumericT rho = NumericT(1);
+
+    tag.iters(0);
+    tag.error(0);
+
+    if (norm_rhs <= NumericT(tag.abs_tolerance())) //solution is zero if RHS norm is zero
+      return result;
+
+    for (unsigned int restart_count = 0; restart_count <= tag.max_restarts(); ++restart_count)
+    {
+      //
+      // prepare restart:
+      //
+      if (restart_count > 0)
+      {
+        residual = viennacl::linalg::prod(A, result);
+        residual = rhs - residual;
+
+        rho_0 = viennacl::linalg::norm_2(residual);
+      }
+
+      tag.error(rho_0 / norm_rhs);
+      if (rho_0 / norm_rhs < tag.tolerance() || rho_0 < tag.abs_tolerance())
+        break;
+
+      residual /= rho_0;
+      rho = NumericT(1);
+
+      //
+      // minimize in the space spanned by the preconditioned directions:
+      //
+      vcl_size_t k = 0;
+      for (k = 0; k < krylov_dim; ++k)
+      {
+        viennacl::vector_range<viennacl::vector<NumericT> > vk(device_krylov_basis, viennacl::range(k*rhs.internal_size(), k*rhs.internal_size() + rhs.size()));
+
+        if (k == 0)
+        {
+          // z_0 = M^{-1} r, v_0 = A z_0 including the first reduction stage for ||v_0||:
+          viennacl::copy(residual, z_0);
+          precond.apply(z_0);
+          viennacl::linalg::pipelined_gmres_prod(A, z_0, vk, device_inner_prod_buffer);
+        }
+        else
+        {
+          // z_k = M_k^{-1} v_{k-1}, v_k = A z_k including the first reduction stage for ||v_k||:
+          viennacl::vector_range<viennacl::vector<NumericT> > vk_minus_1(device_krylov_basis, viennacl::range((k-1)*rhs.internal_size(), (k-1)*rhs.internal_size() + rhs.size()));
+          viennacl::vector_range<viennacl::vector<NumericT> > zk_stored (device_precond_basis, viennacl::range((k-1)*rhs.internal_size(), (k-1)*rhs.internal_size() + rhs.size()));
+          z_k = vk_minus_1;
+          precond.apply(z_k);
+          zk_stored = z_k;
+          viennacl::linalg::pipelined_gmres_prod(A, z_k, vk, device_inner_prod_buffer);
+
+          // Gram-Schmidt against v_0, ..., v_{k-1}, storing <v_i, v_k> in R and computing the first reduction stage for ||v_k||:
+          viennacl::linalg::pipelined_gmres_gram_schmidt_stage1(device_krylov_basis, rhs.size(), rhs.internal_size(), k, device_vi_in_vk_buffer, buffer_size_per_vector);
+          viennacl::linalg::pipelined_gmres_gram_schmidt_stage2(device_krylov_basis, rhs.size(), rhs.internal_size(), k,
+                                                                device_vi_in_vk_buffer,
+                                                                device_buffer_R, krylov_dim,
+                                                                device_inner_prod_buffer, buffer_size_per_vector);
+        }
+
+        // Normalize v_k and compute first reduction stage for <r, v_k> in device_r_dot_vk_buffer:
+        viennacl::linalg::pipelined_gmres_normalize_vk(vk, residual,
+                                                       device_buffer_R, k*krylov_dim + k,
+                                                       device_inner_prod_buffer, device_r_dot_vk_buffer,
+                                                       buffer_size_per_vector, k*buffer_size_per_vector);
+      }
+
+      //
+      // Run reduction to obtain the values \xi_k = <r, v_k>:
+      //
+      viennacl::fast_copy(device_r_dot_vk_buffer.begin(), device_r_dot_vk_buffer.end(), host_r_dot_vk_buffer.begin());
+      for (std::size_t i=0; i<k; ++i)
+      {
+        host_values_xi_k[i] = NumericT(0);
+        for (std::size_t j=0; j<buffer_size_per_vector; ++j)
+          host_values_xi_k[i] += host_r_dot_vk_buffer[i*buffer_size_per_vector + j];
+      }
+
+      viennacl::fast_copy(device_buffer_R.begin(), device_buffer_R.end(), host_buffer_R.begin());
+
+      //
+      // Check for premature convergence: If the diagonal element drops too far below the first norm, A z_k is (numerically) contained in the previous basis.
+      //
+      for (std::size_t i=0; i<k; ++i)
+      {
+        if (std::fabs(host_buffer_R[i + i*krylov_dim]) < tag.tolerance() * host_buffer_R[0])
+        {
+          k = i;
+          break;
+        }
+      }
+
+      // Compute error estimator:
+      for (std::size_t i=0; i<k; ++i)
+      {
+        tag.iters( tag.iters() + 1 ); //increase iteration counter
+
+        // |xi_i| reaching rho means that the residual is eliminated by v_i (e.g. for a very accurate preconditioner), or that orthogonality is lost.
+        // In both cases, no gain from using additional basis vectors, hence restrict the Krylov space after v_i:
+        if (host_values_xi_k[i] >= rho || host_values_xi_k[i] <= -rho)
+        {
+          host_values_xi_k[i] = (host_values_xi_k[i] > 0) ? rho : -rho;
+          rho = 0;
+          k = i + 1;
+          break;
+        }
+
+        // update error estimator
+        rho *= std::sin( std::acos(host_values_xi_k[i] / rho) );
+      }
+
+      //
+      // Solve R eta = xi and update x += rho_0 * Z eta:
+      //
+      host_values_eta_k_buffer = host_values_xi_k;
+
+      for (vcl_size_t i = k; i-- > 0; )
+      {
+        for (vcl_size_t j=i+1; j<k; ++j)
+          host_values_eta_k_buffer[i] -= host_buffer_R[i + j*krylov_dim] * host_values_eta_k_buffer[j];
+
+        host_values_eta_k_buffer[i] /= host_buffer_R[i + i*krylov_dim];
+      }
+
+      for (vcl_size_t i=0; i<k; ++i)
+        host_update_coefficients[i] = rho_0 * host_values_eta_k_buffer[i];
+
+      viennacl::fast_copy(host_update_coefficients.begin(), host_update_coefficients.end(), device_update_coefficients.begin());
+
+      viennacl::linalg::pipelined_gmres_update_result(result, z_0,
+                                                      device_precond_basis, rhs.size(), rhs.internal_size(),
+                                                      device_update_coefficients, k);
+
+      tag.error( std::fabs(rho*rho_0 / norm_rhs) );
+    }
+
+    return result;
+  }
+
+}
+
+/** @brief Solves A x = rhs with the flexible GMRES method and a (possibly variable) preconditioner.
+*
+* @param A          The system matrix, one of the sparse matrix types supported by the pipelined GMRES kernels
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @param precond    The preconditioner. Each call of its member function apply() may use a different preconditioning operator.
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT, typename PreconditionerT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, fgmres_tag const & tag, PreconditionerT const & precond)
+{
+  return detail::pipelined_fgmres_solve(A, rhs, tag, precond);
+}
+
+/** @brief Convenience overload for calling the flexible GMRES solver without preconditioner */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, fgmres_tag const & tag)
+{
+  return detail::pipelined_fgmres_solve(A, rhs, tag, viennacl::linalg::no_precond());
+}
+
+}
+}
+
+#endif
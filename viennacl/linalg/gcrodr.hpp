@@ -0,0 +1,538 @@
+#ifndef VIENNACL_LINALG_GCRODR_HPP_
+#define VIENNACL_LINALG_GCRODR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/gcrodr.hpp
+    @brief Implementation of the GCRO-DR method (GMRES with Krylov subspace recycling) for sequences of linear systems.
+
+    Following Parks, de Sturler, Mackey, Johnson, and Maiti, 'Recycling Krylov Subspaces for Sequences of Linear Systems', SIAM J. Sci. Comput. 28(5), 2006.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/tsqr.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/krylov/small_dense.hpp"
+#include "viennacl/linalg/detail/krylov/block_columns.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the GCRO-DR solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class gcrodr_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||rhs||)
+  * @param max_iterations The maximum number of iterations (including restarts)
+  * @param krylov_dim     The number of Arnoldi steps per restart cycle
+  * @param recycle_dim    The maximum number of vectors in the recycled subspace, which is kept between solver runs. Two vectors of the system size are stored per recycled vector.
+  */
+  gcrodr_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20, unsigned int recycle_dim = 10)
+   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim > 0 ? krylov_dim : 1), recycle_dim_(recycle_dim), iters_taken_(0), last_error_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  unsigned int max_iterations() const { return iterations_; }
+  /** @brief Returns the number of Arnoldi steps per restart cycle */
+  unsigned int krylov_dim() const { return krylov_dim_; }
+  /** @brief Returns the maximum dimension of the recycled subspace */
+  unsigned int recycle_dim() const { return recycle_dim_; }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  /** @brief Set the number of solver iterations (should only be modified by the solver) */
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the relative residual at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the relative residual at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  unsigned int krylov_dim_;
+  unsigned int recycle_dim_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+};
+
+
+namespace detail
+{
+
+  /** @brief The vectors kept by the GCRO-DR solver between runs.
+  *
+  * The columns of S hold the recycled vectors U (right-aligned in the first recycle_dim columns) followed by the preconditioned directions Z of the current cycle,
+  * the columns of W hold C = A U followed by the orthonormal Arnoldi basis V. Thus, [U Z] and [C V] are contiguous blocks of columns satisfying A [U Z] = [C V] G.
+  */
+  template<typename NumericT>
+  struct gcrodr_recycle_space
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+
+    gcrodr_recycle_space() : k(0) {}
+
+    BlockType  S;
+    BlockType  W;
+    BlockType  work;
+    vcl_size_t k;
+  };
+
+  /** @brief Replaces the recycled subspace by the span of the harmonic Ritz vectors of A for the harmonic Ritz values of smallest modulus.
+  *
+  * The search space of the last cycle is spanned by the s columns of [U Z] with A [U Z] = [C V] G, where G is (s+1) x s. The harmonic Ritz vectors [U Z] p solve
+  * G^T G p = theta G^T [C V]^T [U Z] p. The new recycled vectors are U = [U Z] P R^{-1} and C = [C V] Q for G P = Q R, so that C = A U with orthonormal C.
+  *
+  * @return False if the recycled subspace could not be updated (e.g. for a numerically singular G), in which case it is left unchanged.
+  */
+  template<typename NumericT>
+  bool gcrodr_update_recycle_space(gcrodr_recycle_space<NumericT> & space, vcl_size_t recycle_dim, vcl_size_t steps,
+                                   std::vector<double> const & G, vcl_size_t G_cols)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef viennacl::matrix_range<BlockType>                    BlockRangeType;
+
+    vcl_size_t n = space.S.size1();
+    vcl_size_t k = space.k;
+    vcl_size_t s = k + steps;
+    vcl_size_t rows = s + 1;
+    vcl_size_t k_new = std::min(recycle_dim, s);
+    viennacl::range all_rows(0, n);
+    double pivot_tolerance = 100.0 * static_cast<double>(std::numeric_limits<NumericT>::epsilon());
+
+    // N = [C V]^T [U Z]:
+    BlockRangeType S_used(space.S, all_rows, viennacl::range(recycle_dim - k, recycle_dim + steps));
+    BlockRangeType W_used(space.W, all_rows, viennacl::range(recycle_dim - k, recycle_dim + steps + 1));
+    viennacl::matrix<NumericT> small_N(rows, s, viennacl::traits::context(space.S));
+    small_N = viennacl::linalg::prod(viennacl::trans(W_used), S_used);
+    std::vector<double> N;
+    read_small_matrix(small_N, N);
+
+    // G^T G = L L^T and K = L^{-1} G^T N L^{-T}, whose eigenvalues of largest modulus are the inverse harmonic Ritz values of smallest modulus:
+    std::vector<double> GtG(s * s, 0.0);
+    std::vector<double> K(s * s, 0.0);
+    for (vcl_size_t i = 0; i < s; ++i)
+      for (vcl_size_t j = 0; j < s; ++j)
+        for (vcl_size_t l = 0; l < rows; ++l)
+        {
+          GtG[i*s+j] += G[l*G_cols+i] * G[l*G_cols+j];
+          K[i*s+j]   += G[l*G_cols+i] * N[l*s+j];
+        }
+    if (small_cholesky(GtG, s, pivot_tolerance) < s)
+      return false;
+
+    for (vcl_size_t j = 0; j < s; ++j)
+      for (vcl_size_t i = 0; i < s; ++i)
+      {
+        for (vcl_size_t l = 0; l < i; ++l)
+          K[i*s+j] -= GtG[i*s+l] * K[l*s+j];
+        K[i*s+j] /= GtG[i*s+i];
+      }
+    for (vcl_size_t i = 0; i < s; ++i)
+      for (vcl_size_t j = 0; j < s; ++j)
+      {
+        for (vcl_size_t l = 0; l < j; ++l)
+          K[i*s+j] -= GtG[j*s+l] * K[i*s+l];
+        K[i*s+j] /= GtG[j*s+j];
+      }
+
+    // P = L^{-T} Q for the dominant invariant subspace Q of K:
+    std::vector<double> P = small_dominant_subspace(K, s, k_new);
+    for (vcl_size_t j = 0; j < k_new; ++j)
+      for (vcl_size_t i = s; i-- > 0; )
+      {
+        for (vcl_size_t l = i+1; l < s; ++l)
+          P[i*k_new+j] -= GtG[l*s+i] * P[l*k_new+j];
+        P[i*k_new+j] /= GtG[i*s+i];
+      }
+
+    // G P = Q R:
+    std::vector<double> GP(rows * k_new, 0.0);
+    for (vcl_size_t i = 0; i < rows; ++i)
+      for (vcl_size_t j = 0; j < k_new; ++j)
+        for (vcl_size_t l = 0; l < s; ++l)
+          GP[i*k_new+j] += G[i*G_cols+l] * P[l*k_new+j];
+    std::vector<double> Q = small_orthonormal_columns(GP, rows, k_new);
+    std::vector<double> R(k_new * k_new, 0.0);
+    for (vcl_size_t i = 0; i < k_new; ++i)
+      for (vcl_size_t j = i; j < k_new; ++j)
+        for (vcl_size_t l = 0; l < rows; ++l)
+          R[i*k_new+j] += Q[l*k_new+i] * GP[l*k_new+j];
+
+    double max_diag = 0;
+    for (vcl_size_t i = 0; i < k_new; ++i)
+      max_diag = std::max(max_diag, std::fabs(R[i*k_new+i]));
+    for (vcl_size_t i = 0; i < k_new; ++i)
+      if (!(std::fabs(R[i*k_new+i]) > pivot_tolerance * max_diag))
+        return false;
+
+    // P := P R^{-1}:
+    for (vcl_size_t i = 0; i < s; ++i)
+      for (vcl_size_t j = 0; j < k_new; ++j)
+      {
+        for (vcl_size_t l = 0; l < j; ++l)
+          P[i*k_new+j] -= P[i*k_new+l] * R[l*k_new+j];
+        P[i*k_new+j] /= R[j*k_new+j];
+      }
+
+    // U = [U Z] P and C = [C V] Q, both computed in the work block first since they overwrite parts of [U Z] and [C V]:
+    viennacl::matrix<NumericT> small_P(s, k_new, viennacl::traits::context(space.S));
+    BlockRangeType work(space.work, all_rows, viennacl::range(0, k_new));
+    BlockRangeType U_new(space.S, all_rows, viennacl::range(recycle_dim - k_new, recycle_dim));
+    BlockRangeType C_new(space.W, all_rows, viennacl::range(recycle_dim - k_new, recycle_dim));
+
+    write_small_matrix(P, s, k_new, small_P);
+    work = viennacl::linalg::prod(S_used, small_P);
+    static_cast<viennacl::matrix_base<NumericT> &>(U_new) = work;
+
+    viennacl::matrix<NumericT> small_Q(rows, k_new, viennacl::traits::context(space.S));
+    write_small_matrix(Q, rows, k_new, small_Q);
+    work = viennacl::linalg::prod(W_used, small_Q);
+    static_cast<viennacl::matrix_base<NumericT> &>(C_new) = work;
+
+    space.k = k_new;
+    return true;
+  }
+
+  /** @brief Implementation of the GCRO-DR method with right preconditioning.
+  *
+  * Each restart cycle first removes the components in the span of C from the residual and updates the result with the respective combination of U.
+  * Then, Arnoldi steps with the operator (I - C C^T) A M^{-1} extend the search space. At the end of each cycle, the recycled subspace is replaced
+  * by the harmonic Ritz vectors of the current search space. The preconditioned directions are stored, hence the preconditioner may also vary.
+  *
+  * At the start of a run, C = A U is recomputed for the recycled U from the previous run, since the system matrix may have changed.
+  *
+  * @param A            The system matrix
+  * @param rhs          The load vector
+  * @param init_guess   The initial guess. Ignored if its size does not match the size of rhs.
+  * @param tag          Solver configuration tag
+  * @param precond      The preconditioner. Precondition operation is done via member function apply()
+  * @param space        The recycled subspace, which is updated by the solver
+  * @return The result vector
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  viennacl::vector<NumericT> gcrodr_solve(MatrixT const & A,
+                                          viennacl::vector<NumericT> const & rhs,
+                                          viennacl::vector<NumericT> const & init_guess,
+                                          gcrodr_tag const & tag,
+                                          PreconditionerT const & precond,
+                                          gcrodr_recycle_space<NumericT> & space)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef viennacl::matrix_range<BlockType>                    BlockRangeType;
+
+    vcl_size_t n = rhs.size();
+    vcl_size_t m = tag.krylov_dim();
+    vcl_size_t recycle_dim = tag.recycle_dim();
+    viennacl::context ctx = viennacl::traits::context(rhs);
+    viennacl::range all_rows(0, n);
+    double pivot_tolerance = 100.0 * static_cast<double>(std::numeric_limits<NumericT>::epsilon());
+
+    if (space.S.size1() != n || space.S.size2() != recycle_dim + m || space.W.size2() != recycle_dim + m + 1)
+    {
+      space.S.resize(n, recycle_dim + m, false);
+      space.W.resize(n, recycle_dim + m + 1, false);
+      space.work.resize(n, std::max<vcl_size_t>(recycle_dim, 1), false);
+      space.k = 0;
+    }
+
+    viennacl::vector<NumericT> result = viennacl::zero_vector<NumericT>(n, ctx);
+    if (init_guess.size() == n)
+      result += init_guess;
+    viennacl::vector<NumericT> residual = viennacl::linalg::prod(A, result);
+    residual = rhs - residual;
+
+    NumericT norm_rhs = viennacl::linalg::norm_2(rhs);
+    tag.iters(0);
+    tag.error(0);
+    if (norm_rhs <= NumericT(tag.abs_tolerance())) //solution is zero if RHS norm is zero
+      return viennacl::zero_vector<NumericT>(n, ctx);
+
+    //
+    // adjust the recycled subspace to the current matrix: C = A U = Q R, then C := Q and U := U R^{-1}
+    //
+    if (space.k > 0)
+    {
+      vcl_size_t k = space.k;
+      BlockRangeType U(space.S, all_rows, viennacl::range(recycle_dim - k, recycle_dim));
+      BlockRangeType C(space.W, all_rows, viennacl::range(recycle_dim - k, recycle_dim));
+      viennacl::linalg::prod_impl(A, U, C);
+
+      std::vector<double> R;
+      viennacl::linalg::tsqr(C, R);
+
+      // keep the leading columns for which A U has full rank:
+      double max_diag = 0;
+      for (vcl_size_t i = 0; i < k; ++i)
+        max_diag = std::max(max_diag, std::fabs(R[i*k+i]));
+      vcl_size_t rank = 0;
+      while (rank < k && std::fabs(R[rank*k+rank]) > pivot_tolerance * max_diag)
+        ++rank;
+
+      std::vector<double> R_inv(rank * rank, 0.0);
+      for (vcl_size_t j = 0; j < rank; ++j)
+      {
+        R_inv[j*rank+j] = 1.0 / R[j*k+j];
+        for (vcl_size_t i = j; i-- > 0; )
+        {
+          double value = 0;
+          for (vcl_size_t l = i+1; l <= j; ++l)
+            value -= R[i*k+l] * R_inv[l*rank+j];
+          R_inv[i*rank+j] = value / R[i*k+i];
+        }
+      }
+
+      if (rank > 0)
+      {
+        viennacl::matrix<NumericT> small_R_inv(rank, rank, ctx);
+        write_small_matrix(R_inv, rank, rank, small_R_inv);
+        BlockRangeType U_lead(space.S, all_rows, viennacl::range(recycle_dim - k, recycle_dim - k + rank));
+        BlockRangeType work(space.work, all_rows, viennacl::range(0, rank));
+        work = viennacl::linalg::prod(U_lead, small_R_inv);
+
+        // right-align the rank columns kept:
+        BlockRangeType U_new(space.S, all_rows, viennacl::range(recycle_dim - rank, recycle_dim));
+        static_cast<viennacl::matrix_base<NumericT> &>(U_new) = work;
+        for (vcl_size_t j = rank; j-- > 0; )
+          copy_block_column(space.W, recycle_dim - k + j, space.W, recycle_dim - rank + j);
+      }
+      space.k = rank;
+    }
+
+    unsigned int iters = 0;
+    NumericT norm_r = 0;
+    std::vector<NumericT> host_coefficients(recycle_dim + m + 1);
+    viennacl::vector<NumericT> z(n, ctx);
+
+    for (;;)
+    {
+      vcl_size_t k = space.k;
+      BlockRangeType U(space.S, all_rows, viennacl::range(recycle_dim - k, recycle_dim));
+      BlockRangeType C(space.W, all_rows, viennacl::range(recycle_dim - k, recycle_dim));
+
+      //
+      // remove the components in the span of C from the residual: x += U C^T r, r -= C C^T r
+      //
+      if (k > 0)
+      {
+        viennacl::vector<NumericT> c = viennacl::linalg::prod(viennacl::trans(C), residual);
+        result   += viennacl::linalg::prod(U, c);
+        residual -= viennacl::linalg::prod(C, c);
+      }
+
+      norm_r = viennacl::linalg::norm_2(residual);
+      if (norm_r <= tag.tolerance() * norm_rhs || norm_r <= tag.abs_tolerance() || iters >= tag.max_iterations())
+        break;
+
+      //
+      // Arnoldi process with (I - C C^T) A M^{-1}, where A [U Z] = [C V] G with G = [I B; 0 H]:
+      //
+      vcl_size_t G_cols = k + m;
+      std::vector<double> G((G_cols + 1) * G_cols, 0.0);
+      for (vcl_size_t i = 0; i < k; ++i)
+        G[i*G_cols+i] = 1.0;
+
+      viennacl::vector_base<NumericT> v_0(space.W.handle(), space.W.size1(), recycle_dim * space.W.internal_size1(), 1);
+      v_0 = residual / norm_r;
+
+      std::vector<double> y;
+      vcl_size_t steps = 0;
+      bool breakdown = false;
+      for (vcl_size_t j = 0; j < m; ++j)
+      {
+        viennacl::vector_base<NumericT> v_j(space.W.handle(), space.W.size1(), (recycle_dim + j) * space.W.internal_size1(), 1);
+        viennacl::vector_base<NumericT> z_j(space.S.handle(), space.S.size1(), (recycle_dim + j) * space.S.internal_size1(), 1);
+        viennacl::vector_base<NumericT> w(space.W.handle(), space.W.size1(), (recycle_dim + j + 1) * space.W.internal_size1(), 1);
+
+        z = v_j;
+        precond.apply(z);
+        z_j = z;
+        w = viennacl::linalg::prod(A, z);
+
+        // classical Gram-Schmidt against C and v_0, ..., v_j, two passes:
+        BlockRangeType W_prev(space.W, all_rows, viennacl::range(recycle_dim - k, recycle_dim + j + 1));
+        for (unsigned int pass = 0; pass < 2; ++pass)
+        {
+          viennacl::vector<NumericT> h = viennacl::linalg::prod(viennacl::trans(W_prev), w);
+          w -= viennacl::linalg::prod(W_prev, h);
+          viennacl::copy(h.begin(), h.end(), host_coefficients.begin());
+          for (vcl_size_t i = 0; i < k + j + 1; ++i)
+            G[i*G_cols + k + j] += static_cast<double>(host_coefficients[i]);
+        }
+
+        double norm_w = static_cast<double>(viennacl::linalg::norm_2(w));
+        double norm_column = norm_w * norm_w;
+        for (vcl_size_t i = 0; i < k + j + 1; ++i)
+          norm_column += G[i*G_cols + k + j] * G[i*G_cols + k + j];
+        breakdown = !(norm_w * norm_w > pivot_tolerance * norm_column);
+        G[(k + j + 1)*G_cols + k + j] = norm_w;
+        if (!breakdown)
+          w /= NumericT(norm_w);
+
+        ++iters;
+        steps = j + 1;
+
+        // least squares problem min ||norm_r e_1 - H y|| for the Hessenberg matrix H = G(k:k+j+2, k:k+j+1):
+        std::vector<double> H((j + 2) * (j + 1));
+        std::vector<double> e_1(j + 2, 0.0);
+        e_1[0] = static_cast<double>(norm_r);
+        for (vcl_size_t i = 0; i < j + 2; ++i)
+          for (vcl_size_t l = 0; l < j + 1; ++l)
+            H[i*(j+1)+l] = G[(k + i)*G_cols + k + l];
+
+        std::vector<double> residual_norms;
+        y = small_least_squares(H, j + 2, j + 1, e_1, 1, residual_norms);
+
+        if (residual_norms[0] <= tag.tolerance() * norm_rhs || residual_norms[0] <= tag.abs_tolerance() || breakdown || iters >= tag.max_iterations())
+          break;
+      }
+
+      //
+      // x += Z y - U B y:
+      //
+      std::vector<double> coefficients(k + steps, 0.0);
+      for (vcl_size_t l = 0; l < steps; ++l)
+      {
+        coefficients[k + l] = y[l];
+        for (vcl_size_t i = 0; i < k; ++i)
+          coefficients[i] -= G[i*G_cols + k + l] * y[l];
+      }
+      viennacl::vector<NumericT> device_coefficients(k + steps, ctx);
+      write_small_vector(coefficients, k + steps, device_coefficients);
+      BlockRangeType S_used(space.S, all_rows, viennacl::range(recycle_dim - k, recycle_dim + steps));
+      result += viennacl::linalg::prod(S_used, device_coefficients);
+
+      residual = viennacl::linalg::prod(A, result);
+      residual = rhs - residual;
+
+      if (recycle_dim > 0 && !breakdown)
+        gcrodr_update_recycle_space(space, recycle_dim, steps, G, G_cols);
+    }
+
+    tag.iters(iters);
+    tag.error(norm_r / norm_rhs);
+
+    return result;
+  }
+
+}
+
+
+/** @brief GCRO-DR solver for sequences of linear systems, which keeps a recycled subspace between calls of operator().
+*
+* The recycled subspace consists of the harmonic Ritz vectors for the harmonic Ritz values of smallest modulus found in the previous solves.
+* It is projected out of the residual at each restart, so subsequent systems with a slowly changing matrix or right-hand side usually need fewer iterations.
+*
+* @tparam VectorT   The vector type, must be viennacl::vector<>
+*/
+template<typename VectorT>
+class gcrodr_solver
+{
+public:
+  typedef typename viennacl::result_of::cpu_value_type<VectorT>::type   numeric_type;
+
+  gcrodr_solver(gcrodr_tag const & tag) : tag_(tag) {}
+
+  template<typename MatrixT, typename PreconditionerT>
+  VectorT operator()(MatrixT const & A, VectorT const & b, PreconditionerT const & precond)
+  {
+    return detail::gcrodr_solve(A, b, init_guess_, tag_, precond, space_);
+  }
+
+
+  template<typename MatrixT>
+  VectorT operator()(MatrixT const & A, VectorT const & b)
+  {
+    return operator()(A, b, viennacl::linalg::no_precond());
+  }
+
+  /** @brief Specifies an initial guess for the iterative solver. */
+  void set_initial_guess(VectorT const & x) { init_guess_ = x; }
+
+  /** @brief Returns the current dimension of the recycled subspace */
+  vcl_size_t recycle_dim() const { return space_.k; }
+
+  /** @brief Discards the recycled subspace, e.g. if the next system is unrelated to the previous ones */
+  void clear_recycle_space() { space_.k = 0; }
+
+  /** @brief Returns the solver tag containing basic configuration such as tolerances, etc. */
+  gcrodr_tag const & tag() const { return tag_; }
+
+private:
+  gcrodr_tag                                  tag_;
+  VectorT                                     init_guess_;
+  detail::gcrodr_recycle_space<numeric_type>  space_;
+};
+
+
+/** @brief Solves A x = rhs with the GCRO-DR method. Since no subspace is recycled from previous runs, use gcrodr_solver for sequences of linear systems.
+*
+* @param A          The system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @param precond    The preconditioner
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT, typename PreconditionerT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, gcrodr_tag const & tag, PreconditionerT const & precond)
+{
+  gcrodr_solver<viennacl::vector<NumericT> > solver(tag);
+  viennacl::vector<NumericT> result = solver(A, rhs, precond);
+  tag.iters(solver.tag().iters());
+  tag.error(solver.tag().error());
+  return result;
+}
+
+/** @brief Convenience overload for calling the GCRO-DR solver without preconditioner */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, gcrodr_tag const & tag)
+{
+  return viennacl::linalg::solve(A, rhs, tag, viennacl::linalg::no_precond());
+}
+
+}
+}
+
+#endif
@@ -24,7 +24,10 @@
 
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
+#include <vector>
 #include "viennacl/linalg/detail/amg/amg_base.hpp"
+#include "viennacl/linalg/host_based/spgemm_row_kernels.hpp"
 
 #include <map>
 #include <set>
@@ -1346,6 +1349,100 @@ void amg_interpol_sa(compressed_matrix<NumericT> const & A,
 }
 
 
+/** @brief Recomputes the values of the smoothed aggregation interpolation matrix P = (I - omega D^{-1} A) P_tentative for a new operator A with the same sparsity pattern.
+ *
+ * The aggregates and the sparsity pattern of P from a previous call of amg_interpol_sa() are kept, so neither the tentative interpolation nor the Jacobi matrix are formed.
+ * Entry (i, J) of P is the sum of the entries of the Jacobi matrix in row i over all columns in aggregate J.
+ *
+ * @param A            Operator matrix with the same sparsity pattern as in the call of amg_interpol_sa()
+ * @param P            Prolongation matrix as computed by amg_interpol_sa()
+ * @param amg_context  AMG hierarchy datastructures
+ * @param tag          AMG configuration tag
+*/
+template<typename NumericT>
+void amg_interpol_sa_update(compressed_matrix<NumericT> const & A,
+                            compressed_matrix<NumericT> & P,
+                            viennacl::linalg::detail::amg::amg_level_context & amg_context,
+                            viennacl::linalg::amg_tag & tag)
+{
+  unsigned int const * A_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle1());
+  unsigned int const * A_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle2());
+  NumericT     const * A_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A.handle());
+
+  unsigned int const * P_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle1());
+  unsigned int const * P_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle2());
+  NumericT           * P_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(P.handle());
+
+  unsigned int const * coarse_id_ptr = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(amg_context.coarse_id_.handle());
+
+  NumericT weight = NumericT(tag.get_jacobi_weight());
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long row2=0; row2<static_cast<long>(A.size1()); ++row2)
+  {
+    unsigned int row = static_cast<unsigned int>(row2);
+    unsigned int row_begin = A_row_buffer[row];
+    unsigned int row_end   = A_row_buffer[row+1];
+
+    // Step 1: Extract diagonal:
+    NumericT diag = 0;
+    for (unsigned int j = row_begin; j < row_end; ++j)
+    {
+      if (A_col_buffer[j] == row)
+      {
+        diag = A_elements[j];
+        break;
+      }
+    }
+
+    // Step 2: Accumulate the entries of the Jacobi matrix in the respective aggregate (the column indices in the row of P are sorted):
+    unsigned int const * P_cols_begin = P_col_buffer + P_row_buffer[row];
+    unsigned int const * P_cols_end   = P_col_buffer + P_row_buffer[row+1];
+    for (unsigned int k = P_row_buffer[row]; k < P_row_buffer[row+1]; ++k)
+      P_elements[k] = 0;
+
+    for (unsigned int j = row_begin; j < row_end; ++j)
+    {
+      unsigned int col_index = A_col_buffer[j];
+      unsigned int const * P_col_iter = std::lower_bound(P_cols_begin, P_cols_end, coarse_id_ptr[col_index]);
+      assert(P_col_iter != P_cols_end && *P_col_iter == coarse_id_ptr[col_index] && bool("Sparsity pattern of smoothed aggregation interpolation has changed!"));
+
+      if (col_index == row)
+        P_elements[P_col_iter - P_col_buffer] += NumericT(1) - weight;
+      else
+        P_elements[P_col_iter - P_col_buffer] -= weight * A_elements[j] / diag;
+    }
+  }
+}
+
+
+/** @brief Recomputes the interpolation matrix for a new operator A with the same sparsity pattern, keeping the coarse points and aggregates (and influences) in 'amg_context'.
+ *
+ * Aggregation-based interpolation does not depend on the values of A, smoothed aggregation only updates the values of P. Direct interpolation is recomputed.
+ *
+ * @param A            Operator matrix
+ * @param P            Prolongation matrix from a previous call of amg_interpol()
+ * @param amg_context  AMG hierarchy datastructures
+ * @param tag          AMG configuration tag
+*/
+template<typename MatrixT>
+void amg_interpol_update(MatrixT const & A,
+                         MatrixT & P,
+                         viennacl::linalg::detail::amg::amg_level_context & amg_context,
+                         viennacl::linalg::amg_tag & tag)
+{
+  switch (tag.get_interpolation_method())
+  {
+  case viennacl::linalg::AMG_INTERPOLATION_METHOD_DIRECT:               amg_interpol_direct   (A, P, amg_context, tag); break;
+  case viennacl::linalg::AMG_INTERPOLATION_METHOD_AGGREGATION:          break;
+  case viennacl::linalg::AMG_INTERPOLATION_METHOD_SMOOTHED_AGGREGATION: amg_interpol_sa_update(A, P, amg_context, tag); break;
+  default: throw std::runtime_error("Not implemented yet!");
+  }
+}
+
+
 /** @brief Dispatcher for building the interpolation matrix
  *
  * @param A            Operator matrix
@@ -1490,6 +1587,304 @@ void amg_transpose(compressed_matrix<NumericT> const & A,
   free(scratchpad);
 }
 
+/** @brief Returns true if the plan for the Galerkin product has been set up for operands with the same sparsity patterns as A_fine and P. */
+template<typename NumericT>
+bool amg_galerkin_plan_matches(compressed_matrix<NumericT> const & A_fine,
+                               compressed_matrix<NumericT> const & P,
+                               viennacl::linalg::detail::amg::amg_galerkin_plan const & plan)
+{
+  if (!plan.matches(A_fine.size1(), P.size2(), A_fine.nnz(), P.nnz()))
+    return false;
+
+  unsigned int const * A_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_fine.handle1());
+  unsigned int const * A_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_fine.handle2());
+
+  if (plan.A_row_indices_.size() != A_fine.size1() + 1
+      || !std::equal(plan.A_row_indices_.begin(), plan.A_row_indices_.end(), A_row_buffer)
+      || plan.A_col_indices_.size() != A_row_buffer[A_fine.size1()]
+      || !std::equal(plan.A_col_indices_.begin(), plan.A_col_indices_.end(), A_col_buffer))
+    return false;
+
+  unsigned int const * P_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle1());
+  unsigned int const * P_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle2());
+
+  if (P_row_buffer[P.size1()] != plan.P_trans_entries_.size())
+    return false;
+
+  // each nonzero of P is indexed exactly once, hence it suffices to check that the index refers to the correct row and column:
+  for (vcl_size_t I = 0; I < plan.coarse_size(); ++I)
+    for (unsigned int l = plan.P_trans_row_indices_[I]; l < plan.P_trans_row_indices_[I+1]; ++l)
+    {
+      unsigned int i     = plan.P_trans_col_indices_[l];
+      unsigned int entry = plan.P_trans_entries_[l];
+      if (P_col_buffer[entry] != I || entry < P_row_buffer[i] || entry >= P_row_buffer[i+1])
+        return false;
+    }
+
+  return true;
+}
+
+/** @brief Numeric phase of the fused Galerkin product A_coarse = trans(P) * A_fine * P using the sparsity pattern of A_coarse and the column index of P in the plan.
+  *
+  * Row I of A_coarse is obtained as the sum of P(i, I) * A_fine(i, :) * P over the nonzeros P(i, I) in column I of P, so that neither trans(P) nor A_fine * P are formed.
+  * The positions of the nonzeros in row I are scattered to a thread-local work buffer, so products are accumulated in place.
+  * Only the values of A_coarse are written.
+  */
+template<typename NumericT>
+void amg_galerkin_prod_numeric(compressed_matrix<NumericT> const & A_fine,
+                               compressed_matrix<NumericT> const & P,
+                               compressed_matrix<NumericT> & A_coarse,
+                               viennacl::linalg::detail::amg::amg_galerkin_plan & plan)
+{
+  assert( !plan.empty() && bool("Galerkin product: Symbolic phase not carried out"));
+  assert( plan.matches(A_fine.size1(), P.size2(), A_fine.nnz(), P.nnz()) && bool("Galerkin product: Operands do not match plan"));
+  assert( (A_coarse.size1() == P.size2() && A_coarse.nnz() >= plan.coarse_nnz()) && bool("Galerkin product: Result matrix does not match plan"));
+
+  NumericT     const * A_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A_fine.handle());
+  unsigned int const * A_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_fine.handle1());
+  unsigned int const * A_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_fine.handle2());
+
+  NumericT     const * P_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(P.handle());
+  unsigned int const * P_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle1());
+  unsigned int const * P_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle2());
+
+  NumericT * C_elements = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A_coarse.handle());
+
+  unsigned int const * C_row_buffer  = &(plan.coarse_row_indices_[0]);
+  unsigned int const * C_col_buffer  = plan.coarse_col_indices_.size() ? &(plan.coarse_col_indices_[0]) : NULL;
+  unsigned int const * PT_row_buffer = &(plan.P_trans_row_indices_[0]);
+  unsigned int const * PT_col_buffer = plan.P_trans_col_indices_.size() ? &(plan.P_trans_col_indices_[0]) : NULL;
+  unsigned int const * PT_entries    = plan.P_trans_entries_.size()     ? &(plan.P_trans_entries_[0])     : NULL;
+
+  std::vector<vcl_size_t> const & chunk_starts = plan.chunk_starts_;
+  long num_chunks = long(chunk_starts.size()) - 1;
+
+#ifdef VIENNACL_WITH_OPENMP
+  plan.reserve_work_buffers(static_cast<vcl_size_t>(omp_get_max_threads()));
+  #pragma omp parallel
+#else
+  plan.reserve_work_buffers(1);
+#endif
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    std::vector<unsigned int> & positions = plan.work_buffer(static_cast<vcl_size_t>(omp_get_thread_num()));
+#else
+    std::vector<unsigned int> & positions = plan.work_buffer(0);
+#endif
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp for schedule(dynamic, 1)
+#endif
+    for (long chunk = 0; chunk < num_chunks; ++chunk)
+    {
+      for (vcl_size_t I = chunk_starts[static_cast<vcl_size_t>(chunk)]; I < chunk_starts[static_cast<vcl_size_t>(chunk) + 1]; ++I)
+      {
+        for (unsigned int k = C_row_buffer[I]; k < C_row_buffer[I+1]; ++k)
+        {
+          positions[C_col_buffer[k]] = k;
+          C_elements[k] = 0;
+        }
+
+        for (unsigned int l = PT_row_buffer[I]; l < PT_row_buffer[I+1]; ++l)
+        {
+          unsigned int i = PT_col_buffer[l];
+          NumericT val_P_iI = P_elements[PT_entries[l]];
+          for (unsigned int j = A_row_buffer[i]; j < A_row_buffer[i+1]; ++j)
+          {
+            unsigned int k = A_col_buffer[j];
+            NumericT val_PA = val_P_iI * A_elements[j];
+            for (unsigned int m = P_row_buffer[k]; m < P_row_buffer[k+1]; ++m)
+              C_elements[positions[P_col_buffer[m]]] += val_PA * P_elements[m];
+          }
+        }
+      }
+    }
+  }
+}
+
+/** @brief Fused Galerkin product A_coarse = trans(P) * A_fine * P including the symbolic phase, which is recorded in the plan for subsequent calls of amg_galerkin_prod_numeric().
+  *
+  * Stage 1: Index the nonzeros of P by column (pattern of trans(P), no values are copied).
+  * Stage 2: Estimate the work for each row of A_coarse and distribute the rows accordingly.
+  * Stage 3: Compute the rows of A_coarse (sorted column indices and values) into a buffer for each chunk of rows.
+  * Stage 4: Allocate A_coarse and copy the buffers.
+  */
+template<typename NumericT>
+void amg_galerkin_prod_symbolic(compressed_matrix<NumericT> const & A_fine,
+                                compressed_matrix<NumericT> const & P,
+                                compressed_matrix<NumericT> & A_coarse,
+                                viennacl::linalg::detail::amg::amg_galerkin_plan & plan)
+{
+  NumericT     const * A_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A_fine.handle());
+  unsigned int const * A_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_fine.handle1());
+  unsigned int const * A_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_fine.handle2());
+
+  NumericT     const * P_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(P.handle());
+  unsigned int const * P_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle1());
+  unsigned int const * P_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle2());
+
+  vcl_size_t fine_size   = A_fine.size1();
+  vcl_size_t coarse_size = P.size2();
+
+  plan.init(fine_size, coarse_size, A_fine.nnz(), P.nnz());
+  plan.A_row_indices_.assign(A_row_buffer, A_row_buffer + fine_size + 1);
+  plan.A_col_indices_.assign(A_col_buffer, A_col_buffer + A_row_buffer[fine_size]);
+
+  //
+  // Stage 1: Index the nonzeros of P by column
+  //
+  std::vector<unsigned int> & PT_row_buffer = plan.P_trans_row_indices_;
+  std::vector<unsigned int> & PT_col_buffer = plan.P_trans_col_indices_;
+  std::vector<unsigned int> & PT_entries    = plan.P_trans_entries_;
+
+  PT_row_buffer.assign(coarse_size + 1, 0);
+  PT_col_buffer.resize(P_row_buffer[fine_size]);
+  PT_entries.resize(P_row_buffer[fine_size]);
+
+  for (unsigned int j = 0; j < P_row_buffer[fine_size]; ++j)
+    PT_row_buffer[P_col_buffer[j] + 1] += 1;
+  for (vcl_size_t I = 0; I < coarse_size; ++I)
+    PT_row_buffer[I+1] += PT_row_buffer[I];
+
+  std::vector<unsigned int> PT_offsets(PT_row_buffer.begin(), PT_row_buffer.end() - 1);
+  for (vcl_size_t i = 0; i < fine_size; ++i)
+    for (unsigned int j = P_row_buffer[i]; j < P_row_buffer[i+1]; ++j)
+    {
+      unsigned int index = PT_offsets[P_col_buffer[j]]++;
+      PT_col_buffer[index] = static_cast<unsigned int>(i);
+      PT_entries[index]    = j;
+    }
+
+  //
+  // Stage 2: Work estimate (number of products) for each row of A_coarse:
+  //
+  std::vector<vcl_size_t> fine_row_work(fine_size);
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long i = 0; i < long(fine_size); ++i)
+  {
+    vcl_size_t work = 0;
+    for (unsigned int j = A_row_buffer[i]; j < A_row_buffer[i+1]; ++j)
+      work += P_row_buffer[A_col_buffer[j] + 1] - P_row_buffer[A_col_buffer[j]];
+    fine_row_work[static_cast<vcl_size_t>(i)] = work;
+  }
+
+  std::vector<vcl_size_t> work_offsets(coarse_size + 1, 0);
+  for (vcl_size_t I = 0; I < coarse_size; ++I)
+  {
+    vcl_size_t work = 0;
+    for (unsigned int l = PT_row_buffer[I]; l < PT_row_buffer[I+1]; ++l)
+      work += fine_row_work[PT_col_buffer[l]];
+    work_offsets[I+1] = work_offsets[I] + work;
+  }
+
+#ifdef VIENNACL_WITH_OPENMP
+  vcl_size_t num_chunks = 10 * static_cast<vcl_size_t>(omp_get_max_threads());
+#else
+  vcl_size_t num_chunks = 1;
+#endif
+  viennacl::linalg::host_based::spgemm_flop_balanced_chunks(work_offsets, num_chunks, plan.chunk_starts_);
+  std::vector<vcl_size_t> const & chunk_starts = plan.chunk_starts_;
+
+  //
+  // Stage 3: Compute the rows of A_coarse into buffers for each chunk. A column J is marked by storing the current row index I in marker[J]:
+  //
+  std::vector<unsigned int> & C_row_buffer = plan.coarse_row_indices_;
+  std::vector<unsigned int> & C_col_buffer = plan.coarse_col_indices_;
+  C_row_buffer.assign(coarse_size + 1, 0);
+
+  std::vector<std::vector<unsigned int> > chunk_col_buffers(num_chunks);
+  std::vector<std::vector<NumericT> >     chunk_value_buffers(num_chunks);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel
+#endif
+  {
+    std::vector<unsigned int> marker(coarse_size, static_cast<unsigned int>(-1));
+    std::vector<NumericT>     row_values(coarse_size);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp for schedule(dynamic, 1)
+#endif
+    for (long chunk = 0; chunk < long(num_chunks); ++chunk)
+    {
+      std::vector<unsigned int> & chunk_cols   = chunk_col_buffers[static_cast<vcl_size_t>(chunk)];
+      std::vector<NumericT>     & chunk_values = chunk_value_buffers[static_cast<vcl_size_t>(chunk)];
+
+      for (vcl_size_t I = chunk_starts[static_cast<vcl_size_t>(chunk)]; I < chunk_starts[static_cast<vcl_size_t>(chunk) + 1]; ++I)
+      {
+        vcl_size_t row_start = chunk_cols.size();
+        for (unsigned int l = PT_row_buffer[I]; l < PT_row_buffer[I+1]; ++l)
+        {
+          unsigned int i = PT_col_buffer[l];
+          NumericT val_P_iI = P_elements[PT_entries[l]];
+          for (unsigned int j = A_row_buffer[i]; j < A_row_buffer[i+1]; ++j)
+          {
+            unsigned int k = A_col_buffer[j];
+            NumericT val_PA = val_P_iI * A_elements[j];
+            for (unsigned int m = P_row_buffer[k]; m < P_row_buffer[k+1]; ++m)
+            {
+              unsigned int J = P_col_buffer[m];
+              if (marker[J] != I)
+              {
+                marker[J] = static_cast<unsigned int>(I);
+                row_values[J] = 0;
+                chunk_cols.push_back(J);
+              }
+              row_values[J] += val_PA * P_elements[m];
+            }
+          }
+        }
+
+        std::sort(chunk_cols.begin() + static_cast<long>(row_start), chunk_cols.end());
+        for (vcl_size_t l = row_start; l < chunk_cols.size(); ++l)
+          chunk_values.push_back(row_values[chunk_cols[l]]);
+        C_row_buffer[I] = static_cast<unsigned int>(chunk_cols.size() - row_start);
+      }
+    }
+  }
+
+  // exclusive scan to obtain row start indices:
+  unsigned int current_offset = 0;
+  for (vcl_size_t I = 0; I < coarse_size; ++I)
+  {
+    unsigned int tmp = C_row_buffer[I];
+    C_row_buffer[I] = current_offset;
+    current_offset += tmp;
+  }
+  C_row_buffer[coarse_size] = current_offset;
+  C_col_buffer.resize(current_offset);
+
+  //
+  // Stage 4: Set up A_coarse and copy the rows from the chunk buffers:
+  //
+  A_coarse = compressed_matrix<NumericT>(coarse_size, coarse_size, current_offset, viennacl::traits::context(A_fine));
+
+  NumericT     * A_coarse_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A_coarse.handle());
+  unsigned int * A_coarse_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_coarse.handle1());
+  unsigned int * A_coarse_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A_coarse.handle2());
+  std::copy(C_row_buffer.begin(), C_row_buffer.end(), A_coarse_row_buffer);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long chunk = 0; chunk < long(num_chunks); ++chunk)
+  {
+    std::vector<unsigned int> const & chunk_cols   = chunk_col_buffers[static_cast<vcl_size_t>(chunk)];
+    std::vector<NumericT>     const & chunk_values = chunk_value_buffers[static_cast<vcl_size_t>(chunk)];
+    unsigned int offset = C_row_buffer[chunk_starts[static_cast<vcl_size_t>(chunk)]];
+    for (vcl_size_t l = 0; l < chunk_cols.size(); ++l)
+    {
+      C_col_buffer[offset + l]        = chunk_cols[l];
+      A_coarse_col_buffer[offset + l] = chunk_cols[l];
+      A_coarse_elements[offset + l]   = chunk_values[l];
+    }
+  }
+
+  A_coarse.generate_row_block_information();
+}
+
 /** Assign sparse matrix A to dense matrix B */
 template<typename NumericT, unsigned int AlignmentV>
 void assign_to_dense(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
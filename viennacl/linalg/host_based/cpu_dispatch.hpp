@@ -0,0 +1,204 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_CPU_DISPATCH_HPP_
+#define VIENNACL_LINALG_HOST_BASED_CPU_DISPATCH_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/cpu_dispatch.hpp
+    @brief Detection of CPU features and runtime selection of vectorized kernels for the host backend.
+
+    There are two ways of enabling the AVX2/AVX-512 kernels in the host backend:
+      - Static: Define VIENNACL_WITH_AVX2 or VIENNACL_WITH_AVX512 and compile for the respective instruction set (e.g. -mavx2 -mfma or -mavx512f).
+                The resulting binary only runs on CPUs supporting this instruction set.
+      - Dynamic: Define VIENNACL_WITH_CPU_DISPATCH (GCC and Clang on x86 only). All kernel variants are compiled regardless of -march,
+                 the CPU is queried once at startup, and the best variant supported by the CPU is used.
+
+    In both cases the selection can be capped at runtime through set_cpu_isa_limit() or the environment variable VIENNACL_CPU_ISA (values: generic, avx2, avx512).
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "viennacl/forwards.h"
+
+#if defined(VIENNACL_WITH_CPU_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  #define VIENNACL_HOST_CPU_DISPATCH
+  #define VIENNACL_HOST_AVX2_KERNELS
+  #define VIENNACL_HOST_AVX512_KERNELS
+  #define VIENNACL_HOST_TARGET_AVX2    __attribute__((target("avx2,fma")))
+  #define VIENNACL_HOST_TARGET_AVX512  __attribute__((target("avx512f,avx2,fma")))
+#else
+  #if (defined(VIENNACL_WITH_AVX2) || defined(VIENNACL_WITH_AVX512)) && defined(__AVX2__) && defined(__FMA__)
+    #define VIENNACL_HOST_AVX2_KERNELS
+  #endif
+  #if defined(VIENNACL_WITH_AVX512) && defined(__AVX512F__)
+    #define VIENNACL_HOST_AVX512_KERNELS
+  #endif
+  #define VIENNACL_HOST_TARGET_AVX2
+  #define VIENNACL_HOST_TARGET_AVX512
+#endif
+
+#if defined(VIENNACL_HOST_AVX2_KERNELS) || defined(VIENNACL_HOST_AVX512_KERNELS)
+#include "immintrin.h"
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+
+/** @brief Instruction set levels for which the host backend provides specialized kernels. Higher levels include all lower levels. */
+enum cpu_isa_type
+{
+  CPU_ISA_GENERIC = 0,
+  CPU_ISA_AVX2,     // AVX2 and FMA3
+  CPU_ISA_AVX512    // AVX-512F
+};
+
+/** @brief The hot kernels of the host backend which are dispatched at runtime. */
+enum host_kernel_type
+{
+  HOST_KERNEL_GEMM = 0,
+  HOST_KERNEL_GEMV,
+  HOST_KERNEL_CSR_SPMV,
+  HOST_KERNEL_INNER_PROD,
+  HOST_KERNEL_NORM_2
+};
+
+/** @brief Returns a human-readable name of the instruction set level */
+inline std::string cpu_isa_name(cpu_isa_type isa)
+{
+  switch (isa)
+  {
+  case CPU_ISA_AVX2:   return "avx2";
+  case CPU_ISA_AVX512: return "avx512";
+  default:             return "generic";
+  }
+}
+
+namespace detail
+{
+  /** @brief Queries the CPU for the highest supported instruction set level. */
+  inline cpu_isa_type detect_cpu_isa()
+  {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return CPU_ISA_AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return CPU_ISA_AVX2;
+    return CPU_ISA_GENERIC;
+#elif defined(VIENNACL_HOST_AVX512_KERNELS)
+    return CPU_ISA_AVX512;  // no means of detection, trust the compiler flags
+#elif defined(VIENNACL_HOST_AVX2_KERNELS)
+    return CPU_ISA_AVX2;
+#else
+    return CPU_ISA_GENERIC;
+#endif
+  }
+
+  /** @brief Parses the environment variable VIENNACL_CPU_ISA. Returns CPU_ISA_AVX512 (i.e. no restriction) if not set or not recognized. */
+  inline cpu_isa_type cpu_isa_limit_from_environment()
+  {
+    char const * env = std::getenv("VIENNACL_CPU_ISA");
+    if (env)
+    {
+      if (std::strcmp(env, "generic") == 0)
+        return CPU_ISA_GENERIC;
+      if (std::strcmp(env, "avx2") == 0)
+        return CPU_ISA_AVX2;
+    }
+    return CPU_ISA_AVX512;
+  }
+
+  inline cpu_isa_type & cpu_isa_limit()
+  {
+    static cpu_isa_type limit = cpu_isa_limit_from_environment();
+    return limit;
+  }
+
+  /** @brief Type trait specifying whether vectorized kernels are available for a certain numeric type */
+  template<typename NumericT>
+  struct has_simd_kernels { enum { value = false }; };
+
+  /** \cond */
+  template<> struct has_simd_kernels<float>  { enum { value = true }; };
+  template<> struct has_simd_kernels<double> { enum { value = true }; };
+  /** \endcond */
+}
+
+/** @brief Returns the highest instruction set level supported by the CPU the program is running on. Detection is carried out only once. */
+inline cpu_isa_type detected_cpu_isa()
+{
+  static cpu_isa_type isa = detail::detect_cpu_isa();
+  return isa;
+}
+
+/** @brief Returns the highest instruction set level for which kernels have been compiled into the binary. */
+inline cpu_isa_type compiled_cpu_isa()
+{
+#if defined(VIENNACL_HOST_AVX512_KERNELS)
+  return CPU_ISA_AVX512;
+#elif defined(VIENNACL_HOST_AVX2_KERNELS)
+  return CPU_ISA_AVX2;
+#else
+  return CPU_ISA_GENERIC;
+#endif
+}
+
+/** @brief Restricts the kernels used by the host backend to the provided instruction set level. Mostly useful for testing and benchmarking. */
+inline void set_cpu_isa_limit(cpu_isa_type isa) { detail::cpu_isa_limit() = isa; }
+
+/** @brief Returns the instruction set level currently used by the host backend, i.e. the minimum of the detected, the compiled, and the user-provided level. */
+inline cpu_isa_type active_cpu_isa()
+{
+  cpu_isa_type isa = detected_cpu_isa();
+  if (compiled_cpu_isa() < isa)
+    isa = compiled_cpu_isa();
+  if (detail::cpu_isa_limit() < isa)
+    isa = detail::cpu_isa_limit();
+  return isa;
+}
+
+/** @brief Returns the instruction set level of the kernel variant used for the provided kernel and numeric type.
+*
+* Vectorized variants are available for float and double only, all other types use the generic implementation.
+*/
+template<typename NumericT>
+cpu_isa_type selected_cpu_isa(host_kernel_type /*kernel*/)
+{
+  if (!detail::has_simd_kernels<NumericT>::value)
+    return CPU_ISA_GENERIC;
+  return active_cpu_isa();
+}
+
+/** @brief Returns the name of the variant used for the provided kernel and numeric type, e.g. "avx2". */
+template<typename NumericT>
+std::string selected_kernel_variant(host_kernel_type kernel)
+{
+  return cpu_isa_name(selected_cpu_isa<NumericT>(kernel));
+}
+
+} //namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
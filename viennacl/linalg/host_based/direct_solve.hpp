@@ -44,22 +44,57 @@ namespace detail
   {
     typedef typename MatrixT2::value_type   value_type;
 
-    for (vcl_size_t i = 0; i < A_size; ++i)
+    // The columns of B are independent, hence they are processed in blocks which fit into cache (and in parallel):
+    vcl_size_t const block_size = 64;
+    long num_blocks = static_cast<long>((B_size + block_size - 1) / block_size);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (A_size * A_size * B_size > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+    for (long block = 0; block < num_blocks; ++block)
     {
-      vcl_size_t current_row = A_size - i - 1;
+      vcl_size_t k_start = static_cast<vcl_size_t>(block) * block_size;
+      vcl_size_t k_end   = std::min<vcl_size_t>(B_size, k_start + block_size);
 
-      for (vcl_size_t j = current_row + 1; j < A_size; ++j)
+      for (vcl_size_t i = 0; i < A_size; ++i)
       {
-        value_type A_element = A(current_row, j);
-        for (vcl_size_t k=0; k < B_size; ++k)
-          B(current_row, k) -= A_element * B(j, k);
+        vcl_size_t current_row = A_size - i - 1;
+
+        for (vcl_size_t j = current_row + 1; j < A_size; ++j)
+        {
+          value_type A_element = A(current_row, j);
+          for (vcl_size_t k = k_start; k < k_end; ++k)
+            B(current_row, k) -= A_element * B(j, k);
+        }
+
+        if (!unit_diagonal)
+        {
+          value_type A_diag = A(current_row, current_row);
+          for (vcl_size_t k = k_start; k < k_end; ++k)
+            B(current_row, k) /= A_diag;
+        }
       }
+    }
+  }
 
-      if (!unit_diagonal)
+  /** @brief Column-major right hand sides: Each column of B is solved by column-oriented substitution, which accesses B with unit stride. */
+  template<typename MatrixT1, typename NumericT>
+  void upper_inplace_solve_matrix(MatrixT1 & A, matrix_array_wrapper<NumericT, viennacl::column_major, false> & B, vcl_size_t A_size, vcl_size_t B_size, bool unit_diagonal)
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (A_size * A_size * B_size > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+    for (long k = 0; k < static_cast<long>(B_size); ++k)
+    {
+      for (vcl_size_t j = A_size; j > 0; --j)
       {
-        value_type A_diag = A(current_row, current_row);
-        for (vcl_size_t k=0; k < B_size; ++k)
-          B(current_row, k) /= A_diag;
+        vcl_size_t current_row = j - 1;
+        if (!unit_diagonal)
+          B(current_row, k) /= A(current_row, current_row);
+
+        NumericT B_element = B(current_row, k);
+        for (vcl_size_t i = 0; i < current_row; ++i)
+          B(i, k) -= A(i, current_row) * B_element;
       }
     }
   }
@@ -84,20 +119,54 @@ namespace detail
   {
     typedef typename MatrixT2::value_type   value_type;
 
-    for (vcl_size_t i = 0; i < A_size; ++i)
+    // The columns of B are independent, hence they are processed in blocks which fit into cache (and in parallel):
+    vcl_size_t const block_size = 64;
+    long num_blocks = static_cast<long>((B_size + block_size - 1) / block_size);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (A_size * A_size * B_size > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+    for (long block = 0; block < num_blocks; ++block)
     {
-      for (vcl_size_t j = 0; j < i; ++j)
+      vcl_size_t k_start = static_cast<vcl_size_t>(block) * block_size;
+      vcl_size_t k_end   = std::min<vcl_size_t>(B_size, k_start + block_size);
+
+      for (vcl_size_t i = 0; i < A_size; ++i)
       {
-        value_type A_element = A(i, j);
-        for (vcl_size_t k=0; k < B_size; ++k)
-          B(i, k) -= A_element * B(j, k);
+        for (vcl_size_t j = 0; j < i; ++j)
+        {
+          value_type A_element = A(i, j);
+          for (vcl_size_t k = k_start; k < k_end; ++k)
+            B(i, k) -= A_element * B(j, k);
+        }
+
+        if (!unit_diagonal)
+        {
+          value_type A_diag = A(i, i);
+          for (vcl_size_t k = k_start; k < k_end; ++k)
+            B(i, k) /= A_diag;
+        }
       }
+    }
+  }
 
-      if (!unit_diagonal)
+  /** @brief Column-major right hand sides: Each column of B is solved by column-oriented substitution, which accesses B with unit stride. */
+  template<typename MatrixT1, typename NumericT>
+  void lower_inplace_solve_matrix(MatrixT1 & A, matrix_array_wrapper<NumericT, viennacl::column_major, false> & B, vcl_size_t A_size, vcl_size_t B_size, bool unit_diagonal)
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (A_size * A_size * B_size > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+    for (long k = 0; k < static_cast<long>(B_size); ++k)
+    {
+      for (vcl_size_t j = 0; j < A_size; ++j)
       {
-        value_type A_diag = A(i, i);
-        for (vcl_size_t k=0; k < B_size; ++k)
-          B(i, k) /= A_diag;
+        if (!unit_diagonal)
+          B(j, k) /= A(j, j);
+
+        NumericT B_element = B(j, k);
+        for (vcl_size_t i = j + 1; i < A_size; ++i)
+          B(i, k) -= A(i, j) * B_element;
       }
     }
   }
@@ -0,0 +1,466 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_GEMM_HPP_
+#define VIENNACL_LINALG_HOST_BASED_GEMM_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/gemm.hpp
+    @brief Packed, register-blocked matrix-matrix multiplication (GEMM) on the CPU using a single thread or OpenMP.
+
+    The implementation follows the well-known GotoBLAS/BLIS layering:
+    The result matrix C is split into column panels of width NC, the inner dimension into slabs of depth KC, and the rows of A into blocks of height MC.
+    Each KC x NC slab of B and each MC x KC block of A is copied into a contiguous buffer ('packing'), from which a small MR x NR micro-kernel computes register-resident tiles of C.
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+// Minimum Matrix size(size1*size2) for using OpenMP on matrix operations:
+#ifndef VIENNACL_OPENMP_MATRIX_MIN_SIZE
+  #define VIENNACL_OPENMP_MATRIX_MIN_SIZE  5000
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+
+//
+// Micro-kernels: Each kernel provides the register block sizes mr and nr, the cache block sizes mc, kc, nc,
+// as well as a static member apply(), which computes the mr x nr tile (row-major) of the product of a packed mr x kc panel of A with a packed kc x nr panel of B.
+//
+
+/** @brief Portable micro-kernel for arbitrary numeric types. The loop structure is chosen such that compilers are able to auto-vectorize the inner loop. */
+template<typename NumericT>
+struct gemm_kernel_generic
+{
+  static const vcl_size_t mr = 4;
+  static const vcl_size_t nr = 4;
+  static const vcl_size_t mc = 64;
+  static const vcl_size_t kc = 256;
+  static const vcl_size_t nc = 2048;
+
+  static void apply(vcl_size_t k_size, NumericT const * panel_A, NumericT const * panel_B, NumericT * tile_C)
+  {
+    NumericT c[mr * nr];
+    for (vcl_size_t i = 0; i < mr * nr; ++i)
+      c[i] = NumericT(0);
+
+    for (vcl_size_t k = 0; k < k_size; ++k)
+    {
+      NumericT const * a = panel_A + k * mr;
+      NumericT const * b = panel_B + k * nr;
+      for (vcl_size_t i = 0; i < mr; ++i)
+      {
+        NumericT a_i = a[i];
+        for (vcl_size_t j = 0; j < nr; ++j)
+          c[i * nr + j] += a_i * b[j];
+      }
+    }
+
+    for (vcl_size_t i = 0; i < mr * nr; ++i)
+      tile_C[i] = c[i];
+  }
+};
+
+
+#ifdef VIENNACL_HOST_AVX2_KERNELS
+/** @brief AVX2/FMA micro-kernel for double precision, computing a 6x8 tile in twelve ymm registers. */
+struct gemm_kernel_avx2_double
+{
+  static const vcl_size_t mr = 6;
+  static const vcl_size_t nr = 8;
+  static const vcl_size_t mc = 96;
+  static const vcl_size_t kc = 256;
+  static const vcl_size_t nc = 2048;
+
+  static VIENNACL_HOST_TARGET_AVX2 void apply(vcl_size_t k_size, double const * panel_A, double const * panel_B, double * tile_C)
+  {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    for (vcl_size_t k = 0; k < k_size; ++k)
+    {
+      __m256d b0 = _mm256_loadu_pd(panel_B);
+      __m256d b1 = _mm256_loadu_pd(panel_B + 4);
+      __m256d a;
+
+      a = _mm256_broadcast_sd(panel_A + 0); c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+      a = _mm256_broadcast_sd(panel_A + 1); c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+      a = _mm256_broadcast_sd(panel_A + 2); c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+      a = _mm256_broadcast_sd(panel_A + 3); c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+      a = _mm256_broadcast_sd(panel_A + 4); c40 = _mm256_fmadd_pd(a, b0, c40); c41 = _mm256_fmadd_pd(a, b1, c41);
+      a = _mm256_broadcast_sd(panel_A + 5); c50 = _mm256_fmadd_pd(a, b0, c50); c51 = _mm256_fmadd_pd(a, b1, c51);
+
+      panel_A += mr;
+      panel_B += nr;
+    }
+
+    _mm256_storeu_pd(tile_C +  0, c00); _mm256_storeu_pd(tile_C +  4, c01);
+    _mm256_storeu_pd(tile_C +  8, c10); _mm256_storeu_pd(tile_C + 12, c11);
+    _mm256_storeu_pd(tile_C + 16, c20); _mm256_storeu_pd(tile_C + 20, c21);
+    _mm256_storeu_pd(tile_C + 24, c30); _mm256_storeu_pd(tile_C + 28, c31);
+    _mm256_storeu_pd(tile_C + 32, c40); _mm256_storeu_pd(tile_C + 36, c41);
+    _mm256_storeu_pd(tile_C + 40, c50); _mm256_storeu_pd(tile_C + 44, c51);
+  }
+};
+
+/** @brief AVX2/FMA micro-kernel for single precision, computing a 6x16 tile in twelve ymm registers. */
+struct gemm_kernel_avx2_float
+{
+  static const vcl_size_t mr = 6;
+  static const vcl_size_t nr = 16;
+  static const vcl_size_t mc = 96;
+  static const vcl_size_t kc = 256;
+  static const vcl_size_t nc = 4096;
+
+  static VIENNACL_HOST_TARGET_AVX2 void apply(vcl_size_t k_size, float const * panel_A, float const * panel_B, float * tile_C)
+  {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (vcl_size_t k = 0; k < k_size; ++k)
+    {
+      __m256 b0 = _mm256_loadu_ps(panel_B);
+      __m256 b1 = _mm256_loadu_ps(panel_B + 8);
+      __m256 a;
+
+      a = _mm256_broadcast_ss(panel_A + 0); c00 = _mm256_fmadd_ps(a, b0, c00); c01 = _mm256_fmadd_ps(a, b1, c01);
+      a = _mm256_broadcast_ss(panel_A + 1); c10 = _mm256_fmadd_ps(a, b0, c10); c11 = _mm256_fmadd_ps(a, b1, c11);
+      a = _mm256_broadcast_ss(panel_A + 2); c20 = _mm256_fmadd_ps(a, b0, c20); c21 = _mm256_fmadd_ps(a, b1, c21);
+      a = _mm256_broadcast_ss(panel_A + 3); c30 = _mm256_fmadd_ps(a, b0, c30); c31 = _mm256_fmadd_ps(a, b1, c31);
+      a = _mm256_broadcast_ss(panel_A + 4); c40 = _mm256_fmadd_ps(a, b0, c40); c41 = _mm256_fmadd_ps(a, b1, c41);
+      a = _mm256_broadcast_ss(panel_A + 5); c50 = _mm256_fmadd_ps(a, b0, c50); c51 = _mm256_fmadd_ps(a, b1, c51);
+
+      panel_A += mr;
+      panel_B += nr;
+    }
+
+    _mm256_storeu_ps(tile_C +  0, c00); _mm256_storeu_ps(tile_C +  8, c01);
+    _mm256_storeu_ps(tile_C + 16, c10); _mm256_storeu_ps(tile_C + 24, c11);
+    _mm256_storeu_ps(tile_C + 32, c20); _mm256_storeu_ps(tile_C + 40, c21);
+    _mm256_storeu_ps(tile_C + 48, c30); _mm256_storeu_ps(tile_C + 56, c31);
+    _mm256_storeu_ps(tile_C + 64, c40); _mm256_storeu_ps(tile_C + 72, c41);
+    _mm256_storeu_ps(tile_C + 80, c50); _mm256_storeu_ps(tile_C + 88, c51);
+  }
+};
+#endif
+
+
+#ifdef VIENNACL_HOST_AVX512_KERNELS
+/** @brief AVX-512 micro-kernel for double precision, computing a 6x16 tile in twelve zmm registers. */
+struct gemm_kernel_avx512_double
+{
+  static const vcl_size_t mr = 6;
+  static const vcl_size_t nr = 16;
+  static const vcl_size_t mc = 96;
+  static const vcl_size_t kc = 256;
+  static const vcl_size_t nc = 2048;
+
+  static VIENNACL_HOST_TARGET_AVX512 void apply(vcl_size_t k_size, double const * panel_A, double const * panel_B, double * tile_C)
+  {
+    __m512d c[2 * mr];
+    for (vcl_size_t i = 0; i < 2 * mr; ++i)
+      c[i] = _mm512_setzero_pd();
+
+    for (vcl_size_t k = 0; k < k_size; ++k)
+    {
+      __m512d b0 = _mm512_loadu_pd(panel_B);
+      __m512d b1 = _mm512_loadu_pd(panel_B + 8);
+      for (vcl_size_t i = 0; i < mr; ++i)
+      {
+        __m512d a = _mm512_set1_pd(panel_A[i]);
+        c[2*i]   = _mm512_fmadd_pd(a, b0, c[2*i]);
+        c[2*i+1] = _mm512_fmadd_pd(a, b1, c[2*i+1]);
+      }
+      panel_A += mr;
+      panel_B += nr;
+    }
+
+    for (vcl_size_t i = 0; i < mr; ++i)
+    {
+      _mm512_storeu_pd(tile_C + i * nr,     c[2*i]);
+      _mm512_storeu_pd(tile_C + i * nr + 8, c[2*i+1]);
+    }
+  }
+};
+
+/** @brief AVX-512 micro-kernel for single precision, computing a 6x32 tile in twelve zmm registers. */
+struct gemm_kernel_avx512_float
+{
+  static const vcl_size_t mr = 6;
+  static const vcl_size_t nr = 32;
+  static const vcl_size_t mc = 96;
+  static const vcl_size_t kc = 256;
+  static const vcl_size_t nc = 4096;
+
+  static VIENNACL_HOST_TARGET_AVX512 void apply(vcl_size_t k_size, float const * panel_A, float const * panel_B, float * tile_C)
+  {
+    __m512 c[2 * mr];
+    for (vcl_size_t i = 0; i < 2 * mr; ++i)
+      c[i] = _mm512_setzero_ps();
+
+    for (vcl_size_t k = 0; k < k_size; ++k)
+    {
+      __m512 b0 = _mm512_loadu_ps(panel_B);
+      __m512 b1 = _mm512_loadu_ps(panel_B + 16);
+      for (vcl_size_t i = 0; i < mr; ++i)
+      {
+        __m512 a = _mm512_set1_ps(panel_A[i]);
+        c[2*i]   = _mm512_fmadd_ps(a, b0, c[2*i]);
+        c[2*i+1] = _mm512_fmadd_ps(a, b1, c[2*i+1]);
+      }
+      panel_A += mr;
+      panel_B += nr;
+    }
+
+    for (vcl_size_t i = 0; i < mr; ++i)
+    {
+      _mm512_storeu_ps(tile_C + i * nr,      c[2*i]);
+      _mm512_storeu_ps(tile_C + i * nr + 16, c[2*i+1]);
+    }
+  }
+};
+#endif
+
+
+/** @brief Selects the micro-kernel for the given numeric type and instruction set level. Falls back to the generic kernel if no specialized kernel is available. */
+template<typename NumericT, cpu_isa_type IsaV>
+struct gemm_kernel
+{
+  typedef gemm_kernel_generic<NumericT>   type;
+};
+
+/** \cond */
+#ifdef VIENNACL_HOST_AVX2_KERNELS
+template<> struct gemm_kernel<double, CPU_ISA_AVX2>   { typedef gemm_kernel_avx2_double    type; };
+template<> struct gemm_kernel<float,  CPU_ISA_AVX2>   { typedef gemm_kernel_avx2_float     type; };
+#endif
+#ifdef VIENNACL_HOST_AVX512_KERNELS
+template<> struct gemm_kernel<double, CPU_ISA_AVX512> { typedef gemm_kernel_avx512_double  type; };
+template<> struct gemm_kernel<float,  CPU_ISA_AVX512> { typedef gemm_kernel_avx512_float   type; };
+#endif
+/** \endcond */
+
+
+//
+// Packing routines
+//
+
+/** @brief Packs the block A(offset_i:offset_i+m_size, offset_k:offset_k+k_size) into consecutive micro-panels of MR rows. Each micro-panel is stored column by column. Rows beyond m_size are zero-padded. */
+template<typename KernelT, typename MatrixAccT, typename NumericT>
+void gemm_pack_A(MatrixAccT & A, vcl_size_t offset_i, vcl_size_t offset_k, vcl_size_t m_size, vcl_size_t k_size, NumericT * buffer)
+{
+  static const vcl_size_t mr = KernelT::mr;
+
+  for (vcl_size_t panel_start = 0; panel_start < m_size; panel_start += mr)
+  {
+    vcl_size_t rows = std::min<vcl_size_t>(mr, m_size - panel_start);
+    NumericT * panel = buffer + panel_start * k_size;
+    for (vcl_size_t k = 0; k < k_size; ++k)
+    {
+      for (vcl_size_t i = 0; i < rows; ++i)
+        panel[k * mr + i] = A(offset_i + panel_start + i, offset_k + k);
+      for (vcl_size_t i = rows; i < mr; ++i)
+        panel[k * mr + i] = NumericT(0);
+    }
+  }
+}
+
+/** @brief Packs the block B(offset_k:offset_k+k_size, offset_j:offset_j+n_size) into consecutive micro-panels of NR columns. Each micro-panel is stored row by row. Columns beyond n_size are zero-padded. */
+template<typename KernelT, typename MatrixAccT, typename NumericT>
+void gemm_pack_B(MatrixAccT & B, vcl_size_t offset_k, vcl_size_t offset_j, vcl_size_t k_size, vcl_size_t n_size, NumericT * buffer)
+{
+  static const vcl_size_t nr = KernelT::nr;
+
+  long num_panels = static_cast<long>((n_size - 1) / nr + 1);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for if ((k_size*n_size) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+  for (long panel_idx = 0; panel_idx < num_panels; ++panel_idx)
+  {
+    vcl_size_t panel_start = static_cast<vcl_size_t>(panel_idx) * nr;
+    vcl_size_t cols = std::min<vcl_size_t>(nr, n_size - panel_start);
+    NumericT * panel = buffer + panel_start * k_size;
+    for (vcl_size_t k = 0; k < k_size; ++k)
+    {
+      for (vcl_size_t j = 0; j < cols; ++j)
+        panel[k * nr + j] = B(offset_k + k, offset_j + panel_start + j);
+      for (vcl_size_t j = cols; j < nr; ++j)
+        panel[k * nr + j] = NumericT(0);
+    }
+  }
+}
+
+
+/** @brief Computes C = alpha * A * B + beta * C using packed panels and the micro-kernel KernelT.
+*
+* A, B, and C are accessed through the matrix_array_wrapper accessors, hence all combinations of layouts and transpositions are handled by the packing routines.
+*
+* @param A         Accessor for the (possibly transposed) C_size1 x A_size2 matrix A
+* @param B         Accessor for the (possibly transposed) A_size2 x C_size2 matrix B
+* @param C         Accessor for the result matrix
+* @param C_size1   Number of rows of C
+* @param C_size2   Number of columns of C
+* @param A_size2   Inner dimension of the product
+* @param alpha     Scaling factor for A * B
+* @param beta      Scaling factor for C. If zero, C is overwritten (i.e. NaNs in C are not propagated)
+*/
+template<typename KernelT, typename MatrixAccT1, typename MatrixAccT2, typename MatrixAccT3, typename NumericT>
+void gemm_packed(MatrixAccT1 & A, MatrixAccT2 & B, MatrixAccT3 & C,
+                 vcl_size_t C_size1, vcl_size_t C_size2, vcl_size_t A_size2,
+                 NumericT alpha, NumericT beta)
+{
+  if (C_size1 == 0 || C_size2 == 0)
+    return;
+
+  // Step 1: C <- beta * C. All subsequent updates are then of the form C += alpha * A_block * B_block.
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for if ((C_size1*C_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+  for (long row2 = 0; row2 < static_cast<long>(C_size1); ++row2)
+  {
+    vcl_size_t row = static_cast<vcl_size_t>(row2);
+    if (beta > 0 || beta < 0)
+    {
+      for (vcl_size_t col = 0; col < C_size2; ++col)
+        C(row, col) *= beta;
+    }
+    else
+    {
+      for (vcl_size_t col = 0; col < C_size2; ++col)
+        C(row, col) = NumericT(0);
+    }
+  }
+
+  if (A_size2 == 0 || !(alpha > 0 || alpha < 0))
+    return;
+
+  static const vcl_size_t mr = KernelT::mr;
+  static const vcl_size_t nr = KernelT::nr;
+
+  vcl_size_t kc = A_size2;
+  vcl_size_t nc = ((C_size2 - 1) / nr + 1) * nr;
+  vcl_size_t mc = ((C_size1 - 1) / mr + 1) * mr;
+  if (kc > KernelT::kc) kc = KernelT::kc;
+  if (nc > KernelT::nc) nc = KernelT::nc;
+  if (mc > KernelT::mc) mc = KernelT::mc;
+
+  std::vector<NumericT> buffer_B(kc * nc);
+
+  // Step 2: Loop over column panels of C and B:
+  for (vcl_size_t offset_j = 0; offset_j < C_size2; offset_j += nc)
+  {
+    vcl_size_t n_size = std::min<vcl_size_t>(nc, C_size2 - offset_j);
+
+    // Step 3: Loop over slabs of the inner dimension:
+    for (vcl_size_t offset_k = 0; offset_k < A_size2; offset_k += kc)
+    {
+      vcl_size_t k_size = std::min<vcl_size_t>(kc, A_size2 - offset_k);
+
+      gemm_pack_B<KernelT>(B, offset_k, offset_j, k_size, n_size, &(buffer_B[0]));
+
+      long num_blocks_i = static_cast<long>((C_size1 - 1) / mc + 1);
+
+      // Step 4: Loop over row blocks of A and C. Each thread packs its own block of A:
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel if ((C_size1*n_size) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+      {
+        std::vector<NumericT> buffer_A(mc * k_size);
+        NumericT tile_C[mr * nr];
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp for
+#endif
+        for (long block_idx_i = 0; block_idx_i < num_blocks_i; ++block_idx_i)
+        {
+          vcl_size_t offset_i = static_cast<vcl_size_t>(block_idx_i) * mc;
+          vcl_size_t m_size = std::min<vcl_size_t>(mc, C_size1 - offset_i);
+
+          gemm_pack_A<KernelT>(A, offset_i, offset_k, m_size, k_size, &(buffer_A[0]));
+
+          // Step 5: Macro-kernel. Run over all micro-tiles of the current block of C:
+          for (vcl_size_t jr = 0; jr < n_size; jr += nr)
+          {
+            vcl_size_t cols = std::min<vcl_size_t>(nr, n_size - jr);
+            NumericT const * panel_B = &(buffer_B[jr * k_size]);
+
+            for (vcl_size_t ir = 0; ir < m_size; ir += mr)
+            {
+              vcl_size_t rows = std::min<vcl_size_t>(mr, m_size - ir);
+
+              KernelT::apply(k_size, &(buffer_A[ir * k_size]), panel_B, tile_C);
+
+              for (vcl_size_t i = 0; i < rows; ++i)
+                for (vcl_size_t j = 0; j < cols; ++j)
+                  C(offset_i + ir + i, offset_j + jr + j) += alpha * tile_C[i * nr + j];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+
+/** @brief Computes C = alpha * A * B + beta * C using the micro-kernel best suited for the CPU (see cpu_dispatch.hpp). */
+template<typename MatrixAccT1, typename MatrixAccT2, typename MatrixAccT3, typename NumericT>
+void gemm_dispatch(MatrixAccT1 & A, MatrixAccT2 & B, MatrixAccT3 & C,
+                   vcl_size_t C_size1, vcl_size_t C_size2, vcl_size_t A_size2,
+                   NumericT alpha, NumericT beta)
+{
+  switch (selected_cpu_isa<NumericT>(HOST_KERNEL_GEMM))
+  {
+  case CPU_ISA_AVX512:
+    gemm_packed<typename gemm_kernel<NumericT, CPU_ISA_AVX512>::type>(A, B, C, C_size1, C_size2, A_size2, alpha, beta);
+    break;
+  case CPU_ISA_AVX2:
+    gemm_packed<typename gemm_kernel<NumericT, CPU_ISA_AVX2>::type>(A, B, C, C_size1, C_size2, A_size2, alpha, beta);
+    break;
+  default:
+    gemm_packed<typename gemm_kernel<NumericT, CPU_ISA_GENERIC>::type>(A, B, C, C_size1, C_size2, A_size2, alpha, beta);
+  }
+}
+
+} // namespace detail
+} // namespace host_based
+} // namespace linalg
+} // namespace viennacl
+
+#endif
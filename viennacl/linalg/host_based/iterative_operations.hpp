@@ -22,8 +22,10 @@
     @brief Implementations of specialized kernels for fast iterative solvers using OpenMP on the CPU
 */
 
+#include <cassert>
 #include <cmath>
 #include <algorithm>  //for std::max and std::min
+#include <vector>
 
 #include "viennacl/forwards.h"
 #include "viennacl/scalar.hpp"
@@ -34,6 +36,7 @@
 #include "viennacl/traits/start.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
 #include "viennacl/linalg/detail/op_applier.hpp"
+#include "viennacl/linalg/host_based/spmv_symmetric.hpp"
 #include "viennacl/traits/stride.hpp"
 
 #ifdef VIENNACL_WITH_OPENMP
@@ -237,9 +240,10 @@ namespace detail
     IndexT     const * columns_per_block = detail::extract_raw_pointer<IndexT>(A.handle1());
     IndexT     const * column_indices    = detail::extract_raw_pointer<IndexT>(A.handle2());
     IndexT     const * block_start       = detail::extract_raw_pointer<IndexT>(A.handle3());
+    IndexT     const * row_permutation   = (A.sorting_scope() > 1) ? detail::extract_raw_pointer<IndexT>(A.handle4()) : NULL;
     value_type         * data_buffer     = detail::extract_raw_pointer<value_type>(inner_prod_buffer);
 
-    vcl_size_t num_blocks = A.size1() / A.rows_per_block() + 1;
+    vcl_size_t num_blocks = (A.size1() > 0) ? (A.size1() - 1) / A.rows_per_block() + 1 : 0;
 
     value_type inner_prod_ApAp = 0;
     value_type inner_prod_pAp = 0;
@@ -269,12 +273,13 @@ namespace detail
         }
       }
 
+      // rows are stored in the order given by the row permutation (if any):
       vcl_size_t first_row_in_matrix = block_idx * A.rows_per_block();
       for (IndexT row_in_block = 0; row_in_block < A.rows_per_block(); ++row_in_block)
       {
-        vcl_size_t row = first_row_in_matrix + row_in_block;
-        if (row < Ap.size())
+        if (first_row_in_matrix + row_in_block < Ap.size())
         {
+          vcl_size_t row = row_permutation ? static_cast<vcl_size_t>(row_permutation[first_row_in_matrix + row_in_block]) : first_row_in_matrix + row_in_block;
           value_type row_result = result_values[row_in_block];
 
           Ap_buf[row] = row_result;
@@ -364,6 +369,47 @@ namespace detail
       data_buffer[buffer_chunk_offset] = inner_prod_Ap_r0star;
   }
 
+
+  /** @brief Implementation of a fused matrix-vector product with a symmetric_compressed_matrix for an efficient pipelined CG algorithm.
+    *
+    * This routines computes for a matrix A and vectors 'p', 'Ap', and 'r0':
+    *   Ap = prod(A, p);
+    * and computes the two reduction stages for computing inner_prod(p,Ap), inner_prod(Ap,Ap), inner_prod(Ap, r0)
+    * The inner products are accumulated in the pass summing up the thread-local buffers of symmetric_csr_spmv(), so Ap is not read again.
+    */
+  template<typename NumericT>
+  void pipelined_prod_impl(symmetric_compressed_matrix<NumericT> const & A,
+                           vector_base<NumericT> const & p,
+                           vector_base<NumericT> & Ap,
+                           NumericT const * r0star,
+                           vector_base<NumericT> & inner_prod_buffer,
+                           vcl_size_t buffer_chunk_size,
+                           vcl_size_t buffer_chunk_offset)
+  {
+    typedef NumericT        value_type;
+
+    value_type         * Ap_buf      = detail::extract_raw_pointer<value_type>(Ap.handle()) + viennacl::traits::start(Ap);
+    value_type   const *  p_buf      = detail::extract_raw_pointer<value_type>(p.handle()) + viennacl::traits::start(p);
+    value_type   const * elements    = detail::extract_raw_pointer<value_type>(A.handle());
+    unsigned int const *  row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const *  col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+    value_type         * data_buffer = detail::extract_raw_pointer<value_type>(inner_prod_buffer);
+
+    value_type inner_prods[3] = {0, 0, 0};
+    if (A.nnz() > 0)
+      symmetric_csr_spmv(row_buffer, col_buffer, elements, A.size1(),
+                         p_buf, 1, Ap_buf, 1, value_type(1), value_type(0),
+                         inner_prods, r0star);
+    else
+      for (vcl_size_t i = 0; i < A.size1(); ++i)
+        Ap_buf[i] = 0;
+
+    data_buffer[    buffer_chunk_size] = inner_prods[0];
+    data_buffer[2 * buffer_chunk_size] = inner_prods[1];
+    if (r0star)
+      data_buffer[buffer_chunk_offset] = inner_prods[2];
+  }
+
 } // namespace detail
 
 
@@ -505,6 +551,168 @@ void pipelined_cg_prod(hyb_matrix<NumericT> const & A,
   viennacl::linalg::host_based::detail::pipelined_prod_impl(A, p, Ap, PtrType(NULL), inner_prod_buffer, inner_prod_buffer.size() / 3, 0);
 }
 
+
+/** @brief Performs the fused matrix-vector product of the pipelined CG algorithm for a symmetric_compressed_matrix.
+  *
+  * Ap = prod(A, p) is computed by symmetric_csr_spmv() from the upper triangle only, scattering the transposed contributions into thread-local buffers.
+  * inner_prod(p,Ap) and inner_prod(Ap,Ap) are accumulated as the entries of Ap are finalized, so Ap is not read again.
+  */
+template<typename NumericT>
+void pipelined_cg_prod(symmetric_compressed_matrix<NumericT> const & A,
+                       vector_base<NumericT> const & p,
+                       vector_base<NumericT> & Ap,
+                       vector_base<NumericT> & inner_prod_buffer)
+{
+  typedef NumericT const *    PtrType;
+  viennacl::linalg::host_based::detail::pipelined_prod_impl(A, p, Ap, PtrType(NULL), inner_prod_buffer, inner_prod_buffer.size() / 3, 0);
+}
+
+
+namespace detail
+{
+  inline bool & fused_cg_iteration_setting()
+  {
+    static bool enabled = true;
+    return enabled;
+  }
+
+  /** @brief Returns the first row of the part 'part' out of 'num_parts' parts of a CSR matrix, such that the parts hold about the same number of rows plus nonzeros. */
+  inline vcl_size_t csr_balanced_row_boundary(unsigned int const * row_buffer, vcl_size_t num_rows, vcl_size_t part, vcl_size_t num_parts)
+  {
+    if (part >= num_parts)
+      return num_rows;
+
+    vcl_size_t work = (part * (num_rows + row_buffer[num_rows])) / num_parts;
+
+    // smallest row with row + row_buffer[row] >= work:
+    vcl_size_t lower = 0;
+    vcl_size_t upper = num_rows;
+    while (lower < upper)
+    {
+      vcl_size_t mid = (lower + upper) / 2;
+      if (mid + row_buffer[mid] < work)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+    return lower;
+  }
+}
+
+/** @brief Enables or disables the fused CG iteration for a compressed_matrix in main memory, cf. pipelined_cg_iteration(). Enabled by default. */
+inline void set_fused_cg_iteration(bool enabled) { detail::fused_cg_iteration_setting() = enabled; }
+
+/** @brief Returns whether the fused CG iteration is used for a compressed_matrix in main memory */
+inline bool fused_cg_iteration() { return detail::fused_cg_iteration_setting(); }
+
+
+/** @brief Performs a full iteration of the pipelined CG algorithm with a compressed_matrix in a single parallel region.
+  *
+  * This routine computes for a matrix A and vectors 'result', 'p', 'r', 'Ap':
+  *   result += alpha * p;
+  *   r      -= alpha * Ap;
+  *   p       = r + beta * p;
+  *   Ap      = prod(A, p);
+  * and the inner products (r,r), (Ap,Ap), (p,Ap), which are written to inner_prods[0], inner_prods[1], and inner_prods[2].
+  *
+  * Each thread updates and multiplies the same range of rows, balanced by the number of rows plus nonzeros.
+  * Thus, the entries of p, r, and Ap written by a thread are read again by the same thread, and only one barrier is needed between the vector update and the matrix-vector product.
+  * Compared to pipelined_cg_vector_update() followed by pipelined_cg_prod(), this saves one parallel region and the transfer of the partial inner products through a buffer.
+  */
+template<typename NumericT>
+void pipelined_cg_iteration(compressed_matrix<NumericT> const & A,
+                            vector_base<NumericT> & result,
+                            NumericT alpha,
+                            vector_base<NumericT> & p,
+                            vector_base<NumericT> & r,
+                            vector_base<NumericT> & Ap,
+                            NumericT beta,
+                            NumericT * inner_prods)
+{
+  typedef NumericT        value_type;
+
+  value_type         * data_result = detail::extract_raw_pointer<value_type>(result) + viennacl::traits::start(result);
+  value_type         * data_p      = detail::extract_raw_pointer<value_type>(p) + viennacl::traits::start(p);
+  value_type         * data_r      = detail::extract_raw_pointer<value_type>(r) + viennacl::traits::start(r);
+  value_type         * data_Ap     = detail::extract_raw_pointer<value_type>(Ap) + viennacl::traits::start(Ap);
+  value_type   const * elements    = detail::extract_raw_pointer<value_type>(A.handle());
+  unsigned int const * row_buffer  = detail::extract_raw_pointer<unsigned int>(A.handle1());
+  unsigned int const * col_buffer  = detail::extract_raw_pointer<unsigned int>(A.handle2());
+
+  // Note: Due to the special setting in CG, there is no need to check for sizes and strides
+  vcl_size_t num_rows = A.size1();
+
+#ifdef VIENNACL_WITH_OPENMP
+  vcl_size_t max_threads = static_cast<vcl_size_t>(omp_get_max_threads());
+#else
+  vcl_size_t max_threads = 1;
+#endif
+  std::vector<value_type> partial_inner_prods(3 * max_threads);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel
+#endif
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    vcl_size_t thread_id   = static_cast<vcl_size_t>(omp_get_thread_num());
+    vcl_size_t num_threads = static_cast<vcl_size_t>(omp_get_num_threads());
+#else
+    vcl_size_t thread_id   = 0;
+    vcl_size_t num_threads = 1;
+#endif
+    vcl_size_t row_start = detail::csr_balanced_row_boundary(row_buffer, num_rows, thread_id,     num_threads);
+    vcl_size_t row_stop  = detail::csr_balanced_row_boundary(row_buffer, num_rows, thread_id + 1, num_threads);
+
+    // vector update:
+    value_type inner_prod_rr = 0;
+    for (vcl_size_t i = row_start; i < row_stop; ++i)
+    {
+      value_type value_p = data_p[i];
+      value_type value_r = data_r[i];
+
+      data_result[i] += alpha * value_p;
+      value_r -= alpha * data_Ap[i];
+      value_p  = value_r + beta * value_p;
+      inner_prod_rr += value_r * value_r;
+
+      data_p[i] = value_p;
+      data_r[i] = value_r;
+    }
+
+    // all entries of p are required for the matrix-vector product:
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp barrier
+#endif
+
+    value_type inner_prod_ApAp = 0;
+    value_type inner_prod_pAp  = 0;
+    for (vcl_size_t row = row_start; row < row_stop; ++row)
+    {
+      value_type dot_prod = 0;
+      vcl_size_t row_end = row_buffer[row+1];
+      for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
+        dot_prod += elements[i] * data_p[col_buffer[i]];
+
+      data_Ap[row] = dot_prod;
+      inner_prod_ApAp += dot_prod * dot_prod;
+      inner_prod_pAp  += data_p[row] * dot_prod;
+    }
+
+    partial_inner_prods[3 * thread_id    ] = inner_prod_rr;
+    partial_inner_prods[3 * thread_id + 1] = inner_prod_ApAp;
+    partial_inner_prods[3 * thread_id + 2] = inner_prod_pAp;
+  }
+
+  // sum up in a fixed order, so the result does not depend on the scheduling:
+  inner_prods[0] = inner_prods[1] = inner_prods[2] = 0;
+  for (vcl_size_t i = 0; i < max_threads; ++i)
+  {
+    inner_prods[0] += partial_inner_prods[3 * i    ];
+    inner_prods[1] += partial_inner_prods[3 * i + 1];
+    inner_prods[2] += partial_inner_prods[3 * i + 2];
+  }
+}
+
 //////////////////////////
 
 
@@ -817,8 +1025,8 @@ void pipelined_gmres_gram_schmidt_stage1(vector_base<T> const & device_krylov_ba
     thread_count = static_cast<long>(omp_get_num_threads());
 #endif
 
-    long work_per_thread = long(v_k_size - 1) / thread_count;
-    long thread_start = work_per_thread * thread_id;
+    long work_per_thread = (long(v_k_size) - 1) / thread_count + 1;
+    long thread_start = std::min<long>(work_per_thread * thread_id, long(v_k_size));
     long thread_stop  = std::min<long>(work_per_thread * (thread_id + 1), long(v_k_size));
 
     T *thread_scratchpad = &(scratchpad[k * thread_id]);
@@ -937,6 +1145,208 @@ void pipelined_gmres_prod(MatrixType const & A,
 }
 
 
+/////////////////////////////////////////////////////////////
+
+/** @brief Computes y = alpha * x + sum_j coefficients[j] * B(:, first + j) in a single pass, as needed for the small-system updates of IDR(s).
+  *
+  * The vectors are stored in the columns of B. y may be x or one of the columns of B. The vectors x and y must have unit stride.
+  */
+template<typename NumericT>
+void idrs_block_combination(vector_base<NumericT> & y,
+                            NumericT alpha,
+                            vector_base<NumericT> const & x,
+                            matrix<NumericT, column_major> const & B,
+                            vcl_size_t first,
+                            std::vector<NumericT> const & coefficients)
+{
+  typedef NumericT        value_type;
+
+  assert(viennacl::traits::stride(y) == 1 && viennacl::traits::stride(x) == 1 && bool("IDR(s) kernels require vectors with unit stride"));
+  assert(viennacl::traits::size(x) == viennacl::traits::size(y) && B.size1() == viennacl::traits::size(y) && first + coefficients.size() <= B.size2() && bool("Size mismatch"));
+
+  value_type       * data_y = detail::extract_raw_pointer<value_type>(y) + viennacl::traits::start(y);
+  value_type const * data_x = detail::extract_raw_pointer<value_type>(x) + viennacl::traits::start(x);
+  value_type const * data_B = detail::extract_raw_pointer<value_type>(B) + first * B.internal_size1();
+
+  vcl_size_t size  = viennacl::traits::size(y);
+  vcl_size_t ld    = B.internal_size1();
+  vcl_size_t count = coefficients.size();
+  value_type const * data_coefficients = count > 0 ? &(coefficients[0]) : NULL;
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long i = 0; i < static_cast<long>(size); ++i)
+  {
+    value_type value = alpha * data_x[i];
+    for (vcl_size_t j = 0; j < count; ++j)
+      value += data_coefficients[j] * data_B[static_cast<vcl_size_t>(i) + j * ld];
+    data_y[i] = value;
+  }
+}
+
+/** @brief Computes the inner products of v with all columns of B in a single pass over v. The vector v must have unit stride. */
+template<typename NumericT>
+void idrs_block_inner_products(matrix<NumericT, column_major> const & B,
+                               vector_base<NumericT> const & v,
+                               std::vector<NumericT> & result)
+{
+  typedef NumericT        value_type;
+
+  assert(viennacl::traits::stride(v) == 1 && bool("IDR(s) kernels require vectors with unit stride"));
+  assert(B.size1() == viennacl::traits::size(v) && bool("Size mismatch"));
+
+  value_type const * data_B = detail::extract_raw_pointer<value_type>(B);
+  value_type const * data_v = detail::extract_raw_pointer<value_type>(v) + viennacl::traits::start(v);
+
+  vcl_size_t size  = viennacl::traits::size(v);
+  vcl_size_t ld    = B.internal_size1();
+  vcl_size_t count = B.size2();
+
+#ifdef VIENNACL_WITH_OPENMP
+  vcl_size_t max_threads = static_cast<vcl_size_t>(omp_get_max_threads());
+#else
+  vcl_size_t max_threads = 1;
+#endif
+  std::vector<value_type> partial_inner_prods(count * max_threads);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel
+#endif
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    vcl_size_t thread_id   = static_cast<vcl_size_t>(omp_get_thread_num());
+    vcl_size_t num_threads = static_cast<vcl_size_t>(omp_get_num_threads());
+#else
+    vcl_size_t thread_id   = 0;
+    vcl_size_t num_threads = 1;
+#endif
+    vcl_size_t work_per_thread = (size - 1) / num_threads + 1;
+    vcl_size_t thread_start = std::min(work_per_thread * thread_id, size);
+    vcl_size_t thread_stop  = std::min(work_per_thread * (thread_id + 1), size);
+
+    value_type * thread_inner_prods = count > 0 ? &(partial_inner_prods[count * thread_id]) : NULL;
+    for (vcl_size_t i = thread_start; i < thread_stop; ++i)
+    {
+      value_type value_v = data_v[i];
+      for (vcl_size_t j = 0; j < count; ++j)
+        thread_inner_prods[j] += data_B[i + j * ld] * value_v;
+    }
+  }
+
+  // sum up in a fixed order, so the result does not depend on the scheduling:
+  result.resize(count);
+  for (vcl_size_t j = 0; j < count; ++j)
+  {
+    value_type value = 0;
+    for (vcl_size_t i = 0; i < max_threads; ++i)
+      value += partial_inner_prods[j + i * count];
+    result[j] = value;
+  }
+}
+
+/** @brief Performs the vector updates of one IDR(s) step in a single pass:
+  *
+  *   G(:,k) -= G(:,0:k) * alpha;
+  *   U(:,k) -= U(:,0:k) * alpha;
+  *   r      -= beta * G(:,k);
+  *   x      += beta * U(:,k);
+  *
+  * The vectors r and x must have unit stride.
+  *
+  * @return The squared norm of the updated residual r
+  */
+template<typename NumericT>
+NumericT idrs_step_update(matrix<NumericT, column_major> & G,
+                          matrix<NumericT, column_major> & U,
+                          vcl_size_t k,
+                          std::vector<NumericT> const & alpha,
+                          NumericT beta,
+                          vector_base<NumericT> & r,
+                          vector_base<NumericT> & x)
+{
+  typedef NumericT        value_type;
+
+  assert(viennacl::traits::stride(r) == 1 && viennacl::traits::stride(x) == 1 && bool("IDR(s) kernels require vectors with unit stride"));
+  assert(G.size1() == viennacl::traits::size(r) && U.size1() == viennacl::traits::size(r) && viennacl::traits::size(x) == viennacl::traits::size(r) && bool("Size mismatch"));
+  assert(k < G.size2() && k < U.size2() && alpha.size() >= k && bool("Size mismatch"));
+
+  value_type * data_G = detail::extract_raw_pointer<value_type>(G);
+  value_type * data_U = detail::extract_raw_pointer<value_type>(U);
+  value_type * data_r = detail::extract_raw_pointer<value_type>(r) + viennacl::traits::start(r);
+  value_type * data_x = detail::extract_raw_pointer<value_type>(x) + viennacl::traits::start(x);
+
+  vcl_size_t size = viennacl::traits::size(r);
+  vcl_size_t ld_G = G.internal_size1();
+  vcl_size_t ld_U = U.internal_size1();
+  value_type const * data_alpha = k > 0 ? &(alpha[0]) : NULL;
+
+  value_type norm_r_squared = 0;
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for reduction(+: norm_r_squared)
+#endif
+  for (long row = 0; row < static_cast<long>(size); ++row)
+  {
+    vcl_size_t i = static_cast<vcl_size_t>(row);
+    value_type value_g = data_G[i + k * ld_G];
+    value_type value_u = data_U[i + k * ld_U];
+    for (vcl_size_t j = 0; j < k; ++j)
+    {
+      value_g -= data_alpha[j] * data_G[i + j * ld_G];
+      value_u -= data_alpha[j] * data_U[i + j * ld_U];
+    }
+    data_G[i + k * ld_G] = value_g;
+    data_U[i + k * ld_U] = value_u;
+
+    value_type value_r = data_r[i] - beta * value_g;
+    data_r[i] = value_r;
+    data_x[i] += beta * value_u;
+    norm_r_squared += value_r * value_r;
+  }
+
+  return norm_r_squared;
+}
+
+
+/** @brief Performs the vector updates of one unpreconditioned Chebyshev iteration in a single pass without any reductions:
+  *
+  *   x += d;
+  *   r -= t;   with t = A d
+  *   d  = alpha * d + beta * r;
+  */
+template<typename NumericT>
+void chebyshev_update(vector_base<NumericT> & x,
+                      vector_base<NumericT> & r,
+                      vector_base<NumericT> & d,
+                      vector_base<NumericT> const & t,
+                      NumericT alpha,
+                      NumericT beta)
+{
+  typedef NumericT        value_type;
+
+  value_type       * data_x = detail::extract_raw_pointer<value_type>(x) + viennacl::traits::start(x);
+  value_type       * data_r = detail::extract_raw_pointer<value_type>(r) + viennacl::traits::start(r);
+  value_type       * data_d = detail::extract_raw_pointer<value_type>(d) + viennacl::traits::start(d);
+  value_type const * data_t = detail::extract_raw_pointer<value_type>(t) + viennacl::traits::start(t);
+
+  vcl_size_t size = viennacl::traits::size(x);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long row = 0; row < static_cast<long>(size); ++row)
+  {
+    vcl_size_t i = static_cast<vcl_size_t>(row);
+    value_type value_d = data_d[i];
+    value_type value_r = data_r[i] - data_t[i];
+
+    data_x[i] += value_d;
+    data_r[i]  = value_r;
+    data_d[i]  = alpha * value_d + beta * value_r;
+  }
+}
+
+
 } //namespace host_based
 } //namespace linalg
 } //namespace viennacl
@@ -36,6 +36,8 @@
 #include "viennacl/traits/stride.hpp"
 #include "viennacl/linalg/detail/op_applier.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/gemm.hpp"
+#include "viennacl/linalg/host_based/simd_kernels.hpp"
 #include "viennacl/linalg/prod.hpp"
 
 // Minimum Matrix size(size1*size2) for using OpenMP on matrix operations:
@@ -1132,6 +1134,12 @@ void prod_impl(const matrix_base<NumericT> & mat, bool trans,
   vcl_size_t start2 = viennacl::traits::start(result);
   vcl_size_t inc2   = viennacl::traits::stride(result);
 
+  // vectorized kernels are used whenever rows (row-major) or columns (column-major) of the matrix and the vector are contiguous in memory:
+  cpu_isa_type isa = selected_cpu_isa<value_type>(HOST_KERNEL_GEMV);
+  bool use_simd = (isa != CPU_ISA_GENERIC) && (mat.row_major() ? A_inc2 == 1 : A_inc1 == 1);
+  typename detail::simd_kernels<value_type>::dot_function  dot_kernel  = detail::simd_kernels<value_type>::dot(isa);
+  typename detail::simd_kernels<value_type>::axpy_function axpy_kernel = detail::simd_kernels<value_type>::axpy(isa);
+
   if (mat.row_major())
   {
     if (trans)
@@ -1165,8 +1173,11 @@ void prod_impl(const matrix_base<NumericT> & mat, bool trans,
         for (vcl_size_t row = 0; row < (end - begin); ++row)  //run through matrix sequentially
         {
           value_type temp = wrapper_vec(row);
-          for (vcl_size_t col = 0; col < A_size2; ++col)
-            temp_array[A_size2 * id + col] += wrapper_mat(row , col) * temp;
+          if (use_simd)
+            axpy_kernel(temp, &wrapper_mat(row, vcl_size_t(0)), &(temp_array[A_size2 * id]), A_size2);
+          else
+            for (vcl_size_t col = 0; col < A_size2; ++col)
+              temp_array[A_size2 * id + col] += wrapper_mat(row , col) * temp;
         }
       }
       for (vcl_size_t id = 0; id < thread_count; ++id)
@@ -1182,8 +1193,11 @@ void prod_impl(const matrix_base<NumericT> & mat, bool trans,
       for (long row = 0; row < static_cast<long>(A_size1); ++row)
       {
         value_type temp = 0;
-        for (vcl_size_t col = 0; col < A_size2; ++col)
-          temp += data_A[viennacl::row_major::mem_index(static_cast<vcl_size_t>(row) * A_inc1 + A_start1, col * A_inc2 + A_start2, A_internal_size1, A_internal_size2)] * data_x[col * inc1 + start1];
+        if (use_simd && inc1 == 1)
+          temp = dot_kernel(data_A + viennacl::row_major::mem_index(static_cast<vcl_size_t>(row) * A_inc1 + A_start1, A_start2, A_internal_size1, A_internal_size2), data_x + start1, A_size2);
+        else
+          for (vcl_size_t col = 0; col < A_size2; ++col)
+            temp += data_A[viennacl::row_major::mem_index(static_cast<vcl_size_t>(row) * A_inc1 + A_start1, col * A_inc2 + A_start2, A_internal_size1, A_internal_size2)] * data_x[col * inc1 + start1];
 
         data_result[static_cast<vcl_size_t>(row) * inc2 + start2] = temp;
       }
@@ -1222,8 +1236,11 @@ void prod_impl(const matrix_base<NumericT> & mat, bool trans,
         for (vcl_size_t col = 0; col < (end - begin); ++col)  //run through matrix sequentially
         {
           value_type temp = wrapper_vec(col);
-          for (vcl_size_t row = 0; row < A_size1; ++row)
-            temp_array[A_size1 * id + row] += wrapper_mat(row , col) * temp;
+          if (use_simd)
+            axpy_kernel(temp, &wrapper_mat(vcl_size_t(0), col), &(temp_array[A_size1 * id]), A_size1);
+          else
+            for (vcl_size_t row = 0; row < A_size1; ++row)
+              temp_array[A_size1 * id + row] += wrapper_mat(row , col) * temp;
         }
       }
       for (vcl_size_t id = 0; id < thread_count; ++id)
@@ -1238,8 +1255,11 @@ void prod_impl(const matrix_base<NumericT> & mat, bool trans,
       for (long row = 0; row < static_cast<long>(A_size2); ++row)
       {
         value_type temp = 0;
-        for (vcl_size_t col = 0; col < A_size1; ++col)
-          temp += data_A[viennacl::column_major::mem_index(col * A_inc1 + A_start1, static_cast<vcl_size_t>(row) * A_inc2 + A_start2, A_internal_size1, A_internal_size2)] * data_x[col * inc1 + start1];
+        if (use_simd && inc1 == 1)
+          temp = dot_kernel(data_A + viennacl::column_major::mem_index(A_start1, static_cast<vcl_size_t>(row) * A_inc2 + A_start2, A_internal_size1, A_internal_size2), data_x + start1, A_size1);
+        else
+          for (vcl_size_t col = 0; col < A_size1; ++col)
+            temp += data_A[viennacl::column_major::mem_index(col * A_inc1 + A_start1, static_cast<vcl_size_t>(row) * A_inc2 + A_start2, A_internal_size1, A_internal_size2)] * data_x[col * inc1 + start1];
 
         data_result[static_cast<vcl_size_t>(row) * inc2 + start2] = temp;
       }
@@ -1260,89 +1280,7 @@ namespace detail
             vcl_size_t C_size1, vcl_size_t C_size2, vcl_size_t A_size2,
             NumericT alpha, NumericT beta)
   {
-    if (C_size1 == 0 || C_size2 == 0 || A_size2 == 0)
-      return;
-
-    static const vcl_size_t blocksize = 64;
-
-    vcl_size_t num_blocks_C1 = (C_size1 - 1) / blocksize + 1;
-    vcl_size_t num_blocks_C2 = (C_size2 - 1) / blocksize + 1;
-    vcl_size_t num_blocks_A2 = (A_size2 - 1) / blocksize + 1;
-
-    //
-    // outer loop pair: Run over all blocks with indices (block_idx_i, block_idx_j) of the result matrix C:
-    //
-#ifdef VIENNACL_WITH_OPENMP
-    #pragma omp parallel for if ((C_size1*C_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-#endif
-    for (long block_idx_i2=0; block_idx_i2<static_cast<long>(num_blocks_C1); ++block_idx_i2)
-    {
-      // thread-local auxiliary buffers
-      std::vector<NumericT> buffer_A(blocksize * blocksize); // row-major
-      std::vector<NumericT> buffer_B(blocksize * blocksize); // column-major
-      std::vector<NumericT> buffer_C(blocksize * blocksize); // row-major
-
-      vcl_size_t block_idx_i = static_cast<vcl_size_t>(block_idx_i2);
-      for (vcl_size_t block_idx_j=0; block_idx_j<num_blocks_C2; ++block_idx_j)
-      {
-        // Reset block matrix:
-        std::fill(buffer_C.begin(), buffer_C.end(), NumericT(0));
-
-        vcl_size_t offset_i = block_idx_i*blocksize;
-        vcl_size_t offset_j = block_idx_j*blocksize;
-
-        //  C(block_idx_i, block_idx_i) += A(block_idx_i, block_idx_k) * B(block_idx_k, block_idx_j)
-        for (vcl_size_t block_idx_k=0; block_idx_k<num_blocks_A2; ++block_idx_k)
-        {
-          // flush buffers:
-          std::fill(buffer_A.begin(), buffer_A.end(), NumericT(0));
-          std::fill(buffer_B.begin(), buffer_B.end(), NumericT(0));
-
-          vcl_size_t offset_k = block_idx_k*blocksize;
-
-          // load current data:
-          for (vcl_size_t i = offset_i; i < std::min(offset_i + blocksize, C_size1); ++i)
-            for (vcl_size_t k = offset_k; k < std::min(offset_k + blocksize, A_size2); ++k)
-              buffer_A[(i - offset_i) * blocksize + (k - offset_k)] = A(i, k);
-
-          for (vcl_size_t j = offset_j; j < std::min(offset_j + blocksize, C_size2); ++j)
-            for (vcl_size_t k = offset_k; k < std::min(offset_k + blocksize, A_size2); ++k)
-              buffer_B[(k - offset_k) + (j - offset_j) * blocksize] = B(k, j);
-
-          // multiply (this is the hot spot in terms of flops)
-          for (vcl_size_t i = 0; i < blocksize; ++i)
-          {
-            NumericT const * ptrA = &(buffer_A[i*blocksize]);
-            for (vcl_size_t j = 0; j < blocksize; ++j)
-            {
-              NumericT const * ptrB = &(buffer_B[j*blocksize]);
-
-              NumericT temp = NumericT(0);
-              for (vcl_size_t k = 0; k < blocksize; ++k)
-                temp += ptrA[k] * ptrB[k];  // buffer_A[i*blocksize + k] * buffer_B[k + j*blocksize];
-
-              buffer_C[i*blocksize + j] += temp;
-            }
-          }
-        }
-
-        // write result:
-        if (beta > 0 || beta < 0)
-        {
-          for (vcl_size_t i = offset_i; i < std::min(offset_i + blocksize, C_size1); ++i)
-            for (vcl_size_t j = offset_j; j < std::min(offset_j + blocksize, C_size2); ++j)
-              C(i,j) = beta * C(i,j) + alpha * buffer_C[(i - offset_i) * blocksize + (j - offset_j)];
-        }
-        else
-        {
-          for (vcl_size_t i = offset_i; i < std::min(offset_i + blocksize, C_size1); ++i)
-            for (vcl_size_t j = offset_j; j < std::min(offset_j + blocksize, C_size2); ++j)
-              C(i,j) =                 alpha * buffer_C[(i - offset_i) * blocksize + (j - offset_j)];
-        }
-
-      } // for block j
-    } // for block i
-
+    gemm_dispatch(A, B, C, C_size1, C_size2, A_size2, alpha, beta);
   } // prod()
 
 } // namespace detail
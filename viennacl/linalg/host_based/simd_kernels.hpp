@@ -0,0 +1,372 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SIMD_KERNELS_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SIMD_KERNELS_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/simd_kernels.hpp
+    @brief Vectorized building blocks (dot products, axpy, sparse row products) for the host backend. Variants are selected at runtime, cf. cpu_dispatch.hpp
+*/
+
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+
+//
+// Generic implementations
+//
+
+/** @brief Computes the inner product of two contiguous arrays of length n */
+template<typename NumericT>
+NumericT simd_dot_generic(NumericT const * x, NumericT const * y, vcl_size_t n)
+{
+  NumericT temp = 0;
+  for (vcl_size_t i = 0; i < n; ++i)
+    temp += x[i] * y[i];
+  return temp;
+}
+
+/** @brief Computes y += alpha * x for two contiguous arrays of length n */
+template<typename NumericT>
+void simd_axpy_generic(NumericT alpha, NumericT const * x, NumericT * y, vcl_size_t n)
+{
+  for (vcl_size_t i = 0; i < n; ++i)
+    y[i] += alpha * x[i];
+}
+
+/** @brief Computes the inner product of a sparse row (values and column indices) with a dense vector */
+template<typename NumericT>
+NumericT simd_sparse_dot_generic(NumericT const * values, unsigned int const * indices, NumericT const * x, vcl_size_t n)
+{
+  NumericT temp = 0;
+  for (vcl_size_t i = 0; i < n; ++i)
+    temp += values[i] * x[indices[i]];
+  return temp;
+}
+
+
+#ifdef VIENNACL_HOST_AVX2_KERNELS
+
+//
+// AVX2/FMA implementations. Note: Gathers use signed 32-bit offsets, hence column indices need to be smaller than 2^31.
+//
+
+inline VIENNACL_HOST_TARGET_AVX2 double simd_hsum_avx2(__m256d v)
+{
+  __m128d lo = _mm256_castpd256_pd128(v);
+  __m128d hi = _mm256_extractf128_pd(v, 1);
+  lo = _mm_add_pd(lo, hi);
+  return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+inline VIENNACL_HOST_TARGET_AVX2 float simd_hsum_avx2(__m256 v)
+{
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_add_ps(lo, hi);
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  return _mm_cvtss_f32(_mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 1)));
+}
+
+inline VIENNACL_HOST_TARGET_AVX2 double simd_dot_avx2(double const * x, double const * y, vcl_size_t n)
+{
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+  vcl_size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i),      _mm256_loadu_pd(y + i),      acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4),  _mm256_loadu_pd(y + i + 4),  acc1);
+    acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8),  _mm256_loadu_pd(y + i + 8),  acc2);
+    acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), acc3);
+  }
+  for (; i + 4 <= n; i += 4)
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+
+  double temp = simd_hsum_avx2(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+  for (; i < n; ++i)
+    temp += x[i] * y[i];
+  return temp;
+}
+
+inline VIENNACL_HOST_TARGET_AVX2 float simd_dot_avx2(float const * x, float const * y, vcl_size_t n)
+{
+  __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+  vcl_size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i),      _mm256_loadu_ps(y + i),      acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8),  _mm256_loadu_ps(y + i + 8),  acc1);
+    acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16), acc2);
+    acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24), acc3);
+  }
+  for (; i + 8 <= n; i += 8)
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+
+  float temp = simd_hsum_avx2(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+  for (; i < n; ++i)
+    temp += x[i] * y[i];
+  return temp;
+}
+
+inline VIENNACL_HOST_TARGET_AVX2 void simd_axpy_avx2(double alpha, double const * x, double * y, vcl_size_t n)
+{
+  __m256d a = _mm256_set1_pd(alpha);
+  vcl_size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+  for (; i < n; ++i)
+    y[i] += alpha * x[i];
+}
+
+inline VIENNACL_HOST_TARGET_AVX2 void simd_axpy_avx2(float alpha, float const * x, float * y, vcl_size_t n)
+{
+  __m256 a = _mm256_set1_ps(alpha);
+  vcl_size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(y + i, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+  for (; i < n; ++i)
+    y[i] += alpha * x[i];
+}
+
+inline VIENNACL_HOST_TARGET_AVX2 double simd_sparse_dot_avx2(double const * values, unsigned int const * indices, double const * x, vcl_size_t n)
+{
+  __m256d acc = _mm256_setzero_pd();
+  __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+  vcl_size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m128i idx = _mm_loadu_si128(reinterpret_cast<__m128i const *>(indices + i));
+    acc = _mm256_fmadd_pd(_mm256_loadu_pd(values + i), _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx, all_lanes, 8), acc);
+  }
+  double temp = simd_hsum_avx2(acc);
+  for (; i < n; ++i)
+    temp += values[i] * x[indices[i]];
+  return temp;
+}
+
+inline VIENNACL_HOST_TARGET_AVX2 float simd_sparse_dot_avx2(float const * values, unsigned int const * indices, float const * x, vcl_size_t n)
+{
+  __m256 acc = _mm256_setzero_ps();
+  __m256 all_lanes = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+  vcl_size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(indices + i));
+    acc = _mm256_fmadd_ps(_mm256_loadu_ps(values + i), _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, idx, all_lanes, 4), acc);
+  }
+  float temp = simd_hsum_avx2(acc);
+  for (; i < n; ++i)
+    temp += values[i] * x[indices[i]];
+  return temp;
+}
+
+#endif
+
+
+#ifdef VIENNACL_HOST_AVX512_KERNELS
+
+//
+// AVX-512 implementations
+//
+
+// The unmasked gathers and extracts (and thus _mm512_reduce_add_*) start from an undefined register, which GCC 12 reports as uninitialized.
+// The masked variants with an explicit zero source avoid this at no cost.
+inline VIENNACL_HOST_TARGET_AVX512 double simd_hsum_avx512(__m512d v)
+{
+  __m256d lo = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, v, 0);
+  __m256d hi = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, v, 1);
+  return simd_hsum_avx2(_mm256_add_pd(lo, hi));
+}
+
+inline VIENNACL_HOST_TARGET_AVX512 float simd_hsum_avx512(__m512 v)
+{
+  __m256d lo = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, _mm512_castps_pd(v), 0);
+  __m256d hi = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, _mm512_castps_pd(v), 1);
+  return simd_hsum_avx2(_mm256_add_ps(_mm256_castpd_ps(lo), _mm256_castpd_ps(hi)));
+}
+
+inline VIENNACL_HOST_TARGET_AVX512 double simd_dot_avx512(double const * x, double const * y, vcl_size_t n)
+{
+  __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd(), acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+  vcl_size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i),      _mm512_loadu_pd(y + i),      acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8),  _mm512_loadu_pd(y + i + 8),  acc1);
+    acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), acc2);
+    acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), acc3);
+  }
+  for (; i + 8 <= n; i += 8)
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc0);
+
+  double temp = simd_hsum_avx512(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+  for (; i < n; ++i)
+    temp += x[i] * y[i];
+  return temp;
+}
+
+inline VIENNACL_HOST_TARGET_AVX512 float simd_dot_avx512(float const * x, float const * y, vcl_size_t n)
+{
+  __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+  vcl_size_t i = 0;
+  for (; i + 64 <= n; i += 64)
+  {
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i),      _mm512_loadu_ps(y + i),      acc0);
+    acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), acc1);
+    acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y + i + 32), acc2);
+    acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y + i + 48), acc3);
+  }
+  for (; i + 16 <= n; i += 16)
+    acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc0);
+
+  float temp = simd_hsum_avx512(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+  for (; i < n; ++i)
+    temp += x[i] * y[i];
+  return temp;
+}
+
+inline VIENNACL_HOST_TARGET_AVX512 void simd_axpy_avx512(double alpha, double const * x, double * y, vcl_size_t n)
+{
+  __m512d a = _mm512_set1_pd(alpha);
+  vcl_size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+  for (; i < n; ++i)
+    y[i] += alpha * x[i];
+}
+
+inline VIENNACL_HOST_TARGET_AVX512 void simd_axpy_avx512(float alpha, float const * x, float * y, vcl_size_t n)
+{
+  __m512 a = _mm512_set1_ps(alpha);
+  vcl_size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(y + i, _mm512_fmadd_ps(a, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+  for (; i < n; ++i)
+    y[i] += alpha * x[i];
+}
+
+inline VIENNACL_HOST_TARGET_AVX512 double simd_sparse_dot_avx512(double const * values, unsigned int const * indices, double const * x, vcl_size_t n)
+{
+  __m512d acc = _mm512_setzero_pd();
+  vcl_size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(indices + i));
+    acc = _mm512_fmadd_pd(_mm512_loadu_pd(values + i), _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, idx, x, 8), acc);
+  }
+  double temp = simd_hsum_avx512(acc);
+  for (; i < n; ++i)
+    temp += values[i] * x[indices[i]];
+  return temp;
+}
+
+inline VIENNACL_HOST_TARGET_AVX512 float simd_sparse_dot_avx512(float const * values, unsigned int const * indices, float const * x, vcl_size_t n)
+{
+  __m512 acc = _mm512_setzero_ps();
+  vcl_size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    __m512i idx = _mm512_loadu_si512(reinterpret_cast<void const *>(indices + i));
+    acc = _mm512_fmadd_ps(_mm512_loadu_ps(values + i), _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, idx, x, 4), acc);
+  }
+  float temp = simd_hsum_avx512(acc);
+  for (; i < n; ++i)
+    temp += values[i] * x[indices[i]];
+  return temp;
+}
+
+#endif
+
+
+/** @brief Provides function pointers to the kernel variants for a given numeric type and instruction set level. The generic implementation is used for all types other than float and double. */
+template<typename NumericT>
+struct simd_kernels
+{
+  typedef NumericT (*dot_function)(NumericT const *, NumericT const *, vcl_size_t);
+  typedef void     (*axpy_function)(NumericT, NumericT const *, NumericT *, vcl_size_t);
+  typedef NumericT (*sparse_dot_function)(NumericT const *, unsigned int const *, NumericT const *, vcl_size_t);
+
+  static dot_function        dot(cpu_isa_type)        { return &simd_dot_generic<NumericT>; }
+  static axpy_function       axpy(cpu_isa_type)       { return &simd_axpy_generic<NumericT>; }
+  static sparse_dot_function sparse_dot(cpu_isa_type) { return &simd_sparse_dot_generic<NumericT>; }
+};
+
+/** @brief Kernel selection for float and double, for which vectorized variants are available. */
+template<typename NumericT>
+struct simd_kernels_floating_point
+{
+  typedef NumericT (*dot_function)(NumericT const *, NumericT const *, vcl_size_t);
+  typedef void     (*axpy_function)(NumericT, NumericT const *, NumericT *, vcl_size_t);
+  typedef NumericT (*sparse_dot_function)(NumericT const *, unsigned int const *, NumericT const *, vcl_size_t);
+
+  static dot_function dot(cpu_isa_type isa)
+  {
+    (void)isa;
+#ifdef VIENNACL_HOST_AVX512_KERNELS
+    if (isa == CPU_ISA_AVX512) return &simd_dot_avx512;
+#endif
+#ifdef VIENNACL_HOST_AVX2_KERNELS
+    if (isa == CPU_ISA_AVX2)   return &simd_dot_avx2;
+#endif
+    return &simd_dot_generic<NumericT>;
+  }
+
+  static axpy_function axpy(cpu_isa_type isa)
+  {
+    (void)isa;
+#ifdef VIENNACL_HOST_AVX512_KERNELS
+    if (isa == CPU_ISA_AVX512) return &simd_axpy_avx512;
+#endif
+#ifdef VIENNACL_HOST_AVX2_KERNELS
+    if (isa == CPU_ISA_AVX2)   return &simd_axpy_avx2;
+#endif
+    return &simd_axpy_generic<NumericT>;
+  }
+
+  static sparse_dot_function sparse_dot(cpu_isa_type isa)
+  {
+    (void)isa;
+#ifdef VIENNACL_HOST_AVX512_KERNELS
+    if (isa == CPU_ISA_AVX512) return &simd_sparse_dot_avx512;
+#endif
+#ifdef VIENNACL_HOST_AVX2_KERNELS
+    if (isa == CPU_ISA_AVX2)   return &simd_sparse_dot_avx2;
+#endif
+    return &simd_sparse_dot_generic<NumericT>;
+  }
+};
+
+/** \cond */
+template<> struct simd_kernels<float>  : public simd_kernels_floating_point<float>  {};
+template<> struct simd_kernels<double> : public simd_kernels_floating_point<double> {};
+/** \endcond */
+
+} //namespace detail
+} //namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
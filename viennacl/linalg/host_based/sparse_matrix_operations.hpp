@@ -28,8 +28,14 @@
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
 #include "viennacl/linalg/host_based/vector_operations.hpp"
+#include "viennacl/linalg/host_based/simd_kernels.hpp"
 
 #include "viennacl/linalg/host_based/spgemm_vector.hpp"
+#include "viennacl/linalg/host_based/spgemm_row_kernels.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_factor.hpp"
+#include "viennacl/linalg/host_based/spmv_merge_path.hpp"
+#include "viennacl/linalg/host_based/spmv_symmetric.hpp"
+#include "viennacl/linalg/host_based/spmm_tall_skinny.hpp"
 
 #include <vector>
 
@@ -102,6 +108,7 @@ namespace detail
 /** @brief Carries out matrix-vector multiplication with a compressed_matrix, optimized for contiguous access
 *
 * Implementation of the convenience expression result = prod(mat, vec);
+* Matrices with irregular row lengths are processed by the merge-path kernel, cf. set_csr_spmv_kernel().
 *
 * @param mat    The matrix
 * @param vec    The vector
@@ -118,6 +125,29 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
   unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
   unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
 
+  cpu_isa_type isa = selected_cpu_isa<NumericT>(HOST_KERNEL_CSR_SPMV);
+  if (detail::csr_spmv_use_merge_path(row_buffer, mat.size1()))
+  {
+    detail::csr_spmv_merge_path(row_buffer, col_buffer, elements, mat.size1(), vec_buf, 1, result_buf, 1, NumericT(1), NumericT(0),
+                                detail::simd_kernels<NumericT>::sparse_dot(isa));
+    return;
+  }
+
+  if (isa != CPU_ISA_GENERIC)
+  {
+    typename detail::simd_kernels<NumericT>::sparse_dot_function row_kernel = detail::simd_kernels<NumericT>::sparse_dot(isa);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for
+#endif
+    for (long row = 0; row < static_cast<long>(mat.size1()); ++row)
+    {
+      unsigned int row_start = row_buffer[row];
+      result_buf[row] = row_kernel(elements + row_start, col_buffer + row_start, vec_buf, row_buffer[row+1] - row_start);
+    }
+    return;
+  }
+
 #ifdef VIENNACL_WITH_OPENMP
   #pragma omp parallel for
 #endif
@@ -152,7 +182,7 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
   if (   alpha <= NumericT(1) && alpha >= NumericT(1)
       &&  beta <= NumericT(0) &&  beta >= NumericT(0)
       && vec.start() == 0 && vec.stride() == 1
-      && result.start() == 0 && result.stride() == 0)
+      && result.start() == 0 && result.stride() == 1)
   {
     prod_impl(mat, vec, result);
     return;
@@ -164,6 +194,18 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
   unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
   unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
 
+  cpu_isa_type isa = selected_cpu_isa<NumericT>(HOST_KERNEL_CSR_SPMV);
+  bool use_simd = (isa != CPU_ISA_GENERIC) && vec.stride() == 1;
+  typename detail::simd_kernels<NumericT>::sparse_dot_function row_kernel = detail::simd_kernels<NumericT>::sparse_dot(isa);
+
+  if (detail::csr_spmv_use_merge_path(row_buffer, mat.size1()))
+  {
+    detail::csr_spmv_merge_path(row_buffer, col_buffer, elements, mat.size1(),
+                                vec_buf + vec.start(), vec.stride(), result_buf + result.start(), result.stride(), alpha, beta,
+                                row_kernel);
+    return;
+  }
+
 #ifdef VIENNACL_WITH_OPENMP
   #pragma omp parallel for
 #endif
@@ -171,8 +213,11 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
   {
     NumericT dot_prod = 0;
     vcl_size_t row_end = row_buffer[row+1];
-    for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
-      dot_prod += elements[i] * vec_buf[col_buffer[i] * vec.stride() + vec.start()];
+    if (use_simd)
+      dot_prod = row_kernel(elements + row_buffer[row], col_buffer + row_buffer[row], vec_buf + vec.start(), row_end - row_buffer[row]);
+    else
+      for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
+        dot_prod += elements[i] * vec_buf[col_buffer[i] * vec.stride() + vec.start()];
 
     if (beta < 0 || beta > 0)
     {
@@ -230,23 +275,11 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & sp_mat,
       result_wrapper_col(result_data, result_start1, result_start2, result_inc1, result_inc2, result_internal_size1, result_internal_size2);
 
   if ( d_mat.row_major() ) {
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (long row = 0; row < static_cast<long>(sp_mat.size1()); ++row) {
-      vcl_size_t row_start = sp_mat_row_buffer[row];
-      vcl_size_t row_end = sp_mat_row_buffer[row+1];
-      for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
-        NumericT temp = 0;
-        for (vcl_size_t k = row_start; k < row_end; ++k) {
-          temp += sp_mat_elements[k] * d_mat_wrapper_row(static_cast<vcl_size_t>(sp_mat_col_buffer[k]), col);
-        }
-        if (result.row_major())
-          result_wrapper_row(row, col) = temp;
-        else
-          result_wrapper_col(row, col) = temp;
-      }
-    }
+    // each row of sp_mat is read once per block of up to 16 columns of d_mat:
+    detail::spmm_tall_skinny(detail::csr_spmm_tall_skinny_kernel<NumericT>(sp_mat_row_buffer, sp_mat_col_buffer, sp_mat_elements, sp_mat.size1()),
+                             detail::make_dense_strided_view<NumericT const>(d_mat),
+                             detail::make_dense_strided_view<NumericT>(result),
+                             d_mat.size2());
   }
   else {
 #ifdef VIENNACL_WITH_OPENMP
@@ -337,193 +370,500 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & sp_mat,
     }
   }
   else {
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (long col = 0; col < static_cast<long>(d_mat.size2()); ++col) {
-      for (vcl_size_t row = 0; row < sp_mat.size1(); ++row) {
-        vcl_size_t row_start = sp_mat_row_buffer[row];
-        vcl_size_t row_end = sp_mat_row_buffer[row+1];
-        NumericT temp = 0;
-        for (vcl_size_t k = row_start; k < row_end; ++k) {
-          temp += sp_mat_elements[k] * d_mat_wrapper_col(col, static_cast<vcl_size_t>(sp_mat_col_buffer[k]));
-        }
-        if (result.row_major())
-          result_wrapper_row(row, col) = temp;
-        else
-          result_wrapper_col(row, col) = temp;
-      }
-    }
+    // the rows of trans(d_mat) are adjacent in memory, hence each row of sp_mat is read once per block of up to 16 columns of trans(d_mat):
+    detail::spmm_tall_skinny(detail::csr_spmm_tall_skinny_kernel<NumericT>(sp_mat_row_buffer, sp_mat_col_buffer, sp_mat_elements, sp_mat.size1()),
+                             detail::make_transposed_dense_strided_view<NumericT const>(d_mat.lhs()),
+                             detail::make_dense_strided_view<NumericT>(result),
+                             d_mat.size2());
   }
 
 }
 
 
-/** @brief Carries out sparse_matrix-sparse_matrix multiplication for CSR matrices
-*
-* Implementation of the convenience expression C = prod(A, B);
-* Based on computing C(i, :) = A(i, :) * B via merging the respective rows of B
-*
-* @param A     Left factor
-* @param B     Right factor
-* @param C     Result matrix
-*/
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
-               viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
-               viennacl::compressed_matrix<NumericT, AlignmentV> & C)
+namespace detail
 {
+  /** @brief Sparse matrix-matrix product for CSR matrices computing C(i, :) = A(i, :) * B via merging the respective rows of B. The work buffers are sized to the longest row of C. */
+  template<typename NumericT, unsigned int AlignmentV>
+  void prod_merge(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                  viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                  viennacl::compressed_matrix<NumericT, AlignmentV> & C)
+  {
 
-  NumericT     const * A_elements   = detail::extract_raw_pointer<NumericT>(A.handle());
-  unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
-  unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
-
-  NumericT     const * B_elements   = detail::extract_raw_pointer<NumericT>(B.handle());
-  unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
-  unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
+    NumericT     const * A_elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+    unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
 
-  C.resize(A.size1(), B.size2(), false);
-  unsigned int * C_row_buffer = detail::extract_raw_pointer<unsigned int>(C.handle1());
+    NumericT     const * B_elements   = detail::extract_raw_pointer<NumericT>(B.handle());
+    unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
+    unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
 
-#if defined(VIENNACL_WITH_OPENMP)
-  unsigned int block_factor = 10;
-  unsigned int max_threads = omp_get_max_threads();
-  long chunk_size = long(A.size1()) / long(block_factor * max_threads) + 1;
-#else
-  unsigned int max_threads = 1;
-#endif
-  std::vector<unsigned int> max_length_row_C(max_threads);
-  std::vector<unsigned int *> row_C_temp_index_buffers(max_threads);
-  std::vector<NumericT *>     row_C_temp_value_buffers(max_threads);
+    C.resize(A.size1(), B.size2(), false);
+    unsigned int * C_row_buffer = detail::extract_raw_pointer<unsigned int>(C.handle1());
 
+  #if defined(VIENNACL_WITH_OPENMP)
+    unsigned int block_factor = 10;
+    unsigned int max_threads = omp_get_max_threads();
+    long chunk_size = long(A.size1()) / long(block_factor * max_threads) + 1;
+  #else
+    unsigned int max_threads = 1;
+  #endif
+    std::vector<unsigned int> max_length_row_C(max_threads);
+    std::vector<unsigned int *> row_C_temp_index_buffers(max_threads);
+    std::vector<NumericT *>     row_C_temp_value_buffers(max_threads);
 
-  /*
-   * Stage 1: Determine maximum length of work buffers:
-   */
 
-#if defined(VIENNACL_WITH_OPENMP)
-  #pragma omp parallel for schedule(dynamic, chunk_size)
-#endif
-  for (long i=0; i<long(A.size1()); ++i)
-  {
-    unsigned int row_start_A = A_row_buffer[i];
-    unsigned int row_end_A   = A_row_buffer[i+1];
+    /*
+     * Stage 1: Determine maximum length of work buffers:
+     */
 
-    unsigned int row_C_upper_bound_row = 0;
-    for (unsigned int j = row_start_A; j<row_end_A; ++j)
+  #if defined(VIENNACL_WITH_OPENMP)
+    #pragma omp parallel for schedule(dynamic, chunk_size)
+  #endif
+    for (long i=0; i<long(A.size1()); ++i)
     {
-      unsigned int row_B = A_col_buffer[j];
+      unsigned int row_start_A = A_row_buffer[i];
+      unsigned int row_end_A   = A_row_buffer[i+1];
 
-      unsigned int entries_in_row = B_row_buffer[row_B+1] - B_row_buffer[row_B];
-      row_C_upper_bound_row += entries_in_row;
+      unsigned int row_C_upper_bound_row = 0;
+      for (unsigned int j = row_start_A; j<row_end_A; ++j)
+      {
+        unsigned int row_B = A_col_buffer[j];
+
+        unsigned int entries_in_row = B_row_buffer[row_B+1] - B_row_buffer[row_B];
+        row_C_upper_bound_row += entries_in_row;
+      }
+
+  #ifdef VIENNACL_WITH_OPENMP
+      unsigned int thread_id = omp_get_thread_num();
+  #else
+      unsigned int thread_id = 0;
+  #endif
+
+      max_length_row_C[thread_id] = std::max(max_length_row_C[thread_id], std::min(row_C_upper_bound_row, static_cast<unsigned int>(B.size2())));
     }
 
-#ifdef VIENNACL_WITH_OPENMP
-    unsigned int thread_id = omp_get_thread_num();
-#else
-    unsigned int thread_id = 0;
-#endif
+    // determine global maximum row length
+    for (std::size_t i=1; i<max_length_row_C.size(); ++i)
+      max_length_row_C[0] = std::max(max_length_row_C[0], max_length_row_C[i]);
 
-    max_length_row_C[thread_id] = std::max(max_length_row_C[thread_id], std::min(row_C_upper_bound_row, static_cast<unsigned int>(B.size2())));
-  }
+    // allocate work vectors:
+    for (unsigned int i=0; i<max_threads; ++i)
+      row_C_temp_index_buffers[i] = (unsigned int *)malloc(sizeof(unsigned int)*3*max_length_row_C[0]);
+
+
+    /*
+     * Stage 2: Determine sparsity pattern of C
+     */
+
+  #ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for schedule(dynamic, chunk_size)
+  #endif
+    for (long i=0; i<long(A.size1()); ++i)
+    {
+      unsigned int thread_id = 0;
+    #ifdef VIENNACL_WITH_OPENMP
+      thread_id = omp_get_thread_num();
+    #endif
+      unsigned int buffer_len = max_length_row_C[0];
+
+      unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
+      unsigned int *row_C_vector_2 = row_C_vector_1 + buffer_len;
+      unsigned int *row_C_vector_3 = row_C_vector_2 + buffer_len;
+
+      unsigned int row_start_A = A_row_buffer[i];
+      unsigned int row_end_A   = A_row_buffer[i+1];
+
+      C_row_buffer[i] = row_C_scan_symbolic_vector(row_start_A, row_end_A, A_col_buffer,
+                                                   B_row_buffer, B_col_buffer, static_cast<unsigned int>(B.size2()),
+                                                   row_C_vector_1, row_C_vector_2, row_C_vector_3);
+    }
 
-  // determine global maximum row length
-  for (std::size_t i=1; i<max_length_row_C.size(); ++i)
-    max_length_row_C[0] = std::max(max_length_row_C[0], max_length_row_C[i]);
+    // exclusive scan to obtain row start indices:
+    unsigned int current_offset = 0;
+    for (std::size_t i=0; i<C.size1(); ++i)
+    {
+      unsigned int tmp = C_row_buffer[i];
+      C_row_buffer[i] = current_offset;
+      current_offset += tmp;
+    }
+    C_row_buffer[C.size1()] = current_offset;
+    C.reserve(current_offset, false);
 
-  // allocate work vectors:
-  for (unsigned int i=0; i<max_threads; ++i)
-    row_C_temp_index_buffers[i] = (unsigned int *)malloc(sizeof(unsigned int)*3*max_length_row_C[0]);
+    // allocate work vectors:
+    for (unsigned int i=0; i<max_threads; ++i)
+      row_C_temp_value_buffers[i] = (NumericT *)malloc(sizeof(NumericT)*3*max_length_row_C[0]);
 
+    /*
+     * Stage 3: Compute product (code similar, maybe pull out into a separate function to avoid code duplication?)
+     */
+    NumericT     * C_elements   = detail::extract_raw_pointer<NumericT>(C.handle());
+    unsigned int * C_col_buffer = detail::extract_raw_pointer<unsigned int>(C.handle2());
 
-  /*
-   * Stage 2: Determine sparsity pattern of C
-   */
+  #ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for schedule(dynamic, chunk_size)
+  #endif
+    for (long i = 0; i < long(A.size1()); ++i)
+    {
+      unsigned int row_start_A  = A_row_buffer[i];
+      unsigned int row_end_A    = A_row_buffer[i+1];
+
+      unsigned int row_C_buffer_start = C_row_buffer[i];
+      unsigned int row_C_buffer_end   = C_row_buffer[i+1];
 
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for schedule(dynamic, chunk_size)
-#endif
-  for (long i=0; i<long(A.size1()); ++i)
-  {
-    unsigned int thread_id = 0;
   #ifdef VIENNACL_WITH_OPENMP
-    thread_id = omp_get_thread_num();
+      unsigned int thread_id = omp_get_thread_num();
+  #else
+      unsigned int thread_id = 0;
   #endif
-    unsigned int buffer_len = max_length_row_C[0];
 
-    unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
-    unsigned int *row_C_vector_2 = row_C_vector_1 + buffer_len;
-    unsigned int *row_C_vector_3 = row_C_vector_2 + buffer_len;
+      unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
+      unsigned int *row_C_vector_2 = row_C_vector_1 + max_length_row_C[0];
+      unsigned int *row_C_vector_3 = row_C_vector_2 + max_length_row_C[0];
 
-    unsigned int row_start_A = A_row_buffer[i];
-    unsigned int row_end_A   = A_row_buffer[i+1];
+      NumericT *row_C_vector_1_values = row_C_temp_value_buffers[thread_id];
+      NumericT *row_C_vector_2_values = row_C_vector_1_values + max_length_row_C[0];
+      NumericT *row_C_vector_3_values = row_C_vector_2_values + max_length_row_C[0];
 
-    C_row_buffer[i] = row_C_scan_symbolic_vector(row_start_A, row_end_A, A_col_buffer,
-                                                 B_row_buffer, B_col_buffer, static_cast<unsigned int>(B.size2()),
-                                                 row_C_vector_1, row_C_vector_2, row_C_vector_3);
-  }
+      row_C_scan_numeric_vector(row_start_A, row_end_A, A_col_buffer, A_elements,
+                                B_row_buffer, B_col_buffer, B_elements, static_cast<unsigned int>(B.size2()),
+                                row_C_buffer_start, row_C_buffer_end, C_col_buffer, C_elements,
+                                row_C_vector_1, row_C_vector_1_values,
+                                row_C_vector_2, row_C_vector_2_values,
+                                row_C_vector_3, row_C_vector_3_values);
+    }
+
+    // clean up at the end:
+    for (unsigned int i=0; i<max_threads; ++i)
+    {
+      free(row_C_temp_index_buffers[i]);
+      free(row_C_temp_value_buffers[i]);
+    }
 
-  // exclusive scan to obtain row start indices:
-  unsigned int current_offset = 0;
-  for (std::size_t i=0; i<C.size1(); ++i)
-  {
-    unsigned int tmp = C_row_buffer[i];
-    C_row_buffer[i] = current_offset;
-    current_offset += tmp;
   }
-  C_row_buffer[C.size1()] = current_offset;
-  C.reserve(current_offset, false);
 
-  // allocate work vectors:
-  for (unsigned int i=0; i<max_threads; ++i)
-    row_C_temp_value_buffers[i] = (NumericT *)malloc(sizeof(NumericT)*3*max_length_row_C[0]);
+  /** @brief Computes the offsets of the number of products per row of C = A * B and partitions the rows of C into chunks with about the same number of products. */
+  template<typename NumericT, unsigned int AlignmentV>
+  void spgemm_distribute_rows(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                              viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                              std::vector<vcl_size_t> & flop_offsets,
+                              std::vector<vcl_size_t> & chunk_starts)
+  {
+    unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+    unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
 
-  /*
-   * Stage 3: Compute product (code similar, maybe pull out into a separate function to avoid code duplication?)
-   */
-  NumericT     * C_elements   = detail::extract_raw_pointer<NumericT>(C.handle());
-  unsigned int * C_col_buffer = detail::extract_raw_pointer<unsigned int>(C.handle2());
+    flop_offsets.resize(A.size1() + 1);
+    flop_offsets[0] = 0;
 
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for schedule(dynamic, chunk_size)
+    #pragma omp parallel for
 #endif
-  for (long i = 0; i < long(A.size1()); ++i)
-  {
-    unsigned int row_start_A  = A_row_buffer[i];
-    unsigned int row_end_A    = A_row_buffer[i+1];
+    for (long i=0; i<long(A.size1()); ++i)
+    {
+      vcl_size_t row_C_upper_bound = 0;
+      for (unsigned int j = A_row_buffer[i]; j < A_row_buffer[i+1]; ++j)
+        row_C_upper_bound += B_row_buffer[A_col_buffer[j] + 1] - B_row_buffer[A_col_buffer[j]];
+      flop_offsets[static_cast<vcl_size_t>(i) + 1] = row_C_upper_bound;
+    }
 
-    unsigned int row_C_buffer_start = C_row_buffer[i];
-    unsigned int row_C_buffer_end   = C_row_buffer[i+1];
+    for (vcl_size_t i=0; i<A.size1(); ++i)
+      flop_offsets[i+1] += flop_offsets[i];
 
 #ifdef VIENNACL_WITH_OPENMP
-    unsigned int thread_id = omp_get_thread_num();
+    vcl_size_t num_chunks = 10 * static_cast<vcl_size_t>(omp_get_max_threads());
 #else
-    unsigned int thread_id = 0;
+    vcl_size_t num_chunks = 1;
+#endif
+    spgemm_flop_balanced_chunks(flop_offsets, num_chunks, chunk_starts);
+  }
+
+  /** @brief Sparse matrix-matrix product for CSR matrices with a hash, heap, or merge kernel for each row of C.
+  *
+  * The rows are distributed to threads in chunks carrying approximately the same number of products (instead of the same number of rows).
+  * Work buffers are thread-local and grow with the rows actually processed by the thread.
+  *
+  * @param kernel   SPGEMM_KERNEL_HASH or SPGEMM_KERNEL_HEAP for using the respective kernel for all rows, SPGEMM_KERNEL_AUTO for choosing the kernel per row.
+  */
+  template<typename NumericT, unsigned int AlignmentV>
+  void prod_row_wise(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                     viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                     viennacl::compressed_matrix<NumericT, AlignmentV> & C,
+                     spgemm_kernel_type kernel)
+  {
+    NumericT     const * A_elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+    unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+
+    NumericT     const * B_elements   = detail::extract_raw_pointer<NumericT>(B.handle());
+    unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
+    unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
+
+    unsigned int B_size2 = static_cast<unsigned int>(B.size2());
+
+    C.resize(A.size1(), B.size2(), false);
+    unsigned int * C_row_buffer = detail::extract_raw_pointer<unsigned int>(C.handle1());
+
+    /*
+     * Stage 1: Determine the number of products per row (upper bound for the number of nonzeros in C) and distribute the work:
+     */
+    std::vector<vcl_size_t> flop_offsets;
+    std::vector<vcl_size_t> chunk_starts;
+    spgemm_distribute_rows(A, B, flop_offsets, chunk_starts);
+    vcl_size_t num_chunks = chunk_starts.size() - 1;
+
+    /*
+     * Stage 2: Determine sparsity pattern of C
+     */
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      std::vector<unsigned int>      merge_indices;
+      std::vector<unsigned int>      table_keys;
+      std::vector<spgemm_heap_entry> heap;
+      std::vector<unsigned int>      heap_positions;
+
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp for schedule(dynamic, 1)
 #endif
+      for (long chunk = 0; chunk < long(num_chunks); ++chunk)
+      {
+        for (vcl_size_t i = chunk_starts[static_cast<vcl_size_t>(chunk)]; i < chunk_starts[static_cast<vcl_size_t>(chunk) + 1]; ++i)
+        {
+          unsigned int row_start_A = A_row_buffer[i];
+          unsigned int row_end_A   = A_row_buffer[i+1];
+          unsigned int row_C_upper_bound = static_cast<unsigned int>(std::min<vcl_size_t>(flop_offsets[i+1] - flop_offsets[i], B_size2));
+
+          spgemm_kernel_type row_kernel = (kernel == SPGEMM_KERNEL_AUTO) ? spgemm_select_row_kernel(row_end_A - row_start_A, row_C_upper_bound, B_size2) : kernel;
+          if (row_kernel == SPGEMM_KERNEL_MERGE)
+          {
+            if (merge_indices.size() < 3 * row_C_upper_bound)
+              merge_indices.resize(3 * row_C_upper_bound);
+            unsigned int *row_C_vector_1 = merge_indices.size() ? &(merge_indices[0]) : NULL;
+            C_row_buffer[i] = row_C_scan_symbolic_vector(row_start_A, row_end_A, A_col_buffer,
+                                                         B_row_buffer, B_col_buffer, B_size2,
+                                                         row_C_vector_1, row_C_vector_1 + row_C_upper_bound, row_C_vector_1 + 2 * row_C_upper_bound);
+          }
+          else if (row_kernel == SPGEMM_KERNEL_HEAP)
+            C_row_buffer[i] = row_C_heap_symbolic(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer, heap, heap_positions);
+          else
+          {
+            unsigned int table_size = row_C_hash_table_size(row_C_upper_bound, B_size2);
+            if (table_keys.size() < table_size)
+              table_keys.resize(table_size);
+            C_row_buffer[i] = row_C_hash_symbolic(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer, table_size, &(table_keys[0]));
+          }
+        }
+      }
+    }
+
+    // exclusive scan to obtain row start indices:
+    unsigned int current_offset = 0;
+    for (std::size_t i=0; i<C.size1(); ++i)
+    {
+      unsigned int tmp = C_row_buffer[i];
+      C_row_buffer[i] = current_offset;
+      current_offset += tmp;
+    }
+    C_row_buffer[C.size1()] = current_offset;
+    C.reserve(current_offset, false);
+
+    /*
+     * Stage 3: Compute product
+     */
+    NumericT     * C_elements   = detail::extract_raw_pointer<NumericT>(C.handle());
+    unsigned int * C_col_buffer = detail::extract_raw_pointer<unsigned int>(C.handle2());
 
-    unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
-    unsigned int *row_C_vector_2 = row_C_vector_1 + max_length_row_C[0];
-    unsigned int *row_C_vector_3 = row_C_vector_2 + max_length_row_C[0];
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      std::vector<unsigned int>      merge_indices;
+      std::vector<NumericT>          merge_values;
+      std::vector<unsigned int>      table_keys;
+      std::vector<NumericT>          table_values;
+      std::vector<spgemm_heap_entry> heap;
+      std::vector<unsigned int>      heap_positions;
 
-    NumericT *row_C_vector_1_values = row_C_temp_value_buffers[thread_id];
-    NumericT *row_C_vector_2_values = row_C_vector_1_values + max_length_row_C[0];
-    NumericT *row_C_vector_3_values = row_C_vector_2_values + max_length_row_C[0];
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp for schedule(dynamic, 1)
+#endif
+      for (long chunk = 0; chunk < long(num_chunks); ++chunk)
+      {
+        for (vcl_size_t i = chunk_starts[static_cast<vcl_size_t>(chunk)]; i < chunk_starts[static_cast<vcl_size_t>(chunk) + 1]; ++i)
+        {
+          unsigned int row_start_A = A_row_buffer[i];
+          unsigned int row_end_A   = A_row_buffer[i+1];
+          unsigned int row_C_upper_bound = static_cast<unsigned int>(std::min<vcl_size_t>(flop_offsets[i+1] - flop_offsets[i], B_size2));
 
-    row_C_scan_numeric_vector(row_start_A, row_end_A, A_col_buffer, A_elements,
-                              B_row_buffer, B_col_buffer, B_elements, static_cast<unsigned int>(B.size2()),
-                              row_C_buffer_start, row_C_buffer_end, C_col_buffer, C_elements,
-                              row_C_vector_1, row_C_vector_1_values,
-                              row_C_vector_2, row_C_vector_2_values,
-                              row_C_vector_3, row_C_vector_3_values);
+          spgemm_kernel_type row_kernel = (kernel == SPGEMM_KERNEL_AUTO) ? spgemm_select_row_kernel(row_end_A - row_start_A, row_C_upper_bound, B_size2) : kernel;
+          if (row_kernel == SPGEMM_KERNEL_MERGE)
+          {
+            if (merge_indices.size() < 3 * row_C_upper_bound)
+            {
+              merge_indices.resize(3 * row_C_upper_bound);
+              merge_values.resize(3 * row_C_upper_bound);
+            }
+            unsigned int *row_C_vector_1        = merge_indices.size() ? &(merge_indices[0]) : NULL;
+            NumericT     *row_C_vector_1_values = merge_values.size()  ? &(merge_values[0])  : NULL;
+            row_C_scan_numeric_vector(row_start_A, row_end_A, A_col_buffer, A_elements,
+                                      B_row_buffer, B_col_buffer, B_elements, B_size2,
+                                      C_row_buffer[i], C_row_buffer[i+1], C_col_buffer, C_elements,
+                                      row_C_vector_1,                          row_C_vector_1_values,
+                                      row_C_vector_1 +     row_C_upper_bound,  row_C_vector_1_values +     row_C_upper_bound,
+                                      row_C_vector_1 + 2 * row_C_upper_bound,  row_C_vector_1_values + 2 * row_C_upper_bound);
+          }
+          else if (row_kernel == SPGEMM_KERNEL_HEAP)
+            row_C_heap_numeric(row_start_A, row_end_A, A_col_buffer, A_elements, B_row_buffer, B_col_buffer, B_elements,
+                               heap, heap_positions,
+                               C_col_buffer + C_row_buffer[i], C_elements + C_row_buffer[i]);
+          else
+          {
+            unsigned int table_size = row_C_hash_table_size(row_C_upper_bound, B_size2);
+            if (table_keys.size() < table_size)
+            {
+              table_keys.resize(table_size);
+              table_values.resize(table_size);
+            }
+            row_C_hash_numeric(row_start_A, row_end_A, A_col_buffer, A_elements, B_row_buffer, B_col_buffer, B_elements,
+                               table_size, &(table_keys[0]), &(table_values[0]),
+                               C_col_buffer + C_row_buffer[i], C_elements + C_row_buffer[i]);
+          }
+        }
+      }
+    }
   }
+} // namespace detail
+
+/** @brief Carries out sparse_matrix-sparse_matrix multiplication for CSR matrices
+*
+* Implementation of the convenience expression C = prod(A, B);
+* The kernel is selected via set_spgemm_kernel(). By default, one of the following kernels is chosen for each row of C individually (see spgemm_select_row_kernel()):
+*   - Merge of the rows of B for short rows of C
+*   - Accumulation in a hash table for moderately long rows of C
+*   - k-way merge of the rows of B using a heap for very long rows of C
+*
+* @param A     Left factor
+* @param B     Right factor
+* @param C     Result matrix
+*/
+template<typename NumericT, unsigned int AlignmentV>
+void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+               viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+               viennacl::compressed_matrix<NumericT, AlignmentV> & C)
+{
+  if (spgemm_kernel() == SPGEMM_KERNEL_MERGE)
+    detail::prod_merge(A, B, C);
+  else
+    detail::prod_row_wise(A, B, C, spgemm_kernel());
+}
+
+/** @brief Symbolic phase of a sparse matrix-matrix product C = A * B for CSR matrices, which is to be repeated with different values but identical sparsity patterns.
+*
+* The sparsity pattern of C is only known after the full product has been computed, hence C = A * B is computed via prod_impl().
+* Afterwards, the row pointers and column indices of C as well as the distribution of the rows of C among threads are recorded in the plan.
+*
+* @param A     Left factor
+* @param B     Right factor
+* @param C     Result matrix. Holds A * B on return.
+* @param plan  The plan to be set up for subsequent calls of prod_numeric()
+*/
+template<typename NumericT, unsigned int AlignmentV>
+void prod_symbolic(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                   viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                   viennacl::compressed_matrix<NumericT, AlignmentV> & C,
+                   spgemm_plan & plan)
+{
+  prod_impl(A, B, C);
+
+  plan.init(A.size1(), B.size2(), A.nnz(), B.nnz());
+
+  unsigned int const * C_row_buffer = detail::extract_raw_pointer<unsigned int>(C.handle1());
+  unsigned int const * C_col_buffer = detail::extract_raw_pointer<unsigned int>(C.handle2());
+  plan.row_indices().assign(C_row_buffer, C_row_buffer + C.size1() + 1);
+  plan.col_indices().assign(C_col_buffer, C_col_buffer + C_row_buffer[C.size1()]);
+
+  std::vector<vcl_size_t> flop_offsets;
+  detail::spgemm_distribute_rows(A, B, flop_offsets, plan.chunk_starts());
+}
+
+/** @brief Numeric phase of a sparse matrix-matrix product C = A * B for CSR matrices, reusing the sparsity pattern of C recorded in the plan by prod_symbolic().
+*
+* Only the values of C are computed and written to the existing memory buffer C.handle(); neither the pattern of C is determined nor is memory allocated.
+* For each row of C, the positions of its nonzeros are scattered to a thread-local work buffer of size B.size2(), so that the products are accumulated in place without sorting or merging.
+*
+* @param A     Left factor with the same sparsity pattern as passed to prod_symbolic()
+* @param B     Right factor with the same sparsity pattern as passed to prod_symbolic()
+* @param C     Result matrix as returned from prod_symbolic()
+* @param plan  The plan as set up by prod_symbolic()
+*/
+template<typename NumericT, unsigned int AlignmentV>
+void prod_numeric(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                  viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                  viennacl::compressed_matrix<NumericT, AlignmentV> & C,
+                  spgemm_plan & plan)
+{
+  assert( !plan.empty()                                         && bool("Plan for sparse matrix-matrix product not set up by prod_symbolic()"));
+  assert( (A.size1() == plan.size1() && A.nnz() == plan.lhs_nnz()) && bool("Left factor does not match plan for sparse matrix-matrix product"));
+  assert( (B.size2() == plan.size2() && B.nnz() == plan.rhs_nnz()) && bool("Right factor does not match plan for sparse matrix-matrix product"));
+  assert( (C.size1() == plan.size1() && C.size2() == plan.size2() && C.nnz() >= plan.nnz()) && bool("Result matrix does not match plan for sparse matrix-matrix product"));
+
+  NumericT     const * A_elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+  unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+  unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+
+  NumericT     const * B_elements   = detail::extract_raw_pointer<NumericT>(B.handle());
+  unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
+  unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
+
+  NumericT           * C_elements   = detail::extract_raw_pointer<NumericT>(C.handle());
+  unsigned int const * C_row_buffer = plan.row_indices().size() ? &(plan.row_indices()[0]) : NULL;
+  unsigned int const * C_col_buffer = plan.col_indices().size() ? &(plan.col_indices()[0]) : NULL;
 
-  // clean up at the end:
-  for (unsigned int i=0; i<max_threads; ++i)
+  std::vector<vcl_size_t> const & chunk_starts = plan.chunk_starts();
+  vcl_size_t num_chunks = chunk_starts.size() - 1;
+
+#ifdef VIENNACL_WITH_OPENMP
+  plan.reserve_work_buffers(static_cast<vcl_size_t>(omp_get_max_threads()));
+  #pragma omp parallel
+#else
+  plan.reserve_work_buffers(1);
+#endif
   {
-    free(row_C_temp_index_buffers[i]);
-    free(row_C_temp_value_buffers[i]);
-  }
+#ifdef VIENNACL_WITH_OPENMP
+    std::vector<unsigned int> & positions = plan.work_buffer(static_cast<vcl_size_t>(omp_get_thread_num()));
+#else
+    std::vector<unsigned int> & positions = plan.work_buffer(0);
+#endif
+    if (positions.size() < plan.size2())
+      positions.resize(plan.size2());
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp for schedule(dynamic, 1)
+#endif
+    for (long chunk = 0; chunk < long(num_chunks); ++chunk)
+    {
+      for (vcl_size_t i = chunk_starts[static_cast<vcl_size_t>(chunk)]; i < chunk_starts[static_cast<vcl_size_t>(chunk) + 1]; ++i)
+      {
+        unsigned int row_start_C = C_row_buffer[i];
+        unsigned int row_end_C   = C_row_buffer[i+1];
+        for (unsigned int k = row_start_C; k < row_end_C; ++k)
+        {
+          positions[C_col_buffer[k]] = k;
+          C_elements[k] = 0;
+        }
 
+        // every column index encountered below is in the pattern of the row of C, hence positions[] need not be reset:
+        for (unsigned int j = A_row_buffer[i]; j < A_row_buffer[i+1]; ++j)
+        {
+          NumericT val_A = A_elements[j];
+          unsigned int row_B = A_col_buffer[j];
+          for (unsigned int k = B_row_buffer[row_B]; k < B_row_buffer[row_B+1]; ++k)
+            C_elements[positions[B_col_buffer[k]]] += val_A * B_elements[k];
+        }
+      }
+    }
+  }
 }
 
 
@@ -1581,41 +1921,11 @@ void prod_impl(const viennacl::ell_matrix<NumericT, AlignmentV> & sp_mat,
       result_wrapper_col(result_data, result_start1, result_start2, result_inc1, result_inc2, result_internal_size1, result_internal_size2);
 
   if ( d_mat.row_major() ) {
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (long row = 0; row < static_cast<long>(sp_mat.size1()); ++row)
-    {
-      if (result.row_major())
-        for (vcl_size_t col = 0; col < d_mat.size2(); ++col)
-          result_wrapper_row( row, col) = (NumericT)0; /* filling result with zeros, as the product loops are reordered */
-      else
-        for (vcl_size_t col = 0; col < d_mat.size2(); ++col)
-          result_wrapper_col( row, col) = (NumericT)0; /* filling result with zeros, as the product loops are reordered */
-    }
-
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (long row = 0; row < static_cast<long>(sp_mat.size1()); ++row)
-    {
-      for (long item_id = 0; item_id < static_cast<long>(sp_mat.maxnnz()); ++item_id)
-      {
-        vcl_size_t offset = static_cast<vcl_size_t>(row) + static_cast<vcl_size_t>(item_id) * sp_mat.internal_size1();
-        NumericT sp_mat_val = static_cast<NumericT>(sp_mat_elements[offset]);
-        vcl_size_t sp_mat_col = static_cast<vcl_size_t>(sp_mat_coords[offset]);
-
-        if (sp_mat_val < 0 || sp_mat_val > 0) // sp_mat_val != 0 without compiler warnings
-        {
-          if (result.row_major())
-            for (vcl_size_t col = 0; col < d_mat.size2(); ++col)
-              result_wrapper_row(static_cast<vcl_size_t>(row), col) += sp_mat_val * d_mat_wrapper_row( sp_mat_col, col);
-          else
-            for (vcl_size_t col = 0; col < d_mat.size2(); ++col)
-              result_wrapper_col(static_cast<vcl_size_t>(row), col) += sp_mat_val * d_mat_wrapper_row( sp_mat_col, col);
-        }
-      }
-    }
+    // each row of sp_mat is read once per block of up to 16 columns of d_mat:
+    detail::spmm_tall_skinny(detail::ell_spmm_tall_skinny_kernel<NumericT>(sp_mat_coords, sp_mat_elements, sp_mat.size1(), sp_mat.internal_size1(), sp_mat.maxnnz()),
+                             detail::make_dense_strided_view<NumericT const>(d_mat),
+                             detail::make_dense_strided_view<NumericT>(result),
+                             d_mat.size2());
   }
   else {
 #ifdef VIENNACL_WITH_OPENMP
@@ -1742,41 +2052,11 @@ void prod_impl(const viennacl::ell_matrix<NumericT, AlignmentV> & sp_mat,
   }
   else
   {
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (long col = 0; col < static_cast<long>(d_mat.size2()); ++col)
-    {
-      if (result.row_major())
-        for (vcl_size_t row = 0; row < sp_mat.size1(); ++row)
-          result_wrapper_row( row, col) = (NumericT)0; /* filling result with zeros, as the product loops are reordered */
-      else
-        for (vcl_size_t row = 0; row < sp_mat.size1(); ++row)
-          result_wrapper_col( row, col) = (NumericT)0; /* filling result with zeros, as the product loops are reordered */
-    }
-
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (vcl_size_t row = 0; row < sp_mat.size1(); ++row) {
-
-      for (long item_id = 0; item_id < static_cast<long>(sp_mat.maxnnz()); ++item_id) {
-
-        vcl_size_t offset = row + static_cast<vcl_size_t>(item_id) * sp_mat.internal_size1();
-        NumericT sp_mat_val = static_cast<NumericT>(sp_mat_elements[offset]);
-        vcl_size_t sp_mat_col = static_cast<vcl_size_t>(sp_mat_coords[offset]);
-
-        if (sp_mat_val < 0 || sp_mat_val > 0)  // sp_mat_val != 0 without compiler warnings
-        {
-          if (result.row_major())
-            for (vcl_size_t col = 0; col < d_mat.size2(); ++col)
-              result_wrapper_row( row, col) += sp_mat_val * d_mat_wrapper_col( col, sp_mat_col);
-          else
-            for (vcl_size_t col = 0; col < d_mat.size2(); ++col)
-              result_wrapper_col( row, col) += sp_mat_val * d_mat_wrapper_col( col, sp_mat_col);
-        }
-      }
-    }
+    // the rows of trans(d_mat) are adjacent in memory, hence each row of sp_mat is read once per block of up to 16 columns of trans(d_mat):
+    detail::spmm_tall_skinny(detail::ell_spmm_tall_skinny_kernel<NumericT>(sp_mat_coords, sp_mat_elements, sp_mat.size1(), sp_mat.internal_size1(), sp_mat.maxnnz()),
+                             detail::make_transposed_dense_strided_view<NumericT const>(d_mat.lhs()),
+                             detail::make_dense_strided_view<NumericT>(result),
+                             d_mat.size2());
   }
 
 }
@@ -1806,8 +2086,9 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
   IndexT   const * columns_per_block = detail::extract_raw_pointer<IndexT>(mat.handle1());
   IndexT   const * column_indices    = detail::extract_raw_pointer<IndexT>(mat.handle2());
   IndexT   const * block_start       = detail::extract_raw_pointer<IndexT>(mat.handle3());
+  IndexT   const * row_permutation   = (mat.sorting_scope() > 1) ? detail::extract_raw_pointer<IndexT>(mat.handle4()) : NULL;
 
-  vcl_size_t num_blocks = mat.size1() / mat.rows_per_block() + 1;
+  vcl_size_t num_blocks = (mat.size1() > 0) ? (mat.size1() - 1) / mat.rows_per_block() + 1 : 0;
 
 #ifdef VIENNACL_WITH_OPENMP
   #pragma omp parallel for
@@ -1834,6 +2115,7 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
       }
     }
 
+    // rows are stored in the order given by the row permutation (if any):
     vcl_size_t first_row_in_matrix = block_idx * mat.rows_per_block();
     if (beta < 0 || beta > 0)
     {
@@ -1841,7 +2123,8 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
       {
         if (first_row_in_matrix + row_in_block < result.size())
         {
-          vcl_size_t index = (first_row_in_matrix + row_in_block) * result.stride() + result.start();
+          vcl_size_t row = row_permutation ? static_cast<vcl_size_t>(row_permutation[first_row_in_matrix + row_in_block]) : first_row_in_matrix + row_in_block;
+          vcl_size_t index = row * result.stride() + result.start();
           result_buf[index] = alpha * result_values[row_in_block] + beta * result_buf[index];
         }
       }
@@ -1851,13 +2134,69 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
       for (IndexT row_in_block = 0; row_in_block < mat.rows_per_block(); ++row_in_block)
       {
         if (first_row_in_matrix + row_in_block < result.size())
-          result_buf[(first_row_in_matrix + row_in_block) * result.stride() + result.start()] = alpha * result_values[row_in_block];
+        {
+          vcl_size_t row = row_permutation ? static_cast<vcl_size_t>(row_permutation[first_row_in_matrix + row_in_block]) : first_row_in_matrix + row_in_block;
+          result_buf[row * result.stride() + result.start()] = alpha * result_values[row_in_block];
+        }
       }
     }
   }
 }
 
 
+/** @brief Carries out sparse-matrix-dense-matrix multiplication with a sliced_ell_matrix
+*
+* Implementation of the convenience expression result = prod(sp_mat, d_mat);
+* Each row of sp_mat is read once per block of up to 16 columns of d_mat.
+*
+* @param sp_mat     The sparse matrix
+* @param d_mat      The dense matrix
+* @param result     The result matrix
+*/
+template<typename NumericT, typename IndexT>
+void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & sp_mat,
+               const viennacl::matrix_base<NumericT> & d_mat,
+                     viennacl::matrix_base<NumericT> & result)
+{
+  detail::spmm_tall_skinny(detail::sliced_ell_spmm_tall_skinny_kernel<NumericT, IndexT>(detail::extract_raw_pointer<IndexT>(sp_mat.handle1()),
+                                                                                        detail::extract_raw_pointer<IndexT>(sp_mat.handle2()),
+                                                                                        detail::extract_raw_pointer<IndexT>(sp_mat.handle3()),
+                                                                                        detail::extract_raw_pointer<NumericT>(sp_mat.handle()),
+                                                                                        (sp_mat.sorting_scope() > 1) ? detail::extract_raw_pointer<IndexT>(sp_mat.handle4()) : NULL,
+                                                                                        sp_mat.size1(), sp_mat.rows_per_block()),
+                           detail::make_dense_strided_view<NumericT const>(d_mat),
+                           detail::make_dense_strided_view<NumericT>(result),
+                           d_mat.size2());
+}
+
+/** @brief Carries out matrix-trans(matrix) multiplication with a sliced_ell_matrix
+*
+* Implementation of the convenience expression result = prod(sp_mat, trans(d_mat));
+* Each row of sp_mat is read once per block of up to 16 columns of trans(d_mat).
+*
+* @param sp_mat     The sparse matrix
+* @param d_mat      The transposed dense matrix
+* @param result     The result matrix
+*/
+template<typename NumericT, typename IndexT>
+void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & sp_mat,
+               const viennacl::matrix_expression< const viennacl::matrix_base<NumericT>,
+                                                  const viennacl::matrix_base<NumericT>,
+                                                  viennacl::op_trans > & d_mat,
+                     viennacl::matrix_base<NumericT> & result)
+{
+  detail::spmm_tall_skinny(detail::sliced_ell_spmm_tall_skinny_kernel<NumericT, IndexT>(detail::extract_raw_pointer<IndexT>(sp_mat.handle1()),
+                                                                                        detail::extract_raw_pointer<IndexT>(sp_mat.handle2()),
+                                                                                        detail::extract_raw_pointer<IndexT>(sp_mat.handle3()),
+                                                                                        detail::extract_raw_pointer<NumericT>(sp_mat.handle()),
+                                                                                        (sp_mat.sorting_scope() > 1) ? detail::extract_raw_pointer<IndexT>(sp_mat.handle4()) : NULL,
+                                                                                        sp_mat.size1(), sp_mat.rows_per_block()),
+                           detail::make_transposed_dense_strided_view<NumericT const>(d_mat.lhs()),
+                           detail::make_dense_strided_view<NumericT>(result),
+                           d_mat.size2());
+}
+
+
 //
 // Hybrid Matrix
 //
@@ -1975,6 +2314,16 @@ void prod_impl(const viennacl::hyb_matrix<NumericT, AlignmentV> & mat,
   unsigned int const * csr_row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle3());
   unsigned int const * csr_col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle4());
 
+  if (d_mat.row_major())
+  {
+    // each row of mat is read once per block of up to 16 columns of d_mat:
+    detail::spmm_tall_skinny(detail::hyb_spmm_tall_skinny_kernel<NumericT>(coords, elements, mat.size1(), mat.internal_size1(), mat.internal_ellnnz(),
+                                                                           csr_row_buffer, csr_col_buffer, csr_elements),
+                             detail::make_dense_strided_view<NumericT const>(d_mat),
+                             detail::make_dense_strided_view<NumericT>(result),
+                             d_mat.size2());
+    return;
+  }
 
   for (vcl_size_t result_col = 0; result_col < result.size2(); ++result_col)
   {
@@ -2070,6 +2419,16 @@ void prod_impl(const viennacl::hyb_matrix<NumericT, AlignmentV> & mat,
   unsigned int const * csr_row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle3());
   unsigned int const * csr_col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle4());
 
+  if (!d_mat.lhs().row_major())
+  {
+    // the rows of trans(d_mat) are adjacent in memory, hence each row of mat is read once per block of up to 16 columns of trans(d_mat):
+    detail::spmm_tall_skinny(detail::hyb_spmm_tall_skinny_kernel<NumericT>(coords, elements, mat.size1(), mat.internal_size1(), mat.internal_ellnnz(),
+                                                                           csr_row_buffer, csr_col_buffer, csr_elements),
+                             detail::make_transposed_dense_strided_view<NumericT const>(d_mat.lhs()),
+                             detail::make_dense_strided_view<NumericT>(result),
+                             d_mat.size2());
+    return;
+  }
 
   for (vcl_size_t result_col = 0; result_col < result.size2(); ++result_col)
   {
@@ -2117,6 +2476,809 @@ void prod_impl(const viennacl::hyb_matrix<NumericT, AlignmentV> & mat,
 }
 
 
+//
+// BSR matrix
+//
+
+namespace detail
+{
+  /** @brief Loads the entries [offset, offset + BlockSize) of a strided vector of the given size into x_block, padding with zeros beyond the end of the vector. */
+  template<typename NumericT, unsigned int BlockSize>
+  inline void bsr_load_block_vector(NumericT const * x, vcl_size_t inc, vcl_size_t offset, vcl_size_t size, NumericT * x_block)
+  {
+    if (offset + BlockSize <= size)
+      for (unsigned int j = 0; j < BlockSize; ++j)
+        x_block[j] = x[(offset + j) * inc];
+    else
+      for (unsigned int j = 0; j < BlockSize; ++j)
+        x_block[j] = (offset + j < size) ? x[(offset + j) * inc] : NumericT(0);
+  }
+
+  /** @brief Computes y_block += block * x_block for a dense block stored row-major. The loop bounds are compile-time constants, hence the loops are fully unrolled for small block sizes. */
+  template<typename NumericT, unsigned int BlockSize>
+  inline void bsr_block_prod(NumericT const * block, NumericT const * x_block, NumericT * y_block)
+  {
+    for (unsigned int i = 0; i < BlockSize; ++i)
+      for (unsigned int j = 0; j < BlockSize; ++j)
+        y_block[i] += block[i * BlockSize + j] * x_block[j];
+  }
+
+  /** @brief Computes y_block += trans(block) * x_block for a dense block stored row-major. */
+  template<typename NumericT, unsigned int BlockSize>
+  inline void bsr_block_trans_prod(NumericT const * block, NumericT const * x_block, NumericT * y_block)
+  {
+    for (unsigned int i = 0; i < BlockSize; ++i)
+      for (unsigned int j = 0; j < BlockSize; ++j)
+        y_block[j] += block[i * BlockSize + j] * x_block[i];
+  }
+
+  template<typename NumericT, unsigned int BlockSize>
+  void row_info(bsr_matrix<NumericT, BlockSize> const & mat,
+                vector_base<NumericT> & vec,
+                viennacl::linalg::detail::row_info_types info_selector)
+  {
+    NumericT         * result_buf       = detail::extract_raw_pointer<NumericT>(vec.handle());
+    NumericT   const * elements         = detail::extract_raw_pointer<NumericT>(mat.handle());
+    unsigned int const * block_row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+    unsigned int const * block_col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+    for (vcl_size_t row = 0; row < mat.size1(); ++row)
+    {
+      NumericT value = 0;
+      vcl_size_t block_row = row / BlockSize;
+
+      for (unsigned int k = block_row_buffer[block_row]; k < block_row_buffer[block_row + 1]; ++k)
+      {
+        NumericT const * block_row_entries = elements + (vcl_size_t(k) * BlockSize + row % BlockSize) * BlockSize;
+        vcl_size_t col_start = vcl_size_t(block_col_buffer[k]) * BlockSize;
+
+        switch (info_selector)
+        {
+          case viennacl::linalg::detail::SPARSE_ROW_NORM_INF: //inf-norm
+            for (unsigned int j = 0; j < BlockSize; ++j)
+              value = std::max<NumericT>(value, std::fabs(block_row_entries[j]));
+            break;
+
+          case viennacl::linalg::detail::SPARSE_ROW_NORM_1: //1-norm
+            for (unsigned int j = 0; j < BlockSize; ++j)
+              value += std::fabs(block_row_entries[j]);
+            break;
+
+          case viennacl::linalg::detail::SPARSE_ROW_NORM_2: //2-norm
+            for (unsigned int j = 0; j < BlockSize; ++j)
+              value += block_row_entries[j] * block_row_entries[j];
+            break;
+
+          case viennacl::linalg::detail::SPARSE_ROW_DIAGONAL: //diagonal entry
+            if (col_start <= row && row < col_start + BlockSize)
+              value = block_row_entries[row - col_start];
+            break;
+        }
+      }
+
+      if (info_selector == viennacl::linalg::detail::SPARSE_ROW_NORM_2)
+        value = std::sqrt(value);
+      result_buf[row] = value;
+    }
+  }
+
+  /** @brief Computes result = prod(A, B) for a bsr_matrix A and a dense matrix B accessed through the wrapper B_wrapper (possibly transposed). */
+  template<typename NumericT, unsigned int BlockSize, typename DenseWrapperT, typename ResultWrapperT>
+  void bsr_prod_dense(viennacl::bsr_matrix<NumericT, BlockSize> const & A,
+                      DenseWrapperT & B_wrapper, vcl_size_t B_size2,
+                      ResultWrapperT & result_wrapper)
+  {
+    NumericT     const * elements         = detail::extract_raw_pointer<NumericT>(A.handle());
+    unsigned int const * block_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * block_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for
+#endif
+    for (long block_row = 0; block_row < static_cast<long>(A.block_rows()); ++block_row)
+    {
+      vcl_size_t row_start = static_cast<vcl_size_t>(block_row) * BlockSize;
+      vcl_size_t rows_in_block = std::min<vcl_size_t>(BlockSize, A.size1() - row_start);
+
+      // the blocks of the block row are reused from cache for each column of B:
+      for (vcl_size_t col = 0; col < B_size2; ++col)
+      {
+        NumericT x_block[BlockSize];
+        NumericT y_block[BlockSize];
+        for (unsigned int i = 0; i < BlockSize; ++i)
+          y_block[i] = 0;
+
+        for (unsigned int k = block_row_buffer[block_row]; k < block_row_buffer[block_row + 1]; ++k)
+        {
+          vcl_size_t col_start = vcl_size_t(block_col_buffer[k]) * BlockSize;
+          for (unsigned int j = 0; j < BlockSize; ++j)
+            x_block[j] = (col_start + j < A.size2()) ? B_wrapper(col_start + j, col) : NumericT(0);
+          bsr_block_prod<NumericT, BlockSize>(elements + vcl_size_t(k) * BlockSize * BlockSize, x_block, y_block);
+        }
+
+        for (vcl_size_t i = 0; i < rows_in_block; ++i)
+          result_wrapper(row_start + i, col) = y_block[i];
+      }
+    }
+  }
+
+  /** @brief Dispatches the product of a bsr_matrix with a (possibly transposed) dense matrix to the kernel for the memory layouts of the operands. */
+  template<bool TransposedB, typename NumericT, unsigned int BlockSize>
+  void bsr_prod_dense(viennacl::bsr_matrix<NumericT, BlockSize> const & A,
+                      viennacl::matrix_base<NumericT> const & B,
+                      viennacl::matrix_base<NumericT> & result)
+  {
+    NumericT const * B_data      = detail::extract_raw_pointer<NumericT>(B);
+    NumericT       * result_data = detail::extract_raw_pointer<NumericT>(result);
+
+    detail::matrix_array_wrapper<NumericT const, row_major, TransposedB>
+        B_wrapper_row(B_data, viennacl::traits::start1(B), viennacl::traits::start2(B), viennacl::traits::stride1(B), viennacl::traits::stride2(B),
+                      viennacl::traits::internal_size1(B), viennacl::traits::internal_size2(B));
+    detail::matrix_array_wrapper<NumericT const, column_major, TransposedB>
+        B_wrapper_col(B_data, viennacl::traits::start1(B), viennacl::traits::start2(B), viennacl::traits::stride1(B), viennacl::traits::stride2(B),
+                      viennacl::traits::internal_size1(B), viennacl::traits::internal_size2(B));
+
+    detail::matrix_array_wrapper<NumericT, row_major, false>
+        result_wrapper_row(result_data, viennacl::traits::start1(result), viennacl::traits::start2(result), viennacl::traits::stride1(result), viennacl::traits::stride2(result),
+                           viennacl::traits::internal_size1(result), viennacl::traits::internal_size2(result));
+    detail::matrix_array_wrapper<NumericT, column_major, false>
+        result_wrapper_col(result_data, viennacl::traits::start1(result), viennacl::traits::start2(result), viennacl::traits::stride1(result), viennacl::traits::stride2(result),
+                           viennacl::traits::internal_size1(result), viennacl::traits::internal_size2(result));
+
+    if (B.row_major())
+    {
+      if (result.row_major())
+        bsr_prod_dense(A, B_wrapper_row, result.size2(), result_wrapper_row);
+      else
+        bsr_prod_dense(A, B_wrapper_row, result.size2(), result_wrapper_col);
+    }
+    else
+    {
+      if (result.row_major())
+        bsr_prod_dense(A, B_wrapper_col, result.size2(), result_wrapper_row);
+      else
+        bsr_prod_dense(A, B_wrapper_col, result.size2(), result_wrapper_col);
+    }
+  }
+}
+
+/** @brief Carries out matrix-vector multiplication with a bsr_matrix
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+* Each thread processes whole block rows, the products with the dense blocks are unrolled for the block size.
+*
+* @param mat    The matrix
+* @param vec    The vector
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the result vector. If zero, the result vector is not read.
+*/
+template<typename NumericT, unsigned int BlockSize>
+void prod_impl(const viennacl::bsr_matrix<NumericT, BlockSize> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+               viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  NumericT           * result_buf       = detail::extract_raw_pointer<NumericT>(result.handle()) + viennacl::traits::start(result);
+  NumericT     const * vec_buf          = detail::extract_raw_pointer<NumericT>(vec.handle()) + viennacl::traits::start(vec);
+  NumericT     const * elements         = detail::extract_raw_pointer<NumericT>(mat.handle());
+  unsigned int const * block_row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+  unsigned int const * block_col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+  vcl_size_t result_inc = viennacl::traits::stride(result);
+  vcl_size_t vec_inc    = viennacl::traits::stride(vec);
+  bool use_beta = (beta < 0 || beta > 0);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long block_row = 0; block_row < static_cast<long>(mat.block_rows()); ++block_row)
+  {
+    NumericT x_block[BlockSize];
+    NumericT y_block[BlockSize];
+    for (unsigned int i = 0; i < BlockSize; ++i)
+      y_block[i] = 0;
+
+    for (unsigned int k = block_row_buffer[block_row]; k < block_row_buffer[block_row + 1]; ++k)
+    {
+      detail::bsr_load_block_vector<NumericT, BlockSize>(vec_buf, vec_inc, vcl_size_t(block_col_buffer[k]) * BlockSize, mat.size2(), x_block);
+      detail::bsr_block_prod<NumericT, BlockSize>(elements + vcl_size_t(k) * BlockSize * BlockSize, x_block, y_block);
+    }
+
+    vcl_size_t row_start = static_cast<vcl_size_t>(block_row) * BlockSize;
+    vcl_size_t rows_in_block = std::min<vcl_size_t>(BlockSize, mat.size1() - row_start);
+    for (vcl_size_t i = 0; i < rows_in_block; ++i)
+    {
+      NumericT & y = result_buf[(row_start + i) * result_inc];
+      y = use_beta ? alpha * y_block[i] + beta * y : alpha * y_block[i];
+    }
+  }
+}
+
+/** @brief Carries out matrix-vector multiplication with a transposed bsr_matrix
+*
+* Implementation of the convenience expression result = alpha * prod(trans(mat), vec) + beta * result;
+* The block rows are split among the threads, each thread accumulating into a separate buffer. The buffers are summed up afterwards.
+*
+* @param mat_trans  The transposed matrix
+* @param vec        The vector
+* @param alpha      Scaling factor for the matrix-vector product
+* @param result     The result vector
+* @param beta       Scaling factor for the result vector. If zero, the result vector is not read.
+*/
+template<typename NumericT, unsigned int BlockSize>
+void prod_impl(const viennacl::matrix_expression< const viennacl::bsr_matrix<NumericT, BlockSize>,
+                                                  const viennacl::bsr_matrix<NumericT, BlockSize>,
+                                                  viennacl::op_trans > & mat_trans,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+               viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  viennacl::bsr_matrix<NumericT, BlockSize> const & mat = mat_trans.lhs();
+
+  NumericT           * result_buf       = detail::extract_raw_pointer<NumericT>(result.handle()) + viennacl::traits::start(result);
+  NumericT     const * vec_buf          = detail::extract_raw_pointer<NumericT>(vec.handle()) + viennacl::traits::start(vec);
+  NumericT     const * elements         = detail::extract_raw_pointer<NumericT>(mat.handle());
+  unsigned int const * block_row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+  unsigned int const * block_col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+  vcl_size_t result_inc = viennacl::traits::stride(result);
+  vcl_size_t vec_inc    = viennacl::traits::stride(vec);
+  bool use_beta = (beta < 0 || beta > 0);
+
+  vcl_size_t num_threads = 1;
+#ifdef VIENNACL_WITH_OPENMP
+  if (mat.nnz() > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
+    num_threads = static_cast<vcl_size_t>(omp_get_max_threads());
+#endif
+
+  vcl_size_t padded_size2 = mat.block_cols() * BlockSize;
+  std::vector<NumericT> partial_results(num_threads * padded_size2);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for if (num_threads > 1)
+#endif
+  for (long thread_id = 0; thread_id < static_cast<long>(num_threads); ++thread_id)
+  {
+    NumericT * partial_result = &(partial_results[static_cast<vcl_size_t>(thread_id) * padded_size2]);
+    vcl_size_t block_row_start = ( static_cast<vcl_size_t>(thread_id)      * mat.block_rows()) / num_threads;
+    vcl_size_t block_row_stop  = ((static_cast<vcl_size_t>(thread_id) + 1) * mat.block_rows()) / num_threads;
+
+    NumericT x_block[BlockSize];
+    for (vcl_size_t block_row = block_row_start; block_row < block_row_stop; ++block_row)
+    {
+      detail::bsr_load_block_vector<NumericT, BlockSize>(vec_buf, vec_inc, block_row * BlockSize, mat.size1(), x_block);
+      for (unsigned int k = block_row_buffer[block_row]; k < block_row_buffer[block_row + 1]; ++k)
+        detail::bsr_block_trans_prod<NumericT, BlockSize>(elements + vcl_size_t(k) * BlockSize * BlockSize, x_block,
+                                                          partial_result + vcl_size_t(block_col_buffer[k]) * BlockSize);
+    }
+  }
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for if (num_threads > 1)
+#endif
+  for (long col = 0; col < static_cast<long>(mat.size2()); ++col)
+  {
+    NumericT value = 0;
+    for (vcl_size_t thread_id = 0; thread_id < num_threads; ++thread_id)
+      value += partial_results[thread_id * padded_size2 + static_cast<vcl_size_t>(col)];
+
+    NumericT & y = result_buf[static_cast<vcl_size_t>(col) * result_inc];
+    y = use_beta ? alpha * value + beta * y : alpha * value;
+  }
+}
+
+/** @brief Carries out sparse_matrix-matrix multiplication first matrix being a bsr_matrix
+*
+* Implementation of the convenience expression result = prod(sp_mat, d_mat);
+*
+* @param sp_mat     The sparse matrix
+* @param d_mat      The dense matrix
+* @param result     The result matrix
+*/
+template<typename NumericT, unsigned int BlockSize>
+void prod_impl(const viennacl::bsr_matrix<NumericT, BlockSize> & sp_mat,
+               const viennacl::matrix_base<NumericT> & d_mat,
+                     viennacl::matrix_base<NumericT> & result)
+{
+  detail::bsr_prod_dense<false>(sp_mat, d_mat, result);
+}
+
+/** @brief Carries out matrix-trans(matrix) multiplication first matrix being a bsr_matrix
+*          and the second transposed
+*
+* Implementation of the convenience expression result = prod(sp_mat, trans(d_mat));
+*
+* @param sp_mat     The sparse matrix
+* @param d_mat      The transposed dense matrix
+* @param result     The result matrix
+*/
+template<typename NumericT, unsigned int BlockSize>
+void prod_impl(const viennacl::bsr_matrix<NumericT, BlockSize> & sp_mat,
+               const viennacl::matrix_expression< const viennacl::matrix_base<NumericT>,
+                                                  const viennacl::matrix_base<NumericT>,
+                                                  viennacl::op_trans > & d_mat,
+                     viennacl::matrix_base<NumericT> & result)
+{
+  detail::bsr_prod_dense<true>(sp_mat, d_mat.lhs(), result);
+}
+
+
+//
+// Symmetric CSR matrix (upper triangle)
+//
+
+namespace detail
+{
+  template<typename NumericT>
+  void row_info(symmetric_compressed_matrix<NumericT> const & mat,
+                vector_base<NumericT> & vec,
+                viennacl::linalg::detail::row_info_types info_selector)
+  {
+    NumericT         * result_buf = detail::extract_raw_pointer<NumericT>(vec.handle());
+    NumericT   const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
+    unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+    unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+    for (vcl_size_t row = 0; row < mat.size1(); ++row)
+      result_buf[row] = 0;
+
+    // each entry A(i,j) with j > i also is the entry A(j,i) in row j:
+    for (vcl_size_t row = 0; row < mat.size1(); ++row)
+    {
+      for (vcl_size_t i = row_buffer[row]; i < row_buffer[row+1]; ++i)
+      {
+        vcl_size_t col = col_buffer[i];
+        NumericT entry = elements[i];
+
+        switch (info_selector)
+        {
+          case viennacl::linalg::detail::SPARSE_ROW_NORM_INF: //inf-norm
+            result_buf[row] = std::max<NumericT>(result_buf[row], std::fabs(entry));
+            if (col != row)
+              result_buf[col] = std::max<NumericT>(result_buf[col], std::fabs(entry));
+            break;
+
+          case viennacl::linalg::detail::SPARSE_ROW_NORM_1: //1-norm
+            result_buf[row] += std::fabs(entry);
+            if (col != row)
+              result_buf[col] += std::fabs(entry);
+            break;
+
+          case viennacl::linalg::detail::SPARSE_ROW_NORM_2: //2-norm
+            result_buf[row] += entry * entry;
+            if (col != row)
+              result_buf[col] += entry * entry;
+            break;
+
+          case viennacl::linalg::detail::SPARSE_ROW_DIAGONAL: //diagonal entry
+            if (col == row)
+              result_buf[row] = entry;
+            break;
+        }
+      }
+    }
+
+    if (info_selector == viennacl::linalg::detail::SPARSE_ROW_NORM_2)
+      for (vcl_size_t row = 0; row < mat.size1(); ++row)
+        result_buf[row] = std::sqrt(result_buf[row]);
+  }
+
+  /** @brief Computes result = prod(A, B) for a symmetric_compressed_matrix A and a dense matrix B accessed through the wrapper B_wrapper (possibly transposed).
+  *
+  * The columns of the result are distributed among the threads, so the scatter to the rows of the lower triangle does not cause write conflicts.
+  */
+  template<typename NumericT, typename DenseWrapperT, typename ResultWrapperT>
+  void symmetric_csr_prod_dense(viennacl::symmetric_compressed_matrix<NumericT> const & A,
+                                DenseWrapperT & B_wrapper, vcl_size_t B_size2,
+                                ResultWrapperT & result_wrapper)
+  {
+    NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+    unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for
+#endif
+    for (long col2 = 0; col2 < static_cast<long>(B_size2); ++col2)
+    {
+      vcl_size_t col = static_cast<vcl_size_t>(col2);
+      for (vcl_size_t row = 0; row < A.size1(); ++row)
+        result_wrapper(row, col) = 0;
+
+      for (vcl_size_t row = 0; row < A.size1(); ++row)
+      {
+        NumericT B_row = B_wrapper(row, col);
+        NumericT dot_prod = 0;
+        for (vcl_size_t k = row_buffer[row]; k < row_buffer[row+1]; ++k)
+        {
+          vcl_size_t j = col_buffer[k];
+          dot_prod += elements[k] * B_wrapper(j, col);
+          if (j != row)
+            result_wrapper(j, col) += elements[k] * B_row;
+        }
+        result_wrapper(row, col) += dot_prod;
+      }
+    }
+  }
+
+  /** @brief Dispatches the product of a symmetric_compressed_matrix with a (possibly transposed) dense matrix to the kernel for the memory layouts of the operands. */
+  template<bool TransposedB, typename NumericT>
+  void symmetric_csr_prod_dense(viennacl::symmetric_compressed_matrix<NumericT> const & A,
+                                viennacl::matrix_base<NumericT> const & B,
+                                viennacl::matrix_base<NumericT> & result)
+  {
+    NumericT const * B_data      = detail::extract_raw_pointer<NumericT>(B);
+    NumericT       * result_data = detail::extract_raw_pointer<NumericT>(result);
+
+    detail::matrix_array_wrapper<NumericT const, row_major, TransposedB>
+        B_wrapper_row(B_data, viennacl::traits::start1(B), viennacl::traits::start2(B), viennacl::traits::stride1(B), viennacl::traits::stride2(B),
+                      viennacl::traits::internal_size1(B), viennacl::traits::internal_size2(B));
+    detail::matrix_array_wrapper<NumericT const, column_major, TransposedB>
+        B_wrapper_col(B_data, viennacl::traits::start1(B), viennacl::traits::start2(B), viennacl::traits::stride1(B), viennacl::traits::stride2(B),
+                      viennacl::traits::internal_size1(B), viennacl::traits::internal_size2(B));
+
+    detail::matrix_array_wrapper<NumericT, row_major, false>
+        result_wrapper_row(result_data, viennacl::traits::start1(result), viennacl::traits::start2(result), viennacl::traits::stride1(result), viennacl::traits::stride2(result),
+                           viennacl::traits::internal_size1(result), viennacl::traits::internal_size2(result));
+    detail::matrix_array_wrapper<NumericT, column_major, false>
+        result_wrapper_col(result_data, viennacl::traits::start1(result), viennacl::traits::start2(result), viennacl::traits::stride1(result), viennacl::traits::stride2(result),
+                           viennacl::traits::internal_size1(result), viennacl::traits::internal_size2(result));
+
+    if (B.row_major())
+    {
+      if (result.row_major())
+        symmetric_csr_prod_dense(A, B_wrapper_row, result.size2(), result_wrapper_row);
+      else
+        symmetric_csr_prod_dense(A, B_wrapper_row, result.size2(), result_wrapper_col);
+    }
+    else
+    {
+      if (result.row_major())
+        symmetric_csr_prod_dense(A, B_wrapper_col, result.size2(), result_wrapper_row);
+      else
+        symmetric_csr_prod_dense(A, B_wrapper_col, result.size2(), result_wrapper_col);
+    }
+  }
+}
+
+/** @brief Carries out matrix-vector multiplication with a symmetric_compressed_matrix
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+* See symmetric_csr_spmv() for the treatment of the entries of the lower triangle.
+*
+* @param mat    The matrix
+* @param vec    The vector
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the result vector. If zero, the result vector is not read.
+*/
+template<typename NumericT>
+void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+               viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  if (mat.nnz() == 0)
+  {
+    if (beta < 0 || beta > 0)
+      viennacl::linalg::host_based::av(result, result, beta, 1, false, false);
+    else
+      viennacl::linalg::host_based::vector_assign(result, NumericT(0));   // beta == 0 ignores the old contents of result, even if they are NaN
+    return;
+  }
+
+  NumericT           * result_buf = detail::extract_raw_pointer<NumericT>(result.handle()) + viennacl::traits::start(result);
+  NumericT     const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle()) + viennacl::traits::start(vec);
+  NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
+  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+  detail::symmetric_csr_spmv(row_buffer, col_buffer, elements, mat.size1(),
+                             vec_buf, viennacl::traits::stride(vec),
+                             result_buf, viennacl::traits::stride(result),
+                             alpha, beta);
+}
+
+/** @brief Carries out sparse_matrix-matrix multiplication first matrix being a symmetric_compressed_matrix
+*
+* Implementation of the convenience expression result = prod(sp_mat, d_mat);
+*
+* @param sp_mat     The sparse matrix
+* @param d_mat      The dense matrix
+* @param result     The result matrix
+*/
+template<typename NumericT>
+void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & sp_mat,
+               const viennacl::matrix_base<NumericT> & d_mat,
+                     viennacl::matrix_base<NumericT> & result)
+{
+  detail::symmetric_csr_prod_dense<false>(sp_mat, d_mat, result);
+}
+
+/** @brief Carries out matrix-trans(matrix) multiplication first matrix being a symmetric_compressed_matrix
+*          and the second transposed
+*
+* Implementation of the convenience expression result = prod(sp_mat, trans(d_mat));
+*
+* @param sp_mat     The sparse matrix
+* @param d_mat      The transposed dense matrix
+* @param result     The result matrix
+*/
+template<typename NumericT>
+void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & sp_mat,
+               const viennacl::matrix_expression< const viennacl::matrix_base<NumericT>,
+                                                  const viennacl::matrix_base<NumericT>,
+                                                  viennacl::op_trans > & d_mat,
+                     viennacl::matrix_base<NumericT> & result)
+{
+  detail::symmetric_csr_prod_dense<true>(sp_mat, d_mat.lhs(), result);
+}
+
+
+//
+// Delta-compressed CSR matrix
+//
+
+/** @brief Carries out matrix-vector multiplication with a delta_compressed_matrix
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+* For rows holding column offsets, the pointer into the vector is advanced to the base column once per row, so the entries are accessed with the short offsets directly.
+* The rows are processed in blocks of delta_compressed_matrix::block_rows, within which the shift of the offsets by the entries of the wide rows is accumulated.
+*
+* @param mat    The matrix
+* @param vec    The vector
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the result vector. If zero, the result vector is not read.
+*/
+template<typename NumericT, typename DeltaT>
+void prod_impl(const viennacl::delta_compressed_matrix<NumericT, DeltaT> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+               viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  if (mat.nnz() == 0)
+  {
+    if (beta < 0 || beta > 0)
+      viennacl::linalg::host_based::av(result, result, beta, 1, false, false);
+    else
+      viennacl::linalg::host_based::vector_assign(result, NumericT(0));   // beta == 0 ignores the old contents of result, even if they are NaN
+    return;
+  }
+
+  NumericT           * result_buf = detail::extract_raw_pointer<NumericT>(result.handle()) + viennacl::traits::start(result);
+  NumericT     const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle()) + viennacl::traits::start(vec);
+  NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
+  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+  DeltaT       const * offsets    = (mat.wide_nnz() < mat.nnz()) ? detail::extract_raw_pointer<DeltaT>(mat.handle2()) : NULL;
+  unsigned int const * row_info   = mat.plain_csr() ? NULL : detail::extract_raw_pointer<unsigned int>(mat.handle3());
+  unsigned int const * wide_cols  = (mat.wide_nnz() > 0) ? detail::extract_raw_pointer<unsigned int>(mat.handle4()) : NULL;
+  unsigned int const * wide_block_start = (mat.wide_rows() > 0 && !mat.plain_csr()) ? detail::extract_raw_pointer<unsigned int>(mat.handle5()) : NULL;
+
+  vcl_size_t vec_stride    = viennacl::traits::stride(vec);
+  vcl_size_t result_stride = viennacl::traits::stride(result);
+  unsigned int const wide_flag = viennacl::delta_compressed_matrix<NumericT, DeltaT>::wide_row_flag;
+  vcl_size_t   const block_rows = viennacl::delta_compressed_matrix<NumericT, DeltaT>::block_rows;
+  vcl_size_t   const num_blocks = (mat.size1() - 1) / block_rows + 1;
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long block2 = 0; block2 < static_cast<long>(num_blocks); ++block2)
+  {
+    vcl_size_t block = static_cast<vcl_size_t>(block2);
+    vcl_size_t block_stop = std::min<vcl_size_t>((block + 1) * block_rows, mat.size1());
+
+    // number of entries in the wide rows above the current row, by which the offsets are shifted:
+    unsigned int wide_entries = wide_block_start ? wide_block_start[block] : 0;
+
+    for (vcl_size_t row = block * block_rows; row < block_stop; ++row)
+    {
+      unsigned int row_start = row_buffer[row];
+      unsigned int row_end   = row_buffer[row+1];
+      unsigned int info      = row_info ? row_info[row] : wide_flag;
+      NumericT dot_prod = 0;
+
+      if (info & wide_flag) // column offsets do not fit into DeltaT, full column indices are stored
+      {
+        unsigned int wide_start = row_info ? wide_entries : row_start;
+        for (unsigned int i = row_start; i < row_end; ++i)
+          dot_prod += elements[i] * vec_buf[wide_cols[wide_start + (i - row_start)] * vec_stride];
+        wide_entries += row_end - row_start;
+      }
+      else if (row_end > row_start)
+      {
+        DeltaT const * row_offsets = offsets + (row_start - wide_entries);
+        if (vec_stride == 1)
+        {
+          NumericT const * vec_row = vec_buf + info;
+          for (unsigned int i = 0; i < row_end - row_start; ++i)
+            dot_prod += elements[row_start + i] * vec_row[row_offsets[i]];
+        }
+        else
+        {
+          NumericT const * vec_row = vec_buf + info * vec_stride;
+          for (unsigned int i = 0; i < row_end - row_start; ++i)
+            dot_prod += elements[row_start + i] * vec_row[row_offsets[i] * vec_stride];
+        }
+      }
+
+      if (beta < 0 || beta > 0)
+        result_buf[row * result_stride] = alpha * dot_prod + beta * result_buf[row * result_stride];
+      else
+        result_buf[row * result_stride] = alpha * dot_prod;
+    }
+  }
+}
+
+
+
+//
+// Mixed precision: matrix entries stored in a lower precision than the vectors
+//
+
+/** @brief Carries out matrix-vector multiplication with a compressed_matrix holding entries of lower precision than the vectors
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+* Each entry is converted to NumericT when loaded, so the products are accumulated in the precision of the vectors.
+*
+* @param mat    The matrix, entries of type MatrixNumericT (e.g. float)
+* @param vec    The vector, entries of type NumericT (e.g. double)
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the result vector. If zero, the result vector is not read.
+*/
+template<typename MatrixNumericT, typename NumericT, unsigned int AlignmentV>
+void prod_impl(const viennacl::compressed_matrix<MatrixNumericT, AlignmentV> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+               viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  NumericT             * result_buf = detail::extract_raw_pointer<NumericT>(result.handle());
+  NumericT       const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
+  MatrixNumericT const * elements   = detail::extract_raw_pointer<MatrixNumericT>(mat.handle());
+  unsigned int   const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+  unsigned int   const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long row = 0; row < static_cast<long>(mat.size1()); ++row)
+  {
+    NumericT dot_prod = 0;
+    vcl_size_t row_end = row_buffer[row+1];
+    for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
+      dot_prod += static_cast<NumericT>(elements[i]) * vec_buf[col_buffer[i] * vec.stride() + vec.start()];
+
+    if (beta < 0 || beta > 0)
+    {
+      vcl_size_t index = static_cast<vcl_size_t>(row) * result.stride() + result.start();
+      result_buf[index] = alpha * dot_prod + beta * result_buf[index];
+    }
+    else
+      result_buf[static_cast<vcl_size_t>(row) * result.stride() + result.start()] = alpha * dot_prod;
+  }
+}
+
+/** @brief Carries out matrix-vector multiplication with an ell_matrix holding entries of lower precision than the vectors
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+*
+* @param mat    The matrix, entries of type MatrixNumericT (e.g. float)
+* @param vec    The vector, entries of type NumericT (e.g. double)
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the result vector. If zero, the result vector is not read.
+*/
+template<typename MatrixNumericT, typename NumericT, unsigned int AlignmentV>
+void prod_impl(const viennacl::ell_matrix<MatrixNumericT, AlignmentV> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+                     viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  NumericT             * result_buf = detail::extract_raw_pointer<NumericT>(result.handle());
+  NumericT       const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
+  MatrixNumericT const * elements   = detail::extract_raw_pointer<MatrixNumericT>(mat.handle());
+  unsigned int   const * coords     = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long row2 = 0; row2 < static_cast<long>(mat.size1()); ++row2)
+  {
+    vcl_size_t row = static_cast<vcl_size_t>(row2);
+    NumericT sum = 0;
+
+    for (unsigned int item_id = 0; item_id < mat.internal_maxnnz(); ++item_id)
+    {
+      vcl_size_t offset = row + item_id * mat.internal_size1();
+      MatrixNumericT val = elements[offset];
+
+      if (val > 0 || val < 0)
+        sum += vec_buf[coords[offset] * vec.stride() + vec.start()] * static_cast<NumericT>(val);
+    }
+
+    if (beta < 0 || beta > 0)
+    {
+      vcl_size_t index = row * result.stride() + result.start();
+      result_buf[index] = alpha * sum + beta * result_buf[index];
+    }
+    else
+      result_buf[row * result.stride() + result.start()] = alpha * sum;
+  }
+}
+
+/** @brief Carries out matrix-vector multiplication with a sliced_ell_matrix holding entries of lower precision than the vectors
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+*
+* @param mat    The matrix, entries of type MatrixNumericT (e.g. float)
+* @param vec    The vector, entries of type NumericT (e.g. double)
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the result vector. If zero, the result vector is not read.
+*/
+template<typename MatrixNumericT, typename NumericT, typename IndexT>
+void prod_impl(const viennacl::sliced_ell_matrix<MatrixNumericT, IndexT> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+                     viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  NumericT             * result_buf        = detail::extract_raw_pointer<NumericT>(result.handle());
+  NumericT       const * vec_buf           = detail::extract_raw_pointer<NumericT>(vec.handle());
+  MatrixNumericT const * elements          = detail::extract_raw_pointer<MatrixNumericT>(mat.handle());
+  IndexT         const * columns_per_block = detail::extract_raw_pointer<IndexT>(mat.handle1());
+  IndexT         const * column_indices    = detail::extract_raw_pointer<IndexT>(mat.handle2());
+  IndexT         const * block_start       = detail::extract_raw_pointer<IndexT>(mat.handle3());
+  IndexT         const * row_permutation   = (mat.sorting_scope() > 1) ? detail::extract_raw_pointer<IndexT>(mat.handle4()) : NULL;
+
+  vcl_size_t num_blocks = (mat.size1() > 0) ? (mat.size1() - 1) / mat.rows_per_block() + 1 : 0;
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long block_idx2 = 0; block_idx2 < static_cast<long>(num_blocks); ++block_idx2)
+  {
+    vcl_size_t block_idx = static_cast<vcl_size_t>(block_idx2);
+    vcl_size_t current_columns_per_block = columns_per_block[block_idx];
+
+    std::vector<NumericT> result_values(mat.rows_per_block());
+
+    for (IndexT column_entry_index = 0; column_entry_index < current_columns_per_block; ++column_entry_index)
+    {
+      vcl_size_t stride_start = block_start[block_idx] + column_entry_index * mat.rows_per_block();
+      for (IndexT row_in_block = 0; row_in_block < mat.rows_per_block(); ++row_in_block)
+      {
+        MatrixNumericT val = elements[stride_start + row_in_block];
+        if (val > 0 || val < 0)
+          result_values[row_in_block] += vec_buf[column_indices[stride_start + row_in_block] * vec.stride() + vec.start()] * static_cast<NumericT>(val);
+      }
+    }
+
+    vcl_size_t first_row_in_matrix = block_idx * mat.rows_per_block();
+    for (IndexT row_in_block = 0; row_in_block < mat.rows_per_block(); ++row_in_block)
+    {
+      if (first_row_in_matrix + row_in_block < result.size())
+      {
+        vcl_size_t row = row_permutation ? static_cast<vcl_size_t>(row_permutation[first_row_in_matrix + row_in_block]) : first_row_in_matrix + row_in_block;
+        vcl_size_t index = row * result.stride() + result.start();
+        if (beta < 0 || beta > 0)
+          result_buf[index] = alpha * result_values[row_in_block] + beta * result_buf[index];
+        else
+          result_buf[index] = alpha * result_values[row_in_block];
+      }
+    }
+  }
+}
+
 } // namespace host_based
 } //namespace linalg
 } //namespace viennacl
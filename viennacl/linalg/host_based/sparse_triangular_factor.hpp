@@ -0,0 +1,456 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SPARSE_TRIANGULAR_FACTOR_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SPARSE_TRIANGULAR_FACTOR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/sparse_triangular_factor.hpp
+    @brief Level-scheduled triangular solves with a sparse triangular factor in CSR format on the host.
+
+    The rows of the factor are grouped into levels such that the rows within a level only depend on rows of previous levels.
+    The analysis is carried out once when the factor is set up, after which the factor is stored as a CSR matrix with the rows in level order.
+    Each substitution then processes the levels one after another, with all rows of a level processed in parallel using OpenMP.
+
+    For factors with many thin levels, the barrier after each level dominates. These factors are substituted synchronization-free instead:
+    Each row waits on an atomic counter of its unresolved dependencies, which is decremented by the rows it depends on as soon as they are computed.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/traits/start.hpp"
+#include "viennacl/traits/stride.hpp"
+#include "viennacl/linalg/host_based/common.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+/** @brief Minimum number of nonzeros in a triangular factor for using OpenMP in the level-scheduled substitution. Smaller factors are substituted by a single thread. */
+#ifndef VIENNACL_OPENMP_TRIANGULAR_MIN_SIZE
+  #define VIENNACL_OPENMP_TRIANGULAR_MIN_SIZE  20000
+#endif
+
+/** @brief Factors whose levels hold fewer rows than this on average use synchronization-free substitution if the substitution mode is SPARSE_TRIANGULAR_SOLVE_AUTO. */
+#ifndef VIENNACL_TRIANGULAR_SYNC_FREE_ROWS_PER_LEVEL
+  #define VIENNACL_TRIANGULAR_SYNC_FREE_ROWS_PER_LEVEL  128
+#endif
+
+/** @brief Number of consecutive rows (in level order) handed out to a thread at once in the synchronization-free substitution. */
+#ifndef VIENNACL_TRIANGULAR_SYNC_FREE_CHUNK_SIZE
+  #define VIENNACL_TRIANGULAR_SYNC_FREE_CHUNK_SIZE  16
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+
+/** @brief The substitution modes available for sparse_triangular_factor. */
+enum sparse_triangular_solve_mode
+{
+  SPARSE_TRIANGULAR_SOLVE_AUTO = 0,        // choose based on the average number of rows per level
+  SPARSE_TRIANGULAR_SOLVE_LEVEL_SCHEDULED, // rows of a level in parallel, barrier after each level
+  SPARSE_TRIANGULAR_SOLVE_SYNC_FREE        // rows wait on per-row counters of unresolved dependencies, no barriers
+};
+
+namespace detail
+{
+  /** @brief Maps the triangular solver tags to the triangle (lower or upper) and to the treatment of the diagonal (unit or not) */
+  template<typename TagT>
+  struct triangular_tag_properties;
+
+  /** \cond */
+  template<> struct triangular_tag_properties<viennacl::linalg::lower_tag>      { enum { is_lower = 1, is_unit = 0 }; };
+  template<> struct triangular_tag_properties<viennacl::linalg::upper_tag>      { enum { is_lower = 0, is_unit = 0 }; };
+  template<> struct triangular_tag_properties<viennacl::linalg::unit_lower_tag> { enum { is_lower = 1, is_unit = 1 }; };
+  template<> struct triangular_tag_properties<viennacl::linalg::unit_upper_tag> { enum { is_lower = 0, is_unit = 1 }; };
+  /** \endcond */
+}
+
+/** @brief A triangular factor of a sparse matrix prepared for level-scheduled substitution on the host.
+*
+* The factor is set up from a compressed_matrix A (or its transpose) and a triangular solver tag, using the same semantics as inplace_solve():
+* Only the entries of the respective triangle of A (or trans(A)) are referenced, entries in the other triangle are ignored.
+* For unit_lower_tag and unit_upper_tag the diagonal is assumed to be one, otherwise the diagonal entries are taken from A.
+*
+* The factor holds a copy of the entries of A, hence it needs to be set up again if the values of A change.
+*/
+template<typename NumericT>
+class sparse_triangular_factor
+{
+public:
+  sparse_triangular_factor(sparse_triangular_solve_mode solve_mode = SPARSE_TRIANGULAR_SOLVE_AUTO) : size_(0), is_lower_(true), is_unit_(false), mode_(solve_mode) {}
+
+  /** @brief Sets up the factor for inplace_solve(A, x, tag) if 'transposed' is false, or for inplace_solve(trans(A), x, tag) otherwise.
+  *
+  * @param A           The sparse matrix. Must reside in main memory.
+  * @param tag         One of lower_tag, upper_tag, unit_lower_tag, unit_upper_tag
+  * @param transposed  Whether the factor is obtained from trans(A) rather than A
+  */
+  template<unsigned int AlignmentV, typename TagT>
+  void init(viennacl::compressed_matrix<NumericT, AlignmentV> const & A, TagT, bool transposed = false)
+  {
+    assert( (viennacl::traits::context(A).memory_type() == viennacl::MAIN_MEMORY) && bool("Matrix must reside in main memory for setting up a triangular factor") );
+    assert( (A.size1() == A.size2()) && bool("Triangular factor must be square") );
+
+    NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+    unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+
+    init_impl(row_buffer, col_buffer, elements, A.size1(),
+              detail::triangular_tag_properties<TagT>::is_lower == 1,
+              detail::triangular_tag_properties<TagT>::is_unit  == 1,
+              transposed);
+  }
+
+  /** @brief Releases the factor, so that it can be set up again. The substitution mode is kept. */
+  void clear()
+  {
+    size_ = 0;
+    level_offsets_.clear();
+    row_ids_.clear();
+    row_buffer_.clear();
+    col_buffer_.clear();
+    elements_.clear();
+    diagonal_.clear();
+    dependents_row_buffer_.clear();
+    dependents_.clear();
+    dependency_counters_.clear();
+  }
+
+  /** @brief Returns true if the factor has not been set up yet */
+  bool empty() const { return row_buffer_.empty(); }
+
+  /** @brief Number of rows of the factor */
+  vcl_size_t size() const { return size_; }
+
+  /** @brief Number of levels, i.e. the number of sequential steps of a substitution */
+  vcl_size_t levels() const { return level_offsets_.empty() ? 0 : level_offsets_.size() - 1; }
+
+  /** @brief Number of stored off-diagonal nonzeros */
+  vcl_size_t nnz() const { return col_buffer_.size(); }
+
+  /** @brief Returns true if the factor refers to the lower triangle, false for the upper triangle */
+  bool is_lower() const { return is_lower_; }
+  /** @brief Returns true if the factor has a unit diagonal */
+  bool is_unit() const { return is_unit_; }
+
+  /** @brief Returns the substitution mode as specified by the user */
+  sparse_triangular_solve_mode mode() const { return mode_; }
+
+  /** @brief Sets the substitution mode. SPARSE_TRIANGULAR_SOLVE_AUTO selects the mode based on the average number of rows per level. */
+  void mode(sparse_triangular_solve_mode new_mode)
+  {
+    mode_ = new_mode;
+    if (!empty() && selected_mode() == SPARSE_TRIANGULAR_SOLVE_SYNC_FREE && dependents_row_buffer_.empty())
+      setup_dependents();
+  }
+
+  /** @brief Returns the substitution mode used by apply(). For SPARSE_TRIANGULAR_SOLVE_AUTO, synchronization-free substitution is used if the levels hold fewer than VIENNACL_TRIANGULAR_SYNC_FREE_ROWS_PER_LEVEL rows on average and the OpenMP threads do not outnumber the processors. */
+  sparse_triangular_solve_mode selected_mode() const
+  {
+    if (mode_ != SPARSE_TRIANGULAR_SOLVE_AUTO)
+      return mode_;
+#ifdef VIENNACL_WITH_OPENMP
+    // busy waiting stalls if threads are not running concurrently, hence only use it if there is a core for each thread:
+    if (omp_get_max_threads() > omp_get_num_procs())
+      return SPARSE_TRIANGULAR_SOLVE_LEVEL_SCHEDULED;
+#endif
+    if (size_ < levels() * VIENNACL_TRIANGULAR_SYNC_FREE_ROWS_PER_LEVEL)
+      return SPARSE_TRIANGULAR_SOLVE_SYNC_FREE;
+    return SPARSE_TRIANGULAR_SOLVE_LEVEL_SCHEDULED;
+  }
+
+  /** @brief Inplace substitution: Overwrites the right hand side 'vec' with the solution of the triangular system. */
+  void apply(viennacl::vector_base<NumericT> & vec) const
+  {
+    assert( (viennacl::traits::context(vec).memory_type() == viennacl::MAIN_MEMORY) && bool("Vector must reside in main memory for host-based substitution") );
+    assert( (vec.size() == size_) && bool("Size mismatch in triangular substitution") );
+
+    if (size_ == 0)
+      return;
+
+    NumericT * x = detail::extract_raw_pointer<NumericT>(vec.handle()) + viennacl::traits::start(vec);
+    vcl_size_t inc = viennacl::traits::stride(vec);
+
+#ifdef VIENNACL_WITH_OPENMP
+    if (col_buffer_.size() > VIENNACL_OPENMP_TRIANGULAR_MIN_SIZE && omp_get_max_threads() > 1)
+    {
+      if (selected_mode() == SPARSE_TRIANGULAR_SOLVE_SYNC_FREE && !dependents_row_buffer_.empty())
+        apply_sync_free(x, inc);
+      else
+        apply_level_scheduled(x, inc);
+      return;
+    }
+#endif
+
+    // single thread: plain substitution in level order
+    for (vcl_size_t i = 0; i < size_; ++i)
+      x[row_ids_[i] * inc] = substitute_row(x, inc, i);
+  }
+
+private:
+  /** @brief Substitution of one row at position i of the level order */
+  NumericT substitute_row(NumericT const * x, vcl_size_t inc, vcl_size_t i) const
+  {
+    NumericT vec_entry = x[row_ids_[i] * inc];
+    for (unsigned int j = row_buffer_[i]; j < row_buffer_[i+1]; ++j)
+      vec_entry -= x[col_buffer_[j] * inc] * elements_[j];
+    return is_unit_ ? vec_entry : vec_entry / diagonal_[i];
+  }
+
+#ifdef VIENNACL_WITH_OPENMP
+  /** @brief Processes the levels one after another, separated by a barrier */
+  void apply_level_scheduled(NumericT * x, vcl_size_t inc) const
+  {
+    long num_levels = static_cast<long>(levels());
+
+    #pragma omp parallel
+    for (long level = 0; level < num_levels; ++level)
+    {
+      // the implicit barrier at the end of the loop separates the levels:
+      #pragma omp for
+      for (long i = static_cast<long>(level_offsets_[static_cast<vcl_size_t>(level)]); i < static_cast<long>(level_offsets_[static_cast<vcl_size_t>(level) + 1]); ++i)
+        x[row_ids_[static_cast<vcl_size_t>(i)] * inc] = substitute_row(x, inc, static_cast<vcl_size_t>(i));
+    }
+  }
+
+  /** @brief Processes the rows in level order without barriers. Each row waits until the counter of its unresolved dependencies drops to zero, then decrements the counters of the rows depending on it.
+  *
+  * Rows are handed out to threads in chunks of increasing position in the level order. Since a row only depends on rows at smaller positions, the row with the smallest unresolved position can always proceed.
+  */
+  void apply_sync_free(NumericT * x, vcl_size_t inc) const
+  {
+    long num_rows = static_cast<long>(size_);
+    int * counters = &(dependency_counters_[0]);
+    unsigned int const * dependents_row_buffer = &(dependents_row_buffer_[0]);
+    unsigned int const * dependents = dependents_.size() > 0 ? &(dependents_[0]) : NULL;
+
+    #pragma omp parallel
+    {
+      #pragma omp for
+      for (long i = 0; i < num_rows; ++i)
+        counters[i] = static_cast<int>(row_buffer_[static_cast<vcl_size_t>(i) + 1] - row_buffer_[static_cast<vcl_size_t>(i)]);
+
+      #pragma omp for schedule(dynamic, VIENNACL_TRIANGULAR_SYNC_FREE_CHUNK_SIZE)
+      for (long i = 0; i < num_rows; ++i)
+      {
+        // wait for dependencies:
+        for (;;)
+        {
+          int open_dependencies;
+          #pragma omp atomic read
+          open_dependencies = counters[i];
+          if (open_dependencies == 0)
+            break;
+        }
+        #pragma omp flush
+
+        x[row_ids_[static_cast<vcl_size_t>(i)] * inc] = substitute_row(x, inc, static_cast<vcl_size_t>(i));
+
+        // resolve dependencies of other rows:
+        #pragma omp flush
+        for (unsigned int j = dependents_row_buffer[i]; j < dependents_row_buffer[i+1]; ++j)
+        {
+          #pragma omp atomic
+          counters[dependents[j]] -= 1;
+        }
+      }
+    }
+  }
+#endif
+
+  /** @brief Sets up the rows depending on each row (i.e. the transposed pattern, in level order positions) for synchronization-free substitution */
+  void setup_dependents()
+  {
+    std::vector<unsigned int> position(size_);
+    for (vcl_size_t i = 0; i < size_; ++i)
+      position[row_ids_[i]] = static_cast<unsigned int>(i);
+
+    dependents_row_buffer_.assign(size_ + 1, 0);
+    for (vcl_size_t j = 0; j < col_buffer_.size(); ++j)
+      dependents_row_buffer_[position[col_buffer_[j]] + 1] += 1;
+    for (vcl_size_t i = 0; i < size_; ++i)
+      dependents_row_buffer_[i+1] += dependents_row_buffer_[i];
+
+    dependents_.resize(col_buffer_.size());
+    std::vector<unsigned int> write_pos(dependents_row_buffer_.begin(), dependents_row_buffer_.end() - 1);
+    for (vcl_size_t i = 0; i < size_; ++i)
+      for (unsigned int j = row_buffer_[i]; j < row_buffer_[i+1]; ++j)
+        dependents_[write_pos[position[col_buffer_[j]]]++] = static_cast<unsigned int>(i);
+
+    dependency_counters_.resize(size_);
+  }
+
+private:
+  void init_impl(unsigned int const * A_row_buffer, unsigned int const * A_col_buffer, NumericT const * A_elements, vcl_size_t n,
+                 bool is_lower, bool is_unit, bool transposed)
+  {
+    size_ = n;
+    is_lower_ = is_lower;
+    is_unit_ = is_unit;
+
+    //
+    // Stage 1: Extract the triangle of A or trans(A) in natural row order, with the diagonal held separately
+    //
+    std::vector<unsigned int> tri_row_buffer(n + 1, 0);
+    std::vector<unsigned int> tri_col_buffer;
+    std::vector<NumericT>     tri_elements;
+    std::vector<NumericT>     diagonal(is_unit ? 0 : n, NumericT(0));
+
+    if (!transposed)
+    {
+      for (vcl_size_t row = 0; row < n; ++row)
+      {
+        for (unsigned int j = A_row_buffer[row]; j < A_row_buffer[row+1]; ++j)
+        {
+          vcl_size_t col = A_col_buffer[j];
+          if (is_lower ? (col < row) : (col > row))
+          {
+            tri_col_buffer.push_back(static_cast<unsigned int>(col));
+            tri_elements.push_back(A_elements[j]);
+          }
+          else if (col == row && !is_unit)
+            diagonal[row] = A_elements[j];
+        }
+        tri_row_buffer[row+1] = static_cast<unsigned int>(tri_col_buffer.size());
+      }
+    }
+    else // row i of trans(A) is column i of A, collected by a counting sort:
+    {
+      for (vcl_size_t row = 0; row < n; ++row)
+        for (unsigned int j = A_row_buffer[row]; j < A_row_buffer[row+1]; ++j)
+        {
+          vcl_size_t col = A_col_buffer[j];
+          if (is_lower ? (row < col) : (row > col))
+            tri_row_buffer[col+1] += 1;
+          else if (col == row && !is_unit)
+            diagonal[row] = A_elements[j];
+        }
+
+      for (vcl_size_t i = 0; i < n; ++i)
+        tri_row_buffer[i+1] += tri_row_buffer[i];
+
+      tri_col_buffer.resize(tri_row_buffer[n]);
+      tri_elements.resize(tri_row_buffer[n]);
+      std::vector<unsigned int> write_pos(tri_row_buffer.begin(), tri_row_buffer.end() - 1);
+      for (vcl_size_t row = 0; row < n; ++row)
+        for (unsigned int j = A_row_buffer[row]; j < A_row_buffer[row+1]; ++j)
+        {
+          vcl_size_t col = A_col_buffer[j];
+          if (is_lower ? (row < col) : (row > col))
+          {
+            unsigned int pos = write_pos[col]++;
+            tri_col_buffer[pos] = static_cast<unsigned int>(row);
+            tri_elements[pos]   = A_elements[j];
+          }
+        }
+    }
+
+    //
+    // Stage 2: Level of each row is one more than the highest level among the rows it depends on
+    //
+    std::vector<unsigned int> row_level(n, 0);
+    unsigned int max_level = 0;
+    for (vcl_size_t k = 0; k < n; ++k)
+    {
+      vcl_size_t row = is_lower ? k : n - k - 1;
+      unsigned int level = 0;
+      for (unsigned int j = tri_row_buffer[row]; j < tri_row_buffer[row+1]; ++j)
+        level = std::max<unsigned int>(level, row_level[tri_col_buffer[j]] + 1);
+      row_level[row] = level;
+      max_level = std::max<unsigned int>(max_level, level);
+    }
+
+    //
+    // Stage 3: Sort rows by level (counting sort, rows within a level remain in increasing order)
+    //
+    level_offsets_.assign(n > 0 ? max_level + 2 : 1, 0);
+    for (vcl_size_t row = 0; row < n; ++row)
+      level_offsets_[row_level[row] + 1] += 1;
+    for (vcl_size_t i = 1; i < level_offsets_.size(); ++i)
+      level_offsets_[i] += level_offsets_[i-1];
+
+    row_ids_.resize(n);
+    std::vector<vcl_size_t> write_pos(level_offsets_.begin(), level_offsets_.end() - 1);
+    for (vcl_size_t row = 0; row < n; ++row)
+      row_ids_[write_pos[row_level[row]]++] = static_cast<unsigned int>(row);
+
+    //
+    // Stage 4: Copy rows to level-ordered CSR
+    //
+    row_buffer_.resize(n + 1);
+    row_buffer_[0] = 0;
+    for (vcl_size_t i = 0; i < n; ++i)
+      row_buffer_[i+1] = row_buffer_[i] + (tri_row_buffer[row_ids_[i] + 1] - tri_row_buffer[row_ids_[i]]);
+
+    col_buffer_.resize(tri_col_buffer.size());
+    elements_.resize(tri_elements.size());
+    diagonal_.resize(diagonal.size());
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (tri_col_buffer.size() > VIENNACL_OPENMP_TRIANGULAR_MIN_SIZE)
+#endif
+    for (long i = 0; i < static_cast<long>(n); ++i)
+    {
+      vcl_size_t row = row_ids_[static_cast<vcl_size_t>(i)];
+      unsigned int offset = row_buffer_[static_cast<vcl_size_t>(i)];
+      for (unsigned int j = tri_row_buffer[row]; j < tri_row_buffer[row+1]; ++j, ++offset)
+      {
+        col_buffer_[offset] = tri_col_buffer[j];
+        elements_[offset]   = tri_elements[j];
+      }
+      if (!is_unit)
+        diagonal_[static_cast<vcl_size_t>(i)] = diagonal[row];
+    }
+
+    dependents_row_buffer_.clear();
+    dependents_.clear();
+    dependency_counters_.clear();
+    if (selected_mode() == SPARSE_TRIANGULAR_SOLVE_SYNC_FREE)
+      setup_dependents();
+  }
+
+  vcl_size_t                   size_;
+  bool                         is_lower_;
+  bool                         is_unit_;
+  sparse_triangular_solve_mode mode_;
+  std::vector<vcl_size_t>      level_offsets_;
+  std::vector<unsigned int>    row_ids_;
+  std::vector<unsigned int>    row_buffer_;
+  std::vector<unsigned int>    col_buffer_;
+  std::vector<NumericT>        elements_;
+  std::vector<NumericT>        diagonal_;
+
+  // synchronization-free substitution:
+  std::vector<unsigned int>    dependents_row_buffer_;
+  std::vector<unsigned int>    dependents_;
+  mutable std::vector<int>     dependency_counters_;
+};
+
+} // namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
@@ -0,0 +1,409 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SPGEMM_ROW_KERNELS_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SPGEMM_ROW_KERNELS_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/spgemm_row_kernels.hpp
+    @brief Hash-based and heap-based kernels for computing a single row of a sparse matrix-matrix product C = A * B, and the selection among the available kernels.
+
+    Both kernels provide a symbolic variant (returning the number of nonzeros in the row of C) and a numeric variant (writing the sorted row of C).
+    In contrast to the merge kernels in spgemm_vector.hpp used for the full matrix, the work buffers only depend on the current row:
+      - Hash: A table of size O(min(upper bound, B.size2())), where the upper bound is the number of products in the row.
+      - Heap: A heap with one entry per nonzero in the row of A, independent of the length of the rows of B.
+*/
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "viennacl/forwards.h"
+
+/** @brief Rows of C with at most this many products are computed by the merge kernel, which is fastest for short rows. */
+#ifndef VIENNACL_SPGEMM_MERGE_MAX_ENTRIES
+  #define VIENNACL_SPGEMM_MERGE_MAX_ENTRIES 256
+#endif
+
+/** @brief Rows of C with a larger number of candidate columns than this use the heap kernel rather than the hash kernel in order to bound the size of the per-thread work buffers. */
+#ifndef VIENNACL_SPGEMM_HASH_MAX_ENTRIES
+  #define VIENNACL_SPGEMM_HASH_MAX_ENTRIES 262144
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+
+/** @brief The kernels available for computing the sparse matrix-matrix product of two compressed_matrix objects in the host backend. */
+enum spgemm_kernel_type
+{
+  SPGEMM_KERNEL_AUTO = 0, // choose merge, hash, or heap for each row of C
+  SPGEMM_KERNEL_MERGE,    // merge of the rows of B in work buffers sized to the longest row of C
+  SPGEMM_KERNEL_HASH,     // accumulation in a per-row hash table
+  SPGEMM_KERNEL_HEAP      // k-way merge of the rows of B using a heap
+};
+
+namespace detail
+{
+  inline spgemm_kernel_type & spgemm_kernel_setting()
+  {
+    static spgemm_kernel_type kernel = SPGEMM_KERNEL_AUTO;
+    return kernel;
+  }
+}
+
+/** @brief Selects the kernel used for C = prod(A, B) with compressed_matrix operands in the host backend. Default: SPGEMM_KERNEL_AUTO */
+inline void set_spgemm_kernel(spgemm_kernel_type kernel) { detail::spgemm_kernel_setting() = kernel; }
+
+/** @brief Returns the kernel used for C = prod(A, B) with compressed_matrix operands in the host backend. */
+inline spgemm_kernel_type spgemm_kernel() { return detail::spgemm_kernel_setting(); }
+
+/** @brief Chooses the kernel for a single row of C based on the number of nonzeros in the row of A and the upper bound for the number of nonzeros in the row of C.
+*
+*  - Up to two nonzeros in A or short rows of C: Merge, which has the lowest overhead.
+*  - Moderately long rows of C: Hash, which needs O(1) operations per product.
+*  - Otherwise: Heap, which only requires a work buffer proportional to the row of A.
+*/
+inline spgemm_kernel_type spgemm_select_row_kernel(unsigned int row_A_nnz, unsigned int row_C_upper_bound, unsigned int B_size2)
+{
+  if (row_A_nnz <= 2 || row_C_upper_bound <= VIENNACL_SPGEMM_MERGE_MAX_ENTRIES)
+    return SPGEMM_KERNEL_MERGE;
+  if (std::min(row_C_upper_bound, B_size2) <= VIENNACL_SPGEMM_HASH_MAX_ENTRIES)
+    return SPGEMM_KERNEL_HASH;
+  return SPGEMM_KERNEL_HEAP;
+}
+
+
+//
+// Hash kernel
+//
+
+/** @brief Marker for unused slots in the hash table. Not a valid column index. */
+static const unsigned int spgemm_hash_empty = ~0u;
+
+/** @brief Returns the size (a power of two) of the hash table for a row of C, such that the load factor does not exceed 1/2. */
+inline unsigned int row_C_hash_table_size(unsigned int row_C_upper_bound, unsigned int B_size2)
+{
+  unsigned int max_entries = std::min(row_C_upper_bound, B_size2);
+  unsigned int table_size = 16;
+  while (table_size < 2 * max_entries)
+    table_size *= 2;
+  return table_size;
+}
+
+inline unsigned int row_C_hash_slot(unsigned int col, unsigned int mask) { return (col * 107u) & mask; }
+
+/** @brief Returns the number of nonzeros in row C(i, :) = A(i, :) * B using a hash table with table_size slots. */
+inline unsigned int row_C_hash_symbolic(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                                        unsigned int const *B_row_buffer, unsigned int const *B_col_buffer,
+                                        unsigned int table_size, unsigned int *table_keys)
+{
+  unsigned int mask = table_size - 1;
+  std::fill(table_keys, table_keys + table_size, spgemm_hash_empty);
+
+  unsigned int num_entries = 0;
+  for (unsigned int j = row_start_A; j < row_end_A; ++j)
+  {
+    unsigned int row_B = A_col_buffer[j];
+    for (unsigned int k = B_row_buffer[row_B]; k < B_row_buffer[row_B + 1]; ++k)
+    {
+      unsigned int col = B_col_buffer[k];
+      unsigned int slot = row_C_hash_slot(col, mask);
+      while (table_keys[slot] != col)
+      {
+        if (table_keys[slot] == spgemm_hash_empty)
+        {
+          table_keys[slot] = col;
+          ++num_entries;
+          break;
+        }
+        slot = (slot + 1) & mask;
+      }
+    }
+  }
+
+  return num_entries;
+}
+
+/** @brief Computes row C(i, :) = A(i, :) * B using a hash table with table_size slots. The column indices are written in ascending order. */
+template<typename NumericT>
+void row_C_hash_numeric(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer, NumericT const *A_elements,
+                        unsigned int const *B_row_buffer, unsigned int const *B_col_buffer, NumericT const *B_elements,
+                        unsigned int table_size, unsigned int *table_keys, NumericT *table_values,
+                        unsigned int *C_col_buffer, NumericT *C_elements)
+{
+  unsigned int mask = table_size - 1;
+  std::fill(table_keys, table_keys + table_size, spgemm_hash_empty);
+
+  for (unsigned int j = row_start_A; j < row_end_A; ++j)
+  {
+    unsigned int row_B = A_col_buffer[j];
+    NumericT val_A = A_elements[j];
+    for (unsigned int k = B_row_buffer[row_B]; k < B_row_buffer[row_B + 1]; ++k)
+    {
+      unsigned int col = B_col_buffer[k];
+      unsigned int slot = row_C_hash_slot(col, mask);
+      while (table_keys[slot] != col && table_keys[slot] != spgemm_hash_empty)
+        slot = (slot + 1) & mask;
+
+      if (table_keys[slot] == col)
+        table_values[slot] += val_A * B_elements[k];
+      else
+      {
+        table_keys[slot] = col;
+        table_values[slot] = val_A * B_elements[k];
+      }
+    }
+  }
+
+  // gather and sort column indices, then look up the values:
+  unsigned int num_entries = 0;
+  for (unsigned int slot = 0; slot < table_size; ++slot)
+    if (table_keys[slot] != spgemm_hash_empty)
+      C_col_buffer[num_entries++] = table_keys[slot];
+
+  std::sort(C_col_buffer, C_col_buffer + num_entries);
+
+  for (unsigned int i = 0; i < num_entries; ++i)
+  {
+    unsigned int col = C_col_buffer[i];
+    unsigned int slot = row_C_hash_slot(col, mask);
+    while (table_keys[slot] != col)
+      slot = (slot + 1) & mask;
+    C_elements[i] = table_values[slot];
+  }
+}
+
+
+//
+// Heap kernel
+//
+
+/** @brief Heap entries consist of the current column index and the position of the respective nonzero in the row of A. */
+typedef std::pair<unsigned int, unsigned int>   spgemm_heap_entry;
+
+/** @brief Initializes the min-heap with the first column index of each row of B referenced by A(i, :). heap_positions[j] holds the current position in the row of B for the j-th nonzero of A(i, :). */
+inline void row_C_heap_init(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                            unsigned int const *B_row_buffer, unsigned int const *B_col_buffer,
+                            std::vector<spgemm_heap_entry> & heap, std::vector<unsigned int> & heap_positions)
+{
+  heap.clear();
+  heap_positions.resize(row_end_A - row_start_A);
+  for (unsigned int j = row_start_A; j < row_end_A; ++j)
+  {
+    unsigned int row_B = A_col_buffer[j];
+    heap_positions[j - row_start_A] = B_row_buffer[row_B];
+    if (B_row_buffer[row_B] < B_row_buffer[row_B + 1])
+      heap.push_back(spgemm_heap_entry(B_col_buffer[B_row_buffer[row_B]], j - row_start_A));
+  }
+  std::make_heap(heap.begin(), heap.end(), std::greater<spgemm_heap_entry>());
+}
+
+/** @brief Removes the smallest entry from the heap and inserts the next column index from the same row of B (if any). Returns the position in B of the removed entry. */
+inline unsigned int row_C_heap_advance(unsigned int row_start_A, unsigned int const *A_col_buffer,
+                                       unsigned int const *B_row_buffer, unsigned int const *B_col_buffer,
+                                       std::vector<spgemm_heap_entry> & heap, std::vector<unsigned int> & heap_positions)
+{
+  std::pop_heap(heap.begin(), heap.end(), std::greater<spgemm_heap_entry>());
+  unsigned int index_A = heap.back().second;
+  unsigned int pos_B = heap_positions[index_A]++;
+
+  if (heap_positions[index_A] < B_row_buffer[A_col_buffer[row_start_A + index_A] + 1])
+  {
+    heap.back().first = B_col_buffer[heap_positions[index_A]];
+    std::push_heap(heap.begin(), heap.end(), std::greater<spgemm_heap_entry>());
+  }
+  else
+    heap.pop_back();
+
+  return pos_B;
+}
+
+/** @brief Returns the number of nonzeros in row C(i, :) = A(i, :) * B using a k-way merge of the rows of B. */
+inline unsigned int row_C_heap_symbolic(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                                        unsigned int const *B_row_buffer, unsigned int const *B_col_buffer,
+                                        std::vector<spgemm_heap_entry> & heap, std::vector<unsigned int> & heap_positions)
+{
+  row_C_heap_init(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer, heap, heap_positions);
+
+  unsigned int num_entries = 0;
+  unsigned int last_col = spgemm_hash_empty;
+  while (!heap.empty())
+  {
+    unsigned int col = heap.front().first;
+    if (col != last_col)
+    {
+      ++num_entries;
+      last_col = col;
+    }
+    row_C_heap_advance(row_start_A, A_col_buffer, B_row_buffer, B_col_buffer, heap, heap_positions);
+  }
+
+  return num_entries;
+}
+
+/** @brief Computes row C(i, :) = A(i, :) * B using a k-way merge of the rows of B. The column indices are written in ascending order. */
+template<typename NumericT>
+void row_C_heap_numeric(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer, NumericT const *A_elements,
+                        unsigned int const *B_row_buffer, unsigned int const *B_col_buffer, NumericT const *B_elements,
+                        std::vector<spgemm_heap_entry> & heap, std::vector<unsigned int> & heap_positions,
+                        unsigned int *C_col_buffer, NumericT *C_elements)
+{
+  row_C_heap_init(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer, heap, heap_positions);
+
+  long num_entries = -1;
+  unsigned int last_col = spgemm_hash_empty;
+  while (!heap.empty())
+  {
+    unsigned int col     = heap.front().first;
+    unsigned int index_A = heap.front().second;
+    unsigned int pos_B = row_C_heap_advance(row_start_A, A_col_buffer, B_row_buffer, B_col_buffer, heap, heap_positions);
+
+    NumericT value = A_elements[row_start_A + index_A] * B_elements[pos_B];
+    if (col != last_col)
+    {
+      ++num_entries;
+      C_col_buffer[num_entries] = col;
+      C_elements[num_entries] = value;
+      last_col = col;
+    }
+    else
+      C_elements[num_entries] += value;
+  }
+}
+
+
+/** @brief Splits the rows [0, size) into num_chunks contiguous chunks carrying approximately equal work, where flop_offsets is the exclusive prefix sum (of length size+1) of the work per row.
+*
+* @param flop_offsets   Exclusive prefix sum of the number of products per row
+* @param num_chunks     Number of chunks requested
+* @param chunk_starts   First row of each chunk. Has num_chunks+1 entries on return, the last one being the number of rows.
+*/
+inline void spgemm_flop_balanced_chunks(std::vector<vcl_size_t> const & flop_offsets, vcl_size_t num_chunks, std::vector<vcl_size_t> & chunk_starts)
+{
+  vcl_size_t size = flop_offsets.size() - 1;
+  vcl_size_t total_flops = flop_offsets[size];
+  if (num_chunks < 1)
+    num_chunks = 1;
+
+  chunk_starts.resize(num_chunks + 1);
+  chunk_starts[0] = 0;
+  for (vcl_size_t i = 1; i < num_chunks; ++i)
+  {
+    // add one per row so that rows without work are also distributed:
+    vcl_size_t target = (total_flops + size) / num_chunks * i;
+    vcl_size_t lower = chunk_starts[i-1];
+    vcl_size_t upper = size;
+    while (lower < upper) // first row r with flop_offsets[r] + r >= target
+    {
+      vcl_size_t mid = (lower + upper) / 2;
+      if (flop_offsets[mid] + mid < target)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+    chunk_starts[i] = lower;
+  }
+  chunk_starts[num_chunks] = size;
+}
+
+/** @brief Captures the symbolic phase of a sparse matrix-matrix product C = A * B for the repeated computation of products with the same sparsity patterns.
+*
+* Holds the row pointers and column indices of C, the partitioning of the rows of C into chunks with about the same number of products,
+* and the per-thread work buffers of the numeric phase. Set up by prod_symbolic() and used by prod_numeric().
+*/
+class spgemm_plan
+{
+public:
+  spgemm_plan() : size1_(0), size2_(0), A_nnz_(0), B_nnz_(0) {}
+
+  /** @brief Returns true if the plan has not been set up by prod_symbolic() yet */
+  bool empty() const { return row_indices_.empty(); }
+
+  /** @brief Number of rows of C */
+  vcl_size_t size1() const { return size1_; }
+  /** @brief Number of columns of C */
+  vcl_size_t size2() const { return size2_; }
+  /** @brief Number of nonzeros of C */
+  vcl_size_t nnz() const { return col_indices_.size(); }
+
+  /** @brief Number of nonzeros of the left factor A the plan has been set up for */
+  vcl_size_t lhs_nnz() const { return A_nnz_; }
+  /** @brief Number of nonzeros of the right factor B the plan has been set up for */
+  vcl_size_t rhs_nnz() const { return B_nnz_; }
+
+  /** @brief Row pointers of C */
+  std::vector<unsigned int>       & row_indices()       { return row_indices_; }
+  std::vector<unsigned int> const & row_indices() const { return row_indices_; }
+
+  /** @brief Column indices of C */
+  std::vector<unsigned int>       & col_indices()       { return col_indices_; }
+  std::vector<unsigned int> const & col_indices() const { return col_indices_; }
+
+  /** @brief First row of each chunk of rows of C, with an additional entry holding the number of rows of C */
+  std::vector<vcl_size_t>       & chunk_starts()       { return chunk_starts_; }
+  std::vector<vcl_size_t> const & chunk_starts() const { return chunk_starts_; }
+
+  /** @brief Work buffer of the numeric phase for thread 'id', mapping a column index of C to its position in the current row of C */
+  std::vector<unsigned int> & work_buffer(vcl_size_t id) { return work_buffers_[id]; }
+
+  /** @brief Ensures that work buffers for at least 'num_threads' threads are available. Buffers are allocated lazily by the numeric phase. */
+  void reserve_work_buffers(vcl_size_t num_threads)
+  {
+    if (work_buffers_.size() < num_threads)
+      work_buffers_.resize(num_threads);
+  }
+
+  /** @brief Sets the dimensions of the operands and of C. Work buffers of a previous setup are released. */
+  void init(vcl_size_t size1, vcl_size_t size2, vcl_size_t A_nnz, vcl_size_t B_nnz)
+  {
+    size1_ = size1;
+    size2_ = size2;
+    A_nnz_ = A_nnz;
+    B_nnz_ = B_nnz;
+    std::vector<std::vector<unsigned int> >().swap(work_buffers_);
+  }
+
+  /** @brief Releases all data, so that the plan is empty() afterwards */
+  void clear()
+  {
+    init(0, 0, 0, 0);
+    std::vector<unsigned int>().swap(row_indices_);
+    std::vector<unsigned int>().swap(col_indices_);
+    std::vector<vcl_size_t>().swap(chunk_starts_);
+  }
+
+private:
+  vcl_size_t size1_;
+  vcl_size_t size2_;
+  vcl_size_t A_nnz_;
+  vcl_size_t B_nnz_;
+  std::vector<unsigned int> row_indices_;
+  std::vector<unsigned int> col_indices_;
+  std::vector<vcl_size_t>   chunk_starts_;
+  std::vector<std::vector<unsigned int> > work_buffers_;
+};
+
+} // namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
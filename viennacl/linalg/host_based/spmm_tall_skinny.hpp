@@ -0,0 +1,320 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SPMM_TALL_SKINNY_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SPMM_TALL_SKINNY_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/spmm_tall_skinny.hpp
+    @brief Column-blocked products of sparse matrices with tall and skinny dense matrices C = A * B in the host backend.
+
+    The columns of B are processed in blocks of K = 16, 8, 4, 2, or 1 columns, where K is a compile-time constant.
+    Each nonzero of A is read once per block and updates K accumulators held in registers, so A is read at most k/16 + 4 times for a matrix B with k columns instead of k times.
+    The kernels are most efficient if the entries within a row of B are adjacent in memory, i.e. for a row-major B or for trans(B) with a column-major B.
+*/
+
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/start.hpp"
+#include "viennacl/traits/stride.hpp"
+#include "viennacl/linalg/host_based/common.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+  /** @brief Strided view of a dense matrix in main memory: Entry (i, j) is located at data[i * row_inc + j * col_inc]. */
+  template<typename NumericT>
+  struct dense_strided_view
+  {
+    dense_strided_view(NumericT * data_, vcl_size_t row_inc_, vcl_size_t col_inc_) : data(data_), row_inc(row_inc_), col_inc(col_inc_) {}
+
+    NumericT * data;
+    vcl_size_t row_inc;
+    vcl_size_t col_inc;
+  };
+
+  /** @brief Returns the strided view of a dense matrix in main memory */
+  template<typename NumericT, typename MatrixT>
+  dense_strided_view<NumericT> make_dense_strided_view(MatrixT & mat)
+  {
+    NumericT * data = extract_raw_pointer<NumericT>(mat);
+    if (mat.row_major())
+      return dense_strided_view<NumericT>(data + viennacl::traits::start1(mat) * viennacl::traits::internal_size2(mat) + viennacl::traits::start2(mat),
+                                          viennacl::traits::stride1(mat) * viennacl::traits::internal_size2(mat),
+                                          viennacl::traits::stride2(mat));
+    return dense_strided_view<NumericT>(data + viennacl::traits::start1(mat) + viennacl::traits::start2(mat) * viennacl::traits::internal_size1(mat),
+                                        viennacl::traits::stride1(mat),
+                                        viennacl::traits::stride2(mat) * viennacl::traits::internal_size1(mat));
+  }
+
+  /** @brief Returns the strided view of the transpose of a dense matrix in main memory */
+  template<typename NumericT, typename MatrixT>
+  dense_strided_view<NumericT> make_transposed_dense_strided_view(MatrixT & mat)
+  {
+    dense_strided_view<NumericT> view = make_dense_strided_view<NumericT>(mat);
+    return dense_strided_view<NumericT>(view.data, view.col_inc, view.row_inc);
+  }
+
+  /** @brief Adds val * B(b_row, col_offset:col_offset+K) to the K accumulators. UnitStrideB indicates that the entries within a row of B are adjacent. */
+  template<unsigned int K, bool UnitStrideB, typename NumericT>
+  inline void spmm_tall_skinny_update(NumericT * sum, NumericT val, dense_strided_view<NumericT const> const & B, vcl_size_t b_row, vcl_size_t col_offset)
+  {
+    vcl_size_t b_inc = UnitStrideB ? 1 : B.col_inc;
+    NumericT const * b = B.data + b_row * B.row_inc + col_offset * b_inc;
+    for (unsigned int j = 0; j < K; ++j)
+      sum[j] += val * b[j * b_inc];
+  }
+
+  /** @brief Writes the K accumulators to C(row, col_offset:col_offset+K) */
+  template<unsigned int K, typename NumericT>
+  inline void spmm_tall_skinny_store(NumericT const * sum, dense_strided_view<NumericT> const & C, vcl_size_t row, vcl_size_t col_offset)
+  {
+    NumericT * c = C.data + row * C.row_inc + col_offset * C.col_inc;
+    for (unsigned int j = 0; j < K; ++j)
+      c[j * C.col_inc] = sum[j];
+  }
+
+
+  /** @brief Column block kernel for a CSR matrix */
+  template<typename NumericT>
+  struct csr_spmm_tall_skinny_kernel
+  {
+    csr_spmm_tall_skinny_kernel(unsigned int const * row_buffer, unsigned int const * col_buffer, NumericT const * elements, vcl_size_t num_rows)
+      : row_buffer_(row_buffer), col_buffer_(col_buffer), elements_(elements), num_rows_(num_rows) {}
+
+    template<unsigned int K, bool UnitStrideB>
+    void apply(dense_strided_view<NumericT const> const & B, dense_strided_view<NumericT> const & C, vcl_size_t col_offset) const
+    {
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long row2 = 0; row2 < static_cast<long>(num_rows_); ++row2)
+      {
+        vcl_size_t row = static_cast<vcl_size_t>(row2);
+        NumericT sum[K];
+        for (unsigned int j = 0; j < K; ++j)
+          sum[j] = 0;
+
+        vcl_size_t row_end = row_buffer_[row+1];
+        for (vcl_size_t k = row_buffer_[row]; k < row_end; ++k)
+          spmm_tall_skinny_update<K, UnitStrideB>(sum, elements_[k], B, col_buffer_[k], col_offset);
+
+        spmm_tall_skinny_store<K>(sum, C, row, col_offset);
+      }
+    }
+
+    unsigned int const * row_buffer_;
+    unsigned int const * col_buffer_;
+    NumericT     const * elements_;
+    vcl_size_t num_rows_;
+  };
+
+  /** @brief Column block kernel for an ELL matrix */
+  template<typename NumericT>
+  struct ell_spmm_tall_skinny_kernel
+  {
+    ell_spmm_tall_skinny_kernel(unsigned int const * coords, NumericT const * elements, vcl_size_t num_rows, vcl_size_t internal_size1, vcl_size_t maxnnz)
+      : coords_(coords), elements_(elements), num_rows_(num_rows), internal_size1_(internal_size1), maxnnz_(maxnnz) {}
+
+    template<unsigned int K, bool UnitStrideB>
+    void apply(dense_strided_view<NumericT const> const & B, dense_strided_view<NumericT> const & C, vcl_size_t col_offset) const
+    {
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long row2 = 0; row2 < static_cast<long>(num_rows_); ++row2)
+      {
+        vcl_size_t row = static_cast<vcl_size_t>(row2);
+        NumericT sum[K];
+        for (unsigned int j = 0; j < K; ++j)
+          sum[j] = 0;
+
+        for (vcl_size_t item_id = 0; item_id < maxnnz_; ++item_id)
+        {
+          vcl_size_t offset = row + item_id * internal_size1_;
+          NumericT val = elements_[offset];
+          if (val < 0 || val > 0) // val != 0 without compiler warnings
+            spmm_tall_skinny_update<K, UnitStrideB>(sum, val, B, coords_[offset], col_offset);
+        }
+
+        spmm_tall_skinny_store<K>(sum, C, row, col_offset);
+      }
+    }
+
+    unsigned int const * coords_;
+    NumericT     const * elements_;
+    vcl_size_t num_rows_;
+    vcl_size_t internal_size1_;
+    vcl_size_t maxnnz_;
+  };
+
+  /** @brief Column block kernel for a sliced ELL (SELL-C-sigma) matrix. row_permutation holds the row stored at each position, or is NULL if the rows are not reordered. */
+  template<typename NumericT, typename IndexT>
+  struct sliced_ell_spmm_tall_skinny_kernel
+  {
+    sliced_ell_spmm_tall_skinny_kernel(IndexT const * columns_per_block, IndexT const * column_indices, IndexT const * block_start, NumericT const * elements,
+                                       IndexT const * row_permutation, vcl_size_t num_rows, vcl_size_t rows_per_block)
+      : columns_per_block_(columns_per_block), column_indices_(column_indices), block_start_(block_start), elements_(elements),
+        row_permutation_(row_permutation), num_rows_(num_rows), rows_per_block_(rows_per_block) {}
+
+    template<unsigned int K, bool UnitStrideB>
+    void apply(dense_strided_view<NumericT const> const & B, dense_strided_view<NumericT> const & C, vcl_size_t col_offset) const
+    {
+      vcl_size_t num_blocks = (num_rows_ + rows_per_block_ - 1) / rows_per_block_;
+
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long block_idx2 = 0; block_idx2 < static_cast<long>(num_blocks); ++block_idx2)
+      {
+        vcl_size_t block_idx = static_cast<vcl_size_t>(block_idx2);
+        vcl_size_t first_row = block_idx * rows_per_block_;
+        vcl_size_t rows_in_block = std::min<vcl_size_t>(rows_per_block_, num_rows_ - first_row);
+
+        for (vcl_size_t row_in_block = 0; row_in_block < rows_in_block; ++row_in_block)
+        {
+          NumericT sum[K];
+          for (unsigned int j = 0; j < K; ++j)
+            sum[j] = 0;
+
+          for (vcl_size_t column_entry = 0; column_entry < static_cast<vcl_size_t>(columns_per_block_[block_idx]); ++column_entry)
+          {
+            vcl_size_t offset = static_cast<vcl_size_t>(block_start_[block_idx]) + column_entry * rows_per_block_ + row_in_block;
+            NumericT val = elements_[offset];
+            if (val < 0 || val > 0) // val != 0 without compiler warnings
+              spmm_tall_skinny_update<K, UnitStrideB>(sum, val, B, static_cast<vcl_size_t>(column_indices_[offset]), col_offset);
+          }
+
+          vcl_size_t row = row_permutation_ ? static_cast<vcl_size_t>(row_permutation_[first_row + row_in_block]) : first_row + row_in_block;
+          spmm_tall_skinny_store<K>(sum, C, row, col_offset);
+        }
+      }
+    }
+
+    IndexT   const * columns_per_block_;
+    IndexT   const * column_indices_;
+    IndexT   const * block_start_;
+    NumericT const * elements_;
+    IndexT   const * row_permutation_;
+    vcl_size_t num_rows_;
+    vcl_size_t rows_per_block_;
+  };
+
+  /** @brief Column block kernel for a HYB matrix (ELL part plus CSR part) */
+  template<typename NumericT>
+  struct hyb_spmm_tall_skinny_kernel
+  {
+    hyb_spmm_tall_skinny_kernel(unsigned int const * coords, NumericT const * elements, vcl_size_t num_rows, vcl_size_t internal_size1, vcl_size_t ellnnz,
+                                unsigned int const * csr_row_buffer, unsigned int const * csr_col_buffer, NumericT const * csr_elements)
+      : coords_(coords), elements_(elements), num_rows_(num_rows), internal_size1_(internal_size1), ellnnz_(ellnnz),
+        csr_row_buffer_(csr_row_buffer), csr_col_buffer_(csr_col_buffer), csr_elements_(csr_elements) {}
+
+    template<unsigned int K, bool UnitStrideB>
+    void apply(dense_strided_view<NumericT const> const & B, dense_strided_view<NumericT> const & C, vcl_size_t col_offset) const
+    {
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long row2 = 0; row2 < static_cast<long>(num_rows_); ++row2)
+      {
+        vcl_size_t row = static_cast<vcl_size_t>(row2);
+        NumericT sum[K];
+        for (unsigned int j = 0; j < K; ++j)
+          sum[j] = 0;
+
+        // ELL part:
+        for (vcl_size_t item_id = 0; item_id < ellnnz_; ++item_id)
+        {
+          vcl_size_t offset = row + item_id * internal_size1_;
+          NumericT val = elements_[offset];
+          if (val < 0 || val > 0) // val != 0 without compiler warnings
+            spmm_tall_skinny_update<K, UnitStrideB>(sum, val, B, coords_[offset], col_offset);
+        }
+
+        // CSR part:
+        vcl_size_t row_end = csr_row_buffer_[row+1];
+        for (vcl_size_t k = csr_row_buffer_[row]; k < row_end; ++k)
+          spmm_tall_skinny_update<K, UnitStrideB>(sum, csr_elements_[k], B, csr_col_buffer_[k], col_offset);
+
+        spmm_tall_skinny_store<K>(sum, C, row, col_offset);
+      }
+    }
+
+    unsigned int const * coords_;
+    NumericT     const * elements_;
+    vcl_size_t num_rows_;
+    vcl_size_t internal_size1_;
+    vcl_size_t ellnnz_;
+    unsigned int const * csr_row_buffer_;
+    unsigned int const * csr_col_buffer_;
+    NumericT     const * csr_elements_;
+  };
+
+
+  /** @brief Computes C = A * B for the num_cols columns of B, processing blocks of 16, 8, 4, 2, and 1 columns with the supplied kernel for A. */
+  template<bool UnitStrideB, typename KernelT, typename NumericT>
+  void spmm_tall_skinny_blocks(KernelT const & kernel, dense_strided_view<NumericT const> const & B, dense_strided_view<NumericT> const & C, vcl_size_t num_cols)
+  {
+    vcl_size_t col_offset = 0;
+    for (; col_offset + 16 <= num_cols; col_offset += 16)
+      kernel.template apply<16, UnitStrideB>(B, C, col_offset);
+    if (col_offset + 8 <= num_cols)
+    {
+      kernel.template apply<8, UnitStrideB>(B, C, col_offset);
+      col_offset += 8;
+    }
+    if (col_offset + 4 <= num_cols)
+    {
+      kernel.template apply<4, UnitStrideB>(B, C, col_offset);
+      col_offset += 4;
+    }
+    if (col_offset + 2 <= num_cols)
+    {
+      kernel.template apply<2, UnitStrideB>(B, C, col_offset);
+      col_offset += 2;
+    }
+    if (col_offset < num_cols)
+      kernel.template apply<1, UnitStrideB>(B, C, col_offset);
+  }
+
+  /** @brief Computes C = A * B for a dense matrix B with num_cols columns given by its strided view. Dispatches on whether the entries within a row of B are adjacent. */
+  template<typename KernelT, typename NumericT>
+  void spmm_tall_skinny(KernelT const & kernel, dense_strided_view<NumericT const> const & B, dense_strided_view<NumericT> const & C, vcl_size_t num_cols)
+  {
+    if (B.col_inc == 1)
+      spmm_tall_skinny_blocks<true>(kernel, B, C, num_cols);
+    else
+      spmm_tall_skinny_blocks<false>(kernel, B, C, num_cols);
+  }
+
+} // namespace detail
+} // namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
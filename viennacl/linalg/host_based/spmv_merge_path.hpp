@@ -0,0 +1,227 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SPMV_MERGE_PATH_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SPMV_MERGE_PATH_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/spmv_merge_path.hpp
+    @brief Merge-path sparse matrix-vector product for CSR matrices with irregular row lengths, and the selection among the CSR SpMV kernels of the host backend.
+
+    The merge-path kernel (Merrill and Garland, SC'16) considers the row pointers and the nonzeros as two sorted lists which are merged.
+    The merge path of length rows + nonzeros is split into equally long pieces, one per thread, so that each thread processes the same amount of work irrespective of the row lengths.
+    Rows split between threads are summed up partially by each thread, the partial sums are added to the result in a sequential fix-up step.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "viennacl/forwards.h"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+/** @brief If the work (rows plus nonzeros) assigned to a thread by an even split of the rows exceeds the average work per thread by this factor, the merge-path kernel is used with CSR_SPMV_KERNEL_AUTO. */
+#ifndef VIENNACL_CSR_SPMV_MERGE_PATH_IMBALANCE
+  #define VIENNACL_CSR_SPMV_MERGE_PATH_IMBALANCE 1.5
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+
+/** @brief The kernels available for the sparse matrix-vector product with a compressed_matrix in the host backend. */
+enum csr_spmv_kernel_type
+{
+  CSR_SPMV_KERNEL_AUTO = 0,    // merge path for matrices on which an even split of the rows is imbalanced, row-wise otherwise
+  CSR_SPMV_KERNEL_ROW,         // one dot product per row, rows split evenly among threads
+  CSR_SPMV_KERNEL_MERGE_PATH   // rows plus nonzeros split evenly among threads
+};
+
+namespace detail
+{
+  inline csr_spmv_kernel_type & csr_spmv_kernel_setting()
+  {
+    static csr_spmv_kernel_type kernel = CSR_SPMV_KERNEL_AUTO;
+    return kernel;
+  }
+
+  inline vcl_size_t & csr_spmv_merge_path_parts_setting()
+  {
+    static vcl_size_t num_parts = 0;
+    return num_parts;
+  }
+}
+
+/** @brief Selects the kernel used for y = prod(A, x) with a compressed_matrix A in the host backend. Default: CSR_SPMV_KERNEL_AUTO */
+inline void set_csr_spmv_kernel(csr_spmv_kernel_type kernel) { detail::csr_spmv_kernel_setting() = kernel; }
+
+/** @brief Returns the kernel used for y = prod(A, x) with a compressed_matrix A in the host backend. */
+inline csr_spmv_kernel_type csr_spmv_kernel() { return detail::csr_spmv_kernel_setting(); }
+
+/** @brief Sets the number of pieces the merge path is split into, independent of the number of threads. Default: 0, which uses one piece per thread. */
+inline void set_csr_spmv_merge_path_parts(vcl_size_t num_parts) { detail::csr_spmv_merge_path_parts_setting() = num_parts; }
+
+/** @brief Returns the number of pieces the merge path is split into, or 0 if one piece per thread is used. */
+inline vcl_size_t csr_spmv_merge_path_parts() { return detail::csr_spmv_merge_path_parts_setting(); }
+
+namespace detail
+{
+  /** @brief Returns the number of threads among which the merge path is split */
+  inline vcl_size_t csr_spmv_num_threads()
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    return static_cast<vcl_size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+  }
+
+  /** @brief Decides whether the merge-path kernel should be used for a CSR matrix.
+  *
+  * Instead of computing the variance of the row lengths, the work of each thread under an even split of the rows is obtained from the row pointers at the chunk boundaries.
+  * This requires only O(threads) operations and directly reflects the load imbalance of the row-wise kernel.
+  */
+  inline bool csr_spmv_use_merge_path(unsigned int const * row_buffer, vcl_size_t num_rows)
+  {
+    if (num_rows == 0)
+      return false;
+
+    csr_spmv_kernel_type kernel = csr_spmv_kernel();
+    if (kernel != CSR_SPMV_KERNEL_AUTO)
+      return kernel == CSR_SPMV_KERNEL_MERGE_PATH;
+
+    vcl_size_t num_threads = csr_spmv_num_threads();
+    if (num_threads < 2 || num_rows < num_threads)
+      return false;
+
+    vcl_size_t total_work = num_rows + row_buffer[num_rows];
+    vcl_size_t max_work = 0;
+    for (vcl_size_t t = 0; t < num_threads; ++t)
+    {
+      vcl_size_t row_start = ( t      * num_rows) / num_threads;
+      vcl_size_t row_stop  = ((t + 1) * num_rows) / num_threads;
+      max_work = std::max<vcl_size_t>(max_work, (row_stop - row_start) + (row_buffer[row_stop] - row_buffer[row_start]));
+    }
+
+    return static_cast<double>(max_work) * static_cast<double>(num_threads) > VIENNACL_CSR_SPMV_MERGE_PATH_IMBALANCE * static_cast<double>(total_work);
+  }
+
+  /** @brief Finds the coordinate (row, nonzero index) at which the merge path crosses the given diagonal, i.e. the point after 'diagonal' merge steps. */
+  inline void csr_merge_path_search(vcl_size_t diagonal, unsigned int const * row_buffer, vcl_size_t num_rows, vcl_size_t nnz,
+                                    vcl_size_t & row, vcl_size_t & nz)
+  {
+    vcl_size_t lower = (diagonal > nnz) ? diagonal - nnz : 0;
+    vcl_size_t upper = std::min<vcl_size_t>(diagonal, num_rows);
+
+    // row ends are consumed before the nonzeros with the same index, hence the merge path takes a row end row_buffer[i+1] if row_buffer[i+1] <= diagonal - i - 1
+    while (lower < upper)
+    {
+      vcl_size_t pivot = (lower + upper) / 2;
+      if (row_buffer[pivot + 1] + pivot + 1 <= diagonal)
+        lower = pivot + 1;
+      else
+        upper = pivot;
+    }
+
+    row = lower;
+    nz  = diagonal - lower;
+  }
+
+  /** @brief Merge-path sparse matrix-vector product y = alpha * A * x + beta * y for a CSR matrix A.
+  *
+  * @param row_buffer   Row pointers of A
+  * @param col_buffer   Column indices of A
+  * @param elements     Nonzero entries of A
+  * @param num_rows     Number of rows of A
+  * @param x            Pointer to the first entry of x
+  * @param x_inc        Stride of x
+  * @param y            Pointer to the first entry of y
+  * @param y_inc        Stride of y
+  * @param alpha        Scaling factor for A * x
+  * @param beta         Scaling factor for y. If zero, y is not read.
+  * @param row_kernel   Kernel for the dot product of a contiguous range of nonzeros with x. Only used if x_inc is one.
+  */
+  template<typename NumericT, typename RowKernelT>
+  void csr_spmv_merge_path(unsigned int const * row_buffer, unsigned int const * col_buffer, NumericT const * elements, vcl_size_t num_rows,
+                           NumericT const * x, vcl_size_t x_inc,
+                           NumericT       * y, vcl_size_t y_inc,
+                           NumericT alpha, NumericT beta,
+                           RowKernelT row_kernel)
+  {
+    vcl_size_t nnz = row_buffer[num_rows];
+    vcl_size_t num_parts = (csr_spmv_merge_path_parts() > 0) ? csr_spmv_merge_path_parts() : csr_spmv_num_threads();
+    vcl_size_t num_threads = std::max<vcl_size_t>(1, std::min<vcl_size_t>(num_parts, num_rows + nnz));
+    vcl_size_t path_length = num_rows + nnz;
+    vcl_size_t items_per_thread = (path_length + num_threads - 1) / num_threads;
+    bool use_beta = (beta < 0 || beta > 0);
+
+    std::vector<vcl_size_t> carry_row(num_threads);
+    std::vector<NumericT>   carry_value(num_threads);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for schedule(static, 1)
+#endif
+    for (long t = 0; t < static_cast<long>(num_threads); ++t)
+    {
+      vcl_size_t diagonal_start = std::min<vcl_size_t>(static_cast<vcl_size_t>(t) * items_per_thread, path_length);
+      vcl_size_t diagonal_stop  = std::min<vcl_size_t>(diagonal_start + items_per_thread, path_length);
+
+      vcl_size_t row, nz, row_stop, nz_stop;
+      csr_merge_path_search(diagonal_start, row_buffer, num_rows, nnz, row, nz);
+      csr_merge_path_search(diagonal_stop,  row_buffer, num_rows, nnz, row_stop, nz_stop);
+
+      // rows completed by this thread:
+      for (; row < row_stop; ++row)
+      {
+        vcl_size_t row_end = row_buffer[row + 1];
+        NumericT dot_prod = 0;
+        if (x_inc == 1)
+          dot_prod = row_kernel(elements + nz, col_buffer + nz, x, row_end - nz);
+        else
+          for (vcl_size_t i = nz; i < row_end; ++i)
+            dot_prod += elements[i] * x[col_buffer[i] * x_inc];
+        nz = row_end;
+
+        y[row * y_inc] = use_beta ? alpha * dot_prod + beta * y[row * y_inc] : alpha * dot_prod;
+      }
+
+      // partial sum of the row continued by the next thread:
+      NumericT partial = 0;
+      for (; nz < nz_stop; ++nz)
+        partial += elements[nz] * x[col_buffer[nz] * x_inc];
+
+      carry_row[static_cast<vcl_size_t>(t)]   = row_stop;
+      carry_value[static_cast<vcl_size_t>(t)] = partial;
+    }
+
+    // fix-up: the thread completing a row has written y[row] already, add the partial sums of the preceding threads:
+    for (vcl_size_t t = 0; t < num_threads; ++t)
+      if (carry_row[t] < num_rows)
+        y[carry_row[t] * y_inc] += alpha * carry_value[t];
+  }
+}
+
+} // namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SPMV_SYMMETRIC_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SPMV_SYMMETRIC_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/spmv_symmetric.hpp
+    @brief Sparse matrix-vector product for symmetric matrices of which only the upper triangle is stored in CSR format.
+
+    Each stored entry A(i,j) with j > i contributes to two entries of the result: A(i,j) * x(j) to y(i) (gather) and A(i,j) * x(i) to y(j) (scatter).
+    The rows are split among the threads such that each thread processes about the same number of nonzeros.
+    In order to avoid write conflicts in the scatter step, each thread accumulates into a separate buffer covering its first row up to the largest column index referenced by its rows.
+    Since the scatter only targets rows below the current row, a row is complete once it has been processed by its thread, unless it is covered by the buffer of a preceding thread.
+    Complete rows are written to the result right away, only the remaining rows are summed up from the buffers in a second pass.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "viennacl/forwards.h"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+  /** @brief Computes y = alpha * A * x + beta * y for a symmetric matrix A of which the upper triangle (including the diagonal) is stored in CSR format.
+  *
+  * The column indices within each row must be sorted. x and y must not overlap.
+  *
+  * @param row_buffer   Row pointers of the upper triangle of A
+  * @param col_buffer   Column indices of the upper triangle of A, sorted within each row
+  * @param elements     Nonzero entries of the upper triangle of A
+  * @param size         Number of rows (and columns) of A
+  * @param x            Pointer to the first entry of x
+  * @param x_inc        Stride of x
+  * @param y            Pointer to the first entry of y
+  * @param y_inc        Stride of y
+  * @param alpha        Scaling factor for A * x
+  * @param beta         Scaling factor for y. If zero, y is not read.
+  * @param inner_prods  If not NULL, the inner products (A*x, A*x), (x, A*x), and (A*x, r0star) are written to the first three entries (for alpha = 1, beta = 0).
+  * @param r0star       Pointer to the vector r0star with unit stride for the third inner product. May be NULL.
+  */
+  template<typename NumericT>
+  void symmetric_csr_spmv(unsigned int const * row_buffer, unsigned int const * col_buffer, NumericT const * elements, vcl_size_t size,
+                          NumericT const * x, vcl_size_t x_inc,
+                          NumericT       * y, vcl_size_t y_inc,
+                          NumericT alpha, NumericT beta,
+                          NumericT * inner_prods = NULL, NumericT const * r0star = NULL)
+  {
+    vcl_size_t nnz = row_buffer[size];
+    bool use_beta = (beta < 0 || beta > 0);
+
+    vcl_size_t num_threads = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    if (nnz > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
+      num_threads = std::max<vcl_size_t>(1, std::min<vcl_size_t>(static_cast<vcl_size_t>(omp_get_max_threads()), size));
+#endif
+
+    // rows of each thread, such that each thread processes about the same number of nonzeros:
+    std::vector<vcl_size_t> row_starts(num_threads + 1);
+    row_starts[0] = 0;
+    row_starts[num_threads] = size;
+    for (vcl_size_t t = 1; t < num_threads; ++t)
+    {
+      vcl_size_t row = static_cast<vcl_size_t>(std::lower_bound(row_buffer, row_buffer + size, static_cast<unsigned int>((t * nnz) / num_threads)) - row_buffer);
+      row_starts[t] = std::max<vcl_size_t>(row_starts[t-1], row);
+    }
+
+    // the buffer of each thread ranges from its first row to the largest column index in its rows (the last entry of each row).
+    // Rows of a thread below the end of the buffers of all preceding threads are complete after the first pass.
+    std::vector<vcl_size_t> col_stops(num_threads);
+    std::vector<vcl_size_t> complete_starts(num_threads);
+    std::vector<vcl_size_t> buffer_offsets(num_threads + 1);
+    buffer_offsets[0] = 0;
+    vcl_size_t max_col_stop = 0;
+    for (vcl_size_t t = 0; t < num_threads; ++t)
+    {
+      vcl_size_t col_stop = row_starts[t+1];
+      for (vcl_size_t row = row_starts[t]; row < row_starts[t+1]; ++row)
+        if (row_buffer[row] < row_buffer[row+1])
+          col_stop = std::max<vcl_size_t>(col_stop, vcl_size_t(col_buffer[row_buffer[row+1] - 1]) + 1);
+      col_stops[t] = col_stop;
+      complete_starts[t] = std::min<vcl_size_t>(std::max<vcl_size_t>(row_starts[t], max_col_stop), row_starts[t+1]);
+      max_col_stop = std::max<vcl_size_t>(max_col_stop, col_stop);
+      buffer_offsets[t+1] = buffer_offsets[t] + (col_stop - row_starts[t]);
+    }
+
+    std::vector<NumericT> buffers(buffer_offsets[num_threads]);
+
+    NumericT inner_prod_ApAp = 0;
+    NumericT inner_prod_pAp = 0;
+    NumericT inner_prod_Ap_r0star = 0;
+
+    // first pass: gather and scatter into the thread-local buffers, write complete rows to y
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for schedule(static, 1) reduction(+: inner_prod_ApAp, inner_prod_pAp, inner_prod_Ap_r0star) if (num_threads > 1)
+#endif
+    for (long thread_id = 0; thread_id < static_cast<long>(num_threads); ++thread_id)
+    {
+      vcl_size_t t = static_cast<vcl_size_t>(thread_id);
+      NumericT * buffer = &(buffers[0]) + buffer_offsets[t] - row_starts[t]; // buffer[i] refers to row i
+
+      for (vcl_size_t row = row_starts[t]; row < row_starts[t+1]; ++row)
+      {
+        NumericT x_row = x[row * x_inc];
+        NumericT dot_prod = buffer[row];
+        for (vcl_size_t k = row_buffer[row]; k < row_buffer[row+1]; ++k)
+        {
+          vcl_size_t col = col_buffer[k];
+          dot_prod += elements[k] * x[col * x_inc];
+          if (col != row)
+            buffer[col] += elements[k] * x_row;
+        }
+
+        if (row < complete_starts[t])
+          buffer[row] = dot_prod;
+        else
+        {
+          if (inner_prods)
+          {
+            inner_prod_ApAp += dot_prod * dot_prod;
+            inner_prod_pAp  += x_row * dot_prod;
+            inner_prod_Ap_r0star += r0star ? dot_prod * r0star[row] : NumericT(0);
+          }
+
+          NumericT & y_row = y[row * y_inc];
+          y_row = use_beta ? alpha * dot_prod + beta * y_row : alpha * dot_prod;
+        }
+      }
+    }
+
+    // second pass: sum up the buffers overlapping with the remaining rows
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for schedule(static, 1) reduction(+: inner_prod_ApAp, inner_prod_pAp, inner_prod_Ap_r0star) if (num_threads > 1)
+#endif
+    for (long thread_id = 1; thread_id < static_cast<long>(num_threads); ++thread_id)
+    {
+      vcl_size_t owner = static_cast<vcl_size_t>(thread_id);
+      for (vcl_size_t row = row_starts[owner]; row < complete_starts[owner]; ++row)
+      {
+        NumericT value = 0;
+        for (vcl_size_t t = 0; t <= owner; ++t)
+          if (row < col_stops[t])
+            value += buffers[buffer_offsets[t] + row - row_starts[t]];
+
+        if (inner_prods)
+        {
+          inner_prod_ApAp += value * value;
+          inner_prod_pAp  += x[row * x_inc] * value;
+          inner_prod_Ap_r0star += r0star ? value * r0star[row] : NumericT(0);
+        }
+
+        NumericT & y_row = y[row * y_inc];
+        y_row = use_beta ? alpha * value + beta * y_row : alpha * value;
+      }
+    }
+
+    if (inner_prods)
+    {
+      inner_prods[0] = inner_prod_ApAp;
+      inner_prods[1] = inner_prod_pAp;
+      inner_prods[2] = inner_prod_Ap_r0star;
+    }
+  }
+}
+
+} // namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
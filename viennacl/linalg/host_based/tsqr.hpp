@@ -0,0 +1,241 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_TSQR_HPP_
+#define VIENNACL_LINALG_HOST_BASED_TSQR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/tsqr.hpp
+    @brief Tall-skinny QR factorization (TSQR) of dense matrices with few columns using OpenMP on the CPU.
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/start.hpp"
+#include "viennacl/traits/stride.hpp"
+#include "viennacl/linalg/host_based/common.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+
+namespace detail
+{
+  /** @brief Householder QR factorization of the m x k column-major array A in place.
+    *
+    * On return, R is stored in the upper triangle of A and the Householder vectors (with implicit unit first entry) below the diagonal.
+    */
+  inline void tsqr_householder_qr(double * A, vcl_size_t m, vcl_size_t k, double * tau)
+  {
+    vcl_size_t num_reflectors = std::min(m, k);
+    for (vcl_size_t j = 0; j < num_reflectors; ++j)
+    {
+      double * a_j = A + j * m;
+
+      double alpha = a_j[j];
+      double xnorm_squared = 0;
+      for (vcl_size_t i = j+1; i < m; ++i)
+        xnorm_squared += a_j[i] * a_j[i];
+
+      if (xnorm_squared <= 0)
+      {
+        tau[j] = 0;
+        continue;
+      }
+
+      double beta = std::sqrt(alpha * alpha + xnorm_squared);
+      if (alpha > 0)
+        beta = -beta;
+      tau[j] = (beta - alpha) / beta;
+
+      double scaling = 1.0 / (alpha - beta);
+      for (vcl_size_t i = j+1; i < m; ++i)
+        a_j[i] *= scaling;
+      a_j[j] = beta;
+
+      // apply reflector to the remaining columns:
+      for (vcl_size_t l = j+1; l < k; ++l)
+      {
+        double * a_l = A + l * m;
+        double w = a_l[j];
+        for (vcl_size_t i = j+1; i < m; ++i)
+          w += a_j[i] * a_l[i];
+        w *= tau[j];
+        a_l[j] -= w;
+        for (vcl_size_t i = j+1; i < m; ++i)
+          a_l[i] -= w * a_j[i];
+      }
+    }
+  }
+
+  /** @brief Overwrites the m x b_cols column-major array B with Q B, where Q is given by the reflectors computed by tsqr_householder_qr() */
+  inline void tsqr_apply_q(double const * A, vcl_size_t m, vcl_size_t k, double const * tau, double * B, vcl_size_t b_cols)
+  {
+    for (vcl_size_t j = std::min(m, k); j-- > 0; )
+    {
+      if (tau[j] == 0)
+        continue;
+
+      double const * a_j = A + j * m;
+      for (vcl_size_t l = 0; l < b_cols; ++l)
+      {
+        double * b_l = B + l * m;
+        double w = b_l[j];
+        for (vcl_size_t i = j+1; i < m; ++i)
+          w += a_j[i] * b_l[i];
+        w *= tau[j];
+        b_l[j] -= w;
+        for (vcl_size_t i = j+1; i < m; ++i)
+          b_l[i] -= w * a_j[i];
+      }
+    }
+  }
+
+  template<typename WrapperT>
+  void tsqr_impl(WrapperT & V, vcl_size_t m, vcl_size_t k, double * R)
+  {
+    // split the rows into chunks of at least 4k rows, one per thread:
+    vcl_size_t num_chunks = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    num_chunks = static_cast<vcl_size_t>(omp_get_max_threads());
+#endif
+    num_chunks = std::max<vcl_size_t>(1, std::min<vcl_size_t>(num_chunks, m / std::max<vcl_size_t>(4 * k, 1)));
+
+    std::vector<std::vector<double> > chunk_data(num_chunks);
+    std::vector<std::vector<double> > chunk_tau(num_chunks, std::vector<double>(k));
+
+    vcl_size_t stacked_rows = num_chunks * k;
+    std::vector<double> stacked(stacked_rows * k, 0.0);
+
+    // QR factorization of each chunk, R factors stacked on top of each other:
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (num_chunks > 1)
+#endif
+    for (long c2 = 0; c2 < static_cast<long>(num_chunks); ++c2)
+    {
+      vcl_size_t c = static_cast<vcl_size_t>(c2);
+      vcl_size_t row_start = (m * c) / num_chunks;
+      vcl_size_t rows      = (m * (c+1)) / num_chunks - row_start;
+
+      std::vector<double> & data = chunk_data[c];
+      data.resize(rows * k);
+      for (vcl_size_t l = 0; l < k; ++l)
+        for (vcl_size_t i = 0; i < rows; ++i)
+          data[l * rows + i] = static_cast<double>(V(row_start + i, l));
+
+      tsqr_householder_qr(&(data[0]), rows, k, &(chunk_tau[c][0]));
+
+      for (vcl_size_t l = 0; l < k; ++l)
+        for (vcl_size_t i = 0; i <= l && i < rows; ++i)
+          stacked[l * stacked_rows + c * k + i] = data[l * rows + i];
+    }
+
+    // QR factorization of the stacked R factors:
+    std::vector<double> stacked_tau(k);
+    tsqr_householder_qr(&(stacked[0]), stacked_rows, k, &(stacked_tau[0]));
+
+    std::vector<double> stacked_q(stacked_rows * k, 0.0);
+    for (vcl_size_t l = 0; l < k; ++l)
+      stacked_q[l * stacked_rows + l] = 1.0;
+    tsqr_apply_q(&(stacked[0]), stacked_rows, k, &(stacked_tau[0]), &(stacked_q[0]), k);
+
+    // R with nonnegative diagonal:
+    for (vcl_size_t i = 0; i < k; ++i)
+    {
+      double sign = (stacked[i * stacked_rows + i] < 0) ? -1.0 : 1.0;
+      for (vcl_size_t l = 0; l < k; ++l)
+        R[i * k + l] = (l >= i) ? sign * stacked[l * stacked_rows + i] : 0;
+      for (vcl_size_t r = 0; r < stacked_rows; ++r)
+        stacked_q[i * stacked_rows + r] *= sign;
+    }
+
+    // Q of each chunk times the respective block of the Q factor of the stacked R factors:
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if (num_chunks > 1)
+#endif
+    for (long c2 = 0; c2 < static_cast<long>(num_chunks); ++c2)
+    {
+      vcl_size_t c = static_cast<vcl_size_t>(c2);
+      vcl_size_t row_start = (m * c) / num_chunks;
+      vcl_size_t rows      = (m * (c+1)) / num_chunks - row_start;
+
+      std::vector<double> q(rows * k, 0.0);
+      for (vcl_size_t l = 0; l < k; ++l)
+        for (vcl_size_t i = 0; i < std::min(rows, k); ++i)
+          q[l * rows + i] = stacked_q[l * stacked_rows + c * k + i];
+
+      tsqr_apply_q(&(chunk_data[c][0]), rows, k, &(chunk_tau[c][0]), &(q[0]), k);
+
+      for (vcl_size_t l = 0; l < k; ++l)
+        for (vcl_size_t i = 0; i < rows; ++i)
+          V(row_start + i, l) = static_cast<typename WrapperT::value_type>(q[l * rows + i]);
+    }
+  }
+}
+
+/** @brief Computes the thin QR factorization V = Q R of a matrix with many more rows than columns, overwriting V with Q.
+  *
+  * The rows are split into one chunk per thread. Each chunk is factored by Householder QR, then the stacked R factors of the chunks are factored again.
+  * The computation is carried out in double precision.
+  *
+  * @param V    The tall and skinny matrix, overwritten by the orthonormal factor Q
+  * @param R    Array of size k*k for the upper triangular factor R with nonnegative diagonal (row-major), where k is the number of columns of V
+  */
+template<typename NumericT>
+void tsqr(matrix_base<NumericT> & V, double * R)
+{
+  vcl_size_t m = viennacl::traits::size1(V);
+  vcl_size_t k = viennacl::traits::size2(V);
+  if (m == 0 || k == 0)
+    return;
+
+  NumericT * data_V = detail::extract_raw_pointer<NumericT>(V);
+
+  vcl_size_t V_start1 = viennacl::traits::start1(V);
+  vcl_size_t V_start2 = viennacl::traits::start2(V);
+  vcl_size_t V_inc1   = viennacl::traits::stride1(V);
+  vcl_size_t V_inc2   = viennacl::traits::stride2(V);
+  vcl_size_t V_internal_size1 = viennacl::traits::internal_size1(V);
+  vcl_size_t V_internal_size2 = viennacl::traits::internal_size2(V);
+
+  if (V.row_major())
+  {
+    detail::matrix_array_wrapper<NumericT, row_major, false> wrapper_V(data_V, V_start1, V_start2, V_inc1, V_inc2, V_internal_size1, V_internal_size2);
+    detail::tsqr_impl(wrapper_V, m, k, R);
+  }
+  else
+  {
+    detail::matrix_array_wrapper<NumericT, column_major, false> wrapper_V(data_V, V_start1, V_start2, V_inc1, V_inc2, V_internal_size1, V_internal_size2);
+    detail::tsqr_impl(wrapper_V, m, k, R);
+  }
+}
+
+} // namespace host_based
+} // namespace linalg
+} // namespace viennacl
+
+#endif
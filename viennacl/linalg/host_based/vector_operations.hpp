@@ -33,6 +33,7 @@
 #include "viennacl/traits/size.hpp"
 #include "viennacl/traits/start.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/simd_kernels.hpp"
 #include "viennacl/linalg/detail/op_applier.hpp"
 #include "viennacl/traits/stride.hpp"
 
@@ -545,6 +546,35 @@ VIENNACL_INNER_PROD_IMPL_2(double)
 
 #undef VIENNACL_INNER_PROD_IMPL_1
 #undef VIENNACL_INNER_PROD_IMPL_2
+
+  /** @brief Computes the inner product of two contiguous arrays with a vectorized kernel. If OpenMP is enabled, each thread processes one chunk. */
+  template<typename NumericT>
+  NumericT inner_prod_contiguous(typename simd_kernels<NumericT>::dot_function dot_kernel,
+                                 NumericT const * data_vec1, NumericT const * data_vec2, vcl_size_t size1)
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    if (size1 > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
+    {
+      std::vector<NumericT> partial_results(static_cast<vcl_size_t>(omp_get_max_threads()), NumericT(0));
+
+      #pragma omp parallel
+      {
+        vcl_size_t id          = static_cast<vcl_size_t>(omp_get_thread_num());
+        vcl_size_t num_threads = static_cast<vcl_size_t>(omp_get_num_threads());
+        vcl_size_t begin = (size1 * id) / num_threads;
+        vcl_size_t end   = (size1 * (id + 1)) / num_threads;
+
+        partial_results[id] = dot_kernel(data_vec1 + begin, data_vec2 + begin, end - begin);
+      }
+
+      NumericT temp = 0;
+      for (vcl_size_t i = 0; i < partial_results.size(); ++i)
+        temp += partial_results[i];
+      return temp;
+    }
+#endif
+    return dot_kernel(data_vec1, data_vec2, size1);
+  }
 }
 
 /** @brief Computes the inner product of two vectors - implementation. Library users should call inner_prod(vec1, vec2).
@@ -570,8 +600,12 @@ void inner_prod_impl(vector_base<NumericT> const & vec1,
   vcl_size_t start2 = viennacl::traits::start(vec2);
   vcl_size_t inc2   = viennacl::traits::stride(vec2);
 
-  result = detail::inner_prod_impl(data_vec1, start1, inc1, size1,
-                                   data_vec2, start2, inc2);  //Note: Assignment to result might be expensive, thus a temporary is introduced here
+  cpu_isa_type isa = selected_cpu_isa<value_type>(HOST_KERNEL_INNER_PROD);
+  if (isa != CPU_ISA_GENERIC && inc1 == 1 && inc2 == 1)
+    result = detail::inner_prod_contiguous(detail::simd_kernels<value_type>::dot(isa), data_vec1 + start1, data_vec2 + start2, size1);
+  else
+    result = detail::inner_prod_impl(data_vec1, start1, inc1, size1,
+                                     data_vec2, start2, inc2);  //Note: Assignment to result might be expensive, thus a temporary is introduced here
 }
 
 template<typename NumericT>
@@ -829,7 +863,11 @@ void norm_2_impl(vector_base<NumericT> const & vec1,
   vcl_size_t inc1   = viennacl::traits::stride(vec1);
   vcl_size_t size1  = viennacl::traits::size(vec1);
 
-  result = std::sqrt(detail::norm_2_impl(data_vec1, start1, inc1, size1));  //Note: Assignment to result might be expensive, thus 'temp' is used for accumulation
+  cpu_isa_type isa = selected_cpu_isa<value_type>(HOST_KERNEL_NORM_2);
+  if (isa != CPU_ISA_GENERIC && inc1 == 1)
+    result = std::sqrt(detail::inner_prod_contiguous(detail::simd_kernels<value_type>::dot(isa), data_vec1 + start1, data_vec1 + start1, size1));
+  else
+    result = std::sqrt(detail::norm_2_impl(data_vec1, start1, inc1, size1));  //Note: Assignment to result might be expensive, thus 'temp' is used for accumulation
 }
 
 /** @brief Computes the supremum-norm of a vector
@@ -30,6 +30,7 @@
 #include "viennacl/compressed_matrix.hpp"
 
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_factor.hpp"
 
 #include <map>
 
@@ -40,7 +41,21 @@ namespace linalg
 
 /** @brief A tag for incomplete Cholesky factorization with static pattern (ILU0)
 */
-class ichol0_tag {};
+class ichol0_tag
+{
+public:
+  /** @brief The constructor.
+  *
+  * @param with_level_scheduling  Flag for enabling multi-threaded triangular solves on the host via level scheduling.
+  */
+  ichol0_tag(bool with_level_scheduling = false) : use_level_scheduling_(with_level_scheduling) {}
+
+  bool use_level_scheduling() const { return use_level_scheduling_; }
+  void use_level_scheduling(bool b) { use_level_scheduling_ = b; }
+
+private:
+  bool use_level_scheduling_;
+};
 
 
 /** @brief Implementation of a ILU-preconditioner with static pattern. Optimized version for CSR matrices.
@@ -159,7 +174,7 @@ private:
     viennacl::linalg::precondition(LLT, tag_);
   }
 
-  ichol0_tag const & tag_;
+  ichol0_tag tag_;
   viennacl::compressed_matrix<NumericType> LLT;
 };
 
@@ -194,6 +209,11 @@ public:
       viennacl::linalg::inplace_solve(      LLT , vec, upper_tag());
       viennacl::switch_memory_context(vec, old_ctx);
     }
+    else if (!host_L_.empty())
+    {
+      host_L_.apply(vec);
+      host_LT_.apply(vec);
+    }
     else //apply ILU0 directly:
     {
       // Note: L is stored in a column-oriented fashion, i.e. transposed w.r.t. the row-oriented layout. Thus, the factorization A = L L^T holds L in the upper triangular part of A.
@@ -210,10 +230,19 @@ private:
     LLT = mat;
 
     viennacl::linalg::precondition(LLT, tag_);
+
+    if (tag_.use_level_scheduling() && viennacl::traits::context(mat).memory_type() == viennacl::MAIN_MEMORY)
+    {
+      host_L_.init(LLT, lower_tag(), true);
+      host_LT_.init(LLT, upper_tag());
+    }
   }
 
-  ichol0_tag const & tag_;
+  ichol0_tag tag_;
   viennacl::compressed_matrix<NumericT> LLT;
+
+  viennacl::linalg::host_based::sparse_triangular_factor<NumericT> host_L_;
+  viennacl::linalg::host_based::sparse_triangular_factor<NumericT> host_LT_;
 };
 
 }
@@ -0,0 +1,474 @@
+#ifndef VIENNACL_LINALG_IDRS_HPP_
+#define VIENNACL_LINALG_IDRS_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/idrs.hpp
+    @brief Implementation of the induced dimension reduction method IDR(s) for nonsymmetric systems.
+
+    Following the bi-orthogonal variant by M. B. van Gijzen and P. Sonneveld, 'Algorithm 913: An Elegant IDR(s) Variant that Efficiently Exploits Biorthogonality Properties', ACM Trans. Math. Softw. 38(1), 2011.
+*/
+
+#include <vector>
+#include <cmath>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/traits/handle.hpp"
+#include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/iterative_operations.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the IDR(s) solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class idrs_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param s          The dimension of the shadow space. Each cycle of s+1 matrix-vector products requires 3s+4 vectors of memory.
+  * @param tol        Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+  * @param max_iters  The maximum number of iterations, i.e. of matrix-vector products
+  */
+  idrs_tag(vcl_size_t s = 4, double tol = 1e-8, vcl_size_t max_iters = 400)
+    : s_(s > 0 ? s : 1), tol_(tol), abs_tol_(0), iterations_(max_iters), angle_(0.7), iters_taken_(0), last_error_(0) {}
+
+  /** @brief Returns the dimension of the shadow space */
+  vcl_size_t s() const { return s_; }
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  vcl_size_t max_iterations() const { return iterations_; }
+
+  /** @brief Returns the minimum cosine of the angle between A v and r in the dimension reduction step, below which omega is enlarged (default: 0.7) */
+  double angle() const { return angle_; }
+  /** @brief Sets the minimum cosine of the angle between A v and r in the dimension reduction step. A value of 0 yields the minimal residual choice of omega. */
+  void angle(double new_angle) { if (new_angle >= 0 && new_angle < 1) angle_ = new_angle; }
+
+  /** @brief Return the number of solver iterations, i.e. of matrix-vector products: */
+  vcl_size_t iters() const { return iters_taken_; }
+  void iters(vcl_size_t i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  vcl_size_t s_;
+  double tol_;
+  double abs_tol_;
+  vcl_size_t iterations_;
+  double angle_;
+
+  //return values from solver
+  mutable vcl_size_t iters_taken_;
+  mutable double last_error_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Computes y = alpha * x + B(:, first:first+c.size()) * c. In main memory, this is a single pass of a fused kernel. y may be x or one of the columns of B. */
+  template<typename NumericT>
+  void idrs_combination(viennacl::vector_base<NumericT> & y, NumericT alpha, viennacl::vector_base<NumericT> const & x,
+                        viennacl::matrix<NumericT, viennacl::column_major> const & B, vcl_size_t first, std::vector<NumericT> const & c)
+  {
+    if (viennacl::traits::active_handle_id(x) == viennacl::MAIN_MEMORY)
+      viennacl::linalg::idrs_block_combination(y, alpha, x, B, first, c);
+    else
+    {
+      viennacl::vector<NumericT> device_c(c.size(), viennacl::traits::context(x));
+      viennacl::copy(c, device_c);
+      viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> const> B_used(B, viennacl::range(0, B.size1()), viennacl::range(first, first + c.size()));
+      viennacl::vector<NumericT> temp = viennacl::linalg::prod(B_used, device_c);
+      y = alpha * x;
+      y += temp;
+    }
+  }
+
+  /** @brief Computes the inner products B^T v. In main memory, all inner products are computed in a single pass over v. */
+  template<typename NumericT>
+  void idrs_inner_products(viennacl::matrix<NumericT, viennacl::column_major> const & B, viennacl::vector_base<NumericT> const & v, std::vector<NumericT> & result)
+  {
+    if (viennacl::traits::active_handle_id(v) == viennacl::MAIN_MEMORY)
+      viennacl::linalg::idrs_block_inner_products(B, v, result);
+    else
+    {
+      viennacl::vector<NumericT> temp = viennacl::linalg::prod(viennacl::trans(B), v);
+      result.resize(B.size2());
+      viennacl::copy(temp, result);
+    }
+  }
+
+  /** @brief Carries out G(:,k) -= G(:,0:k) alpha, U(:,k) -= U(:,0:k) alpha, r -= beta G(:,k), x += beta U(:,k) and returns ||r||. In main memory, this is a single pass of a fused kernel. */
+  template<typename NumericT>
+  NumericT idrs_update(viennacl::matrix<NumericT, viennacl::column_major> & G, viennacl::matrix<NumericT, viennacl::column_major> & U, vcl_size_t k,
+                       std::vector<NumericT> const & alpha, NumericT beta, viennacl::vector<NumericT> & r, viennacl::vector<NumericT> & x)
+  {
+    if (viennacl::traits::active_handle_id(r) == viennacl::MAIN_MEMORY)
+      return std::sqrt(viennacl::linalg::idrs_step_update(G, U, k, alpha, beta, r, x));
+
+    viennacl::vector_base<NumericT> g_k(G.handle(), G.size1(), k * G.internal_size1(), 1);
+    viennacl::vector_base<NumericT> u_k(U.handle(), U.size1(), k * U.internal_size1(), 1);
+    if (k > 0)
+    {
+      std::vector<NumericT> minus_alpha(k);
+      for (vcl_size_t i = 0; i < k; ++i)
+        minus_alpha[i] = -alpha[i];
+      idrs_combination(g_k, NumericT(1), g_k, G, 0, minus_alpha);
+      idrs_combination(u_k, NumericT(1), u_k, U, 0, minus_alpha);
+    }
+    r -= beta * g_k;
+    x += beta * u_k;
+    return viennacl::linalg::norm_2(r);
+  }
+
+  /** @brief Returns the s orthonormal columns of the shadow space as a column-major matrix, generated from a fixed sequence of pseudo-random numbers */
+  template<typename NumericT>
+  viennacl::matrix<NumericT, viennacl::column_major> idrs_shadow_space(vcl_size_t n, vcl_size_t s, viennacl::context ctx)
+  {
+    viennacl::matrix<NumericT, viennacl::column_major> P(n, s, ctx);
+
+    std::vector<std::vector<double> > columns(s, std::vector<double>(n));
+    unsigned long state = 12345;
+    for (vcl_size_t j = 0; j < s; ++j)
+    {
+      for (vcl_size_t i = 0; i < n; ++i)
+      {
+        state = (state * 1103515245ul + 12345ul) % 2147483648ul;
+        columns[j][i] = static_cast<double>(state) / 1073741824.0 - 1.0;
+      }
+
+      // modified Gram-Schmidt:
+      for (vcl_size_t l = 0; l < j; ++l)
+      {
+        double value = 0;
+        for (vcl_size_t i = 0; i < n; ++i)
+          value += columns[l][i] * columns[j][i];
+        for (vcl_size_t i = 0; i < n; ++i)
+          columns[j][i] -= value * columns[l][i];
+      }
+      double norm = 0;
+      for (vcl_size_t i = 0; i < n; ++i)
+        norm += columns[j][i] * columns[j][i];
+      norm = std::sqrt(norm);
+
+      std::vector<NumericT> host_column(n);
+      for (vcl_size_t i = 0; i < n; ++i)
+      {
+        columns[j][i] /= norm;
+        host_column[i] = static_cast<NumericT>(columns[j][i]);
+      }
+      viennacl::vector_base<NumericT> P_j(P.handle(), P.size1(), j * P.internal_size1(), 1);
+      viennacl::copy(host_column.begin(), host_column.end(), P_j.begin());
+    }
+
+    return P;
+  }
+
+  /** @brief Implementation of the IDR(s) method with right preconditioning.
+  *
+  * Each cycle consists of s steps which generate the vectors G = A U with G bi-orthogonal to the shadow space P,
+  * followed by one dimension reduction step with a minimal residual (or angle-limited) choice of omega.
+  * The coefficients of the s-dimensional small systems are computed on the host. In main memory, the vector updates depending on them
+  * are carried out by fused kernels, see viennacl::linalg::idrs_block_combination(), viennacl::linalg::idrs_block_inner_products(), and viennacl::linalg::idrs_step_update().
+  *
+  * @param A            The system matrix
+  * @param rhs          The load vector
+  * @param tag          Solver configuration tag
+  * @param precond      A preconditioner. Precondition operation is done via member function apply()
+  * @param monitor      A callback routine which is called at each iteration
+  * @param monitor_data Data pointer to be passed to the callback routine to pass on user-specific data
+  * @return The result vector
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  viennacl::vector<NumericT> solve_impl(MatrixT const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        idrs_tag const & tag,
+                                        PreconditionerT const & precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+
+    vcl_size_t n = rhs.size();
+    vcl_size_t s = tag.s();
+    viennacl::context ctx = viennacl::traits::context(rhs);
+
+    viennacl::vector<NumericT> result = viennacl::zero_vector<NumericT>(n, ctx);
+    viennacl::vector<NumericT> residual = rhs;
+    viennacl::vector<NumericT> v(n, ctx);
+    viennacl::vector<NumericT> t(n, ctx);
+
+    NumericT norm_rhs = viennacl::linalg::norm_2(rhs);
+    NumericT norm_r = norm_rhs;
+    tag.iters(0);
+    tag.error(0);
+
+    if (norm_rhs <= tag.abs_tolerance()) //solution is zero if RHS norm is zero
+      return result;
+
+    BlockType P = idrs_shadow_space<NumericT>(n, s, ctx);
+    BlockType G(n, s, ctx);
+    BlockType U(n, s, ctx);
+
+    // M = P^T G is lower triangular, f = P^T r:
+    std::vector<NumericT> M(s * s, NumericT(0));
+    for (vcl_size_t i = 0; i < s; ++i)
+      M[i*s+i] = NumericT(1);
+    std::vector<NumericT> f(s);
+    std::vector<NumericT> a(s);
+    std::vector<NumericT> c;
+    std::vector<NumericT> alpha;
+    NumericT omega = 1;
+
+    vcl_size_t iters = 0;
+    bool done = false;
+    while (!done && iters < tag.max_iterations())
+    {
+      bool converged = false;
+      idrs_inner_products(P, residual, f);
+
+      for (vcl_size_t k = 0; k < s; ++k)
+      {
+        // solve the lower triangular system M(k:s, k:s) c = f(k:s):
+        c.resize(s - k);
+        for (vcl_size_t i = k; i < s; ++i)
+        {
+          NumericT value = f[i];
+          for (vcl_size_t j = k; j < i; ++j)
+            value -= M[i*s+j] * c[j-k];
+          c[i-k] = value / M[i*s+i];
+        }
+
+        // v = M^{-1} (r - G(:, k:s) c), U(:, k) = omega v + U(:, k:s) c, G(:, k) = A U(:, k):
+        std::vector<NumericT> minus_c(c.size());
+        for (vcl_size_t i = 0; i < c.size(); ++i)
+          minus_c[i] = -c[i];
+        idrs_combination(v, NumericT(1), residual, G, k, minus_c);
+        precond.apply(v);
+
+        viennacl::vector_base<NumericT> u_k(U.handle(), U.size1(), k * U.internal_size1(), 1);
+        viennacl::vector_base<NumericT> g_k(G.handle(), G.size1(), k * G.internal_size1(), 1);
+        idrs_combination(u_k, omega, v, U, k, c);
+        g_k = viennacl::linalg::prod(A, u_k);
+        ++iters;
+
+        // bi-orthogonalize G(:, k) against P(:, 0:k), i.e. G(:, k) -= G(:, 0:k) alpha with alpha = M(0:k, 0:k)^{-1} P(:, 0:k)^T G(:, k), and set M(k:s, k) = P(:, k:s)^T G(:, k),
+        // both obtained from the single set of inner products a = P^T G(:, k):
+        idrs_inner_products(P, g_k, a);
+        alpha.resize(k);
+        for (vcl_size_t i = 0; i < k; ++i)
+        {
+          NumericT value = a[i];
+          for (vcl_size_t j = 0; j < i; ++j)
+            value -= M[i*s+j] * alpha[j];
+          alpha[i] = value / M[i*s+i];
+        }
+        for (vcl_size_t i = k; i < s; ++i)
+        {
+          NumericT value = a[i];
+          for (vcl_size_t j = 0; j < k; ++j)
+            value -= M[i*s+j] * alpha[j];
+          M[i*s+k] = value;
+        }
+
+        if (M[k*s+k] <= 0 && M[k*s+k] >= 0) // breakdown
+        {
+          done = true;
+          break;
+        }
+
+        // r -= beta G(:, k), x += beta U(:, k) for beta = f(k) / M(k, k), such that r is orthogonal to P(:, 0:k+1):
+        NumericT beta = f[k] / M[k*s+k];
+        norm_r = idrs_update(G, U, k, alpha, beta, residual, result);
+        for (vcl_size_t i = k+1; i < s; ++i)
+          f[i] -= beta * M[i*s+k];
+
+        tag.iters(iters);
+        if (monitor && monitor(result, std::fabs(norm_r / norm_rhs), monitor_data))
+          done = true;
+        converged = norm_r <= tag.tolerance() * norm_rhs || norm_r <= tag.abs_tolerance();
+        if (done || converged || iters >= tag.max_iterations())
+          break;
+      }
+      if (done)
+        break;
+
+      if (!converged && iters < tag.max_iterations())
+      {
+        // dimension reduction step: v = M^{-1} r, t = A v, r -= omega t, x += omega v:
+        viennacl::copy(residual, v);
+        precond.apply(v);
+        t = viennacl::linalg::prod(A, v);
+        ++iters;
+
+        NumericT norm_t = viennacl::linalg::norm_2(t);
+        NumericT t_dot_r = viennacl::linalg::inner_prod(t, residual);
+        if (norm_t <= 0) // breakdown
+          break;
+        omega = t_dot_r / (norm_t * norm_t);
+        NumericT rho = std::fabs(t_dot_r) / (norm_t * norm_r);
+        if (rho < NumericT(tag.angle()))
+          omega *= NumericT(tag.angle()) / rho;
+        if (omega <= 0 && omega >= 0) // breakdown
+          break;
+
+        residual -= omega * t;
+        result += omega * v;
+        norm_r = viennacl::linalg::norm_2(residual);
+
+        tag.iters(iters);
+        if (monitor && monitor(result, std::fabs(norm_r / norm_rhs), monitor_data))
+          break;
+        converged = norm_r <= tag.tolerance() * norm_rhs || norm_r <= tag.abs_tolerance();
+      }
+
+      // the recursively updated residual may deviate from the true residual in finite precision, hence check the latter and continue with it if necessary:
+      if (converged)
+      {
+        residual = viennacl::linalg::prod(A, result);
+        residual = rhs - residual;
+        ++iters;
+        norm_r = viennacl::linalg::norm_2(residual);
+        done = norm_r <= tag.tolerance() * norm_rhs || norm_r <= tag.abs_tolerance();
+      }
+    }
+
+    //store last error estimate:
+    tag.iters(iters);
+    tag.error(norm_r / norm_rhs);
+
+    return result;
+  }
+
+}
+
+
+/** @brief Solves A x = rhs with the IDR(s) method and a preconditioner (applied from the right).
+*
+* @param A          The system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @param precond    The preconditioner
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT, typename PreconditionerT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, idrs_tag const & tag, PreconditionerT const & precond)
+{
+  return detail::solve_impl(A, rhs, tag, precond);
+}
+
+/** @brief Entry point for the unpreconditioned IDR(s) method.
+ *
+ *  @param A         The system matrix
+ *  @param rhs       Right hand side vector (load vector)
+ *  @param tag       An IDR(s) tag providing the dimension of the shadow space, relative tolerances, etc.
+ */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, idrs_tag const & tag)
+{
+  return viennacl::linalg::solve(A, rhs, tag, viennacl::linalg::no_precond());
+}
+
+
+/** @brief IDR(s) solver class, which allows to specify an initial guess and a monitor function.
+*
+* @tparam VectorT   The vector type, must be viennacl::vector<>
+*/
+template<typename VectorT>
+class idrs_solver
+{
+public:
+  typedef typename viennacl::result_of::cpu_value_type<VectorT>::type   numeric_type;
+
+  idrs_solver(idrs_tag const & tag) : tag_(tag), monitor_callback_(NULL), user_data_(NULL) {}
+
+  template<typename MatrixT, typename PreconditionerT>
+  VectorT operator()(MatrixT const & A, VectorT const & b, PreconditionerT const & precond) const
+  {
+    if (viennacl::traits::size(init_guess_) > 0) // take initial guess into account
+    {
+      VectorT mod_rhs = viennacl::linalg::prod(A, init_guess_);
+      mod_rhs = b - mod_rhs;
+      VectorT y = detail::solve_impl(A, mod_rhs, tag_, precond, monitor_callback_, user_data_);
+      return init_guess_ + y;
+    }
+    return detail::solve_impl(A, b, tag_, precond, monitor_callback_, user_data_);
+  }
+
+
+  template<typename MatrixT>
+  VectorT operator()(MatrixT const & A, VectorT const & b) const
+  {
+    return operator()(A, b, viennacl::linalg::no_precond());
+  }
+
+  /** @brief Specifies an initial guess for the iterative solver.
+    *
+    * An iterative solver for Ax = b with initial guess x_0 is equivalent to an iterative solver for Ay = b' := b - Ax_0, where x = x_0 + y.
+    */
+  void set_initial_guess(VectorT const & x) { init_guess_ = x; }
+
+  /** @brief Sets a monitor function pointer to be called in each iteration. Set to NULL to run without monitor.
+   *
+   *  The monitor function is called with the current guess for the result as first argument and the current relative residual as second argument.
+   *  The third argument is a pointer to user-defined data, through which additional information can be passed.
+   *  If the montior function returns true, the solver terminates (either convergence or divergence).
+   */
+  void set_monitor(bool (*monitor_fun)(VectorT const &, numeric_type, void *), void *user_data)
+  {
+    monitor_callback_ = monitor_fun;
+    user_data_ = user_data;
+  }
+
+  /** @brief Returns the solver tag containing basic configuration such as tolerances, etc. */
+  idrs_tag const & tag() const { return tag_; }
+
+private:
+  idrs_tag      tag_;
+  VectorT       init_guess_;
+  bool          (*monitor_callback_)(VectorT const &, numeric_type, void *);
+  void          *user_data_;
+};
+
+
+}
+}
+
+#endif
@@ -121,6 +121,60 @@ void pipelined_cg_prod(MatrixT const & A,
   }
 }
 
+/** @brief Performs the fused matrix-vector product of the pipelined CG algorithm for a symmetric_compressed_matrix (host backend only).
+  *
+  * Computes Ap = prod(A, p) from the upper triangle of A, where each stored off-diagonal entry contributes to both its row and its column.
+  * The partial sums for inner_prod(p,Ap) and inner_prod(Ap,Ap) are written to inner_prod_buffer as for the other sparse matrix types.
+  */
+template<typename NumericT>
+void pipelined_cg_prod(symmetric_compressed_matrix<NumericT> const & A,
+                       vector_base<NumericT> const & p,
+                       vector_base<NumericT> & Ap,
+                       vector_base<NumericT> & inner_prod_buffer)
+{
+  switch (viennacl::traits::handle(p).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    viennacl::linalg::host_based::pipelined_cg_prod(A, p, Ap, inner_prod_buffer);
+    break;
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
+/** @brief Performs a full iteration of the pipelined CG algorithm with a compressed_matrix in a single parallel region (host backend only).
+  *
+  * This routine computes for a matrix A and vectors 'result', 'p', 'r', 'Ap':
+  *   result += alpha * p;
+  *   r      -= alpha * Ap;
+  *   p       = r + beta * p;
+  *   Ap      = prod(A, p);
+  * and the inner products (r,r), (Ap,Ap), (p,Ap), which are written to inner_prods[0], inner_prods[1], and inner_prods[2].
+  */
+template<typename NumericT>
+void pipelined_cg_iteration(compressed_matrix<NumericT> const & A,
+                            vector_base<NumericT> & result,
+                            NumericT alpha,
+                            vector_base<NumericT> & p,
+                            vector_base<NumericT> & r,
+                            vector_base<NumericT> & Ap,
+                            NumericT beta,
+                            NumericT * inner_prods)
+{
+  switch (viennacl::traits::handle(p).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    viennacl::linalg::host_based::pipelined_cg_iteration(A, result, alpha, p, r, Ap, beta, inner_prods);
+    break;
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
 ////////////////////////////////////////////
 
 /** @brief Performs a joint vector update operation needed for an efficient pipelined CG algorithm.
@@ -418,6 +472,109 @@ void pipelined_gmres_prod(MatrixType const & A,
 }
 
 
+/////////////////////////////////////////////////////////////
+
+/** @brief Computes y = alpha * x + sum_j coefficients[j] * B(:, first + j) in a single pass, as needed for the small-system updates of IDR(s) (host backend only).
+  *
+  * The vectors are stored in the columns of B. y may be x or one of the columns of B. The vectors x and y must have unit stride.
+  */
+template<typename NumericT>
+void idrs_block_combination(vector_base<NumericT> & y,
+                            NumericT alpha,
+                            vector_base<NumericT> const & x,
+                            matrix<NumericT, column_major> const & B,
+                            vcl_size_t first,
+                            std::vector<NumericT> const & coefficients)
+{
+  switch (viennacl::traits::handle(y).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    viennacl::linalg::host_based::idrs_block_combination(y, alpha, x, B, first, coefficients);
+    break;
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
+/** @brief Computes the inner products of v with all columns of B in a single pass over v (host backend only). The vector v must have unit stride. */
+template<typename NumericT>
+void idrs_block_inner_products(matrix<NumericT, column_major> const & B,
+                               vector_base<NumericT> const & v,
+                               std::vector<NumericT> & result)
+{
+  switch (viennacl::traits::handle(v).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    viennacl::linalg::host_based::idrs_block_inner_products(B, v, result);
+    break;
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
+/** @brief Performs the vector updates of one IDR(s) step in a single pass (host backend only):
+  *
+  *   G(:,k) -= G(:,0:k) * alpha;
+  *   U(:,k) -= U(:,0:k) * alpha;
+  *   r      -= beta * G(:,k);
+  *   x      += beta * U(:,k);
+  *
+  * The vectors r and x must have unit stride.
+  *
+  * @return The squared norm of the updated residual r
+  */
+template<typename NumericT>
+NumericT idrs_step_update(matrix<NumericT, column_major> & G,
+                          matrix<NumericT, column_major> & U,
+                          vcl_size_t k,
+                          std::vector<NumericT> const & alpha,
+                          NumericT beta,
+                          vector_base<NumericT> & r,
+                          vector_base<NumericT> & x)
+{
+  switch (viennacl::traits::handle(r).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    return viennacl::linalg::host_based::idrs_step_update(G, U, k, alpha, beta, r, x);
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
+
+/** @brief Performs the vector updates of one unpreconditioned Chebyshev iteration in a single pass without any reductions (host backend only):
+  *
+  *   x += d;
+  *   r -= t;   with t = A d
+  *   d  = alpha * d + beta * r;
+  */
+template<typename NumericT>
+void chebyshev_update(vector_base<NumericT> & x,
+                      vector_base<NumericT> & r,
+                      vector_base<NumericT> & d,
+                      vector_base<NumericT> const & t,
+                      NumericT alpha,
+                      NumericT beta)
+{
+  switch (viennacl::traits::handle(x).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    viennacl::linalg::host_based::chebyshev_update(x, r, d, t, alpha, beta);
+    break;
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
+
 } //namespace linalg
 } //namespace viennacl
 
@@ -171,7 +171,7 @@ namespace detail
     bool second_step = false;
     NumericT eps = std::numeric_limits<NumericT>::epsilon();
     NumericT squ_eps = std::sqrt(eps);
-    NumericT eta = std::exp(std::log(eps) * tag.factor());
+    NumericT eta = std::exp(std::log(eps) * NumericT(tag.factor()));
 
     NumericT beta = viennacl::linalg::norm_2(r);
 
@@ -200,10 +200,10 @@ namespace detail
       // Update recurrence relation for estimating orthogonality loss
       //
       w_old = w;
-      w[0] = (betas[1] * w_old[1] + (alphas[0] - alpha) * w_old[0] - betas[i - 1] * w_old[0]) / beta + eps * 0.3 * get_N() * (betas[1] + beta);
+      w[0] = (betas[1] * w_old[1] + (alphas[0] - alpha) * w_old[0] - betas[i - 1] * w_old[0]) / beta + eps * NumericT(0.3) * get_N() * (betas[1] + beta);
       for (vcl_size_t j = 1; j < i - 1; j++)
-        w[j] = (betas[j + 1] * w_old[j + 1] + (alphas[j] - alpha) * w_old[j] + betas[j] * w_old[j - 1] - betas[i - 1] * w_old[j]) / beta + eps * 0.3 * get_N() * (betas[j + 1] + beta);
-      w[i-1] = 0.6 * eps * NumericT(n) * get_N() * betas[1] / beta;
+        w[j] = (betas[j + 1] * w_old[j + 1] + (alphas[j] - alpha) * w_old[j] + betas[j] * w_old[j - 1] - betas[i - 1] * w_old[j]) / beta + eps * NumericT(0.3) * get_N() * (betas[j + 1] + beta);
+      w[i-1] = NumericT(0.6) * eps * NumericT(n) * get_N() * betas[1] / beta;
 
       //
       // Check whether there has been a need for reorthogonalization detected in the previous iteration.
@@ -218,7 +218,7 @@ namespace detail
             viennacl::vector_base<NumericT> q_k(Q.handle(), Q.size1(), k * Q.internal_size1(), 1);
             inner_rt = viennacl::linalg::inner_prod(r, q_k);
             r = r - inner_rt * q_k;
-            w[k] = 1.5 * eps * get_N();
+            w[k] = NumericT(1.5) * eps * get_N();
           }
         }
         NumericT temp = viennacl::linalg::norm_2(r);
@@ -238,7 +238,7 @@ namespace detail
           viennacl::vector_base<NumericT> q_j(Q.handle(), Q.size1(), j * Q.internal_size1(), 1);
           inner_rt = viennacl::linalg::inner_prod(r, q_j);
           r = r - inner_rt * q_j;
-          w[j] = 1.5 * eps * get_N();
+          w[j] = NumericT(1.5) * eps * get_N();
           vcl_size_t k = j - 1;
 
           // orthogonalization with respect to earlier basis vectors
@@ -247,7 +247,7 @@ namespace detail
             viennacl::vector_base<NumericT> q_k(Q.handle(), Q.size1(), k * Q.internal_size1(), 1);
             inner_rt = viennacl::linalg::inner_prod(r, q_k);
             r = r - inner_rt * q_k;
-            w[k] = 1.5 * eps * get_N();
+            w[k] = NumericT(1.5) * eps * get_N();
             if (k == 0) break;
             k--;
           }
@@ -260,7 +260,7 @@ namespace detail
             viennacl::vector_base<NumericT> q_k(Q.handle(), Q.size1(), k * Q.internal_size1(), 1);
             inner_rt = viennacl::linalg::inner_prod(r, q_k);
             r = r - inner_rt * q_k;
-            w[k] = 1.5 * eps * get_N();
+            w[k] = NumericT(1.5) * eps * get_N();
             k++;
           }
           u_bound[batches] = k - 1;
@@ -23,12 +23,25 @@
 */
 
 #include <algorithm>    //for std::min
+#include <cmath>
+#include <vector>
 
 #include "viennacl/matrix.hpp"
 #include "viennacl/matrix_proxy.hpp"
 
 #include "viennacl/linalg/prod.hpp"
 #include "viennacl/linalg/direct_solve.hpp"
+#include "viennacl/linalg/host_based/common.hpp"
+
+/** @brief Width of the panels in the blocked LU factorization with partial pivoting. The trailing matrix is updated by a GEMM with inner dimension of this size. */
+#ifndef VIENNACL_LU_BLOCKSIZE
+  #define VIENNACL_LU_BLOCKSIZE 128
+#endif
+
+/** @brief Panels of at most this many columns are factored by the unblocked algorithm rather than split recursively. */
+#ifndef VIENNACL_LU_PANEL_BASE_SIZE
+  #define VIENNACL_LU_PANEL_BASE_SIZE 16
+#endif
 
 namespace viennacl
 {
@@ -188,6 +201,207 @@ void lu_factorize(matrix<NumericT, viennacl::column_major> & A)
 }
 
 
+namespace detail
+{
+  /** @brief Applies the row interchanges pivots[k_begin], ..., pivots[k_end-1] to the columns [col_begin, col_end) of a matrix in main memory.
+  *
+  * Columns are independent of each other, hence the interchanges are carried out in parallel over the columns.
+  */
+  template<typename WrapperT>
+  void lu_swap_rows(WrapperT & A, std::vector<vcl_size_t> const & pivots,
+                    vcl_size_t k_begin, vcl_size_t k_end,
+                    vcl_size_t col_begin, vcl_size_t col_end)
+  {
+    if (col_begin >= col_end || k_begin >= k_end)
+      return;
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for if ((col_end - col_begin) * (k_end - k_begin) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+    for (long col = static_cast<long>(col_begin); col < static_cast<long>(col_end); ++col)
+    {
+      for (vcl_size_t k = k_begin; k < k_end; ++k)
+      {
+        vcl_size_t p = pivots[k];
+        if (p != k)
+          std::swap(A(k, col), A(p, col));
+      }
+    }
+  }
+
+  /** @brief Unblocked right-looking LU factorization with partial pivoting of the panel A(j0:n, j0:j1). Row interchanges are applied within the panel only. */
+  template<typename NumericT, typename WrapperT>
+  void lu_factorize_panel_unblocked(WrapperT & A, vcl_size_t n, vcl_size_t j0, vcl_size_t j1, std::vector<vcl_size_t> & pivots)
+  {
+    for (vcl_size_t j = j0; j < j1; ++j)
+    {
+      // find pivot:
+      vcl_size_t p = j;
+      NumericT max_value = std::fabs(A(j, j));
+      for (vcl_size_t i = j + 1; i < n; ++i)
+      {
+        NumericT value = std::fabs(A(i, j));
+        if (value > max_value)
+        {
+          max_value = value;
+          p = i;
+        }
+      }
+      pivots[j] = p;
+
+      if (p != j)
+        for (vcl_size_t col = j0; col < j1; ++col)
+          std::swap(A(j, col), A(p, col));
+
+      NumericT a_jj = A(j, j);
+      if (a_jj <= 0 && a_jj >= 0)  // singular matrix: column is already zero below the diagonal, nothing to eliminate
+        continue;
+
+      // compute l_ij and update the remaining columns of the panel:
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp parallel for if ((n - j) * (j1 - j) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+      for (long i = static_cast<long>(j + 1); i < static_cast<long>(n); ++i)
+      {
+        NumericT l_ij = A(i, j) / a_jj;
+        A(i, j) = l_ij;
+        for (vcl_size_t col = j + 1; col < j1; ++col)
+          A(i, col) -= l_ij * A(j, col);
+      }
+    }
+  }
+
+  /** @brief Recursive LU factorization with partial pivoting of the panel A(j0:n, j0:j1).
+  *
+  * The panel is split into a left and a right half. After factoring the left half, the right half is updated by a triangular solve and a GEMM,
+  * so that most of the work in the panel is carried out by the (parallel) matrix-matrix product rather than by rank-1 updates.
+  */
+  template<typename MatrixT, typename WrapperT>
+  void lu_factorize_panel(MatrixT & A, WrapperT & A_wrapper, vcl_size_t j0, vcl_size_t j1, std::vector<vcl_size_t> & pivots)
+  {
+    typedef typename viennacl::result_of::cpu_value_type<MatrixT>::type  NumericType;
+
+    vcl_size_t n = A.size1();
+    if (j1 - j0 <= VIENNACL_LU_PANEL_BASE_SIZE)
+    {
+      lu_factorize_panel_unblocked<NumericType>(A_wrapper, n, j0, j1, pivots);
+      return;
+    }
+
+    vcl_size_t j_mid = j0 + (j1 - j0) / 2;
+
+    lu_factorize_panel(A, A_wrapper, j0, j_mid, pivots);
+    lu_swap_rows(A_wrapper, pivots, j0, j_mid, j_mid, j1);
+
+    viennacl::range left_range(j0, j_mid);
+    viennacl::range right_range(j_mid, j1);
+    viennacl::range lower_range(j_mid, n);
+
+    viennacl::matrix_range<MatrixT> L_11(A, left_range, left_range);
+    viennacl::matrix_range<MatrixT> A_12(A, left_range, right_range);
+    viennacl::linalg::inplace_solve(L_11, A_12, viennacl::linalg::unit_lower_tag());
+
+    viennacl::matrix_range<MatrixT> L_21(A, lower_range, left_range);
+    viennacl::matrix_range<MatrixT> A_22(A, lower_range, right_range);
+    A_22 -= viennacl::linalg::prod(L_21, A_12);
+
+    lu_factorize_panel(A, A_wrapper, j_mid, j1, pivots);
+    lu_swap_rows(A_wrapper, pivots, j_mid, j1, j0, j_mid);
+  }
+
+  /** @brief Applies the row interchanges of a pivoted LU factorization to the rows of B. */
+  template<typename NumericT, typename F, unsigned int AlignmentV>
+  void lu_permute(std::vector<vcl_size_t> const & pivots, matrix<NumericT, F, AlignmentV> & B)
+  {
+    viennacl::context ctx = viennacl::traits::context(B);
+    if (ctx.memory_type() != viennacl::MAIN_MEMORY)
+      B.switch_memory_context(viennacl::context(viennacl::MAIN_MEMORY));
+
+    viennacl::linalg::host_based::detail::matrix_array_wrapper<NumericT, F, false>
+        B_wrapper(viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(B), 0, 0, 1, 1, B.internal_size1(), B.internal_size2());
+    lu_swap_rows(B_wrapper, pivots, 0, pivots.size(), 0, B.size2());
+
+    if (ctx.memory_type() != viennacl::MAIN_MEMORY)
+      B.switch_memory_context(ctx);
+  }
+
+  /** @brief Applies the row interchanges of a pivoted LU factorization to the entries of vec. */
+  template<typename NumericT, unsigned int AlignmentV>
+  void lu_permute(std::vector<vcl_size_t> const & pivots, vector<NumericT, AlignmentV> & vec)
+  {
+    std::vector<NumericT> temp(vec.size());
+    viennacl::copy(vec, temp);
+    for (vcl_size_t k = 0; k < pivots.size(); ++k)
+      if (pivots[k] != k)
+        std::swap(temp[k], temp[pivots[k]]);
+    viennacl::copy(temp, vec);
+  }
+}
+
+/** @brief Blocked LU factorization with partial pivoting of a dense matrix, i.e. PA = LU.
+*
+* Right-looking algorithm: Each panel of VIENNACL_LU_BLOCKSIZE columns is factored recursively, then the trailing matrix is updated by a triangular solve and a matrix-matrix product.
+* With the host backend, the trailing update runs through the packed, multithreaded GEMM. Matrices in other memory domains are transferred to main memory for the factorization.
+*
+* @param A        The system matrix, where the LU matrices are directly written to. The implicit unit diagonal of L is not written.
+* @param pivots   The row interchanges (LAPACK convention): Row k was interchanged with row pivots[k] >= k, for k = 0, ..., size1() - 1, in this order.
+*/
+template<typename NumericT, typename F, unsigned int AlignmentV>
+void lu_factorize(matrix<NumericT, F, AlignmentV> & A, std::vector<vcl_size_t> & pivots)
+{
+  typedef matrix<NumericT, F, AlignmentV>  MatrixType;
+
+  assert(A.size1() == A.size2() && bool("Matrix must be square"));
+
+  vcl_size_t n = A.size1();
+  pivots.resize(n);
+  for (vcl_size_t k = 0; k < n; ++k)
+    pivots[k] = k;
+
+  viennacl::context ctx = viennacl::traits::context(A);
+  if (ctx.memory_type() != viennacl::MAIN_MEMORY)
+    A.switch_memory_context(viennacl::context(viennacl::MAIN_MEMORY));
+
+  viennacl::linalg::host_based::detail::matrix_array_wrapper<NumericT, F, false>
+      A_wrapper(viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A), 0, 0, 1, 1, A.internal_size1(), A.internal_size2());
+
+  vcl_size_t block_size = VIENNACL_LU_BLOCKSIZE;
+  for (vcl_size_t k = 0; k < n; k += block_size)
+  {
+    vcl_size_t k_end = std::min<vcl_size_t>(n, k + block_size);
+
+    // factor panel A(k:n, k:k_end) and apply its row interchanges to the left and the right of the panel:
+    detail::lu_factorize_panel(A, A_wrapper, k, k_end, pivots);
+    detail::lu_swap_rows(A_wrapper, pivots, k, k_end, 0, k);
+    detail::lu_swap_rows(A_wrapper, pivots, k, k_end, k_end, n);
+
+    if (k_end < n)
+    {
+      viennacl::range     block_range(k, k_end);
+      viennacl::range remainder_range(k_end, n);
+
+      //
+      // Compute U_12:
+      //
+      viennacl::matrix_range<MatrixType> L_11(A, block_range, block_range);
+      viennacl::matrix_range<MatrixType> U_12(A, block_range, remainder_range);
+      viennacl::linalg::inplace_solve(L_11, U_12, viennacl::linalg::unit_lower_tag());
+
+      //
+      // Update remainder of A
+      //
+      viennacl::matrix_range<MatrixType> L_21(A, remainder_range, block_range);
+      viennacl::matrix_range<MatrixType> A_22(A, remainder_range, remainder_range);
+
+      A_22 -= viennacl::linalg::prod(L_21, U_12);
+    }
+  }
+
+  if (ctx.memory_type() != viennacl::MAIN_MEMORY)
+    A.switch_memory_context(ctx);
+}
+
+
 //
 // Convenience layer:
 //
@@ -221,6 +435,43 @@ void lu_substitute(matrix<NumericT, F, MatAlignmentV> const & A,
   inplace_solve(A, vec, upper_tag());
 }
 
+/** @brief LU substitution for the system PA = LU with pivots obtained from lu_factorize(A, pivots).
+*
+* @param A       The LU factors of the system matrix as computed by lu_factorize(A, pivots)
+* @param pivots  The row interchanges as computed by lu_factorize(A, pivots)
+* @param B       The matrix of load vectors, where the solution is directly written to
+*/
+template<typename NumericT, typename F1, typename F2, unsigned int AlignmentV1, unsigned int AlignmentV2>
+void lu_substitute(matrix<NumericT, F1, AlignmentV1> const & A,
+                   std::vector<vcl_size_t> const & pivots,
+                   matrix<NumericT, F2, AlignmentV2> & B)
+{
+  assert(A.size1() == A.size2() && bool("Matrix must be square"));
+  assert(A.size1() == B.size1() && bool("Matrix must be square"));
+  assert(A.size1() == pivots.size() && bool("Size of pivot vector does not match matrix size"));
+  detail::lu_permute(pivots, B);
+  inplace_solve(A, B, unit_lower_tag());
+  inplace_solve(A, B, upper_tag());
+}
+
+/** @brief LU substitution for the system PA = LU with pivots obtained from lu_factorize(A, pivots).
+*
+* @param A       The LU factors of the system matrix as computed by lu_factorize(A, pivots)
+* @param pivots  The row interchanges as computed by lu_factorize(A, pivots)
+* @param vec     The load vector, where the solution is directly written to
+*/
+template<typename NumericT, typename F, unsigned int MatAlignmentV, unsigned int VecAlignmentV>
+void lu_substitute(matrix<NumericT, F, MatAlignmentV> const & A,
+                   std::vector<vcl_size_t> const & pivots,
+                   vector<NumericT, VecAlignmentV> & vec)
+{
+  assert(A.size1() == A.size2() && bool("Matrix must be square"));
+  assert(A.size1() == pivots.size() && bool("Size of pivot vector does not match matrix size"));
+  detail::lu_permute(pivots, vec);
+  inplace_solve(A, vec, unit_lower_tag());
+  inplace_solve(A, vec, upper_tag());
+}
+
 }
 }
 
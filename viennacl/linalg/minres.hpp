@@ -0,0 +1,287 @@
+#ifndef VIENNACL_LINALG_MINRES_HPP_
+#define VIENNACL_LINALG_MINRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/minres.hpp
+    @brief Implementation of the minimal residual method MINRES for symmetric, possibly indefinite systems.
+
+    Following C. C. Paige and M. A. Saunders, 'Solution of Sparse Indefinite Systems of Linear Equations', SIAM J. Numer. Anal. 12(4), 1975.
+*/
+
+#include <cmath>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/traits/size.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/meta/result_of.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the MINRES solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class minres_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+  * @param max_iterations   The maximum number of iterations
+  */
+  minres_tag(double tol = 1e-8, vcl_size_t max_iterations = 300)
+    : tol_(tol), abs_tol_(0), iterations_(max_iterations), iters_taken_(0), last_error_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  vcl_size_t max_iterations() const { return iterations_; }
+
+  /** @brief Return the number of solver iterations: */
+  vcl_size_t iters() const { return iters_taken_; }
+  void iters(vcl_size_t i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  vcl_size_t iterations_;
+
+  //return values from solver
+  mutable vcl_size_t iters_taken_;
+  mutable double last_error_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Implementation of the preconditioned MINRES method.
+  *
+  * The preconditioner must be symmetric positive definite. The residual is then minimized in the norm induced by its inverse,
+  * which is the norm the convergence criterion refers to. Without preconditioner, this is the Euclidean norm.
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  viennacl::vector<NumericT> solve_impl(MatrixT const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        minres_tag const & tag,
+                                        PreconditionerT const & precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    vcl_size_t n = rhs.size();
+    viennacl::context ctx = viennacl::traits::context(rhs);
+
+    viennacl::vector<NumericT> result = viennacl::zero_vector<NumericT>(n, ctx);
+    viennacl::vector<NumericT> r1 = rhs;     // the last two Lanczos vectors before preconditioning
+    viennacl::vector<NumericT> r2 = rhs;
+    viennacl::vector<NumericT> y = rhs;
+    viennacl::vector<NumericT> v(n, ctx);
+    viennacl::vector<NumericT> w  = viennacl::zero_vector<NumericT>(n, ctx);   // the last three search directions
+    viennacl::vector<NumericT> w1 = viennacl::zero_vector<NumericT>(n, ctx);
+    viennacl::vector<NumericT> w2 = viennacl::zero_vector<NumericT>(n, ctx);
+
+    tag.iters(0);
+    tag.error(0);
+
+    precond.apply(y);
+    NumericT beta1 = viennacl::linalg::inner_prod(rhs, y);
+    if (beta1 <= 0) // zero right hand side (or preconditioner not positive definite)
+      return result;
+    beta1 = std::sqrt(beta1);
+    if (beta1 <= tag.abs_tolerance())
+      return result;
+
+    NumericT old_beta = 0;
+    NumericT beta = beta1;
+    NumericT dbar = 0;
+    NumericT epsilon = 0;
+    NumericT phibar = beta1;
+    NumericT cs = -1;
+    NumericT sn = 0;
+
+    vcl_size_t i = 0;
+    for (i = 0; i < tag.max_iterations(); ++i)
+    {
+      // Lanczos step:
+      v = y / beta;
+      y = viennacl::linalg::prod(A, v);
+      if (i > 0)
+        y -= (beta / old_beta) * r1;
+
+      NumericT alpha = viennacl::linalg::inner_prod(v, y);
+      y -= (alpha / beta) * r2;
+      r1.fast_swap(r2);
+      viennacl::copy(y, r2);
+      precond.apply(y);
+      old_beta = beta;
+      beta = viennacl::linalg::inner_prod(r2, y);
+      beta = (beta > 0) ? std::sqrt(beta) : 0;
+
+      // apply the previous rotation to the new column of the tridiagonal matrix and compute the next one:
+      NumericT old_epsilon = epsilon;
+      NumericT delta = cs * dbar + sn * alpha;
+      NumericT gbar  = sn * dbar - cs * alpha;
+      epsilon = sn * beta;
+      dbar = -cs * beta;
+
+      NumericT gamma = std::sqrt(gbar * gbar + beta * beta);
+      if (gamma <= 0) // breakdown, A is singular
+        break;
+      cs = gbar / gamma;
+      sn = beta / gamma;
+      NumericT phi = cs * phibar;
+      phibar = sn * phibar;
+
+      // update search directions and the result:
+      w1.fast_swap(w2);
+      w2.fast_swap(w);
+      w = v - old_epsilon * w1;
+      w -= delta * w2;
+      w /= gamma;
+      result += phi * w;
+
+      if (monitor && monitor(result, std::fabs(phibar / beta1), monitor_data))
+      {
+        ++i;
+        break;
+      }
+      if (phibar <= tag.tolerance() * beta1 || phibar <= tag.abs_tolerance() || beta <= 0) // converged, or invariant Krylov subspace reached
+      {
+        ++i;
+        break;
+      }
+    }
+
+    //store last error estimate:
+    tag.iters(i);
+    tag.error(phibar / beta1);
+
+    return result;
+  }
+
+}
+
+
+/** @brief Solves A x = rhs with the MINRES method and a symmetric positive definite preconditioner.
+*
+* @param A          The symmetric system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @param precond    The preconditioner
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT, typename PreconditionerT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, minres_tag const & tag, PreconditionerT const & precond)
+{
+  return detail::solve_impl(A, rhs, tag, precond);
+}
+
+/** @brief Entry point for the unpreconditioned MINRES method.
+ *
+ *  @param A         The symmetric system matrix
+ *  @param rhs       Right hand side vector (load vector)
+ *  @param tag       A MINRES tag providing relative tolerances, etc.
+ */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, minres_tag const & tag)
+{
+  return viennacl::linalg::solve(A, rhs, tag, viennacl::linalg::no_precond());
+}
+
+
+/** @brief MINRES solver class, which allows to specify an initial guess and a monitor function.
+*
+* @tparam VectorT   The vector type, must be viennacl::vector<>
+*/
+template<typename VectorT>
+class minres_solver
+{
+public:
+  typedef typename viennacl::result_of::cpu_value_type<VectorT>::type   numeric_type;
+
+  minres_solver(minres_tag const & tag) : tag_(tag), monitor_callback_(NULL), user_data_(NULL) {}
+
+  template<typename MatrixT, typename PreconditionerT>
+  VectorT operator()(MatrixT const & A, VectorT const & b, PreconditionerT const & precond) const
+  {
+    if (viennacl::traits::size(init_guess_) > 0) // take initial guess into account
+    {
+      VectorT mod_rhs = viennacl::linalg::prod(A, init_guess_);
+      mod_rhs = b - mod_rhs;
+      VectorT y = detail::solve_impl(A, mod_rhs, tag_, precond, monitor_callback_, user_data_);
+      return init_guess_ + y;
+    }
+    return detail::solve_impl(A, b, tag_, precond, monitor_callback_, user_data_);
+  }
+
+
+  template<typename MatrixT>
+  VectorT operator()(MatrixT const & A, VectorT const & b) const
+  {
+    return operator()(A, b, viennacl::linalg::no_precond());
+  }
+
+  /** @brief Specifies an initial guess for the iterative solver.
+    *
+    * An iterative solver for Ax = b with initial guess x_0 is equivalent to an iterative solver for Ay = b' := b - Ax_0, where x = x_0 + y.
+    */
+  void set_initial_guess(VectorT const & x) { init_guess_ = x; }
+
+  /** @brief Sets a monitor function pointer to be called in each iteration. Set to NULL to run without monitor.
+   *
+   *  The monitor function is called with the current guess for the result as first argument and the current relative residual estimate as second argument.
+   *  The third argument is a pointer to user-defined data, through which additional information can be passed.
+   *  If the montior function returns true, the solver terminates (either convergence or divergence).
+   */
+  void set_monitor(bool (*monitor_fun)(VectorT const &, numeric_type, void *), void *user_data)
+  {
+    monitor_callback_ = monitor_fun;
+    user_data_ = user_data;
+  }
+
+  /** @brief Returns the solver tag containing basic configuration such as tolerances, etc. */
+  minres_tag const & tag() const { return tag_; }
+
+private:
+  minres_tag    tag_;
+  VectorT       init_guess_;
+  bool          (*monitor_callback_)(VectorT const &, numeric_type, void *);
+  void          *user_data_;
+};
+
+
+}
+}
+
+#endif
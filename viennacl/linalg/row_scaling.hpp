@@ -74,6 +74,18 @@ namespace viennacl
       {
         enum { value = true };
       };
+
+      template<typename ScalarType, unsigned int BlockSize>
+      struct row_scaling_for_viennacl< viennacl::bsr_matrix<ScalarType, BlockSize> >
+      {
+        enum { value = true };
+      };
+
+      template<typename ScalarType>
+      struct row_scaling_for_viennacl< viennacl::symmetric_compressed_matrix<ScalarType> >
+      {
+        enum { value = true };
+      };
     }
     /** \endcond */
 
@@ -0,0 +1,369 @@
+#ifndef VIENNACL_LINALG_S_STEP_CG_HPP_
+#define VIENNACL_LINALG_S_STEP_CG_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/s_step_cg.hpp
+    @brief The s-step (communication-avoiding) conjugate gradient method is implemented here
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/clear.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/krylov/small_dense.hpp"
+#include "viennacl/linalg/detail/krylov/s_step_basis.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the s-step conjugate gradient solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class s_step_cg_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+  * @param max_iterations   The maximum number of CG steps (each block of s steps counts as s)
+  * @param s                Number of Krylov vectors generated and orthogonalized at once
+  * @param basis            The polynomial basis for generating the Krylov vectors
+  */
+  s_step_cg_tag(double tol = 1e-8, unsigned int max_iterations = 300, unsigned int s = 4, s_step_basis_type basis = S_STEP_BASIS_NEWTON)
+    : tol_(tol), abs_tol_(0), iterations_(max_iterations), s_(s > 0 ? s : 1), basis_(basis), basis_tol_(1e-10), iters_taken_(0), last_error_(0), basis_fallbacks_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  unsigned int max_iterations() const { return iterations_; }
+
+  /** @brief Returns the number of Krylov vectors generated per block */
+  unsigned int s() const { return s_; }
+
+  /** @brief Returns the polynomial basis used for generating the Krylov vectors */
+  s_step_basis_type basis() const { return basis_; }
+
+  /** @brief Returns the tolerance below which a new search direction is considered numerically dependent on the previous ones of the block */
+  double basis_tolerance() const { return basis_tol_; }
+  /** @brief Sets the tolerance below which a new search direction is considered numerically dependent on the previous ones of the block */
+  void basis_tolerance(double new_tol) { if (new_tol >= 0) basis_tol_ = new_tol; }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+  /** @brief Returns the number of blocks in which the basis was too ill-conditioned for s steps, so that fewer steps were taken */
+  unsigned int basis_fallbacks() const { return basis_fallbacks_; }
+  /** @brief Sets the number of blocks with fewer than s steps (should only be modified by the solver) */
+  void basis_fallbacks(unsigned int num) const { basis_fallbacks_ = num; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  unsigned int s_;
+  s_step_basis_type basis_;
+  double basis_tol_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+  mutable unsigned int basis_fallbacks_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Sets up the small system of an s-step CG block from the Gram matrix G = Z^T V (leading dimension ld).
+  *
+  * B = (P^T A P)^{-1} (AP)^T V makes the Krylov vectors V A-conjugate to the previous search directions P.
+  * The new search directions V - P B yield the projected matrix D = (V - P B)^T A (V - P B) = V^T A V - ((AP)^T V)^T B and the right hand side g = (V - P B)^T r.
+  */
+  inline void s_step_cg_small_system(std::vector<double> const & G, vcl_size_t ld,
+                                     std::vector<double> const & T, vcl_size_t k,
+                                     std::vector<double> const & L_prev, vcl_size_t ld_prev, vcl_size_t num_prev,
+                                     vcl_size_t P_offset, vcl_size_t V_offset, vcl_size_t AP_offset,
+                                     std::vector<double> & B, std::vector<double> & D, std::vector<double> & g)
+  {
+    B.resize(num_prev * k);
+    for (vcl_size_t j = 0; j < k; ++j)
+    {
+      std::vector<double> column(num_prev);
+      for (vcl_size_t i = 0; i < num_prev; ++i)
+        column[i] = G[(AP_offset + i) * ld + j];
+      small_cholesky_solve(L_prev, ld_prev, num_prev, column);
+      for (vcl_size_t i = 0; i < num_prev; ++i)
+        B[i * k + j] = column[i];
+    }
+
+    D.resize(k * k);
+    g.resize(k);
+    for (vcl_size_t i = 0; i < k; ++i)
+    {
+      for (vcl_size_t j = 0; j < k; ++j)
+      {
+        double value = 0;
+        for (vcl_size_t l = 0; l <= k; ++l)
+          value += G[(V_offset + i) * ld + l] * T[l * k + j];
+        for (vcl_size_t l = 0; l < num_prev; ++l)
+          value -= G[(AP_offset + l) * ld + i] * B[l * k + j];
+        D[i * k + j] = value;
+      }
+
+      g[i] = G[(V_offset + i) * ld];
+      for (vcl_size_t l = 0; l < num_prev; ++l)
+        g[i] -= B[l * k + i] * G[(P_offset + l) * ld];
+    }
+    for (vcl_size_t i = 0; i < k; ++i)
+      for (vcl_size_t j = i+1; j < k; ++j)
+        D[i * k + j] = D[j * k + i] = 0.5 * (D[i * k + j] + D[j * k + i]);
+  }
+
+  /** @brief Implementation of the s-step conjugate gradient method (no preconditioner).
+  *
+  * Following A. T. Chronopoulos and C. W. Gear, J. Comput. Appl. Math. 25(2), 153-168 (1989).
+  * Each block generates the Krylov vectors V = [r, p_1(A) r, ..., p_s(A) r] with s sparse matrix-vector products,
+  * makes them A-conjugate to the previous block of search directions P, and minimizes the error over the new block.
+  * All inner products of the block are obtained from the single Gram matrix [P, V, AP]^T V.
+  *
+  * If the A-orthogonalized basis turns out to be numerically rank-deficient (see s_step_cg_tag::basis_tolerance()),
+  * only the leading well-conditioned directions are used and the fallback is counted in s_step_cg_tag::basis_fallbacks().
+  */
+  template<typename MatrixT, typename NumericT>
+  viennacl::vector<NumericT> s_step_cg_solve(MatrixT const & A,
+                                             viennacl::vector<NumericT> const & rhs,
+                                             s_step_cg_tag const & tag)
+  {
+    vcl_size_t n = rhs.size();
+    vcl_size_t s = tag.s();
+    viennacl::context ctx = viennacl::traits::context(rhs);
+
+    viennacl::vector<NumericT> result(rhs);
+    viennacl::traits::clear(result);
+    viennacl::vector<NumericT> residual(rhs);
+
+    // Columns of Z: the previous search directions P (right-aligned in the first s columns, such that [P, V] is contiguous),
+    // the Krylov vectors V (s+1 columns), and the images AP of the search directions (left-aligned in the last s columns).
+    // The new P and AP are written to the second buffer, then the two buffers are swapped.
+    vcl_size_t V_offset  = s;
+    vcl_size_t AP_offset = 2 * s + 1;
+    viennacl::matrix<NumericT, viennacl::column_major> Z_buffer_1(n, 3 * s + 1, ctx);
+    viennacl::matrix<NumericT, viennacl::column_major> Z_buffer_2(n, 3 * s + 1, ctx);
+    viennacl::matrix<NumericT, viennacl::column_major> * Z      = &Z_buffer_1;
+    viennacl::matrix<NumericT, viennacl::column_major> * Z_next = &Z_buffer_2;
+
+    viennacl::matrix<NumericT> gram(3 * s + 1, s + 1, ctx);
+    viennacl::matrix<NumericT> small_B(2 * s, s, ctx);
+    viennacl::matrix<NumericT> small_T(s + 1, s, ctx);
+    viennacl::vector<NumericT> small_a(s, ctx);
+
+    viennacl::range all_rows(0, n);
+
+    detail::s_step_recurrence recurrence(s, tag.basis());
+    double pivot_tolerance = std::max(tag.basis_tolerance(), 100.0 * static_cast<double>(std::numeric_limits<NumericT>::epsilon()));
+
+    std::vector<double> G;
+    std::vector<double> L_prev;        // Cholesky factor of P^T A P of the previous block
+    vcl_size_t ld_prev = 0;            // leading dimension of L_prev
+    vcl_size_t num_prev = 0;           // number of search directions in the previous block
+    double norm_rhs_squared = 0;
+    double norm_r_squared = 0;
+    unsigned int iters = 0;
+    unsigned int fallbacks = 0;
+
+    for (;;)
+    {
+      vcl_size_t k = std::min<vcl_size_t>(s, tag.max_iterations() - iters);
+      vcl_size_t P_offset = V_offset - num_prev;
+
+      viennacl::vector_base<NumericT> v_0(Z->handle(), n, V_offset * Z->internal_size1(), 1);
+      v_0 = residual;
+      detail::s_step_generate_basis(A, *Z, V_offset, k, recurrence);
+
+      // one global reduction for all inner products of the block:
+      viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > V(*Z, all_rows, viennacl::range(V_offset, V_offset + k + 1));
+      viennacl::matrix_range<viennacl::matrix<NumericT> > gram_block(gram, viennacl::range(0, 3 * s + 1), viennacl::range(0, k + 1));
+      gram_block = viennacl::linalg::prod(viennacl::trans(*Z), V);
+      read_small_matrix(gram, G);
+
+      vcl_size_t ld = s + 1;
+      norm_r_squared = G[V_offset * ld];
+      if (iters == 0)
+      {
+        norm_rhs_squared = norm_r_squared;
+        if (norm_rhs_squared <= tag.abs_tolerance() * tag.abs_tolerance()) //check for early convergence of A*x = 0
+          break;
+      }
+      if (k == 0)
+        break;
+      if (   std::fabs(norm_r_squared) < tag.tolerance() * tag.tolerance() * norm_rhs_squared
+          || std::fabs(norm_r_squared) < tag.abs_tolerance() * tag.abs_tolerance())
+      {
+        // the recursively updated residual may deviate from the true residual for ill-conditioned bases, so check the latter:
+        residual = viennacl::linalg::prod(A, result);
+        residual = rhs - residual;
+        norm_r_squared = viennacl::linalg::norm_2(residual);
+        norm_r_squared *= norm_r_squared;
+        if (   norm_r_squared < tag.tolerance() * tag.tolerance() * norm_rhs_squared
+            || norm_r_squared < tag.abs_tolerance() * tag.abs_tolerance())
+          break;
+
+        num_prev = 0; // restart from the true residual
+        continue;
+      }
+
+      std::vector<double> T = recurrence.change_of_basis(k);
+      std::vector<double> B, D, g;
+      vcl_size_t num_new = 0;
+      for (;;)
+      {
+        P_offset = V_offset - num_prev;
+        s_step_cg_small_system(G, ld, T, k, L_prev, ld_prev, num_prev, P_offset, V_offset, AP_offset, B, D, g);
+
+        // use the leading directions for which D is numerically positive definite:
+        num_new = small_cholesky(D, k, pivot_tolerance);
+        if (num_new > 0 || num_prev == 0)
+          break;
+
+        num_prev = 0; // not even the residual can be made A-conjugate to the previous block in finite precision: restart
+        ++fallbacks;
+      }
+      if (num_new == 0) // breakdown, A is not positive definite
+        break;
+      if (num_new < k)
+        ++fallbacks;
+
+      small_cholesky_solve(D, k, num_new, g);
+
+      // P_new = [P, V] [-B; I],  AP_new = V T - AP B:
+      std::vector<double> S((num_prev + num_new) * num_new, 0.0);
+      std::vector<double> B_new(num_prev * num_new);
+      std::vector<double> T_new((num_new + 1) * num_new);
+      for (vcl_size_t j = 0; j < num_new; ++j)
+      {
+        for (vcl_size_t i = 0; i < num_prev; ++i)
+        {
+          S[i * num_new + j] = -B[i * k + j];
+          B_new[i * num_new + j] = B[i * k + j];
+        }
+        S[(num_prev + j) * num_new + j] = 1.0;
+        for (vcl_size_t i = 0; i <= num_new; ++i)
+          T_new[i * num_new + j] = T[i * k + j];
+      }
+
+      viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > PV    (*Z,      all_rows, viennacl::range(P_offset, V_offset + num_new));
+      viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > V_ext (*Z,      all_rows, viennacl::range(V_offset, V_offset + num_new + 1));
+      viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > P_new (*Z_next, all_rows, viennacl::range(V_offset - num_new, V_offset));
+      viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > AP_new(*Z_next, all_rows, viennacl::range(AP_offset, AP_offset + num_new));
+
+      write_small_matrix(S, num_prev + num_new, num_new, small_B);
+      P_new = viennacl::linalg::prod(PV, small_B);
+      write_small_matrix(T_new, num_new + 1, num_new, small_T);
+      AP_new = viennacl::linalg::prod(V_ext, small_T);
+      if (num_prev > 0)
+      {
+        viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > AP(*Z, all_rows, viennacl::range(AP_offset, AP_offset + num_prev));
+        write_small_matrix(B_new, num_prev, num_new, small_B);
+        AP_new -= viennacl::linalg::prod(AP, small_B);
+      }
+
+      // x += P a,  r -= A P a:
+      write_small_vector(g, num_new, small_a);
+      result   += viennacl::linalg::prod(P_new,  small_a);
+      residual -= viennacl::linalg::prod(AP_new, small_a);
+
+      // Ritz values from the first block for the shifts and scaling of the basis:
+      if (iters == 0)
+      {
+        std::vector<double> VtV(k * k);
+        std::vector<double> VtAV(k * k);
+        for (vcl_size_t i = 0; i < k; ++i)
+          for (vcl_size_t j = 0; j < k; ++j)
+          {
+            VtV[i * k + j] = G[(V_offset + i) * ld + j];
+            VtAV[i * k + j] = 0;
+            for (vcl_size_t l = 0; l <= k; ++l)
+              VtAV[i * k + j] += G[(V_offset + i) * ld + l] * T[l * k + j];
+          }
+        recurrence.set_ritz_values(small_generalized_eigenvalues(VtAV, VtV, k, pivot_tolerance));
+      }
+
+      std::swap(Z, Z_next);
+      L_prev = D;
+      ld_prev = k;
+      num_prev = num_new;
+      iters += static_cast<unsigned int>(num_new);
+    }
+
+    tag.iters(iters);
+    tag.basis_fallbacks(fallbacks);
+    tag.error(norm_rhs_squared > 0 ? std::sqrt(std::fabs(norm_r_squared) / norm_rhs_squared) : 0);
+
+    return result;
+  }
+
+}
+
+
+/** @brief Solves A x = rhs with the s-step conjugate gradient method. A must be one of the ViennaCL sparse matrix types.
+*
+* @param A          The system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, s_step_cg_tag const & tag, viennacl::linalg::no_precond)
+{
+  return detail::s_step_cg_solve(A, rhs, tag);
+}
+
+/** @brief Convenience overload for calling the s-step CG solver without preconditioner */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, s_step_cg_tag const & tag)
+{
+  return detail::s_step_cg_solve(A, rhs, tag);
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,387 @@
+#ifndef VIENNACL_LINALG_S_STEP_GMRES_HPP_
+#define VIENNACL_LINALG_S_STEP_GMRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/s_step_gmres.hpp
+    @brief Implementation of the s-step (communication-avoiding) GMRES solver
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/tsqr.hpp"
+#include "viennacl/traits/clear.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/krylov/small_dense.hpp"
+#include "viennacl/linalg/detail/krylov/s_step_basis.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the s-step GMRES solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class s_step_gmres_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+  * @param max_iterations The maximum number of iterations (including restarts)
+  * @param krylov_dim     The maximum dimension of the Krylov space before restart
+  * @param s              Number of Krylov vectors generated and orthogonalized at once
+  * @param basis          The polynomial basis for generating the Krylov vectors
+  */
+  s_step_gmres_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20, unsigned int s = 4, s_step_basis_type basis = S_STEP_BASIS_NEWTON)
+   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim > 0 ? krylov_dim : 1), s_(s > 0 ? s : 1), basis_(basis), basis_tol_(1e-10),
+     iters_taken_(0), last_error_(0), basis_fallbacks_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  unsigned int max_iterations() const { return iterations_; }
+  /** @brief Returns the maximum dimension of the Krylov space before restart */
+  unsigned int krylov_dim() const { return krylov_dim_; }
+
+  /** @brief Returns the number of Krylov vectors generated per block */
+  unsigned int s() const { return s_; }
+
+  /** @brief Returns the polynomial basis used for generating the Krylov vectors */
+  s_step_basis_type basis() const { return basis_; }
+
+  /** @brief Returns the tolerance below which a new Krylov vector is considered numerically dependent on the previous ones */
+  double basis_tolerance() const { return basis_tol_; }
+  /** @brief Sets the tolerance below which a new Krylov vector is considered numerically dependent on the previous ones */
+  void basis_tolerance(double new_tol) { if (new_tol >= 0) basis_tol_ = new_tol; }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  /** @brief Set the number of solver iterations (should only be modified by the solver) */
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+  /** @brief Returns the number of blocks in which the basis was too ill-conditioned for s steps, so that fewer Krylov vectors were kept */
+  unsigned int basis_fallbacks() const { return basis_fallbacks_; }
+  /** @brief Sets the number of blocks with fewer than s Krylov vectors (should only be modified by the solver) */
+  void basis_fallbacks(unsigned int num) const { basis_fallbacks_ = num; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  unsigned int krylov_dim_;
+  unsigned int s_;
+  s_step_basis_type basis_;
+  double basis_tol_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+  mutable unsigned int basis_fallbacks_;
+};
+
+
+namespace detail
+{
+
+  /** @brief Implementation of the s-step GMRES method (no preconditioner).
+  *
+  * Following the communication-avoiding GMRES of M. Hoemmen, PhD thesis, UC Berkeley (2010).
+  * Each block generates s Krylov vectors from the last orthonormal basis vector with s sparse matrix-vector products,
+  * orthogonalizes them against the previous basis vectors by block classical Gram-Schmidt (two passes), and among themselves by TSQR.
+  * The columns of the Hessenberg matrix are then recovered from the R factors and the change-of-basis matrix of the polynomial basis.
+  *
+  * If the R factor reveals a numerically rank-deficient block (see s_step_gmres_tag::basis_tolerance()),
+  * only the leading well-conditioned Krylov vectors (at least one, which amounts to a classical Arnoldi step) are kept
+  * and the fallback is counted in s_step_gmres_tag::basis_fallbacks().
+  */
+  template<typename MatrixT, typename NumericT>
+  viennacl::vector<NumericT> s_step_gmres_solve(MatrixT const & A,
+                                                viennacl::vector<NumericT> const & rhs,
+                                                s_step_gmres_tag const & tag)
+  {
+    vcl_size_t n = rhs.size();
+    vcl_size_t m = std::min<vcl_size_t>(tag.krylov_dim(), n);
+    vcl_size_t s = std::min<vcl_size_t>(tag.s(), m);
+    viennacl::context ctx = viennacl::traits::context(rhs);
+
+    viennacl::vector<NumericT> result(rhs);
+    viennacl::traits::clear(result);
+    viennacl::vector<NumericT> residual(rhs);
+
+    viennacl::matrix<NumericT, viennacl::column_major> Q(n, m + 1, ctx);
+    viennacl::matrix<NumericT> small_C(m + 1, s, ctx);
+    viennacl::vector<NumericT> small_y(m, ctx);
+
+    viennacl::range all_rows(0, n);
+    viennacl::vector_base<NumericT> q_0(Q.handle(), n, 0, 1);
+
+    detail::s_step_recurrence recurrence(s, tag.basis());
+    bool ritz_values_set = false;
+    double breakdown_tolerance = 100.0 * static_cast<double>(std::numeric_limits<NumericT>::epsilon());
+    double pivot_tolerance = std::max(tag.basis_tolerance(), breakdown_tolerance);
+
+    std::vector<double> H((m + 1) * m);          // Hessenberg matrix
+    std::vector<double> H_rotated((m + 1) * m);  // Hessenberg matrix after Givens rotations
+    std::vector<double> givens_c(m), givens_s(m);
+    std::vector<double> g(m + 1);
+
+    double norm_rhs = viennacl::linalg::norm_2(rhs);
+    double norm_r = norm_rhs;
+    unsigned int iters = 0;
+    unsigned int fallbacks = 0;
+
+    if (norm_rhs <= tag.abs_tolerance()) //solution is zero if RHS norm is zero
+    {
+      tag.iters(0);
+      tag.basis_fallbacks(0);
+      tag.error(0);
+      return result;
+    }
+
+    for (;;)
+    {
+      if (norm_r <= tag.tolerance() * norm_rhs || norm_r <= tag.abs_tolerance() || iters >= tag.max_iterations())
+        break;
+
+      q_0 = residual;
+      q_0 /= NumericT(norm_r);
+
+      std::fill(H.begin(), H.end(), 0.0);
+      std::fill(H_rotated.begin(), H_rotated.end(), 0.0);
+      std::fill(g.begin(), g.end(), 0.0);
+      g[0] = norm_r;
+
+      vcl_size_t j = 0;    // number of Hessenberg columns computed in this cycle
+      bool cycle_done = false;
+      while (j < m && !cycle_done)
+      {
+        vcl_size_t k = std::min<vcl_size_t>(std::min<vcl_size_t>(s, m - j), tag.max_iterations() - iters);
+
+        detail::s_step_generate_basis(A, Q, j, k, recurrence);
+
+        // block Gram-Schmidt against Q(:, 0:j+1), two passes:
+        viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > Q_prev(Q, all_rows, viennacl::range(0, j + 1));
+        viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > V_new (Q, all_rows, viennacl::range(j + 1, j + 1 + k));
+        viennacl::matrix_range<viennacl::matrix<NumericT> > C_block(small_C, viennacl::range(0, j + 1), viennacl::range(0, k));
+
+        std::vector<double> C((j + 1) * k, 0.0);
+        for (unsigned int pass = 0; pass < 2; ++pass)
+        {
+          std::vector<double> C_pass;
+          C_block = viennacl::linalg::prod(viennacl::trans(Q_prev), V_new);
+          V_new -= viennacl::linalg::prod(Q_prev, C_block);
+          read_small_matrix(small_C, C_pass);
+          for (vcl_size_t i = 0; i <= j; ++i)
+            for (vcl_size_t l = 0; l < k; ++l)
+              C[i * k + l] += C_pass[i * s + l];
+        }
+
+        std::vector<double> R;
+        viennacl::linalg::tsqr(V_new, R);
+
+        // keep the leading Krylov vectors with a sufficiently large component orthogonal to the previous ones:
+        vcl_size_t num_new = 0;
+        for (; num_new < k; ++num_new)
+        {
+          double norm_squared = 0;
+          for (vcl_size_t i = 0; i <= j; ++i)
+            norm_squared += C[i * k + num_new] * C[i * k + num_new];
+          for (vcl_size_t i = 0; i <= num_new; ++i)
+            norm_squared += R[i * k + num_new] * R[i * k + num_new];
+          if (!(R[num_new * k + num_new] * R[num_new * k + num_new] > pivot_tolerance * norm_squared))
+            break;
+        }
+        if (num_new == 0)
+        {
+          // Even the first Krylov vector fails the basis tolerance. Its orthogonalization does not depend on the later vectors of the block,
+          // so keeping it alone is the same as redoing the block with k = 1, i.e. a classical Arnoldi step.
+          // Only if its new component vanishes up to round-off, A q_j lies in the span of the previous basis vectors (lucky breakdown):
+          double norm_squared = R[0] * R[0];
+          for (vcl_size_t i = 0; i <= j; ++i)
+            norm_squared += C[i * k] * C[i * k];
+          if (!(R[0] * R[0] > breakdown_tolerance * norm_squared))
+            cycle_done = true;
+          num_new = 1;
+        }
+        if (num_new < k)
+          ++fallbacks;
+
+        // the basis vectors in terms of the orthonormal ones: [V_0, ..., V_num_new] = Q(:, 0:j+num_new+1) R_big, where V_0 = q_j:
+        vcl_size_t rows = j + 1 + num_new;
+        std::vector<double> R_big(rows * (num_new + 1), 0.0);
+        R_big[j * (num_new + 1)] = 1.0;
+        for (vcl_size_t l = 1; l <= num_new; ++l)
+        {
+          for (vcl_size_t i = 0; i <= j; ++i)
+            R_big[i * (num_new + 1) + l] = C[i * k + (l-1)];
+          for (vcl_size_t i = 0; i < l; ++i)
+            R_big[(j + 1 + i) * (num_new + 1) + l] = R[i * k + (l-1)];
+        }
+
+        // new Hessenberg columns: (R_big T - H(:, 0:j) R_big(0:j, :)) R_big(j:j+num_new, :)^{-1}
+        std::vector<double> T = recurrence.change_of_basis(num_new);
+        std::vector<double> X(rows * num_new, 0.0);
+        for (vcl_size_t i = 0; i < rows; ++i)
+          for (vcl_size_t c = 0; c < num_new; ++c)
+          {
+            double value = 0;
+            for (vcl_size_t l = 0; l <= num_new; ++l)
+              value += R_big[i * (num_new + 1) + l] * T[l * num_new + c];
+            if (i <= j)
+              for (vcl_size_t l = 0; l < j; ++l)
+                value -= H[i * m + l] * R_big[l * (num_new + 1) + c];
+            X[i * num_new + c] = value;
+          }
+        for (vcl_size_t i = 0; i < rows; ++i)
+          for (vcl_size_t c = 0; c < num_new; ++c)
+          {
+            double value = X[i * num_new + c];
+            for (vcl_size_t l = 0; l < c; ++l)
+              value -= H[i * m + j + l] * R_big[(j + l) * (num_new + 1) + c];
+            H[i * m + j + c] = (i <= j + c + 1) ? value / R_big[(j + c) * (num_new + 1) + c] : 0;
+          }
+
+        // Ritz values from the first block for the shifts and scaling of the basis:
+        if (!ritz_values_set)
+        {
+          std::vector<double> H_symm(num_new * num_new);
+          std::vector<double> identity(num_new * num_new, 0.0);
+          for (vcl_size_t i = 0; i < num_new; ++i)
+          {
+            identity[i * num_new + i] = 1.0;
+            for (vcl_size_t l = 0; l < num_new; ++l)
+              H_symm[i * num_new + l] = 0.5 * (H[i * m + l] + H[l * m + i]);
+          }
+          recurrence.set_ritz_values(small_generalized_eigenvalues(H_symm, identity, num_new, 0.0));
+          ritz_values_set = true;
+        }
+
+        // least squares problem via Givens rotations:
+        vcl_size_t num_used = num_new;
+        for (vcl_size_t c = 0; c < num_new; ++c)
+        {
+          vcl_size_t col = j + c;
+          for (vcl_size_t i = 0; i <= col + 1; ++i)
+            H_rotated[i * m + col] = H[i * m + col];
+
+          for (vcl_size_t i = 0; i < col; ++i)
+          {
+            double h_i  = H_rotated[i * m + col];
+            double h_i1 = H_rotated[(i+1) * m + col];
+            H_rotated[i * m + col]     =  givens_c[i] * h_i + givens_s[i] * h_i1;
+            H_rotated[(i+1) * m + col] = -givens_s[i] * h_i + givens_c[i] * h_i1;
+          }
+
+          double h_diag = H_rotated[col * m + col];
+          double h_sub  = H_rotated[(col+1) * m + col];
+          double norm = std::sqrt(h_diag * h_diag + h_sub * h_sub);
+          givens_c[col] = (norm > 0) ? h_diag / norm : 1.0;
+          givens_s[col] = (norm > 0) ? h_sub  / norm : 0.0;
+          H_rotated[col * m + col] = norm;
+          H_rotated[(col+1) * m + col] = 0;
+          g[col+1] = -givens_s[col] * g[col];
+          g[col]   =  givens_c[col] * g[col];
+
+          ++iters;
+          if (std::fabs(g[col+1]) <= tag.tolerance() * norm_rhs || std::fabs(g[col+1]) <= tag.abs_tolerance() || norm <= 0)
+          {
+            num_used = c + 1;
+            cycle_done = true;
+            break;
+          }
+        }
+
+        j += num_used;
+        if (iters >= tag.max_iterations())
+          cycle_done = true;
+      }
+
+      // solve the triangular system and update the result:
+      std::vector<double> y(j);
+      for (vcl_size_t i = j; i-- > 0; )
+      {
+        double value = g[i];
+        for (vcl_size_t l = i+1; l < j; ++l)
+          value -= H_rotated[i * m + l] * y[l];
+        y[i] = (H_rotated[i * m + i] != 0) ? value / H_rotated[i * m + i] : 0;
+      }
+
+      viennacl::matrix_range<viennacl::matrix<NumericT, viennacl::column_major> > Q_used(Q, all_rows, viennacl::range(0, j));
+      write_small_vector(y, j, small_y);
+      result += viennacl::linalg::prod(Q_used, small_y);
+
+      residual = viennacl::linalg::prod(A, result);
+      residual = rhs - residual;
+      norm_r = viennacl::linalg::norm_2(residual);
+    }
+
+    tag.iters(iters);
+    tag.basis_fallbacks(fallbacks);
+    tag.error(norm_r / norm_rhs);
+
+    return result;
+  }
+
+}
+
+
+/** @brief Solves A x = rhs with the s-step GMRES method. A must be one of the ViennaCL sparse matrix types.
+*
+* @param A          The system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, s_step_gmres_tag const & tag, viennacl::linalg::no_precond)
+{
+  return detail::s_step_gmres_solve(A, rhs, tag);
+}
+
+/** @brief Convenience overload for calling the s-step GMRES solver without preconditioner */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, s_step_gmres_tag const & tag)
+{
+  return detail::s_step_gmres_solve(A, rhs, tag);
+}
+
+}
+}
+
+#endif
@@ -73,6 +73,39 @@ namespace viennacl
         }
       }
 
+      template<typename NumericT, unsigned int BlockSize, unsigned int VEC_ALIGNMENT>
+      void row_info(viennacl::bsr_matrix<NumericT, BlockSize> const & mat,
+                    vector<NumericT, VEC_ALIGNMENT> & vec,
+                    row_info_types info_selector)
+      {
+        switch (viennacl::traits::handle(mat).get_active_handle_id())
+        {
+          case viennacl::MAIN_MEMORY:
+            viennacl::linalg::host_based::detail::row_info(mat, vec, info_selector);
+            break;
+          case viennacl::MEMORY_NOT_INITIALIZED:
+            throw memory_exception("not initialised!");
+          default:
+            throw memory_exception("not implemented");
+        }
+      }
+      template<typename NumericT, unsigned int VEC_ALIGNMENT>
+      void row_info(viennacl::symmetric_compressed_matrix<NumericT> const & mat,
+                    vector<NumericT, VEC_ALIGNMENT> & vec,
+                    row_info_types info_selector)
+      {
+        switch (viennacl::traits::handle(mat).get_active_handle_id())
+        {
+          case viennacl::MAIN_MEMORY:
+            viennacl::linalg::host_based::detail::row_info(mat, vec, info_selector);
+            break;
+          case viennacl::MEMORY_NOT_INITIALIZED:
+            throw memory_exception("not initialised!");
+          default:
+            throw memory_exception("not implemented");
+        }
+      }
+
     }
 
 
@@ -203,6 +236,460 @@ namespace viennacl
       }
     }
 
+    // sliced_ell_matrix times dense matrix: host backend only
+
+    /** @brief Carries out matrix-matrix multiplication with a sliced_ell_matrix and a dense matrix
+    *
+    * Implementation of the convenience expression result = prod(sp_mat, d_mat);
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The dense matrix
+    * @param result   The result matrix (dense)
+    */
+    template<typename NumericT, typename IndexT>
+    void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & sp_mat,
+                   const viennacl::matrix_base<NumericT> & d_mat,
+                         viennacl::matrix_base<NumericT> & result)
+    {
+      assert( (sp_mat.size1() == result.size1()) && bool("Size check failed for sliced ELL matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.size1())  && bool("Size check failed for sliced ELL matrix - dense matrix product: size2(sp_mat) != size1(d_mat)"));
+
+      switch (viennacl::traits::handle(sp_mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, result);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-matrix multiplication with a sliced_ell_matrix and a transposed dense matrix
+    *
+    * Implementation of the convenience expression result = prod(sp_mat, trans(d_mat));
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The dense matrix (transposed)
+    * @param result   The result matrix (dense)
+    */
+    template<typename NumericT, typename IndexT>
+    void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & sp_mat,
+                   const viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                                     const viennacl::matrix_base<NumericT>,
+                                                     viennacl::op_trans> & d_mat,
+                         viennacl::matrix_base<NumericT> & result)
+    {
+      assert( (sp_mat.size1() == result.size1()) && bool("Size check failed for sliced ELL matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.size1())  && bool("Size check failed for sliced ELL matrix - dense matrix product: size2(sp_mat) != size1(d_mat)"));
+
+      switch (viennacl::traits::handle(sp_mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, result);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    // bsr_matrix: host backend only
+
+    /** @brief Carries out matrix-vector multiplication with a bsr_matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * The matrix and the vectors must reside in main memory.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the result vector
+    */
+    template<typename NumericT, unsigned int BlockSize>
+    void prod_impl(const viennacl::bsr_matrix<NumericT, BlockSize> & mat,
+                   const viennacl::vector_base<NumericT> & vec,
+                   NumericT alpha,
+                         viennacl::vector_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for BSR matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for BSR matrix-vector product: size2(mat) != size(x)"));
+
+      switch (viennacl::traits::handle(mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          assert( (viennacl::traits::active_handle_id(vec) == viennacl::MAIN_MEMORY && viennacl::traits::active_handle_id(result) == viennacl::MAIN_MEMORY)
+                  && bool("Vectors must reside in main memory for products with a bsr_matrix"));
+          viennacl::linalg::host_based::prod_impl(mat, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-vector multiplication with a transposed bsr_matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(trans(mat), vec) + beta * result;
+    * The matrix and the vectors must reside in main memory.
+    *
+    * @param mat_trans  The transposed matrix
+    * @param vec        The vector
+    * @param alpha      Scaling factor for the matrix-vector product
+    * @param result     The result vector
+    * @param beta       Scaling factor for the result vector
+    */
+    template<typename NumericT, unsigned int BlockSize>
+    void prod_impl(const viennacl::matrix_expression< const viennacl::bsr_matrix<NumericT, BlockSize>,
+                                                      const viennacl::bsr_matrix<NumericT, BlockSize>,
+                                                      viennacl::op_trans > & mat_trans,
+                   const viennacl::vector_base<NumericT> & vec,
+                   NumericT alpha,
+                         viennacl::vector_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (mat_trans.lhs().size2() == result.size()) && bool("Size check failed for transposed BSR matrix-vector product: size2(mat) != size(result)"));
+      assert( (mat_trans.lhs().size1() == vec.size())    && bool("Size check failed for transposed BSR matrix-vector product: size1(mat) != size(x)"));
+
+      switch (viennacl::traits::handle(mat_trans.lhs()).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          assert( (viennacl::traits::active_handle_id(vec) == viennacl::MAIN_MEMORY && viennacl::traits::active_handle_id(result) == viennacl::MAIN_MEMORY)
+                  && bool("Vectors must reside in main memory for products with a bsr_matrix"));
+          viennacl::linalg::host_based::prod_impl(mat_trans, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-matrix multiplication with a bsr_matrix and a dense matrix
+    *
+    * Implementation of the convenience expression result = prod(sp_mat, d_mat);
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The dense matrix
+    * @param result   The result matrix (dense)
+    */
+    template<typename NumericT, unsigned int BlockSize>
+    void prod_impl(const viennacl::bsr_matrix<NumericT, BlockSize> & sp_mat,
+                   const viennacl::matrix_base<NumericT> & d_mat,
+                         viennacl::matrix_base<NumericT> & result)
+    {
+      assert( (sp_mat.size1() == result.size1()) && bool("Size check failed for BSR matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.size1())  && bool("Size check failed for BSR matrix - dense matrix product: size2(sp_mat) != size1(d_mat)"));
+
+      switch (viennacl::traits::handle(sp_mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, result);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-matrix multiplication with a bsr_matrix and a transposed dense matrix
+    *
+    * Implementation of the convenience expression result = prod(sp_mat, trans(d_mat));
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The transposed dense matrix
+    * @param result   The result matrix (dense)
+    */
+    template<typename NumericT, unsigned int BlockSize>
+    void prod_impl(const viennacl::bsr_matrix<NumericT, BlockSize> & sp_mat,
+                   const viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                                     const viennacl::matrix_base<NumericT>,
+                                                     viennacl::op_trans> & d_mat,
+                         viennacl::matrix_base<NumericT> & result)
+    {
+      assert( (sp_mat.size1() == result.size1())       && bool("Size check failed for BSR matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.lhs().size2())  && bool("Size check failed for BSR matrix - dense matrix product: size2(sp_mat) != size2(d_mat)"));
+
+      switch (viennacl::traits::handle(sp_mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, result);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    // symmetric_compressed_matrix: host backend only
+
+    /** @brief Carries out matrix-vector multiplication with a symmetric_compressed_matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * Since the matrix is symmetric, this also covers result = alpha * prod(trans(mat), vec) + beta * result;
+    * The matrix and the vectors must reside in main memory.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the result vector
+    */
+    template<typename NumericT>
+    void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & mat,
+                   const viennacl::vector_base<NumericT> & vec,
+                   NumericT alpha,
+                         viennacl::vector_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for symmetric CSR matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for symmetric CSR matrix-vector product: size2(mat) != size(x)"));
+
+      // a matrix without entries holds no buffers, the product then only scales the result:
+      switch ((mat.nnz() > 0) ? viennacl::traits::handle(mat).get_active_handle_id() : viennacl::MAIN_MEMORY)
+      {
+        case viennacl::MAIN_MEMORY:
+          assert( (viennacl::traits::active_handle_id(vec) == viennacl::MAIN_MEMORY && viennacl::traits::active_handle_id(result) == viennacl::MAIN_MEMORY)
+                  && bool("Vectors must reside in main memory for products with a symmetric_compressed_matrix"));
+          viennacl::linalg::host_based::prod_impl(mat, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-matrix multiplication with a symmetric_compressed_matrix and a dense matrix
+    *
+    * Implementation of the convenience expression result = prod(sp_mat, d_mat);
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The dense matrix
+    * @param result   The result matrix (dense)
+    */
+    template<typename NumericT>
+    void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & sp_mat,
+                   const viennacl::matrix_base<NumericT> & d_mat,
+                         viennacl::matrix_base<NumericT> & result)
+    {
+      assert( (sp_mat.size1() == result.size1()) && bool("Size check failed for symmetric CSR matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.size1())  && bool("Size check failed for symmetric CSR matrix - dense matrix product: size2(sp_mat) != size1(d_mat)"));
+
+      switch (viennacl::traits::handle(sp_mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, result);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-matrix multiplication with a symmetric_compressed_matrix and a transposed dense matrix
+    *
+    * Implementation of the convenience expression result = prod(sp_mat, trans(d_mat));
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The transposed dense matrix
+    * @param result   The result matrix (dense)
+    */
+    template<typename NumericT>
+    void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & sp_mat,
+                   const viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                                     const viennacl::matrix_base<NumericT>,
+                                                     viennacl::op_trans> & d_mat,
+                         viennacl::matrix_base<NumericT> & result)
+    {
+      assert( (sp_mat.size1() == result.size1())       && bool("Size check failed for symmetric CSR matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.lhs().size2())  && bool("Size check failed for symmetric CSR matrix - dense matrix product: size2(sp_mat) != size2(d_mat)"));
+
+      switch (viennacl::traits::handle(sp_mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, result);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    // delta_compressed_matrix: host backend only
+
+    /** @brief Carries out matrix-vector multiplication with a delta_compressed_matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * The matrix and the vectors must reside in main memory.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the result vector
+    */
+    template<typename NumericT, typename DeltaT>
+    void prod_impl(const viennacl::delta_compressed_matrix<NumericT, DeltaT> & mat,
+                   const viennacl::vector_base<NumericT> & vec,
+                   NumericT alpha,
+                         viennacl::vector_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for delta-compressed CSR matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for delta-compressed CSR matrix-vector product: size2(mat) != size(x)"));
+
+      // a matrix without entries holds no buffers, the product then only scales the result:
+      switch ((mat.nnz() > 0) ? viennacl::traits::handle(mat).get_active_handle_id() : viennacl::MAIN_MEMORY)
+      {
+        case viennacl::MAIN_MEMORY:
+          assert( (viennacl::traits::active_handle_id(vec) == viennacl::MAIN_MEMORY && viennacl::traits::active_handle_id(result) == viennacl::MAIN_MEMORY)
+                  && bool("Vectors must reside in main memory for products with a delta_compressed_matrix"));
+          viennacl::linalg::host_based::prod_impl(mat, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    // mixed precision: float entries, double vectors. Host backend only
+
+    /** @brief Carries out matrix-vector multiplication with a compressed_matrix holding single precision entries and double precision vectors
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * The products are accumulated in double precision. Supported by the host backend only.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the result vector
+    */
+    template<unsigned int AlignmentV>
+    void prod_impl(const viennacl::compressed_matrix<float, AlignmentV> & mat,
+                   const viennacl::vector_base<double> & vec,
+                   double alpha,
+                         viennacl::vector_base<double> & result,
+                   double beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for mixed precision matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for mixed precision matrix-vector product: size2(mat) != size(x)"));
+
+      switch (viennacl::traits::handle(mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(mat, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-vector multiplication with a ell_matrix holding single precision entries and double precision vectors
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * The products are accumulated in double precision. Supported by the host backend only.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the result vector
+    */
+    template<unsigned int AlignmentV>
+    void prod_impl(const viennacl::ell_matrix<float, AlignmentV> & mat,
+                   const viennacl::vector_base<double> & vec,
+                   double alpha,
+                         viennacl::vector_base<double> & result,
+                   double beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for mixed precision matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for mixed precision matrix-vector product: size2(mat) != size(x)"));
+
+      switch (viennacl::traits::handle(mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(mat, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Carries out matrix-vector multiplication with a sliced_ell_matrix holding single precision entries and double precision vectors
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * The products are accumulated in double precision. Supported by the host backend only.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the result vector
+    */
+    template<typename IndexT>
+    void prod_impl(const viennacl::sliced_ell_matrix<float, IndexT> & mat,
+                   const viennacl::vector_base<double> & vec,
+                   double alpha,
+                         viennacl::vector_base<double> & result,
+                   double beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for mixed precision matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for mixed precision matrix-vector product: size2(mat) != size(x)"));
+
+      switch (viennacl::traits::handle(mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(mat, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    // auto_sparse_matrix: dispatched to the selected format at run time
+
+    /** @brief Carries out matrix-vector multiplication with an auto_sparse_matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * The product is computed by the backend of the memory domain the matrix was created in, using the format selected for the matrix.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the result vector
+    */
+    template<typename NumericT>
+    void prod_impl(const viennacl::auto_sparse_matrix<NumericT> & mat,
+                   const viennacl::vector_base<NumericT> & vec,
+                   NumericT alpha,
+                         viennacl::vector_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for auto sparse matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for auto sparse matrix-vector product: size2(mat) != size(x)"));
+
+      mat.apply_prod(vec, alpha, result, beta);
+    }
+
     // A * B with both A and B sparse
 
     /** @brief Carries out sparse_matrix-sparse_matrix multiplication for CSR matrices
@@ -246,6 +733,110 @@ namespace viennacl
       }
     }
 
+    /** @brief Captures the symbolic phase of a sparse matrix-matrix product C = A * B for CSR matrices as set up by prod_symbolic().
+    *
+    * The contents depend on the backend the product has been computed with. Currently only the host backend stores a plan, the other backends leave it empty.
+    */
+    class spgemm_plan
+    {
+    public:
+      /** @brief Returns true if no plan is stored for the backend of the last call to prod_symbolic() */
+      bool empty() const { return host_plan_.empty(); }
+
+      /** @brief Releases all data stored in the plan */
+      void clear() { host_plan_.clear(); }
+
+      /** @brief Returns the plan for the host backend */
+      viennacl::linalg::host_based::spgemm_plan       & host_plan()       { return host_plan_; }
+      viennacl::linalg::host_based::spgemm_plan const & host_plan() const { return host_plan_; }
+
+    private:
+      viennacl::linalg::host_based::spgemm_plan host_plan_;
+    };
+
+    /** @brief Symbolic phase of a sparse matrix-matrix product C = A * B for CSR matrices, which is to be repeated for operands with new values but the same sparsity patterns.
+    *
+    * Computes C = A * B and records the sparsity pattern of C in the plan. Use prod_numeric() for subsequent products.
+    * Only the host backend reuses the plan; other backends recompute the full product in prod_numeric().
+    *
+    * @param A     Left factor
+    * @param B     Right factor
+    * @param C     Result matrix
+    * @param plan  The plan to be set up
+    */
+    template<typename NumericT>
+    void
+    prod_symbolic(const viennacl::compressed_matrix<NumericT> & A,
+                  const viennacl::compressed_matrix<NumericT> & B,
+                        viennacl::compressed_matrix<NumericT> & C,
+                        spgemm_plan & plan)
+    {
+      assert( (A.size2() == B.size1())                    && bool("Size check failed for sparse matrix-matrix product: size2(A) != size1(B)"));
+      assert( (C.size1() == 0 || C.size1() == A.size1())  && bool("Size check failed for sparse matrix-matrix product: size1(A) != size1(C)"));
+      assert( (C.size2() == 0 || C.size2() == B.size2())  && bool("Size check failed for sparse matrix-matrix product: size2(B) != size2(B)"));
+
+      switch (viennacl::traits::handle(A).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_symbolic(A, B, C, plan.host_plan());
+          break;
+#ifdef VIENNACL_WITH_OPENCL
+        case viennacl::OPENCL_MEMORY:
+          plan.clear();
+          viennacl::linalg::opencl::prod_impl(A, B, C);
+          break;
+#endif
+#ifdef VIENNACL_WITH_CUDA
+        case viennacl::CUDA_MEMORY:
+          plan.clear();
+          viennacl::linalg::cuda::prod_impl(A, B, C);
+          break;
+#endif
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Numeric phase of a sparse matrix-matrix product C = A * B for CSR matrices, reusing the sparsity pattern of C determined by prod_symbolic().
+    *
+    * The values of C are written to the existing buffer C.handle(). A and B must have the same sparsity patterns as in the call to prod_symbolic(), C must not have been modified otherwise.
+    *
+    * @param A     Left factor
+    * @param B     Right factor
+    * @param C     Result matrix as computed by prod_symbolic()
+    * @param plan  The plan set up by prod_symbolic()
+    */
+    template<typename NumericT>
+    void
+    prod_numeric(const viennacl::compressed_matrix<NumericT> & A,
+                 const viennacl::compressed_matrix<NumericT> & B,
+                       viennacl::compressed_matrix<NumericT> & C,
+                       spgemm_plan & plan)
+    {
+      switch (viennacl::traits::handle(A).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_numeric(A, B, C, plan.host_plan());
+          break;
+#ifdef VIENNACL_WITH_OPENCL
+        case viennacl::OPENCL_MEMORY:
+          viennacl::linalg::opencl::prod_impl(A, B, C);
+          break;
+#endif
+#ifdef VIENNACL_WITH_CUDA
+        case viennacl::CUDA_MEMORY:
+          viennacl::linalg::cuda::prod_impl(A, B, C);
+          break;
+#endif
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
 
     /** @brief Carries out triangular inplace solves
     *
@@ -285,6 +876,54 @@ namespace viennacl
     }
 
 
+    /** @brief Carries out triangular inplace solves, reusing the analysis of the triangular factor for multi-threaded substitution on the host.
+    *
+    * If the factor is empty, it is set up from mat and tag. Subsequent calls reuse the factor, hence it needs to be cleared whenever the entries of mat change.
+    * The substitution mode (level-scheduled or synchronization-free) is selected by the factor, cf. sparse_triangular_factor::mode().
+    * Matrices in other memory domains use the triangular solvers of the respective backend, the factor is left untouched in this case.
+    *
+    * @param mat     The matrix
+    * @param vec     The vector
+    * @param tag     The solver tag (lower_tag, unit_lower_tag, unit_upper_tag, or upper_tag)
+    * @param factor  The triangular factor of mat
+    */
+    template<typename NumericT, unsigned int AlignmentV, typename SolverTagT>
+    void
+    inplace_solve(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
+                  viennacl::vector_base<NumericT> & vec,
+                  SolverTagT tag,
+                  viennacl::linalg::host_based::sparse_triangular_factor<NumericT> & factor)
+    {
+      assert( (mat.size1() == mat.size2()) && bool("Size check failed for triangular solve on compressed matrix: size1(mat) != size2(mat)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for compressed matrix-vector product: size2(mat) != size(x)"));
+
+      switch (viennacl::traits::handle(mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          if (factor.empty())
+            factor.init(mat, tag);
+          assert( (factor.size() == mat.size1()) && bool("Triangular factor does not match the matrix"));
+          assert( (factor.is_lower() == (viennacl::linalg::host_based::detail::triangular_tag_properties<SolverTagT>::is_lower == 1)) && bool("Triangular factor does not match the solver tag"));
+          factor.apply(vec);
+          break;
+#ifdef VIENNACL_WITH_OPENCL
+        case viennacl::OPENCL_MEMORY:
+          viennacl::linalg::opencl::inplace_solve(mat, vec, tag);
+          break;
+#endif
+#ifdef VIENNACL_WITH_CUDA
+        case viennacl::CUDA_MEMORY:
+          viennacl::linalg::cuda::inplace_solve(mat, vec, tag);
+          break;
+#endif
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+
     /** @brief Carries out transposed triangular inplace solves
     *
     * @param mat    The matrix
@@ -0,0 +1,136 @@
+#ifndef VIENNACL_LINALG_TSQR_HPP_
+#define VIENNACL_LINALG_TSQR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/tsqr.hpp
+    @brief Thin QR factorization of tall and skinny dense matrices as needed for orthogonalizing blocks of Krylov vectors.
+*/
+
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/detail/krylov/small_dense.hpp"
+#include "viennacl/linalg/host_based/tsqr.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+namespace detail
+{
+  /** @brief Cholesky QR applied twice, used for the memory domains without a TSQR implementation.
+    *
+    * Columns which are numerically linearly dependent on the previous ones are set to zero in Q, the respective rows of R are zero.
+    */
+  template<typename NumericT>
+  void cholesky_qr2(matrix_base<NumericT> & V, std::vector<double> & R)
+  {
+    vcl_size_t m = V.size1();
+    vcl_size_t k = V.size2();
+
+    std::vector<double> R_total(k * k, 0.0);
+    for (vcl_size_t i = 0; i < k; ++i)
+      R_total[i * k + i] = 1.0;
+
+    viennacl::matrix<NumericT> gram(k, k, viennacl::traits::context(V));
+    viennacl::matrix<NumericT> R_inverse_device(k, k, viennacl::traits::context(V));
+    viennacl::matrix<NumericT, viennacl::column_major> temp(m, k, viennacl::traits::context(V));
+
+    for (unsigned int pass = 0; pass < 2; ++pass)
+    {
+      std::vector<double> L;
+      gram = viennacl::linalg::prod(viennacl::trans(V), V);
+      read_small_matrix(gram, L);
+      vcl_size_t rank = small_cholesky(L, k, 1e-14);
+
+      // R = L^T and its inverse on the leading block, zero for the dependent columns:
+      std::vector<double> R_pass(k * k, 0.0);
+      std::vector<double> R_inverse(k * k, 0.0);
+      for (vcl_size_t i = 0; i < rank; ++i)
+        for (vcl_size_t j = i; j < rank; ++j)
+          R_pass[i * k + j] = L[j * k + i];
+      for (vcl_size_t j = 0; j < rank; ++j) // columns of the inverse by back substitution
+        for (vcl_size_t i = j + 1; i-- > 0; )
+        {
+          double value = (i == j) ? 1.0 : 0.0;
+          for (vcl_size_t l = i + 1; l <= j; ++l)
+            value -= R_pass[i * k + l] * R_inverse[l * k + j];
+          R_inverse[i * k + j] = value / R_pass[i * k + i];
+        }
+
+      write_small_matrix(R_inverse, k, k, R_inverse_device);
+      temp = viennacl::linalg::prod(V, R_inverse_device);
+      V = temp;
+
+      std::vector<double> R_new(k * k, 0.0);
+      for (vcl_size_t i = 0; i < k; ++i)
+        for (vcl_size_t j = i; j < k; ++j)
+          for (vcl_size_t l = i; l <= j; ++l)
+            R_new[i * k + j] += R_pass[i * k + l] * R_total[l * k + j];
+      R_total = R_new;
+    }
+
+    R = R_total;
+  }
+}
+
+/** @brief Computes the thin QR factorization V = Q R of a matrix with many more rows than columns, overwriting V with Q.
+  *
+  * In main memory, the tall-skinny QR algorithm (TSQR) is used, which needs a single pass over V for the factorization.
+  * In the other memory domains, Cholesky QR is applied twice.
+  *
+  * @param V    The tall and skinny matrix, overwritten by the orthonormal factor Q
+  * @param R    Returns the upper triangular k x k factor R (row-major, double precision on the host), where k is the number of columns of V
+  */
+template<typename NumericT>
+void tsqr(matrix_base<NumericT> & V, std::vector<double> & R)
+{
+  R.resize(V.size2() * V.size2());
+  if (V.size1() == 0 || V.size2() == 0)
+    return;
+
+  switch (viennacl::traits::handle(V).get_active_handle_id())
+  {
+    case viennacl::MAIN_MEMORY:
+      viennacl::linalg::host_based::tsqr(V, &(R[0]));
+      break;
+#ifdef VIENNACL_WITH_OPENCL
+    case viennacl::OPENCL_MEMORY:
+      detail::cholesky_qr2(V, R);
+      break;
+#endif
+#ifdef VIENNACL_WITH_CUDA
+    case viennacl::CUDA_MEMORY:
+      detail::cholesky_qr2(V, R);
+      break;
+#endif
+    case viennacl::MEMORY_NOT_INITIALIZED:
+      throw memory_exception("not initialised!");
+    default:
+      throw memory_exception("not implemented");
+  }
+}
+
+} //namespace linalg
+} //namespace viennacl
+
+#endif
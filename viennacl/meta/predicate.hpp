@@ -325,6 +325,39 @@ struct is_sliced_ell_matrix<viennacl::sliced_ell_matrix<ScalarType, IndexT> >
 };
 /** \endcond */
 
+//
+// is_bsr_matrix
+//
+/** \cond */
+template<typename ScalarType, unsigned int BlockSize>
+struct is_bsr_matrix<viennacl::bsr_matrix<ScalarType, BlockSize> >
+{
+  enum { value = true };
+};
+/** \endcond */
+
+//
+// is_symmetric_compressed_matrix
+//
+/** \cond */
+template<typename ScalarType>
+struct is_symmetric_compressed_matrix<viennacl::symmetric_compressed_matrix<ScalarType> >
+{
+  enum { value = true };
+};
+/** \endcond */
+
+//
+// is_delta_compressed_matrix
+//
+/** \cond */
+template<typename ScalarType, typename DeltaType>
+struct is_delta_compressed_matrix<viennacl::delta_compressed_matrix<ScalarType, DeltaType> >
+{
+  enum { value = true };
+};
+/** \endcond */
+
 //
 // is_hyb_matrix
 //
@@ -383,6 +416,24 @@ struct is_any_sparse_matrix<viennacl::hyb_matrix<ScalarType, AlignmentV> >
   enum { value = true };
 };
 
+template<typename ScalarType, unsigned int BlockSize>
+struct is_any_sparse_matrix<viennacl::bsr_matrix<ScalarType, BlockSize> >
+{
+  enum { value = true };
+};
+
+template<typename ScalarType>
+struct is_any_sparse_matrix<viennacl::symmetric_compressed_matrix<ScalarType> >
+{
+  enum { value = true };
+};
+
+template<typename ScalarType, typename DeltaType>
+struct is_any_sparse_matrix<viennacl::delta_compressed_matrix<ScalarType, DeltaType> >
+{
+  enum { value = true };
+};
+
 template<typename T>
 struct is_any_sparse_matrix<const T>
 {
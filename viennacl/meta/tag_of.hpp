@@ -264,6 +264,30 @@ namespace traits
     typedef viennacl::tag_viennacl  type;
   };
 
+  template< typename T, unsigned int B>
+  struct tag_of< viennacl::bsr_matrix<T,B> >
+  {
+    typedef viennacl::tag_viennacl  type;
+  };
+
+  template< typename T>
+  struct tag_of< viennacl::symmetric_compressed_matrix<T> >
+  {
+    typedef viennacl::tag_viennacl  type;
+  };
+
+  template< typename T, typename D>
+  struct tag_of< viennacl::delta_compressed_matrix<T,D> >
+  {
+    typedef viennacl::tag_viennacl  type;
+  };
+
+  template< typename T>
+  struct tag_of< viennacl::auto_sparse_matrix<T> >
+  {
+    typedef viennacl::tag_viennacl  type;
+  };
+
   template< typename T, unsigned int I>
   struct tag_of< viennacl::circulant_matrix<T,I> >
   {
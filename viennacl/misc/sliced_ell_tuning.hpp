@@ -0,0 +1,186 @@
+#ifndef VIENNACL_MISC_SLICED_ELL_TUNING_HPP_
+#define VIENNACL_MISC_SLICED_ELL_TUNING_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/misc/sliced_ell_tuning.hpp
+    @brief Selection of the parameters C and sigma of sliced_ell_matrix by measuring the throughput of matrix-vector products in main memory.
+*/
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <ostream>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/sliced_ell_matrix.hpp"
+#include "viennacl/tools/timer.hpp"
+
+namespace viennacl
+{
+
+/** @brief A tag holding the candidate parameters for tune_sliced_ell() */
+class sliced_ell_tuning_tag
+{
+public:
+  /** @brief Sets up the default candidates: C = 4, 8, 16, 32 and sigma = 1 (no sorting), 4C, 32C, 256C.
+    *
+    * @param benchmark_runs   Number of timed matrix-vector products per candidate
+    */
+  sliced_ell_tuning_tag(unsigned int benchmark_runs = 5) : benchmark_runs_(benchmark_runs)
+  {
+    rows_per_block_.push_back(4);
+    rows_per_block_.push_back(8);
+    rows_per_block_.push_back(16);
+    rows_per_block_.push_back(32);
+
+    sorting_scope_factors_.push_back(0);
+    sorting_scope_factors_.push_back(4);
+    sorting_scope_factors_.push_back(32);
+    sorting_scope_factors_.push_back(256);
+  }
+
+  unsigned int benchmark_runs() const { return benchmark_runs_; }
+  void benchmark_runs(unsigned int num) { if (num > 0) benchmark_runs_ = num; }
+
+  /** @brief The candidates for the number of rows per block C */
+  std::vector<vcl_size_t> const & rows_per_block() const { return rows_per_block_; }
+  void rows_per_block(std::vector<vcl_size_t> const & candidates) { rows_per_block_ = candidates; }
+
+  /** @brief The candidates for sigma as multiples of C. A factor of 0 stands for sigma = 1, i.e. no sorting. */
+  std::vector<vcl_size_t> const & sorting_scope_factors() const { return sorting_scope_factors_; }
+  void sorting_scope_factors(std::vector<vcl_size_t> const & candidates) { sorting_scope_factors_ = candidates; }
+
+private:
+  unsigned int benchmark_runs_;
+  std::vector<vcl_size_t> rows_per_block_;
+  std::vector<vcl_size_t> sorting_scope_factors_;
+};
+
+
+/** @brief The parameters selected by tune_sliced_ell() together with the resulting storage and the measured performance */
+struct sliced_ell_tuning_result
+{
+  sliced_ell_tuning_result() : rows_per_block(0), sorting_scope(1), nnz(0), internal_nnz(0), padding_overhead(0), time_per_product(0), gflops(0) {}
+
+  vcl_size_t rows_per_block;     // parameter C
+  vcl_size_t sorting_scope;      // parameter sigma
+  vcl_size_t nnz;                // number of entries
+  vcl_size_t internal_nnz;       // number of stored entries including padding
+  double     padding_overhead;   // (internal_nnz - nnz) / nnz
+  double     time_per_product;   // seconds per matrix-vector product
+  double     gflops;             // 2 * nnz / time_per_product / 1e9
+};
+
+/** @brief Prints the selected parameters, the padding, and the measured performance */
+inline std::ostream & operator<<(std::ostream & os, sliced_ell_tuning_result const & result)
+{
+  os << "SELL-C-sigma: C = " << result.rows_per_block << ", sigma = " << result.sorting_scope
+     << ", nnz = " << result.nnz << ", stored = " << result.internal_nnz
+     << " (padding overhead " << 100.0 * result.padding_overhead << "%)"
+     << ", " << result.gflops << " GFLOP/s";
+  return os;
+}
+
+
+/** @brief Copies a sparse matrix to a sliced_ell_matrix, choosing C and sigma from the candidates in 'tag' by the throughput of matrix-vector products in main memory.
+  *
+  * Each candidate is set up in main memory and timed. The winning parameters are then used for setting up 'sell_matrix'.
+  * If sell_matrix resides in a memory domain other than main memory, only C is carried over, since sigma > 1 is supported by the host backend only.
+  *
+  * @param cpu_matrix     A sparse matrix on the host composed of an STL vector and an STL map
+  * @param sell_matrix    The sliced_ell_matrix to be set up
+  * @param tag            The candidate parameters
+  * @return The selected parameters, the padding overhead, and the measured performance
+  */
+template<typename IndexT, typename NumericT, typename IndexT2>
+sliced_ell_tuning_result tune_sliced_ell(std::vector< std::map<IndexT, NumericT> > const & cpu_matrix,
+                                         viennacl::sliced_ell_matrix<NumericT, IndexT2> & sell_matrix,
+                                         sliced_ell_tuning_tag const & tag = sliced_ell_tuning_tag())
+{
+  sliced_ell_tuning_result best;
+
+  vcl_size_t num_cols = 0;
+  for (vcl_size_t i=0; i<cpu_matrix.size(); ++i)
+    if (cpu_matrix[i].size() > 0)
+      num_cols = std::max<vcl_size_t>(num_cols, static_cast<vcl_size_t>(cpu_matrix[i].rbegin()->first) + 1);
+
+  if (cpu_matrix.size() > 0 && num_cols > 0)
+  {
+    viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+    viennacl::vector<NumericT> x = viennacl::scalar_vector<NumericT>(num_cols, NumericT(1), host_ctx);
+    viennacl::vector<NumericT> y(cpu_matrix.size(), host_ctx);
+    viennacl::tools::timer timer;
+
+    for (std::size_t i=0; i<tag.rows_per_block().size(); ++i)
+    {
+      vcl_size_t rows_per_block = tag.rows_per_block()[i];
+      vcl_size_t previous_sorting_scope = 0;
+
+      for (std::size_t j=0; j<tag.sorting_scope_factors().size(); ++j)
+      {
+        // windows larger than the matrix are equivalent to sorting all rows:
+        vcl_size_t sorting_scope = std::min<vcl_size_t>(std::max<vcl_size_t>(tag.sorting_scope_factors()[j] * rows_per_block, 1), cpu_matrix.size());
+        if (sorting_scope == previous_sorting_scope)
+          continue;
+        previous_sorting_scope = sorting_scope;
+
+        viennacl::sliced_ell_matrix<NumericT, IndexT2> candidate(viennacl::sliced_ell_parameters(rows_per_block, sorting_scope), host_ctx);
+        viennacl::copy(cpu_matrix, candidate);
+
+        y = viennacl::linalg::prod(candidate, x); // warm-up
+
+        timer.start();
+        for (unsigned int run=0; run<tag.benchmark_runs(); ++run)
+          y = viennacl::linalg::prod(candidate, x);
+        double time_per_product = timer.get() / tag.benchmark_runs();
+
+        if (best.rows_per_block == 0 || time_per_product < best.time_per_product)
+        {
+          best.rows_per_block   = rows_per_block;
+          best.sorting_scope    = sorting_scope;
+          best.nnz              = candidate.nnz();
+          best.internal_nnz     = candidate.internal_nnz();
+          best.padding_overhead = candidate.padding_overhead();
+          best.time_per_product = time_per_product;
+          best.gflops           = (time_per_product > 0) ? 2.0 * double(candidate.nnz()) / time_per_product * 1e-9 : 0;
+        }
+      }
+    }
+  }
+
+  if (best.rows_per_block == 0) // nothing to tune, use defaults
+    best.rows_per_block = 32;
+
+  viennacl::sliced_ell_matrix<NumericT, IndexT2> result(viennacl::sliced_ell_parameters(best.rows_per_block, best.sorting_scope), viennacl::traits::context(sell_matrix.handle()));
+  viennacl::copy(cpu_matrix, result);
+  sell_matrix = result;
+
+  // sigma may have been reset to 1 if sell_matrix does not reside in main memory:
+  best.sorting_scope    = sell_matrix.sorting_scope();
+  best.nnz              = sell_matrix.nnz();
+  best.internal_nnz     = sell_matrix.internal_nnz();
+  best.padding_overhead = sell_matrix.padding_overhead();
+
+  return best;
+}
+
+} //namespace viennacl
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef VIENNACL_MISC_SPARSE_FORMAT_SELECTION_HPP_
+#define VIENNACL_MISC_SPARSE_FORMAT_SELECTION_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/misc/sparse_format_selection.hpp
+    @brief Row statistics of sparse matrices and the data used for selecting a sparse matrix format. See viennacl/auto_sparse_matrix.hpp for the selection itself.
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <sstream>
+
+#include "viennacl/forwards.h"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/tools/sha1.hpp"
+#include "viennacl/traits/handle.hpp"
+
+namespace viennacl
+{
+
+/** @brief The sparse matrix formats considered by the automatic format selection */
+enum sparse_format_type
+{
+  SPARSE_FORMAT_CSR = 0,          // compressed_matrix
+  SPARSE_FORMAT_COMPRESSED_CSR,   // compressed_compressed_matrix
+  SPARSE_FORMAT_COO,              // coordinate_matrix
+  SPARSE_FORMAT_ELL,              // ell_matrix
+  SPARSE_FORMAT_SLICED_ELL,       // sliced_ell_matrix
+  SPARSE_FORMAT_HYB               // hyb_matrix
+};
+
+/** @brief Returns the name of the class implementing the respective sparse format */
+inline std::string sparse_format_name(sparse_format_type format)
+{
+  switch (format)
+  {
+    case SPARSE_FORMAT_CSR:            return "compressed_matrix";
+    case SPARSE_FORMAT_COMPRESSED_CSR: return "compressed_compressed_matrix";
+    case SPARSE_FORMAT_COO:            return "coordinate_matrix";
+    case SPARSE_FORMAT_ELL:            return "ell_matrix";
+    case SPARSE_FORMAT_SLICED_ELL:     return "sliced_ell_matrix";
+    case SPARSE_FORMAT_HYB:            return "hyb_matrix";
+  }
+  return "unknown";
+}
+
+
+/** @brief Statistics of the row lengths (number of nonzeros per row) of a sparse matrix */
+struct sparse_row_statistics
+{
+  sparse_row_statistics() : size1(0), size2(0), nnz(0), mean_row_length(0), row_length_variance(0), max_row_length(0), empty_rows(0), bandwidth(0) {}
+
+  vcl_size_t size1;
+  vcl_size_t size2;
+  vcl_size_t nnz;
+  double     mean_row_length;
+  double     row_length_variance;
+  vcl_size_t max_row_length;
+  vcl_size_t empty_rows;
+  vcl_size_t bandwidth;            // maximum of |i - j| over all nonzeros (i, j)
+};
+
+/** @brief Computes the row statistics of a compressed_matrix. The matrix may reside in any memory domain.
+  *
+  * @param A    The sparse matrix
+  */
+template<typename NumericT, unsigned int AlignmentV>
+sparse_row_statistics row_statistics(viennacl::compressed_matrix<NumericT, AlignmentV> const & A)
+{
+  sparse_row_statistics stats;
+  stats.size1 = A.size1();
+  stats.size2 = A.size2();
+  stats.nnz   = A.nnz();
+
+  if (A.size1() == 0)
+    return stats;
+
+  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(A.handle1(), A.size1() + 1);
+  viennacl::backend::memory_read(A.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+
+  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(A.handle2(), A.nnz());
+  if (A.nnz() > 0)
+    viennacl::backend::memory_read(A.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+
+  stats.mean_row_length = double(A.nnz()) / double(A.size1());
+
+  for (vcl_size_t row = 0; row < A.size1(); ++row)
+  {
+    vcl_size_t row_start  = row_buffer[row];
+    vcl_size_t row_stop   = row_buffer[row+1];
+    vcl_size_t row_length = row_stop - row_start;
+
+    double deviation = double(row_length) - stats.mean_row_length;
+    stats.row_length_variance += deviation * deviation;
+    stats.max_row_length = std::max(stats.max_row_length, row_length);
+    if (row_length == 0)
+      ++stats.empty_rows;
+
+    for (vcl_size_t k = row_start; k < row_stop; ++k)
+    {
+      vcl_size_t col = col_buffer[k];
+      stats.bandwidth = std::max(stats.bandwidth, (col > row) ? col - row : row - col);
+    }
+  }
+  stats.row_length_variance /= double(A.size1());
+
+  return stats;
+}
+
+
+/** @brief A tag holding the parameters of the automatic sparse format selection */
+class auto_sparse_tag
+{
+public:
+  /** @brief The constructor
+    *
+    * @param benchmark_runs     Number of timed sparse matrix-vector products per candidate format. If zero, the format is chosen from the row statistics only.
+    * @param max_ell_fill       ELL is only considered if the padded ELL storage holds at most max_ell_fill times the number of nonzeros
+    * @param empty_row_ratio    compressed_compressed_matrix is preferred by the heuristic if more than this fraction of rows is empty
+    */
+  auto_sparse_tag(unsigned int benchmark_runs = 5, double max_ell_fill = 3.0, double empty_row_ratio = 0.5)
+    : benchmark_runs_(benchmark_runs), max_ell_fill_(max_ell_fill), empty_row_ratio_(empty_row_ratio) {}
+
+  unsigned int benchmark_runs() const { return benchmark_runs_; }
+  void benchmark_runs(unsigned int num) { benchmark_runs_ = num; }
+
+  double max_ell_fill() const { return max_ell_fill_; }
+  void max_ell_fill(double ratio) { if (ratio >= 1.0) max_ell_fill_ = ratio; }
+
+  double empty_row_ratio() const { return empty_row_ratio_; }
+  void empty_row_ratio(double ratio) { if (ratio >= 0 && ratio <= 1.0) empty_row_ratio_ = ratio; }
+
+private:
+  unsigned int benchmark_runs_;
+  double max_ell_fill_;
+  double empty_row_ratio_;
+};
+
+
+/** @brief Returns the formats worth benchmarking for a matrix with the supplied row statistics. compressed_matrix is always included. */
+inline std::vector<sparse_format_type> sparse_format_candidates(sparse_row_statistics const & stats, auto_sparse_tag const & tag)
+{
+  std::vector<sparse_format_type> candidates;
+  candidates.push_back(SPARSE_FORMAT_CSR);
+  if (stats.nnz == 0)
+    return candidates;
+
+  if (stats.empty_rows > 0)
+    candidates.push_back(SPARSE_FORMAT_COMPRESSED_CSR);
+  candidates.push_back(SPARSE_FORMAT_COO);
+  if (double(stats.size1) * double(stats.max_row_length) <= tag.max_ell_fill() * double(stats.nnz))
+    candidates.push_back(SPARSE_FORMAT_ELL);
+  candidates.push_back(SPARSE_FORMAT_SLICED_ELL);
+  candidates.push_back(SPARSE_FORMAT_HYB);
+
+  return candidates;
+}
+
+/** @brief Chooses a format from the row statistics only, used if no benchmarks are run.
+  *
+  * Matrices with many empty rows use compressed_compressed_matrix. Matrices with uniform row lengths use ELL (for which little padding is required).
+  * Otherwise, compressed_matrix is used in main memory, whereas the irregular rows are split off by hyb_matrix on GPUs.
+  */
+inline sparse_format_type sparse_format_heuristic(sparse_row_statistics const & stats, auto_sparse_tag const & tag, viennacl::memory_types memory_type)
+{
+  if (stats.nnz == 0)
+    return SPARSE_FORMAT_CSR;
+
+  if (double(stats.empty_rows) > tag.empty_row_ratio() * double(stats.size1))
+    return SPARSE_FORMAT_COMPRESSED_CSR;
+
+  double std_deviation = std::sqrt(stats.row_length_variance);
+  if (double(stats.max_row_length) <= stats.mean_row_length + 1.0 || std_deviation < 0.1 * stats.mean_row_length)
+    return (double(stats.size1) * double(stats.max_row_length) <= tag.max_ell_fill() * double(stats.nnz)) ? SPARSE_FORMAT_ELL : SPARSE_FORMAT_SLICED_ELL;
+
+  if (memory_type == viennacl::MAIN_MEMORY)
+    return SPARSE_FORMAT_CSR;
+
+  return SPARSE_FORMAT_HYB;
+}
+
+
+/** @brief Returns a key identifying the sparsity pattern of a compressed_matrix and the memory domain it resides in. The matrix entries do not enter the key.
+  *
+  * The key is the SHA1 hash of the matrix dimensions, the row array, and the column index array.
+  */
+template<typename NumericT, unsigned int AlignmentV>
+std::string sparse_structure_key(viennacl::compressed_matrix<NumericT, AlignmentV> const & A)
+{
+  viennacl::tools::detail::sha1 hasher;
+
+  vcl_size_t dims[3] = { A.size1(), A.size2(), A.nnz() };
+  hasher.processBytes(dims, sizeof(dims));
+
+  if (A.size1() > 0)
+  {
+    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(A.handle1(), A.size1() + 1);
+    viennacl::backend::memory_read(A.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+    hasher.processBytes(row_buffer.get(), row_buffer.raw_size());
+  }
+
+  if (A.nnz() > 0)
+  {
+    viennacl::backend::typesafe_host_array<unsigned int> col_buffer(A.handle2(), A.nnz());
+    viennacl::backend::memory_read(A.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+    hasher.processBytes(col_buffer.get(), col_buffer.raw_size());
+  }
+
+  viennacl::tools::uint32_t hash[5];
+  hasher.getDigest(hash);
+
+  std::ostringstream oss;
+  oss << viennacl::traits::active_handle_id(A) << ":";
+  for (int i = 0; i < 5; ++i)
+    oss << std::hex << std::setfill('0') << std::setw(8) << hash[i];
+
+  return oss.str();
+}
+
+
+/** @brief Cache of selected sparse formats, keyed by the sparsity pattern of the matrix (see sparse_structure_key()).
+  *
+  * Selecting a format by benchmarking is expensive compared to a single product, so the decision for a given sparsity pattern should be reused,
+  * e.g. for the matrices of subsequent time steps or Newton iterations.
+  */
+class sparse_format_cache
+{
+public:
+  /** @brief Looks up the format stored for the supplied key. Returns false if no format is stored. */
+  bool find(std::string const & key, sparse_format_type & format) const
+  {
+    std::map<std::string, sparse_format_type>::const_iterator it = formats_.find(key);
+    if (it == formats_.end())
+      return false;
+    format = it->second;
+    return true;
+  }
+
+  /** @brief Stores the format for the supplied key, replacing any previous entry */
+  void insert(std::string const & key, sparse_format_type format) { formats_[key] = format; }
+
+  /** @brief Returns the number of stored decisions */
+  vcl_size_t size() const { return formats_.size(); }
+
+  /** @brief Removes all stored decisions */
+  void clear() { formats_.clear(); }
+
+private:
+  std::map<std::string, sparse_format_type> formats_;
+};
+
+} //namespace viennacl
+
+#endif
@@ -25,6 +25,9 @@
 */
 
 
+#include <algorithm>
+#include <vector>
+
 #include "viennacl/forwards.h"
 #include "viennacl/vector.hpp"
 
@@ -34,13 +37,40 @@
 
 namespace viennacl
 {
+namespace detail
+{
+  /** @brief Orders row indices by decreasing row length, used for sorting the rows within a window of \f$ \sigma \f$ rows */
+  class sliced_ell_row_length_greater
+  {
+  public:
+    sliced_ell_row_length_greater(std::vector<vcl_size_t> const & row_lengths) : row_lengths_(row_lengths) {}
+
+    bool operator()(vcl_size_t a, vcl_size_t b) const { return row_lengths_[a] > row_lengths_[b]; }
+
+  private:
+    std::vector<vcl_size_t> const & row_lengths_;
+  };
+}
+
+/** @brief Layout parameters of a sliced_ell_matrix: the block size C and the sorting scope \f$ \sigma \f$. */
+struct sliced_ell_parameters
+{
+  sliced_ell_parameters(vcl_size_t num_rows_per_block = 0, vcl_size_t num_sorting_scope = 1)
+    : rows_per_block(num_rows_per_block), sorting_scope(num_sorting_scope) {}
+
+  vcl_size_t rows_per_block;  //parameter C in the paper by Kreutzer et al.
+  vcl_size_t sorting_scope;   //parameter sigma in the paper by Kreutzer et al.
+};
+
 /** @brief Sparse matrix class using the sliced ELLPACK with parameters C, \f$ \sigma \f$
   *
   * Based on the SELL-C-sigma format provided by Kreutzer et al., 2014
   * Can be seen as a block-wise ELLPACK format, where C rows are accumulated into the same block
   * for which a column-wise storage is used. Enables fully-coalesced reads from global memory.
   *
-  * Note: Currently \f$ \sigma \f$ is fixed to 1, since the sorting of rows
+  * If \f$ \sigma \f$ > 1, the rows within each window of \f$ \sigma \f$ consecutive rows are sorted by decreasing length before they are grouped into blocks,
+  * which reduces the padding. The row permutation is applied in the matrix-vector product, so the product refers to the original row ordering.
+  * Row sorting is only supported in main memory, for other memory domains \f$ \sigma \f$ is reset to 1 in copy().
   */
 template<typename ScalarT, typename IndexT /* see forwards.h = unsigned int */>
 class sliced_ell_matrix
@@ -50,35 +80,39 @@ public:
   typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<ScalarT>::ResultType>   value_type;
   typedef vcl_size_t                                                                              size_type;
 
-  explicit sliced_ell_matrix() : rows_(0), cols_(0), rows_per_block_(0) {}
+  explicit sliced_ell_matrix() : rows_(0), cols_(0), rows_per_block_(0), sorting_scope_(1), nnz_(0), internal_nnz_(0) {}
 
   /** @brief Standard constructor for setting the row and column sizes as well as the block size.
     *
-    * Supported values for num_rows_per_block_ are 32, 64, 128, 256. Other values may work, but are unlikely to yield good performance.
+    * Supported values for num_rows_per_block_ are 32, 64, 128, 256 on GPUs. In main memory, smaller values such as 8 or 16 are usually better.
+    * If sorting_scope (the parameter \f$ \sigma \f$) is larger than 1, the rows in each window of sorting_scope rows are sorted by decreasing length in copy().
     **/
   sliced_ell_matrix(size_type num_rows,
                     size_type num_cols,
-                    size_type num_rows_per_block_ = 0)
+                    size_type num_rows_per_block_ = 0,
+                    size_type sorting_scope = 1)
     : rows_(num_rows),
       cols_(num_cols),
-      rows_per_block_(num_rows_per_block_) {}
-
-  explicit sliced_ell_matrix(viennacl::context ctx) : rows_(0), cols_(0), rows_per_block_(0)
+      rows_per_block_(num_rows_per_block_),
+      sorting_scope_(std::max<size_type>(sorting_scope, 1)),
+      nnz_(0),
+      internal_nnz_(0) {}
+
+  /** @brief Constructor for a matrix to be created by copy() in the supplied context, using the block size C and the sorting scope \f$ \sigma \f$ from 'params'. */
+  sliced_ell_matrix(sliced_ell_parameters const & params, viennacl::context ctx)
+    : rows_(0),
+      cols_(0),
+      rows_per_block_(params.rows_per_block),
+      sorting_scope_(std::max<size_type>(params.sorting_scope, 1)),
+      nnz_(0),
+      internal_nnz_(0)
   {
-    columns_per_block_.switch_active_handle_id(ctx.memory_type());
-    column_indices_.switch_active_handle_id(ctx.memory_type());
-    block_start_.switch_active_handle_id(ctx.memory_type());
-    elements_.switch_active_handle_id(ctx.memory_type());
+    init_context(ctx);
+  }
 
-#ifdef VIENNACL_WITH_OPENCL
-    if (ctx.memory_type() == OPENCL_MEMORY)
-    {
-      columns_per_block_.opencl_handle().context(ctx.opencl_context());
-      column_indices_.opencl_handle().context(ctx.opencl_context());
-      block_start_.opencl_handle().context(ctx.opencl_context());
-      elements_.opencl_handle().context(ctx.opencl_context());
-    }
-#endif
+  explicit sliced_ell_matrix(viennacl::context ctx) : rows_(0), cols_(0), rows_per_block_(0), sorting_scope_(1), nnz_(0), internal_nnz_(0)
+  {
+    init_context(ctx);
   }
 
   /** @brief Resets all entries in the matrix back to zero without changing the matrix size. Resets the sparsity pattern. */
@@ -93,6 +127,9 @@ public:
     viennacl::backend::memory_create(column_indices_,    host_column_buffer.element_size() * internal_size1(),                         viennacl::traits::context(column_indices_),    host_column_buffer.get());
     viennacl::backend::memory_create(block_start_,       host_block_start_buffer.element_size() * ((rows_ - 1) / rows_per_block_ + 1), viennacl::traits::context(block_start_),       host_block_start_buffer.get());
     viennacl::backend::memory_create(elements_,          sizeof(ScalarT) * 1,                                                          viennacl::traits::context(elements_),          &(host_elements[0]));
+
+    nnz_ = 0;
+    internal_nnz_ = 0;
   }
 
   vcl_size_t internal_size1() const { return viennacl::tools::align_to_multiple<vcl_size_t>(rows_, rows_per_block_); }
@@ -103,8 +140,15 @@ public:
 
   vcl_size_t rows_per_block() const { return rows_per_block_; }
 
-  //vcl_size_t nnz() const { return rows_ * maxnnz_; }
-  //vcl_size_t internal_nnz() const { return internal_size1() * internal_maxnnz(); }
+  /** @brief Returns the size of the windows of rows sorted by decreasing length (parameter \f$ \sigma \f$). A value of 1 means that the rows are not reordered. */
+  vcl_size_t sorting_scope() const { return sorting_scope_; }
+
+  /** @brief Returns the number of entries supplied to copy() */
+  vcl_size_t nnz() const { return nnz_; }
+  /** @brief Returns the number of stored entries including the padding */
+  vcl_size_t internal_nnz() const { return internal_nnz_; }
+  /** @brief Returns the padding overhead, i.e. the number of padding entries relative to the number of entries */
+  double padding_overhead() const { return nnz_ > 0 ? double(internal_nnz_ - nnz_) / double(nnz_) : 0.0; }
 
   handle_type & handle1()       { return columns_per_block_; }
   const handle_type & handle1() const { return columns_per_block_; }
@@ -118,6 +162,10 @@ public:
   handle_type & handle()       { return elements_; }
   const handle_type & handle() const { return elements_; }
 
+  /** @brief Returns the handle to the row permutation: Entry i holds the row of the matrix stored at position i. Only set up if sorting_scope() > 1. */
+  handle_type & handle4()       { return row_permutation_; }
+  const handle_type & handle4() const { return row_permutation_; }
+
 #if defined(_MSC_VER) && _MSC_VER < 1500          //Visual Studio 2005 needs special treatment
   template<typename CPUMatrixT>
   friend void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix & gpu_matrix );
@@ -127,14 +175,38 @@ public:
 #endif
 
 private:
+  void init_context(viennacl::context ctx)
+  {
+    columns_per_block_.switch_active_handle_id(ctx.memory_type());
+    column_indices_.switch_active_handle_id(ctx.memory_type());
+    block_start_.switch_active_handle_id(ctx.memory_type());
+    elements_.switch_active_handle_id(ctx.memory_type());
+    row_permutation_.switch_active_handle_id(ctx.memory_type());
+
+#ifdef VIENNACL_WITH_OPENCL
+    if (ctx.memory_type() == OPENCL_MEMORY)
+    {
+      columns_per_block_.opencl_handle().context(ctx.opencl_context());
+      column_indices_.opencl_handle().context(ctx.opencl_context());
+      block_start_.opencl_handle().context(ctx.opencl_context());
+      elements_.opencl_handle().context(ctx.opencl_context());
+      row_permutation_.opencl_handle().context(ctx.opencl_context());
+    }
+#endif
+  }
+
   vcl_size_t rows_;
   vcl_size_t cols_;
   vcl_size_t rows_per_block_; //parameter C in the paper by Kreutzer et al.
+  vcl_size_t sorting_scope_;  //parameter sigma in the paper by Kreutzer et al.
+  vcl_size_t nnz_;
+  vcl_size_t internal_nnz_;
 
   handle_type columns_per_block_;
   handle_type column_indices_;
   handle_type block_start_;
   handle_type elements_;
+  handle_type row_permutation_;
 };
 
 template<typename CPUMatrixT, typename ScalarT, typename IndexT>
@@ -146,43 +218,71 @@ void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix<ScalarT, IndexT> & gp
   if (gpu_matrix.rows_per_block() == 0) // not yet initialized by user. Set default: 32 is perfect for NVIDIA GPUs and older AMD GPUs. Still okay for newer AMD GPUs.
     gpu_matrix.rows_per_block_ = 32;
 
+  if (viennacl::traits::context(gpu_matrix.handle()).memory_type() != viennacl::MAIN_MEMORY) // row permutation only supported by the host backend
+    gpu_matrix.sorting_scope_ = 1;
+
   if (viennacl::traits::size1(cpu_matrix) > 0 && viennacl::traits::size2(cpu_matrix) > 0)
   {
-    //determine max capacity for row
-    IndexT columns_in_current_block = 0;
-    vcl_size_t total_element_buffer_size = 0;
-    viennacl::backend::typesafe_host_array<IndexT> columns_in_block_buffer(gpu_matrix.handle1(), (viennacl::traits::size1(cpu_matrix) - 1) / gpu_matrix.rows_per_block() + 1);
+    vcl_size_t num_rows = viennacl::traits::size1(cpu_matrix);
+    vcl_size_t num_blocks = (num_rows - 1) / gpu_matrix.rows_per_block() + 1;
+
+    //determine row lengths
+    std::vector<vcl_size_t> row_lengths(num_rows);
+    vcl_size_t nnz = 0;
     for (typename CPUMatrixT::const_iterator1 row_it = cpu_matrix.begin1(); row_it != cpu_matrix.end1(); ++row_it)
     {
       vcl_size_t entries_in_row = 0;
       for (typename CPUMatrixT::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it)
         ++entries_in_row;
 
-      columns_in_current_block = std::max(columns_in_current_block, static_cast<IndexT>(entries_in_row));
+      row_lengths[row_it.index1()] = entries_in_row;
+      nnz += entries_in_row;
+    }
 
-      // check for end of block
-      if ( (row_it.index1() % gpu_matrix.rows_per_block() == gpu_matrix.rows_per_block() - 1)
-           || row_it.index1() == viennacl::traits::size1(cpu_matrix) - 1)
-      {
-        total_element_buffer_size += columns_in_current_block * gpu_matrix.rows_per_block();
-        columns_in_block_buffer.set(row_it.index1() / gpu_matrix.rows_per_block(), columns_in_current_block);
-        columns_in_current_block = 0;
-      }
+    //sort rows by decreasing length within windows of sigma rows. row_permutation[i] is the row stored at position i, row_position is the inverse
+    std::vector<vcl_size_t> row_permutation(num_rows);
+    std::vector<vcl_size_t> row_position(num_rows);
+    for (vcl_size_t i=0; i<num_rows; ++i)
+      row_permutation[i] = i;
+    if (gpu_matrix.sorting_scope() > 1)
+    {
+      for (vcl_size_t window_start = 0; window_start < num_rows; window_start += gpu_matrix.sorting_scope())
+        std::stable_sort(row_permutation.begin() + static_cast<long>(window_start),
+                         row_permutation.begin() + static_cast<long>(std::min(window_start + gpu_matrix.sorting_scope(), num_rows)),
+                         detail::sliced_ell_row_length_greater(row_lengths));
+    }
+    for (vcl_size_t i=0; i<num_rows; ++i)
+      row_position[row_permutation[i]] = i;
+
+    //determine max capacity for row
+    vcl_size_t total_element_buffer_size = 0;
+    viennacl::backend::typesafe_host_array<IndexT> columns_in_block_buffer(gpu_matrix.handle1(), num_blocks);
+    viennacl::backend::typesafe_host_array<IndexT> block_start(gpu_matrix.handle3(), num_blocks);
+    for (vcl_size_t block_index = 0; block_index < num_blocks; ++block_index)
+    {
+      vcl_size_t columns_in_current_block = 0;
+      for (vcl_size_t i = block_index * gpu_matrix.rows_per_block(); i < std::min((block_index + 1) * gpu_matrix.rows_per_block(), num_rows); ++i)
+        columns_in_current_block = std::max(columns_in_current_block, row_lengths[row_permutation[i]]);
+
+      columns_in_block_buffer.set(block_index, static_cast<IndexT>(columns_in_current_block));
+      block_start.set(block_index, static_cast<IndexT>(total_element_buffer_size));
+      total_element_buffer_size += columns_in_current_block * gpu_matrix.rows_per_block();
     }
 
     //setup GPU matrix
     gpu_matrix.rows_ = cpu_matrix.size1();
     gpu_matrix.cols_ = cpu_matrix.size2();
+    gpu_matrix.nnz_ = nnz;
+    gpu_matrix.internal_nnz_ = total_element_buffer_size;
 
     viennacl::backend::typesafe_host_array<IndexT> coords(gpu_matrix.handle2(), total_element_buffer_size);
-    viennacl::backend::typesafe_host_array<IndexT> block_start(gpu_matrix.handle3(), (viennacl::traits::size1(cpu_matrix) - 1) / gpu_matrix.rows_per_block() + 1);
     std::vector<ScalarT> elements(total_element_buffer_size, 0);
 
-    vcl_size_t block_offset = 0;
-    vcl_size_t block_index  = 0;
-    vcl_size_t row_in_block = 0;
     for (typename CPUMatrixT::const_iterator1 row_it = cpu_matrix.begin1(); row_it != cpu_matrix.end1(); ++row_it)
     {
+      vcl_size_t position     = row_position[row_it.index1()];
+      vcl_size_t block_offset = static_cast<vcl_size_t>(block_start[position / gpu_matrix.rows_per_block()]);
+      vcl_size_t row_in_block = position % gpu_matrix.rows_per_block();
       vcl_size_t entry_in_row = 0;
 
       for (typename CPUMatrixT::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it)
@@ -192,24 +292,20 @@ void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix<ScalarT, IndexT> & gp
         elements[buffer_index] = *col_it;
         entry_in_row++;
       }
-
-      ++row_in_block;
-
-      // check for end of block:
-      if ( (row_it.index1() % gpu_matrix.rows_per_block() == gpu_matrix.rows_per_block() - 1)
-           || row_it.index1() == viennacl::traits::size1(cpu_matrix) - 1)
-      {
-        block_start.set(block_index, static_cast<IndexT>(block_offset));
-        block_offset += columns_in_block_buffer[block_index] * gpu_matrix.rows_per_block();
-        ++block_index;
-        row_in_block = 0;
-      }
     }
 
     viennacl::backend::memory_create(gpu_matrix.handle1(), columns_in_block_buffer.raw_size(), traits::context(gpu_matrix.handle1()), columns_in_block_buffer.get());
     viennacl::backend::memory_create(gpu_matrix.handle2(), coords.raw_size(),                  traits::context(gpu_matrix.handle2()), coords.get());
     viennacl::backend::memory_create(gpu_matrix.handle3(), block_start.raw_size(),             traits::context(gpu_matrix.handle3()), block_start.get());
     viennacl::backend::memory_create(gpu_matrix.handle(),  sizeof(ScalarT) * elements.size(),  traits::context(gpu_matrix.handle()), &(elements[0]));
+
+    if (gpu_matrix.sorting_scope() > 1)
+    {
+      viennacl::backend::typesafe_host_array<IndexT> permutation_buffer(gpu_matrix.handle4(), num_rows);
+      for (vcl_size_t i=0; i<num_rows; ++i)
+        permutation_buffer.set(i, row_permutation[i]);
+      viennacl::backend::memory_create(gpu_matrix.handle4(), permutation_buffer.raw_size(), traits::context(gpu_matrix.handle()), permutation_buffer.get());
+    }
   }
 }
 
@@ -335,6 +431,56 @@ namespace detail
   };
 
 
+  // x = A * y with single precision entries and double precision vectors
+  template<typename IndexT>
+  struct op_executor<vector_base<double>, op_assign, vector_expression<const sliced_ell_matrix<float, IndexT>, const vector_base<double>, op_prod> >
+  {
+    static void apply(vector_base<double> & lhs, vector_expression<const sliced_ell_matrix<float, IndexT>, const vector_base<double>, op_prod> const & rhs)
+    {
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<double> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, temp, 0.0);
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, lhs, 0.0);
+    }
+  };
+
+  template<typename IndexT>
+  struct op_executor<vector_base<double>, op_inplace_add, vector_expression<const sliced_ell_matrix<float, IndexT>, const vector_base<double>, op_prod> >
+  {
+    static void apply(vector_base<double> & lhs, vector_expression<const sliced_ell_matrix<float, IndexT>, const vector_base<double>, op_prod> const & rhs)
+    {
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<double> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, temp, 0.0);
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, lhs, 1.0);
+    }
+  };
+
+  template<typename IndexT>
+  struct op_executor<vector_base<double>, op_inplace_sub, vector_expression<const sliced_ell_matrix<float, IndexT>, const vector_base<double>, op_prod> >
+  {
+    static void apply(vector_base<double> & lhs, vector_expression<const sliced_ell_matrix<float, IndexT>, const vector_base<double>, op_prod> const & rhs)
+    {
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<double> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), 1.0, temp, 0.0);
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), -1.0, lhs, 1.0);
+    }
+  };
+
+
   // x = A * vec_op
   template<typename ScalarT, typename IndexT, typename LHS, typename RHS, typename OP>
   struct op_executor<vector_base<ScalarT>, op_assign, vector_expression<const sliced_ell_matrix<ScalarT, IndexT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
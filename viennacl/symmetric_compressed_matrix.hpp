@@ -0,0 +1,394 @@
+#ifndef VIENNACL_SYMMETRIC_COMPRESSED_MATRIX_HPP_
+#define VIENNACL_SYMMETRIC_COMPRESSED_MATRIX_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/symmetric_compressed_matrix.hpp
+    @brief Implementation of the symmetric_compressed_matrix class (CSR format holding the upper triangle of a symmetric matrix)
+*/
+
+#include <map>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+
+#include "viennacl/tools/tools.hpp"
+
+#include "viennacl/linalg/sparse_matrix_operations.hpp"
+
+namespace viennacl
+{
+/** @brief Sparse matrix class for symmetric matrices, storing only the upper triangle (including the diagonal) in compressed sparse row (CSR) format.
+  *
+  * Compared to a compressed_matrix holding both triangles, the memory and the memory traffic for the matrix entries are about halved.
+  * The column indices within each row are sorted.
+  *
+  * The matrix resides in main memory. Operations are provided by the host backend only.
+  */
+template<typename NumericT>
+class symmetric_compressed_matrix
+{
+public:
+  typedef viennacl::backend::mem_handle                                                              handle_type;
+  typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<NumericT>::ResultType>     value_type;
+  typedef vcl_size_t                                                                                 size_type;
+
+  symmetric_compressed_matrix() : size_(0), nonzeros_(0) {}
+
+  /** @brief Construction of an empty matrix with the supplied number of rows and columns. Entries are supplied by copy() or by set(). */
+  explicit symmetric_compressed_matrix(size_type num_rows) : size_(num_rows), nonzeros_(0) {}
+
+  /** @brief Sets the row pointers, the column indices, and the entries of the upper triangle.
+    *
+    * @param row_jumper     Start and stop indices in the column and entry array for each row (length size+1)
+    * @param col_buffer     Column indices, sorted within each row. Each column index must not be smaller than the row index.
+    * @param elements       The entries of the upper triangle
+    * @param size           Number of rows and columns of the matrix
+    * @param nonzeros       Number of stored entries
+    */
+  void set(unsigned int const * row_jumper,
+           unsigned int const * col_buffer,
+           NumericT     const * elements,
+           size_type size,
+           size_type nonzeros)
+  {
+    assert( (size > 0)     && bool("Error in symmetric_compressed_matrix::set(): Number of rows must be larger than zero!"));
+    assert( (nonzeros > 0) && bool("Error in symmetric_compressed_matrix::set(): Number of nonzeros must be larger than zero!"));
+
+    size_ = size;
+    nonzeros_ = nonzeros;
+
+    viennacl::context host_context(viennacl::MAIN_MEMORY);
+    viennacl::backend::memory_create(row_buffer_, sizeof(unsigned int) * (size + 1), host_context, row_jumper);
+    viennacl::backend::memory_create(col_buffer_, sizeof(unsigned int) * nonzeros,   host_context, col_buffer);
+    viennacl::backend::memory_create(elements_,   sizeof(NumericT) * nonzeros,       host_context, elements);
+  }
+
+  /** @brief Resets the matrix to the empty state, releasing all memory. */
+  void clear()
+  {
+    size_ = 0;
+    nonzeros_ = 0;
+    row_buffer_ = handle_type();
+    col_buffer_ = handle_type();
+    elements_ = handle_type();
+  }
+
+  /** @brief Returns the number of rows */
+  size_type size1() const { return size_; }
+  /** @brief Returns the number of columns */
+  size_type size2() const { return size_; }
+
+  /** @brief Returns the number of stored entries, i.e. the nonzeros of the upper triangle including the diagonal */
+  size_type nnz() const { return nonzeros_; }
+
+  /** @brief Returns the memory handle to the row index array */
+  const handle_type & handle1() const { return row_buffer_; }
+  /** @brief Returns the memory handle to the column index array */
+  const handle_type & handle2() const { return col_buffer_; }
+  /** @brief Returns the memory handle to the matrix entry array */
+  const handle_type & handle() const { return elements_; }
+
+  /** @brief Returns the memory handle to the row index array */
+  handle_type & handle1() { return row_buffer_; }
+  /** @brief Returns the memory handle to the column index array */
+  handle_type & handle2() { return col_buffer_; }
+  /** @brief Returns the memory handle to the matrix entry array */
+  handle_type & handle() { return elements_; }
+
+private:
+  size_type size_;
+  size_type nonzeros_;
+  handle_type row_buffer_;
+  handle_type col_buffer_;
+  handle_type elements_;
+};
+
+
+/** @brief Copies the upper triangle of a symmetric sparse matrix given as a STL vector of maps to a symmetric_compressed_matrix. Entries below the diagonal are ignored.
+  *
+  * @param cpu_matrix   A symmetric sparse square matrix on the host
+  * @param sym_mat      The symmetric_compressed_matrix
+  */
+template<typename SizeT, typename NumericT>
+void copy(std::vector< std::map<SizeT, NumericT> > const & cpu_matrix,
+          symmetric_compressed_matrix<NumericT> & sym_mat)
+{
+  vcl_size_t size = cpu_matrix.size();
+  if (size == 0)
+  {
+    sym_mat.clear();
+    return;
+  }
+
+  std::vector<unsigned int> row_buffer(size + 1);
+  std::vector<unsigned int> col_buffer;
+  std::vector<NumericT>     elements;
+
+  for (vcl_size_t row = 0; row < size; ++row)
+  {
+    row_buffer[row] = static_cast<unsigned int>(col_buffer.size());
+    for (typename std::map<SizeT, NumericT>::const_iterator it = cpu_matrix[row].lower_bound(static_cast<SizeT>(row)); it != cpu_matrix[row].end(); ++it)
+    {
+      col_buffer.push_back(static_cast<unsigned int>(it->first));
+      elements.push_back(it->second);
+    }
+  }
+  row_buffer[size] = static_cast<unsigned int>(col_buffer.size());
+
+  if (col_buffer.empty())
+  {
+    sym_mat.clear();
+    return;
+  }
+
+  sym_mat.set(&(row_buffer[0]), &(col_buffer[0]), &(elements[0]), size, col_buffer.size());
+}
+
+
+/** @brief Copies the upper triangle of a symmetric compressed_matrix to a symmetric_compressed_matrix. Entries below the diagonal are ignored.
+  *
+  * @param csr_mat      The symmetric compressed_matrix, may reside in any memory domain
+  * @param sym_mat      The symmetric_compressed_matrix in main memory
+  */
+template<typename NumericT, unsigned int AlignmentV>
+void copy(compressed_matrix<NumericT, AlignmentV> const & csr_mat,
+          symmetric_compressed_matrix<NumericT> & sym_mat)
+{
+  assert( (csr_mat.size1() == csr_mat.size2()) && bool("Matrix must be square for conversion to symmetric_compressed_matrix") );
+
+  if (csr_mat.size1() == 0 || csr_mat.nnz() == 0)
+  {
+    sym_mat.clear();
+    return;
+  }
+
+  //get raw data from memory:
+  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(csr_mat.handle1(), csr_mat.size1() + 1);
+  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(csr_mat.handle2(), csr_mat.nnz());
+  std::vector<NumericT> csr_elements(csr_mat.nnz());
+
+  viennacl::backend::memory_read(csr_mat.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+  viennacl::backend::memory_read(csr_mat.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+  viennacl::backend::memory_read(csr_mat.handle(),  0, sizeof(NumericT) * csr_mat.nnz(), &(csr_elements[0]));
+
+  std::vector< std::map<unsigned int, NumericT> > upper(csr_mat.size1());
+  for (vcl_size_t row = 0; row < csr_mat.size1(); ++row)
+    for (vcl_size_t j = row_buffer[row]; j < row_buffer[row+1]; ++j)
+      if (col_buffer[j] >= row)
+        upper[row][static_cast<unsigned int>(col_buffer[j])] = csr_elements[j];
+
+  viennacl::copy(upper, sym_mat);
+}
+
+
+/** @brief Converts a symmetric_compressed_matrix to a compressed_matrix holding both triangles.
+  *
+  * @param sym_mat      The symmetric_compressed_matrix
+  * @param csr_mat      The compressed_matrix, may reside in any memory domain
+  */
+template<typename NumericT, unsigned int AlignmentV>
+void copy(symmetric_compressed_matrix<NumericT> const & sym_mat,
+          compressed_matrix<NumericT, AlignmentV> & csr_mat)
+{
+  assert( (csr_mat.size1() == 0 || csr_mat.size1() == sym_mat.size1()) && bool("Size mismatch") );
+  assert( (csr_mat.size2() == 0 || csr_mat.size2() == sym_mat.size2()) && bool("Size mismatch") );
+
+  if (sym_mat.nnz() == 0)
+    return;
+
+  unsigned int const * sym_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(sym_mat.handle1());
+  unsigned int const * sym_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(sym_mat.handle2());
+  NumericT     const * sym_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(sym_mat.handle());
+
+  std::vector< std::map<unsigned int, NumericT> > full(sym_mat.size1());
+  for (vcl_size_t row = 0; row < sym_mat.size1(); ++row)
+    for (vcl_size_t j = sym_row_buffer[row]; j < sym_row_buffer[row+1]; ++j)
+    {
+      full[row][sym_col_buffer[j]] = sym_elements[j];
+      full[sym_col_buffer[j]][static_cast<unsigned int>(row)] = sym_elements[j];
+    }
+
+  viennacl::copy(full, csr_mat);
+}
+
+
+//
+// Specify available operations:
+//
+
+/** \cond */
+
+namespace linalg
+{
+namespace detail
+{
+  // x = A * y
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x = A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x += A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x -= A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+
+  // x = A * vec_op
+  template<typename NumericT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  // x += A * vec_op
+  template<typename NumericT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  // x -= A * vec_op
+  template<typename NumericT, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const symmetric_compressed_matrix<NumericT>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<NumericT> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+
+  // x = trans(A) * y, where trans(A) = A
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const matrix_expression<const symmetric_compressed_matrix<NumericT>, const symmetric_compressed_matrix<NumericT>, op_trans>,
+                                                                         const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const matrix_expression<const symmetric_compressed_matrix<NumericT>, const symmetric_compressed_matrix<NumericT>, op_trans>,
+                                                                      const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x = trans(A) * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs().lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs().lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const matrix_expression<const symmetric_compressed_matrix<NumericT>, const symmetric_compressed_matrix<NumericT>, op_trans>,
+                                                                              const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const matrix_expression<const symmetric_compressed_matrix<NumericT>, const symmetric_compressed_matrix<NumericT>, op_trans>,
+                                                                      const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x += trans(A) * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs().lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs().lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const matrix_expression<const symmetric_compressed_matrix<NumericT>, const symmetric_compressed_matrix<NumericT>, op_trans>,
+                                                                              const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const matrix_expression<const symmetric_compressed_matrix<NumericT>, const symmetric_compressed_matrix<NumericT>, op_trans>,
+                                                                      const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x -= trans(A) * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs().lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs().lhs(), rhs.rhs(), NumericT(-1), lhs, NumericT(1));
+    }
+  };
+
+} // namespace detail
+} // namespace linalg
+
+/** \endcond */
+}
+
+#endif